@@ -0,0 +1,173 @@
+/**
+ * Metric history micro-benchmark
+ *
+ * Measures what the sampler thread pays per tick to record a sample and what
+ * one Sparkline repaint pays to reduce a full ring to its buckets, against a
+ * mutex-guarded std::deque of sample structs (the straightforward way to keep
+ * the same history). The *Contended cases run a second thread pushing every
+ * 100 us, ten thousand times the real sampling rate.
+ * Usage: metric-ring-bench [--benchmark_filter=...]
+ */
+#include "metric_ring.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+constexpr size_t Capacity = 4096;
+constexpr size_t Buckets = 256;
+constexpr int64_t WindowMs = 3600 * 1000;   // the whole ring at one sample per second
+
+struct Sample {
+    int64_t timeMs;
+    float values[metrics::SeriesCount];
+};
+
+class LockedHistory {
+public:
+    void push(const Sample &sample)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_samples.size() == Capacity - 1) m_samples.pop_front();
+        m_samples.push_back(sample);
+    }
+
+    size_t downsample(metrics::Series series, int64_t windowMs, metrics::Bucket *buckets, size_t bucketCount)
+    {
+        std::fill(buckets, buckets + bucketCount,
+                  metrics::Bucket{ std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), 0 });
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_samples.empty()) return 0;
+        const int64_t from = m_samples.back().timeMs - windowMs;
+        size_t used = 0;
+        for (auto it = m_samples.rbegin(); it != m_samples.rend() && it->timeMs >= from; ++it) {
+            const float v = it->values[series];
+            if (std::isnan(v)) continue;
+            metrics::Bucket &bucket = buckets[std::min(size_t((it->timeMs - from) * int64_t(bucketCount) / windowMs), bucketCount - 1)];
+            bucket.min = std::min(bucket.min, v);
+            bucket.max = std::max(bucket.max, v);
+            ++bucket.count;
+            ++used;
+        }
+        return used;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<Sample> m_samples;
+};
+
+Sample makeSample(int64_t i)
+{
+    return { i * 1000, { float(i % 100), float(40 + i % 20), 45.0f + float(i % 7) } };
+}
+
+template <typename History>
+void fill(History &history)
+{
+    for (int64_t i = 0; i < int64_t(Capacity); ++i) {
+        const Sample sample = makeSample(i);
+        if constexpr (std::is_same_v<History, metrics::MetricRing>) {
+            history.push(sample.timeMs, sample.values);
+        } else {
+            history.push(sample);
+        }
+    }
+}
+
+void BM_PushRing(benchmark::State &state)
+{
+    metrics::MetricRing ring(Capacity);
+    int64_t i = 0;
+    for (auto _ : state) {
+        const Sample sample = makeSample(i++);
+        ring.push(sample.timeMs, sample.values);
+    }
+}
+BENCHMARK(BM_PushRing);
+
+void BM_PushLocked(benchmark::State &state)
+{
+    LockedHistory history;
+    int64_t i = 0;
+    for (auto _ : state) {
+        history.push(makeSample(i++));
+    }
+}
+BENCHMARK(BM_PushLocked);
+
+void BM_DownsampleRing(benchmark::State &state)
+{
+    metrics::MetricRing ring(Capacity);
+    fill(ring);
+    std::vector<metrics::Bucket> buckets(Buckets);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ring.downsample(metrics::Cpu, WindowMs, buckets.data(), buckets.size()));
+    }
+}
+BENCHMARK(BM_DownsampleRing);
+
+void BM_DownsampleLocked(benchmark::State &state)
+{
+    LockedHistory history;
+    fill(history);
+    std::vector<metrics::Bucket> buckets(Buckets);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(history.downsample(metrics::Cpu, WindowMs, buckets.data(), buckets.size()));
+    }
+}
+BENCHMARK(BM_DownsampleLocked);
+
+void BM_DownsampleRingContended(benchmark::State &state)
+{
+    metrics::MetricRing ring(Capacity);
+    fill(ring);
+    std::atomic<bool> stop(false);
+    std::thread writer([&] {
+        for (int64_t i = Capacity; !stop.load(std::memory_order_relaxed); ++i) {
+            const Sample sample = makeSample(i);
+            ring.push(sample.timeMs, sample.values);
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+    std::vector<metrics::Bucket> buckets(Buckets);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ring.downsample(metrics::Cpu, WindowMs, buckets.data(), buckets.size()));
+    }
+    stop = true;
+    writer.join();
+}
+BENCHMARK(BM_DownsampleRingContended)->UseRealTime();
+
+void BM_DownsampleLockedContended(benchmark::State &state)
+{
+    LockedHistory history;
+    fill(history);
+    std::atomic<bool> stop(false);
+    std::thread writer([&] {
+        for (int64_t i = Capacity; !stop.load(std::memory_order_relaxed); ++i) {
+            history.push(makeSample(i));
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    });
+    std::vector<metrics::Bucket> buckets(Buckets);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(history.downsample(metrics::Cpu, WindowMs, buckets.data(), buckets.size()));
+    }
+    stop = true;
+    writer.join();
+}
+BENCHMARK(BM_DownsampleLockedContended)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
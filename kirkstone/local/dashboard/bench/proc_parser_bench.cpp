@@ -0,0 +1,173 @@
+/**
+ * /proc parsing micro-benchmark
+ *
+ * Compares one sampling tick of the CPU, memory and uptime probes done the
+ * previous way (QFile + QTextStream::readAll, then QString::split per line
+ * and per field, with /proc/stat read and split twice) against the
+ * proc_parser module on persistent descriptors. The Parse* cases run on a
+ * buffer captured once, so they measure parsing alone; the Tick* cases
+ * include the kernel regenerating the files.
+ * Usage: proc-parser-bench [--benchmark_filter=...]
+ */
+#include "proc_parser.h"
+#include <benchmark/benchmark.h>
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+std::string capture(const char *path)
+{
+    std::string content;
+    FILE *file = fopen(path, "r");
+    if (!file) return content;
+    char chunk[4096];
+    size_t length;
+    while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        content.append(chunk, length);
+    }
+    fclose(file);
+    return content;
+}
+
+// The SystemInfo code before the sampler, minus the property updates
+
+QString readFileContent(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QString();
+    }
+    QTextStream stream(&file);
+    return stream.readAll();
+}
+
+qint64 legacyCpu(const QString &statContent)
+{
+    QStringList lines = statContent.split('\n');
+    QStringList cpuData = lines[0].split(' ', Qt::SkipEmptyParts);
+    qint64 total = 0;
+    for (int i = 1; i < cpuData.size(); ++i) {
+        total += cpuData[i].toLongLong();
+    }
+    return total + cpuData[4].toLongLong();
+}
+
+int legacyCores(const QString &statContent)
+{
+    QStringList lines = statContent.split('\n');
+    QStringList usage;
+    for (const QString &line : lines) {
+        if (line.startsWith("cpu") && line != lines[0]) {
+            QStringList cpuData = line.split(' ', Qt::SkipEmptyParts);
+            if (cpuData.size() < 8) continue;
+            qint64 idle = cpuData[4].toLongLong();
+            qint64 total = 0;
+            for (int i = 1; i < cpuData.size(); ++i) {
+                total += cpuData[i].toLongLong();
+            }
+            usage.append(QString::number(total > 0 ? 100.0 * (total - idle) / total : 0.0, 'f', 1));
+        }
+    }
+    return usage.size();
+}
+
+qint64 legacyMemory(const QString &meminfoContent)
+{
+    QStringList lines = meminfoContent.split('\n');
+    qint64 memTotal = 0, memAvailable = 0;
+    for (const QString &line : lines) {
+        QStringList parts = line.split(':', Qt::SkipEmptyParts);
+        if (parts.size() < 2) continue;
+        QString key = parts[0].trimmed();
+        qint64 value = parts[1].trimmed().split(' ')[0].toLongLong() * 1024;
+        if (key == "MemTotal") memTotal = value;
+        else if (key == "MemAvailable") memAvailable = value;
+    }
+    return memTotal - memAvailable;
+}
+
+double legacyUptime(const QString &uptimeContent)
+{
+    return uptimeContent.split(' ')[0].toDouble();
+}
+
+// The proc_parser equivalents
+
+struct ParserState {
+    proc::CpuTimes cpu;
+    proc::CpuTimes cores[proc::MaxCpuCores];
+    proc::MeminfoParser meminfo;
+    uint64_t memory[proc::MeminfoFieldCount] = {};
+    uint64_t uptime = 0;
+};
+
+void BM_ParseLegacy(benchmark::State &state)
+{
+    const QString stat = QString::fromStdString(capture("/proc/stat"));
+    const QString meminfo = QString::fromStdString(capture("/proc/meminfo"));
+    const QString uptime = QString::fromStdString(capture("/proc/uptime"));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyCpu(stat));
+        benchmark::DoNotOptimize(legacyCores(stat));
+        benchmark::DoNotOptimize(legacyMemory(meminfo));
+        benchmark::DoNotOptimize(legacyUptime(uptime));
+    }
+}
+BENCHMARK(BM_ParseLegacy);
+
+void BM_ParseProcParser(benchmark::State &state)
+{
+    const std::string stat = capture("/proc/stat");
+    const std::string meminfo = capture("/proc/meminfo");
+    const std::string uptime = capture("/proc/uptime");
+    ParserState parser;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(proc::parseStat(stat.data(), stat.size(), parser.cpu, parser.cores,
+                                                 proc::MaxCpuCores));
+        benchmark::DoNotOptimize(parser.meminfo.parse(meminfo.data(), meminfo.size(), parser.memory));
+        benchmark::DoNotOptimize(proc::parseUptime(uptime.data(), uptime.size(), parser.uptime));
+    }
+}
+BENCHMARK(BM_ParseProcParser);
+
+void BM_TickLegacy(benchmark::State &state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(legacyCpu(readFileContent("/proc/stat")));
+        benchmark::DoNotOptimize(legacyCores(readFileContent("/proc/stat")));
+        benchmark::DoNotOptimize(legacyMemory(readFileContent("/proc/meminfo")));
+        benchmark::DoNotOptimize(legacyUptime(readFileContent("/proc/uptime")));
+    }
+}
+BENCHMARK(BM_TickLegacy);
+
+void BM_TickProcParser(benchmark::State &state)
+{
+    proc::ProcFile stat, meminfo, uptime;
+    if (!stat.open("/proc/stat") || !meminfo.open("/proc/meminfo") || !uptime.open("/proc/uptime")) {
+        state.SkipWithError("cannot open /proc files");
+        return;
+    }
+    ParserState parser;
+    static char buffer[16384];
+    for (auto _ : state) {
+        long length = std::max(stat.read(buffer, sizeof(buffer)), 0L);
+        benchmark::DoNotOptimize(proc::parseStat(buffer, size_t(length), parser.cpu, parser.cores,
+                                                 proc::MaxCpuCores));
+        length = std::max(meminfo.read(buffer, sizeof(buffer)), 0L);
+        benchmark::DoNotOptimize(parser.meminfo.parse(buffer, size_t(length), parser.memory));
+        length = std::max(uptime.read(buffer, sizeof(buffer)), 0L);
+        benchmark::DoNotOptimize(proc::parseUptime(buffer, size_t(length), parser.uptime));
+    }
+}
+BENCHMARK(BM_TickProcParser);
+
+} // namespace
+
+BENCHMARK_MAIN();
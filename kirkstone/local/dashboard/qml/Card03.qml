@@ -1,6 +1,7 @@
 import QtQuick 2.15
 import QtQuick.Controls 2.15
 import SystemInfo 1.0
+import Metrics 1.0
 
 DashboardCardBase {
     title: "Memory"
@@ -11,6 +12,17 @@ DashboardCardBase {
         onTriggered: if (systemInfo) systemInfo.refresh()
     }
 
+    // Last 10 minutes behind the current value
+    Sparkline {
+        anchors.fill: parent
+        anchors.margins: 6
+        history: systemInfo ? systemInfo.history : null
+        series: MetricHistory.Memory
+        windowSeconds: 600
+        color: "#44aaff"
+        opacity: 0.35
+    }
+
     Column {
         anchors.left: parent.left
         anchors.right: parent.right
@@ -1,10 +1,24 @@
 import QtQuick 2.15
 import SystemInfo 1.0
+import Metrics 1.0
 
 DashboardCardBase {
     title: "System Temp (°C)"
     property SystemInfo systemInfo: null
 
+    // Last 10 minutes behind the current value
+    Sparkline {
+        anchors.fill: parent
+        anchors.margins: 6
+        history: systemInfo ? systemInfo.history : null
+        series: MetricHistory.Temperature
+        windowSeconds: 600
+        minimum: 20
+        maximum: 100
+        color: "#ffaa00"
+        opacity: 0.35
+    }
+
     Column {
         anchors.left: parent.left
         anchors.right: parent.right
@@ -35,5 +49,17 @@ DashboardCardBase {
             font.bold: true
             anchors.horizontalCenter: parent.horizontalCenter
         }
+
+        // Individual sensors (coretemp cores, thermal zones, ...) as discovered by the sampler
+        Repeater {
+            model: systemInfo ? systemInfo.temperatureSensors.slice(0, 3) : []
+            CardInfoRow {
+                label: modelData.label
+                value: modelData.temperature.toFixed(1) + "°C"
+                labelWidth: 120
+                labelFontSize: 8
+                valueFontSize: 8
+            }
+        }
     }
 }
@@ -1,6 +1,37 @@
 import QtQuick 2.15
+import SystemInfo 1.0
 
 DashboardCardBase {
-    title: "Card 08"
-    isEmpty: true
+    title: "Hawkbit Log"
+    property SystemInfo systemInfo: null
+
+    ListView {
+        id: logView
+        anchors.fill: parent
+        anchors.margins: 8
+        clip: true
+        spacing: 1
+        model: systemInfo ? systemInfo.hawkbitLog : null
+
+        // Follow new entries unless the user scrolled back
+        property bool following: true
+        onMovementEnded: following = atYEnd
+        onCountChanged: if (following) positionViewAtEnd()
+
+        delegate: Text {
+            width: logView.width
+            text: time + "  " + message
+            elide: Text.ElideRight
+            color: priority <= 3 ? "#ff4444" : priority === 4 ? "#ffaa00" : "#cccccc"
+            font.pointSize: 7
+        }
+    }
+
+    Text {
+        anchors.centerIn: parent
+        text: "No log entries"
+        color: "#666666"
+        font.pointSize: 9
+        visible: logView.count === 0
+    }
 }
@@ -192,7 +192,8 @@ ApplicationWindow {
             checkCount++
 
             if (swUpdateInProgress) {
-                // Check actual service status
+                // Service state and logs are followed in the background;
+                // these calls only read the latest values
                 var serviceActive = systemInfo.checkHawkbitServiceStatus()
 
                 if (serviceActive) {
@@ -323,15 +324,19 @@ ApplicationWindow {
         }
     }
 
-    Component.onCompleted: {
-        systemInfo.logUIEvent("Dashboard startup", "Initializing managers")
+    // Initialize managers once the first frame is on screen; the refreshes
+    // start processes and D-Bus calls the first frame does not need
+    Connections {
+        target: startupTrace
+        function onFirstFrameShownChanged() {
+            systemInfo.logUIEvent("Dashboard startup", "Initializing managers")
 
-        // Initialize managers on startup
-        raucManager.refresh()
-        grubManager.refresh()
-        updateAgentManager.refresh()
+            raucManager.refresh()
+            grubManager.refresh()
+            updateAgentManager.refresh()
 
-        systemInfo.logUIEvent("Dashboard initialized", "All components loaded")
+            systemInfo.logUIEvent("Dashboard initialized", "All components loaded")
+        }
     }
 
     // SW Update Popup - Enhanced with animations and modern styling
@@ -434,6 +439,9 @@ ApplicationWindow {
             width: contentArea.width - 20
             height: contentArea.height - 20
 
+            // Rows 1-2 hold the live system cards and are part of the first
+            // frame; the rest are LazyCard cells created right after it
+
             // Row 1: System Monitoring Cards
             Card01 {
                 systemInfo: systemInfo
@@ -464,60 +472,74 @@ ApplicationWindow {
                 systemInfo: systemInfo
             }
 
-            Card08 {}
+            LazyCard {
+                sourceComponent: Component {
+                    Card08 {
+                        systemInfo: systemInfo
+                    }
+                }
+            }
 
-            Card09 {}
+            LazyCard { sourceComponent: Component { Card09 {} } }
 
-            Card10 {}
+            LazyCard { sourceComponent: Component { Card10 {} } }
 
-            Card11 {}
+            LazyCard { sourceComponent: Component { Card11 {} } }
 
-            Card12 {}
+            LazyCard { sourceComponent: Component { Card12 {} } }
 
             // Row 3: Empty Cards
-            Card13 {}
+            LazyCard { sourceComponent: Component { Card13 {} } }
 
-            Card14 {}
+            LazyCard { sourceComponent: Component { Card14 {} } }
 
-            Card15 {}
+            LazyCard { sourceComponent: Component { Card15 {} } }
 
-            Card16 {}
+            LazyCard { sourceComponent: Component { Card16 {} } }
 
-            Card17 {}
+            LazyCard { sourceComponent: Component { Card17 {} } }
 
-            Card18 {}
+            LazyCard { sourceComponent: Component { Card18 {} } }
 
             // Row 4: Empty Cards
-            Card19 {}
+            LazyCard { sourceComponent: Component { Card19 {} } }
 
-            Card20 {}
+            LazyCard { sourceComponent: Component { Card20 {} } }
 
-            Card21 {}
+            LazyCard { sourceComponent: Component { Card21 {} } }
 
-            Card22 {}
+            LazyCard { sourceComponent: Component { Card22 {} } }
 
-            Card23 {}
+            LazyCard { sourceComponent: Component { Card23 {} } }
 
-            Card24 {}
+            LazyCard { sourceComponent: Component { Card24 {} } }
 
             // Row 5: Empty Cards
-            Card25 {
-                raucSystemManager: raucSystemManager
-                systemInfo: systemInfo
+            LazyCard {
+                sourceComponent: Component {
+                    Card25 {
+                        raucSystemManager: raucSystemManager
+                        systemInfo: systemInfo
+                    }
+                }
             }
 
-            Card26 {
-                raucSystemManager: raucSystemManager
-                updateAgentManager: updateAgentManager
+            LazyCard {
+                sourceComponent: Component {
+                    Card26 {
+                        raucSystemManager: raucSystemManager
+                        updateAgentManager: updateAgentManager
+                    }
+                }
             }
 
-            Card27 {}
+            LazyCard { sourceComponent: Component { Card27 {} } }
 
-            Card28 {}
+            LazyCard { sourceComponent: Component { Card28 {} } }
 
-            Card29 {}
+            LazyCard { sourceComponent: Component { Card29 {} } }
 
-            Card30 {}
+            LazyCard { sourceComponent: Component { Card30 {} } }
         }
     }
 
@@ -0,0 +1,13 @@
+import QtQuick 2.15
+import QtQuick.Layouts 1.15
+
+// Grid cell for a card that is not needed in the first frame. The cell
+// takes the card's place in the layout and incubates the card in the
+// background once startupTrace reports the first frame, so the frame
+// only waits for the cards created directly.
+Loader {
+    Layout.fillWidth: true
+    Layout.fillHeight: true
+    asynchronous: true
+    active: startupTrace.firstFrameShown
+}
@@ -1,10 +1,14 @@
 #include "grub_manager.h"
 #include <QTextStream>
 #include <QDebug>
+#include <cstring>
 #include <dlt/dlt.h>
+#include <grubenv.h>
 
 DltContext GrubManager::m_ctx;
 
+static const char GrubEnvPath[] = "/grubenv/grubenv";
+
 static void ensureDltContext()
 {
     static bool initialized = false;
@@ -25,14 +29,6 @@ static void ensureDltContext()
 
 GrubManager::GrubManager(QObject *parent) : QObject(parent) {}
 
-void GrubManager::runProcess(const QString &cmd, const QStringList &args) {
-    GRB_LOG(QString("Run process: %1 %2").arg(cmd, args.join(" ")).toUtf8().constData());
-    QProcess proc;
-    proc.start(cmd, args);
-    proc.waitForFinished(4000);
-    updateStatus(QString::fromUtf8(proc.readAllStandardOutput()));
-}
-
 void GrubManager::updateStatus(const QString &output) {
     m_status = output.trimmed();
     parseGrubEnv(output);
@@ -86,8 +82,20 @@ void GrubManager::parseGrubVersion(const QString &output) {
 void GrubManager::refresh() {
     GRB_LOG("Refresh GRUB status requested");
 
-    // Get grubenv information
-    runProcess("/usr/bin/grub-editenv", {"/grubenv/grubenv", "list"});
+    // Read the environment block directly; the listing has the same
+    // "name=value" lines grub-editenv list prints
+    grubenv_t env;
+    char list[GRUBENV_MAX_SIZE];
+    int ret = grubenv_load(&env, GrubEnvPath);
+    if (ret >= 0) {
+        ret = grubenv_list(&env, list, sizeof(list));
+    }
+    if (ret < 0) {
+        GRB_LOG(QString("Failed to read %1: %2").arg(QString::fromLatin1(GrubEnvPath), QString::fromLocal8Bit(strerror(-ret))).toUtf8().constData());
+        updateStatus(QString());
+    } else {
+        updateStatus(QString::fromUtf8(list, ret));
+    }
 
     // Get GRUB version
     QProcess versionProc;
@@ -98,7 +106,12 @@ void GrubManager::refresh() {
 
 void GrubManager::setBootOrder(const QString &order) {
     GRB_LOG(QString("Set boot order: %1").arg(order).toUtf8().constData());
-    QProcess::execute("/usr/bin/grub-editenv", {"/grubenv/grubenv", "set", QString("ORDER=%1").arg(order)});
+    const QByteArray assignment = QString("ORDER=%1").arg(order).toUtf8();
+    const char *assignments[] = { assignment.constData() };
+    const int ret = grubenv_update(GrubEnvPath, assignments, 1);
+    if (ret < 0) {
+        GRB_LOG(QString("Failed to set boot order: %1").arg(QString::fromLocal8Bit(strerror(-ret))).toUtf8().constData());
+    }
     refresh();
 }
 
@@ -50,7 +50,6 @@ private:
     QString m_slotAOrder;
     QString m_slotBOrder;
 
-    void runProcess(const QString &cmd, const QStringList &args = {});
     void updateStatus(const QString &output);
     void parseGrubEnv(const QString &output);
     void parseGrubVersion(const QString &output);
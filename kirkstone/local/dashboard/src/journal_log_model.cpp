@@ -0,0 +1,210 @@
+#include "journal_log_model.h"
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+
+DltContext JournalLogModel::m_ctx;
+
+JournalLogModel::JournalLogModel(const QString &unit, int capacity, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_unit(unit)
+    , m_capacity(qMax(1, capacity))
+    , m_process(new QProcess(this))
+    , m_restartTimer(new QTimer(this))
+{
+    static bool dltContextRegistered = false;
+    if (!dltContextRegistered) {
+        DLT_REGISTER_CONTEXT(JournalLogModel::m_ctx, "JRNL", "Journal Log Follower");
+        dltContextRegistered = true;
+    }
+
+    m_entries.reserve(m_capacity);
+
+    m_process->setStandardErrorFile(QProcess::nullDevice());
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &JournalLogModel::onReadyRead);
+    connect(m_process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this, &JournalLogModel::onFinished);
+    connect(m_process, &QProcess::errorOccurred, this, &JournalLogModel::onErrorOccurred);
+
+    m_restartTimer->setSingleShot(true);
+    m_restartTimer->setInterval(RestartDelayMs);
+    connect(m_restartTimer, &QTimer::timeout, this, &JournalLogModel::startProcess);
+}
+
+JournalLogModel::~JournalLogModel()
+{
+    // No restart from the finished signal while tearing down
+    disconnect(m_process, nullptr, this, nullptr);
+    if (m_process->state() != QProcess::NotRunning) {
+        m_process->kill();
+        m_process->waitForFinished(1000);
+    }
+}
+
+void JournalLogModel::start()
+{
+    if (m_process->state() == QProcess::NotRunning && !m_restartTimer->isActive()) {
+        startProcess();
+    }
+}
+
+void JournalLogModel::startProcess()
+{
+    QStringList args;
+    args << "-u" << m_unit << "--follow" << "--quiet" << "--no-pager"
+         << "--output=json" << "--output-fields=MESSAGE,PRIORITY";
+    // After a restart continue where the previous process stopped
+    if (m_cursor.isEmpty()) {
+        args << "--lines" << QString::number(m_capacity);
+    } else {
+        args << "--after-cursor" << m_cursor;
+    }
+
+    m_pending.clear();
+    m_process->start("journalctl", args, QIODevice::ReadOnly);
+    DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Following journal of"), DLT_STRING(m_unit.toUtf8().constData()));
+}
+
+void JournalLogModel::onReadyRead()
+{
+    m_pending += m_process->readAllStandardOutput();
+
+    // One JSON object per line; a trailing partial line waits for the next read
+    QVector<Entry> entries;
+    int start = 0;
+    int newline;
+    while ((newline = m_pending.indexOf('\n', start)) >= 0) {
+        Entry entry;
+        if (parseEntry(m_pending.mid(start, newline - start), entry)) {
+            entries.append(entry);
+        }
+        start = newline + 1;
+    }
+    m_pending.remove(0, start);
+
+    if (!entries.isEmpty()) {
+        appendEntries(entries);
+    }
+}
+
+bool JournalLogModel::parseEntry(const QByteArray &line, Entry &entry)
+{
+    const QJsonObject object = QJsonDocument::fromJson(line).object();
+    if (object.isEmpty()) {
+        return false;
+    }
+
+    const QString cursor = object.value("__CURSOR").toString();
+    if (!cursor.isEmpty()) {
+        m_cursor = cursor;
+    }
+
+    // Non-UTF-8 messages come as an array of byte values
+    const QJsonValue message = object.value("MESSAGE");
+    if (message.isArray()) {
+        QByteArray bytes;
+        for (const QJsonValue &byte : message.toArray()) {
+            bytes.append(char(byte.toInt()));
+        }
+        entry.message = QString::fromLocal8Bit(bytes);
+    } else {
+        entry.message = message.toString();
+    }
+    entry.priority = object.value("PRIORITY").toString().toInt();
+    entry.realtimeUs = object.value("__REALTIME_TIMESTAMP").toString().toLongLong();
+    return true;
+}
+
+void JournalLogModel::appendEntries(QVector<Entry> &entries)
+{
+    QStringList messages;
+    messages.reserve(entries.size());
+    for (const Entry &entry : qAsConst(entries)) {
+        messages.append(entry.message);
+    }
+
+    // Only the newest capacity entries of a large batch are kept
+    if (entries.size() > m_capacity) {
+        entries.erase(entries.begin(), entries.end() - m_capacity);
+    }
+
+    const int overflow = m_entries.size() + entries.size() - m_capacity;
+    if (overflow > 0) {
+        beginRemoveRows(QModelIndex(), 0, overflow - 1);
+        m_entries.erase(m_entries.begin(), m_entries.begin() + overflow);
+        endRemoveRows();
+    }
+
+    const int first = m_entries.size();
+    beginInsertRows(QModelIndex(), first, first + entries.size() - 1);
+    m_entries += entries;
+    endInsertRows();
+
+    if (overflow < entries.size()) {
+        emit countChanged();
+    }
+    emit messagesAppended(messages);
+}
+
+void JournalLogModel::onFinished(int exitCode, QProcess::ExitStatus status)
+{
+    DLT_LOG(m_ctx, DLT_LOG_WARN, DLT_STRING("journalctl stopped, exit code:"), DLT_INT(exitCode),
+            DLT_STRING(status == QProcess::CrashExit ? "(crashed)" : ""), DLT_STRING("restarting in ms:"),
+            DLT_INT(RestartDelayMs));
+    m_restartTimer->start();
+}
+
+void JournalLogModel::onErrorOccurred(QProcess::ProcessError error)
+{
+    // finished() follows every error except a failed start
+    if (error == QProcess::FailedToStart) {
+        DLT_LOG(m_ctx, DLT_LOG_ERROR, DLT_STRING("Cannot start journalctl:"),
+                DLT_STRING(m_process->errorString().toUtf8().constData()));
+        m_restartTimer->start();
+    }
+}
+
+int JournalLogModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_entries.size();
+}
+
+QVariant JournalLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_entries.size()) {
+        return QVariant();
+    }
+
+    const Entry &entry = m_entries.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case MessageRole:
+        return entry.message;
+    case PriorityRole:
+        return entry.priority;
+    case TimeRole:
+        return QDateTime::fromMSecsSinceEpoch(entry.realtimeUs / 1000).toString("hh:mm:ss");
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> JournalLogModel::roleNames() const
+{
+    return {
+        { MessageRole, "message" },
+        { PriorityRole, "priority" },
+        { TimeRole, "time" },
+    };
+}
+
+QString JournalLogModel::tail(int lines) const
+{
+    QStringList messages;
+    for (int row = qMax(0, m_entries.size() - lines); row < m_entries.size(); ++row) {
+        messages.append(m_entries.at(row).message);
+    }
+    return messages.join('\n');
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <QAbstractListModel>
+#include <QByteArray>
+#include <QProcess>
+#include <QStringList>
+#include <QVector>
+#include <dlt/dlt.h>
+
+class QTimer;
+
+// Journal of one systemd unit as a bounded list model, oldest row first.
+// A single long-lived "journalctl -f -o json" process is read as its output
+// arrives: each entry is parsed once and appended, and rows beyond capacity
+// are dropped from the front. If journalctl exits it is started again after
+// the last cursor seen, so no entry is read twice.
+class JournalLogModel : public QAbstractListModel {
+    Q_OBJECT
+    Q_PROPERTY(QString unit READ unit CONSTANT)
+    Q_PROPERTY(int capacity READ capacity CONSTANT)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+public:
+    enum Roles {
+        MessageRole = Qt::UserRole + 1,
+        PriorityRole,       // syslog priority, 0 (emerg) to 7 (debug)
+        TimeRole            // "hh:mm:ss"
+    };
+
+    JournalLogModel(const QString &unit, int capacity, QObject *parent = nullptr);
+    ~JournalLogModel() override;
+
+    // Starts following; the newest capacity entries are loaded first
+    void start();
+
+    QString unit() const { return m_unit; }
+    int capacity() const { return m_capacity; }
+    int count() const { return m_entries.size(); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    // The newest lines messages joined by '\n', oldest first
+    Q_INVOKABLE QString tail(int lines) const;
+
+    static constexpr int RestartDelayMs = 5000;
+    static DltContext m_ctx;
+
+signals:
+    void countChanged();
+    // The messages of one batch of new entries, oldest first
+    void messagesAppended(const QStringList &messages);
+
+private slots:
+    void onReadyRead();
+    void onFinished(int exitCode, QProcess::ExitStatus status);
+    void onErrorOccurred(QProcess::ProcessError error);
+
+private:
+    struct Entry {
+        QString message;
+        int priority;
+        qint64 realtimeUs;
+    };
+
+    void startProcess();
+    bool parseEntry(const QByteArray &line, Entry &entry);
+    void appendEntries(QVector<Entry> &entries);
+
+    QString m_unit;
+    int m_capacity;
+    QProcess *m_process;
+    QTimer *m_restartTimer;
+    QByteArray m_pending;       // incomplete last line of the previous read
+    QString m_cursor;           // of the newest entry read
+    QVector<Entry> m_entries;
+};
@@ -3,7 +3,11 @@
 #include <QQmlContext>
 #include <QFontDatabase>
 #include <QDir>
+#include <QQuickWindow>
+#include "startup_trace.h"
 #include "system_info.h"
+#include "metric_history.h"
+#include "sparkline.h"
 #include "rauc_manager.h"
 #include "rauc_system_manager.h"
 #include "grub_manager.h"
@@ -14,8 +18,12 @@ static DltContext ctxUI;
 
 int main(int argc, char *argv[])
 {
+    // First, so the trace covers everything up to the first frame
+    StartupTrace startupTrace;
+
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
     QGuiApplication app(argc, argv);
+    startupTrace.mark("application created");
 
     // DLT initialization
     DLT_REGISTER_APP("DBRD", "Dashboard Application");
@@ -31,12 +39,17 @@ int main(int argc, char *argv[])
     // Register QML types
     DLT_LOG(ctxUI, DLT_LOG_INFO, DLT_STRING("Registering QML types"));
     qmlRegisterType<SystemInfo>("SystemInfo", 1, 0, "SystemInfo");
+    qmlRegisterUncreatableType<JournalLogModel>("SystemInfo", 1, 0, "JournalLogModel", "Use SystemInfo.hawkbitLog");
     qmlRegisterType<RaucManager>("Rauc", 1, 0, "RaucManager");
     qmlRegisterType<RaucSystemManager>("RaucSystem", 1, 0, "RaucSystemManager");
     qmlRegisterType<GrubManager>("Grub", 1, 0, "GrubManager");
     qmlRegisterType<UpdateAgentManager>("UpdateAgent", 1, 0, "UpdateAgentManager");
+    qmlRegisterUncreatableType<MetricHistory>("Metrics", 1, 0, "MetricHistory", "Use SystemInfo.history");
+    qmlRegisterType<Sparkline>("Metrics", 1, 0, "Sparkline");
+    startupTrace.mark("types registered");
 
     QQmlApplicationEngine engine;
+    engine.rootContext()->setContextProperty("startupTrace", &startupTrace);
 
     // Load main QML file with fallback strategy
     bool loaded = false;
@@ -85,6 +98,11 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    startupTrace.mark("qml loaded");
+    if (QQuickWindow *window = qobject_cast<QQuickWindow *>(engine.rootObjects().first())) {
+        startupTrace.watchFirstFrame(window);
+    }
+
     DLT_LOG(ctxUI, DLT_LOG_INFO, DLT_STRING("Dashboard UI loaded successfully, entering main event loop"));
     int ret = app.exec();
 
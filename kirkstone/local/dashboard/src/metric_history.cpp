@@ -0,0 +1,23 @@
+#include "metric_history.h"
+#include <algorithm>
+#include <limits>
+
+MetricHistory::MetricHistory(QObject *parent)
+    : QObject(parent)
+    , m_ring(Capacity)
+{
+}
+
+int MetricHistory::count() const
+{
+    return int(std::min<uint64_t>(m_ring.written(), m_ring.capacity() - 1));
+}
+
+double MetricHistory::latest(Series series) const
+{
+    float value;
+    if (!m_ring.latest(metrics::Series(series), value)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    return value;
+}
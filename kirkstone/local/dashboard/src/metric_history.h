@@ -0,0 +1,43 @@
+#pragma once
+#include <QObject>
+#include "metric_ring.h"
+
+// CPU, memory and temperature history shared by SystemSampler (writer, on
+// the sampler thread) and the Sparkline items (readers, on the render
+// thread). The ring is preallocated; the samples never pass through QML.
+// updated() is emitted on the GUI thread once per snapshot.
+class MetricHistory : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY updated)
+    Q_PROPERTY(int capacity READ capacity CONSTANT)
+public:
+    enum Series {
+        Cpu = metrics::Cpu,
+        Memory = metrics::Memory,
+        Temperature = metrics::Temperature
+    };
+    Q_ENUM(Series)
+
+    // About 70 minutes at one sample per second
+    static constexpr size_t Capacity = 4096;
+
+    explicit MetricHistory(QObject *parent = nullptr);
+
+    metrics::MetricRing &ring() { return m_ring; }
+    const metrics::MetricRing &ring() const { return m_ring; }
+
+    // Samples that can still be read
+    int count() const;
+    int capacity() const { return int(m_ring.capacity()); }
+
+    // Newest value of series, NaN if there is none
+    Q_INVOKABLE double latest(Series series) const;
+
+    void notifyUpdated() { emit updated(); }
+
+signals:
+    void updated();
+
+private:
+    metrics::MetricRing m_ring;
+};
@@ -0,0 +1,121 @@
+#include "metric_ring.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace metrics {
+
+// The writer announces a sample in m_begin before touching its slot and
+// publishes it in m_end afterwards (a seqlock over the whole ring). A reader
+// loads m_end, reads slots, then loads m_begin: if the writer has started on
+// the slot of the oldest sample read, that sample may be torn and the read
+// is repeated. The fences make a torn read imply the newer m_begin.
+
+MetricRing::MetricRing(size_t capacity)
+    : m_mask(0)
+    , m_begin(0)
+    , m_end(0)
+{
+    size_t rounded = 2;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    m_mask = rounded - 1;
+
+    m_time.reset(new std::atomic<int64_t>[rounded]);
+    for (size_t i = 0; i < rounded; ++i) {
+        m_time[i].store(0, std::memory_order_relaxed);
+    }
+    for (auto &values : m_values) {
+        values.reset(new std::atomic<float>[rounded]);
+        for (size_t i = 0; i < rounded; ++i) {
+            values[i].store(0.0f, std::memory_order_relaxed);
+        }
+    }
+}
+
+void MetricRing::push(int64_t timeMs, const float (&values)[SeriesCount])
+{
+    const uint64_t index = m_end.load(std::memory_order_relaxed);
+    m_begin.store(index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const size_t s = slot(index);
+    m_time[s].store(timeMs, std::memory_order_relaxed);
+    for (int series = 0; series < SeriesCount; ++series) {
+        m_values[series][s].store(values[series], std::memory_order_relaxed);
+    }
+    m_end.store(index + 1, std::memory_order_release);
+}
+
+bool MetricRing::latest(Series series, float &value, int64_t *timeMs) const
+{
+    for (;;) {
+        const uint64_t end = m_end.load(std::memory_order_acquire);
+        if (end == 0) return false;
+
+        const size_t s = slot(end - 1);
+        const float v = m_values[series][s].load(std::memory_order_relaxed);
+        const int64_t t = m_time[s].load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_begin.load(std::memory_order_relaxed) <= end - 1 + capacity()) {
+            if (std::isnan(v)) return false;
+            value = v;
+            if (timeMs) *timeMs = t;
+            return true;
+        }
+    }
+}
+
+size_t MetricRing::downsample(Series series, int64_t windowMs, Bucket *buckets, size_t bucketCount) const
+{
+    if (bucketCount == 0 || windowMs <= 0) return 0;
+
+    const std::atomic<float> *values = m_values[series].get();
+    for (;;) {
+        std::fill(buckets, buckets + bucketCount,
+                  Bucket{ std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(), 0 });
+
+        const uint64_t end = m_end.load(std::memory_order_acquire);
+        if (end == 0) return 0;
+
+        // One slot short of the capacity, so a single push during the read
+        // does not force a retry
+        const uint64_t oldest = end > m_mask ? end - m_mask : 0;
+        const int64_t from = m_time[slot(end - 1)].load(std::memory_order_relaxed) - windowMs;
+        uint64_t first = end - 1;
+        size_t used = 0;
+
+        // Newest to oldest, stopping at the start of the window. Times only
+        // decrease, so the bucket index steps down instead of being divided
+        // out per sample: bucket b starts at from + ceil(b * windowMs / bucketCount).
+        size_t b = bucketCount - 1;
+        int64_t bucketStart = (int64_t(b) * windowMs + int64_t(bucketCount) - 1) / int64_t(bucketCount);
+        for (uint64_t index = end; index > oldest; --index) {
+            const size_t s = slot(index - 1);
+            const int64_t t = m_time[s].load(std::memory_order_relaxed);
+            if (t < from) break;
+            first = index - 1;
+
+            const float v = values[s].load(std::memory_order_relaxed);
+            if (std::isnan(v)) continue;
+            while (b > 0 && t - from < bucketStart) {
+                --b;
+                bucketStart = (int64_t(b) * windowMs + int64_t(bucketCount) - 1) / int64_t(bucketCount);
+            }
+            Bucket &bucket = buckets[b];
+            bucket.min = std::min(bucket.min, v);
+            bucket.max = std::max(bucket.max, v);
+            ++bucket.count;
+            ++used;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_begin.load(std::memory_order_relaxed) <= first + capacity()) {
+            return used;
+        }
+    }
+}
+
+} // namespace metrics
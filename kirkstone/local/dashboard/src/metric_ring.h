@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// History of the sampled metrics for the sparklines. No Qt types, so it can
+// be benchmarked on its own (bench/metric_ring_bench.cpp).
+namespace metrics {
+
+enum Series {
+    Cpu,            // percent
+    Memory,         // percent
+    Temperature,    // degrees Celsius
+    SeriesCount
+};
+
+// Smallest and largest value of the samples that fell into one bucket
+struct Bucket {
+    float min;
+    float max;
+    uint32_t count;   // 0 when no sample fell into the bucket
+};
+
+// Fixed-capacity ring of samples stored as one array per series plus one of
+// timestamps, all allocated up front. One thread pushes; any thread reads,
+// without locks: a reader checks afterwards whether the writer lapped the
+// oldest sample it used and retries in that (rare) case.
+class MetricRing {
+public:
+    // capacity is rounded up to a power of two
+    explicit MetricRing(size_t capacity);
+    MetricRing(const MetricRing &) = delete;
+    MetricRing &operator=(const MetricRing &) = delete;
+
+    // Writer thread only. timeMs must not decrease; NaN marks a value that
+    // was not available in this sample.
+    void push(int64_t timeMs, const float (&values)[SeriesCount]);
+
+    size_t capacity() const { return m_mask + 1; }
+    // Samples pushed so far, including those already overwritten
+    uint64_t written() const { return m_end.load(std::memory_order_acquire); }
+
+    // Newest value of series; false if there is none
+    bool latest(Series series, float &value, int64_t *timeMs = nullptr) const;
+
+    // Min/max decimation of the last windowMs before the newest sample into
+    // bucketCount buckets of equal duration, oldest first. Returns the number
+    // of samples used.
+    size_t downsample(Series series, int64_t windowMs, Bucket *buckets, size_t bucketCount) const;
+
+private:
+    size_t slot(uint64_t index) const { return size_t(index) & m_mask; }
+
+    size_t m_mask;
+    std::unique_ptr<std::atomic<int64_t>[]> m_time;
+    std::unique_ptr<std::atomic<float>[]> m_values[SeriesCount];
+    // Index + 1 of the sample being written, and of the last one completed
+    std::atomic<uint64_t> m_begin;
+    std::atomic<uint64_t> m_end;
+};
+
+} // namespace metrics
@@ -0,0 +1,205 @@
+#include "proc_parser.h"
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <string_view>
+#include <unistd.h>
+
+namespace proc {
+
+namespace {
+
+// Keys in MeminfoField order, without the trailing ':'
+constexpr std::string_view MeminfoKeys[MeminfoFieldCount] = {
+    "MemTotal", "MemFree", "MemAvailable", "Buffers", "Cached", "SwapTotal", "SwapFree",
+};
+
+const char *skipBlanks(const char *p, const char *end)
+{
+    while (p < end && (*p == ' ' || *p == '\t')) {
+        ++p;
+    }
+    return p;
+}
+
+const char *nextLine(const char *p, const char *end)
+{
+    const void *newline = memchr(p, '\n', size_t(end - p));
+    return newline ? static_cast<const char *>(newline) + 1 : end;
+}
+
+// Unsigned number after optional blanks; nullptr if there is none before the line ends
+const char *scanNumber(const char *p, const char *end, uint64_t &value)
+{
+    p = skipBlanks(p, end);
+    const std::from_chars_result result = std::from_chars(p, end, value);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+// "Key:   1234 kB" at line, for a key of known length
+bool scanMeminfoValue(const char *line, const char *end, std::string_view key, uint64_t &value)
+{
+    if (size_t(end - line) <= key.size() || line[key.size()] != ':' ||
+        memcmp(line, key.data(), key.size()) != 0) {
+        return false;
+    }
+    return scanNumber(line + key.size() + 1, end, value) != nullptr;
+}
+
+} // namespace
+
+ProcFile::~ProcFile()
+{
+    close();
+}
+
+bool ProcFile::open(const char *path)
+{
+    close();
+    m_fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    return m_fd >= 0;
+}
+
+void ProcFile::close()
+{
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+}
+
+long ProcFile::read(char *buffer, size_t size) const
+{
+    if (m_fd < 0) {
+        return -1;
+    }
+    ssize_t length;
+    do {
+        length = ::pread(m_fd, buffer, size, 0);
+    } while (length < 0 && errno == EINTR);
+    return long(length);
+}
+
+int parseStat(const char *data, size_t length, CpuTimes &aggregate, CpuTimes *cores, int maxCores)
+{
+    // "cpu  user nice system idle iowait irq softirq steal guest guest_nice"
+    // followed by one "cpuN ..." line per core; everything after is ignored
+    const char *p = data;
+    const char *end = data + length;
+    bool haveAggregate = false;
+    int count = 0;
+    while (end - p > 3 && memcmp(p, "cpu", 3) == 0) {
+        const char *field = p + 3;
+        const bool isAggregate = *field == ' ';
+        while (field < end && *field >= '0' && *field <= '9') {
+            ++field;
+        }
+
+        CpuTimes times;
+        int fields = 0;
+        uint64_t value = 0;
+        while ((field = scanNumber(field, end, value)) != nullptr) {
+            times.total += value;
+            if (fields == 3) times.idle = value;
+            ++fields;
+        }
+        p = nextLine(p, end);
+        if (fields < 4) continue;
+
+        if (isAggregate) {
+            aggregate = times;
+            haveAggregate = true;
+        } else if (count < maxCores) {
+            cores[count++] = times;
+        }
+    }
+    return haveAggregate ? count : -1;
+}
+
+double cpuUsagePercent(const CpuTimes &previous, const CpuTimes &current)
+{
+    if (current.total <= previous.total) {
+        return 0.0;
+    }
+    const uint64_t total = current.total - previous.total;
+    const uint64_t idle = current.idle >= previous.idle ? current.idle - previous.idle : 0;
+    return idle >= total ? 0.0 : 100.0 * double(total - idle) / double(total);
+}
+
+MeminfoParser::MeminfoParser()
+    : m_tableLines(0)
+{
+    memset(m_lineField, -1, sizeof(m_lineField));
+}
+
+bool MeminfoParser::parse(const char *data, size_t length, uint64_t (&values)[MeminfoFieldCount])
+{
+    if (m_tableLines > 0 && parseWithTable(data, length, values)) {
+        return true;
+    }
+    return buildTable(data, length, values);
+}
+
+bool MeminfoParser::parseWithTable(const char *data, size_t length, uint64_t (&values)[MeminfoFieldCount]) const
+{
+    const char *p = data;
+    const char *end = data + length;
+    for (int line = 0; line < m_tableLines; ++line) {
+        if (p >= end) return false;
+        const int field = m_lineField[line];
+        if (field >= 0 && !scanMeminfoValue(p, end, MeminfoKeys[field], values[field])) {
+            return false;
+        }
+        p = nextLine(p, end);
+    }
+    return true;
+}
+
+bool MeminfoParser::buildTable(const char *data, size_t length, uint64_t (&values)[MeminfoFieldCount])
+{
+    memset(m_lineField, -1, sizeof(m_lineField));
+    m_tableLines = 0;
+
+    const char *p = data;
+    const char *end = data + length;
+    int found = 0;
+    for (int line = 0; line < MaxLines && p < end && found < MeminfoFieldCount; ++line) {
+        const char *colon = static_cast<const char *>(memchr(p, ':', size_t(end - p)));
+        const char *next = nextLine(p, end);
+        if (colon && colon < next) {
+            const std::string_view key(p, size_t(colon - p));
+            for (int field = 0; field < MeminfoFieldCount; ++field) {
+                if (key == MeminfoKeys[field] && scanNumber(colon + 1, end, values[field])) {
+                    m_lineField[line] = int8_t(field);
+                    m_tableLines = line + 1;
+                    ++found;
+                    break;
+                }
+            }
+        }
+        p = next;
+    }
+    if (found < MeminfoFieldCount) {
+        // Older kernels lack some fields (MemAvailable before 3.14); keep
+        // scanning by key next time rather than trusting a partial table
+        m_tableLines = 0;
+        return false;
+    }
+    return true;
+}
+
+bool parseUptime(const char *data, size_t length, uint64_t &seconds)
+{
+    // "12345.67 54321.00"; the fraction is dropped
+    return scanNumber(data, data + length, seconds) != nullptr;
+}
+
+bool parseValue(const char *data, size_t length, int64_t &value)
+{
+    const char *end = data + length;
+    const char *p = skipBlanks(data, end);
+    return std::from_chars(p, end, value).ec == std::errc();
+}
+
+} // namespace proc
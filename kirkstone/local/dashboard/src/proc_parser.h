@@ -0,0 +1,81 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Allocation-free parsers for the /proc and sysfs files SystemSampler reads
+// every tick. They scan a caller-owned buffer in one pass, convert numbers
+// with std::from_chars and never copy or allocate; no Qt types, so they can
+// be benchmarked on their own (bench/proc_parser_bench.cpp).
+namespace proc {
+
+// A /proc or sysfs file kept open and re-read from offset 0 with pread(),
+// which makes the kernel regenerate its contents
+class ProcFile {
+public:
+    ProcFile() = default;
+    ~ProcFile();
+    ProcFile(const ProcFile &) = delete;
+    ProcFile &operator=(const ProcFile &) = delete;
+
+    bool open(const char *path);
+    void close();
+    bool isOpen() const { return m_fd >= 0; }
+
+    // Bytes read into buffer, -1 if the file is not open or the read failed
+    long read(char *buffer, size_t size) const;
+
+private:
+    int m_fd = -1;
+};
+
+struct CpuTimes {
+    uint64_t total = 0;   // sum of all fields, in USER_HZ ticks
+    uint64_t idle = 0;
+};
+
+constexpr int MaxCpuCores = 256;
+
+// /proc/stat: the aggregate "cpu" line and up to maxCores "cpuN" lines.
+// Returns the number of cores parsed, -1 if there is no aggregate line.
+int parseStat(const char *data, size_t length, CpuTimes &aggregate, CpuTimes *cores, int maxCores);
+
+// Usage in percent between two samples of the same counters
+double cpuUsagePercent(const CpuTimes &previous, const CpuTimes &current);
+
+enum MeminfoField {
+    MemTotal,
+    MemFree,
+    MemAvailable,
+    Buffers,
+    Cached,
+    SwapTotal,
+    SwapFree,
+    MeminfoFieldCount
+};
+
+// /proc/meminfo. The first parse records which line holds each field; later
+// parses jump from line to line and only compare the keys on those lines.
+// The kernel never reorders the file, but a mismatch rebuilds the table.
+class MeminfoParser {
+public:
+    MeminfoParser();
+
+    // Values in kB; returns false unless every field was found
+    bool parse(const char *data, size_t length, uint64_t (&values)[MeminfoFieldCount]);
+
+private:
+    bool parseWithTable(const char *data, size_t length, uint64_t (&values)[MeminfoFieldCount]) const;
+    bool buildTable(const char *data, size_t length, uint64_t (&values)[MeminfoFieldCount]);
+
+    static constexpr int MaxLines = 128;
+    int8_t m_lineField[MaxLines];   // MeminfoField of each line, -1 if unused
+    int m_tableLines;               // lines covered by the table, 0 before the first parse
+};
+
+// /proc/uptime: whole seconds since boot
+bool parseUptime(const char *data, size_t length, uint64_t &seconds);
+
+// A sysfs attribute holding one integer, e.g. temp*_input in millidegrees
+bool parseValue(const char *data, size_t length, int64_t &value);
+
+} // namespace proc
@@ -1,7 +1,9 @@
 #include "rauc_manager.h"
 #include <QTextStream>
 #include <QDebug>
+#include <cstring>
 #include <dlt/dlt.h>
+#include <grubenv.h>
 
 DltContext RaucManager::m_ctx;
 
@@ -163,7 +165,12 @@ void RaucManager::refresh() {
 }
 
 static void setBootOrder(const QString &order) {
-    QProcess::execute("/usr/bin/grub-editenv", {"/grubenv/grubenv", "set", QString("ORDER=%1").arg(order)});
+    const QByteArray assignment = QString("ORDER=%1").arg(order).toUtf8();
+    const char *assignments[] = { assignment.constData() };
+    const int ret = grubenv_update("/grubenv/grubenv", assignments, 1);
+    if (ret < 0) {
+        RUC_LOG(QString("Failed to set boot order: %1").arg(QString::fromLocal8Bit(strerror(-ret))).toUtf8().constData());
+    }
 }
 
 void RaucManager::bootSlotA() {
@@ -5,11 +5,22 @@
 #include <QCoreApplication>
 #include <QDir>
 #include <QDateTime>
+#include <QProcess>
+#include <QDBusArgument>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <cstring>
+#include <grubenv.h>
 
 // Constants
 const QString RaucSystemManager::RAUC_BUNDLE_PATH = "/data/nuc-image-qt5-bundle-intel-corei7-64.raucb";
 const QString RaucSystemManager::GRUB_CONFIG_PATH = "/grubenv/grubenv";
 
+static const char RaucService[] = "de.pengutronix.rauc";
+static const char RaucPath[] = "/";
+static const char RaucInstallerInterface[] = "de.pengutronix.rauc.Installer";
+static const char PropertiesInterface[] = "org.freedesktop.DBus.Properties";
+
 // DLT context definition
 DltContext RaucSystemManager::m_ctx;
 
@@ -47,7 +58,10 @@ RaucSystemManager::RaucSystemManager(QObject *parent)
     , m_bundleSize(0)
     , m_bundleSizeFormatted("0 B")
     , m_bundleModified("")
-    , m_raucProcess(nullptr)
+    , m_bus(QDBusConnection::systemBus())
+    , m_slotStatusPending(false)
+    , m_installSource(InstallSource::None)
+    , m_raucOperation("idle")
 {
     // Register DLT context (once per process)
     static bool contextRegistered = false;
@@ -58,104 +72,117 @@ RaucSystemManager::RaucSystemManager(QObject *parent)
 
     DLT_LOG_CXX_INFO("RaucSystemManager initialized");
 
+    // Installation progress is pushed by RAUC; the timer only covers the
+    // boot order, bundle files and slot states changed by other tools
+    subscribeRauc();
+
     // Setup status refresh timer
     m_statusTimer = new QTimer(this);
     connect(m_statusTimer, &QTimer::timeout, this, &RaucSystemManager::refreshStatus);
     m_statusTimer->start(5000); // Refresh every 5 seconds
 
-    // Setup D-Bus monitoring timer for RAUC operations
-    m_dbusMonitorTimer = new QTimer(this);
-    connect(m_dbusMonitorTimer, &QTimer::timeout, this, &RaucSystemManager::checkRaucDBusProgress);
-
     // Initial status update
+    requestRaucProperties();
     refreshStatus();
 }
 
 void RaucSystemManager::refreshStatus()
 {
-    updateCurrentBootSlot();
     updateBootOrder();
-    updateSlotStatus();
     updateBundleInfo();
+    requestSlotStatus();
 }
 
-void RaucSystemManager::updateCurrentBootSlot()
+void RaucSystemManager::subscribeRauc()
 {
-    QString raucOutput = executeRaucCommand(QStringList() << "status");
-    QStringList lines = raucOutput.split('\n');
-
-    QString newSlot = "Unknown";
-
-    for (const QString &line : lines) {
-        if (line.contains("Booted from:")) {
-            if (line.contains("rootfs.0")) {
-                newSlot = "rootfs.0";
-            } else if (line.contains("rootfs.1")) {
-                newSlot = "rootfs.1";
-            }
-            break;
-        }
+    if (!m_bus.isConnected()) {
+        DLT_LOG_CXX_ERROR("Failed to connect to system D-Bus");
+        return;
     }
 
-    if (m_currentBootSlot != newSlot) {
-        m_currentBootSlot = newSlot;
-        emit currentBootSlotChanged();
-        DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Current boot slot updated: "), DLT_STRING(m_currentBootSlot.toUtf8().constData()));
+    bool connected = m_bus.connect(RaucService, RaucPath, PropertiesInterface, "PropertiesChanged", this,
+                                   SLOT(onRaucPropertiesChanged(QString, QVariantMap, QStringList)));
+    connected &= m_bus.connect(RaucService, RaucPath, RaucInstallerInterface, "Completed", this,
+                               SLOT(onRaucCompleted(int)));
+    if (!connected) {
+        DLT_LOG_CXX_ERROR("Failed to subscribe to RAUC D-Bus signals");
     }
 }
 
-void RaucSystemManager::updateBootOrder()
+void RaucSystemManager::requestRaucProperties()
 {
-    QProcess process;
-    process.start("grub-editenv", QStringList() << GRUB_CONFIG_PATH << "list");
-    process.waitForFinished();
-
-    QString output = process.readAllStandardOutput();
-    QStringList lines = output.split('\n');
+    QDBusMessage call = QDBusMessage::createMethodCall(RaucService, RaucPath, PropertiesInterface, "GetAll");
+    call << QString(RaucInstallerInterface);
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &RaucSystemManager::onRaucPropertiesReply);
+}
 
-    QString newOrder = "Unknown";
-    for (const QString &line : lines) {
-        if (line.startsWith("ORDER=")) {
-            newOrder = line.mid(6); // Remove "ORDER=" prefix
-            break;
-        }
+void RaucSystemManager::requestSlotStatus()
+{
+    // A slow reply must not pile up calls behind it
+    if (m_slotStatusPending) {
+        return;
     }
+    m_slotStatusPending = true;
 
-    if (m_bootOrder != newOrder) {
-        m_bootOrder = newOrder;
-        emit bootOrderChanged();
+    QDBusMessage call = QDBusMessage::createMethodCall(RaucService, RaucPath, RaucInstallerInterface,
+                                                       "GetSlotStatus");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &RaucSystemManager::onSlotStatusReply);
+}
+
+void RaucSystemManager::onRaucPropertiesReply(QDBusPendingCallWatcher *watcher)
+{
+    watcher->deleteLater();
+    const QDBusMessage reply = watcher->reply();
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        DLT_LOG_CXX_WARN(QString("RAUC properties unavailable: %1").arg(reply.errorMessage()).toUtf8().constData());
+        return;
     }
+    applyRaucProperties(qdbus_cast<QVariantMap>(reply.arguments().first()));
 }
 
-void RaucSystemManager::updateSlotStatus()
+void RaucSystemManager::onSlotStatusReply(QDBusPendingCallWatcher *watcher)
 {
-    QString raucOutput = executeRaucCommand(QStringList() << "status");
-    QStringList lines = raucOutput.split('\n');
+    watcher->deleteLater();
+    m_slotStatusPending = false;
+    const QDBusMessage reply = watcher->reply();
+    if (reply.type() != QDBusMessage::ReplyMessage || reply.arguments().isEmpty()) {
+        qDebug() << "RAUC GetSlotStatus failed:" << reply.errorMessage();
+        return;
+    }
 
+    // a(sa{sv}): slot name ("rootfs.0") and its status dictionary
+    QString newSlot = "Unknown";
     QString newSlotAStatus = "unknown";
     QString newSlotBStatus = "unknown";
 
-    for (int i = 0; i < lines.size(); ++i) {
-        const QString &line = lines[i];
-
-        if (line.contains("bootname: A")) {
-            // Look for boot status in the following lines
-            for (int j = i + 1; j < lines.size() && j < i + 5; ++j) {
-                if (lines[j].contains("boot status:")) {
-                    newSlotAStatus = lines[j].split("boot status:").last().trimmed();
-                    break;
-                }
-            }
-        } else if (line.contains("bootname: B")) {
-            // Look for boot status in the following lines
-            for (int j = i + 1; j < lines.size() && j < i + 5; ++j) {
-                if (lines[j].contains("boot status:")) {
-                    newSlotBStatus = lines[j].split("boot status:").last().trimmed();
-                    break;
-                }
-            }
+    const QDBusArgument slotArray = reply.arguments().first().value<QDBusArgument>();
+    slotArray.beginArray();
+    while (!slotArray.atEnd()) {
+        QString name;
+        QVariantMap status;
+        slotArray.beginStructure();
+        slotArray >> name >> status;
+        slotArray.endStructure();
+
+        if (status.value("state").toString() == "booted") {
+            newSlot = name;
+        }
+        const QString bootname = status.value("bootname").toString();
+        if (bootname == "A") {
+            newSlotAStatus = status.value("boot-status", "unknown").toString();
+        } else if (bootname == "B") {
+            newSlotBStatus = status.value("boot-status", "unknown").toString();
         }
     }
+    slotArray.endArray();
+
+    if (m_currentBootSlot != newSlot) {
+        m_currentBootSlot = newSlot;
+        emit currentBootSlotChanged();
+        DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Current boot slot updated: "), DLT_STRING(m_currentBootSlot.toUtf8().constData()));
+    }
 
     if (m_slotAStatus != newSlotAStatus) {
         m_slotAStatus = newSlotAStatus;
@@ -170,6 +197,96 @@ void RaucSystemManager::updateSlotStatus()
     }
 }
 
+void RaucSystemManager::onRaucPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                                                const QStringList &invalidated)
+{
+    Q_UNUSED(invalidated);
+    if (interface == RaucInstallerInterface) {
+        applyRaucProperties(changed);
+    }
+}
+
+void RaucSystemManager::applyRaucProperties(const QVariantMap &properties)
+{
+    if (properties.contains("Operation")) {
+        m_raucOperation = properties.value("Operation").toString();
+    }
+    if (properties.contains("LastError")) {
+        m_raucLastError = properties.value("LastError").toString();
+    }
+    if (!properties.contains("Progress") || m_installSource == InstallSource::None) {
+        return;
+    }
+
+    // (isi): percentage, message, nesting depth
+    int percentage = 0;
+    int depth = 0;
+    QString message;
+    const QDBusArgument progress = properties.value("Progress").value<QDBusArgument>();
+    progress.beginStructure();
+    progress >> percentage >> message >> depth;
+    progress.endStructure();
+
+    // Completion is reported by the Completed signal, with its result
+    if (percentage < 0 || percentage >= 100) {
+        return;
+    }
+    DLT_LOG_CXX_INFO(QString("RAUC Progress: %1% - %2").arg(percentage).arg(message).toUtf8().constData());
+    if (m_installSource == InstallSource::Hawkbit) {
+        emit updateProgress(percentage, QString("RAUC Hawkbit: %1").arg(message));
+    } else {
+        emit updateProgress(percentage, QString("RAUC: %1").arg(message));
+    }
+}
+
+void RaucSystemManager::onRaucCompleted(int result)
+{
+    const InstallSource source = m_installSource;
+    m_installSource = InstallSource::None;
+
+    QString finishMsg = QString("RAUC installation finished with result: %1").arg(result);
+    DLT_LOG_CXX_INFO(finishMsg.toUtf8().constData());
+    qDebug() << "RAUC installation finished with result:" << result;
+
+    if (result == 0) {
+        DLT_LOG_CXX_INFO("RAUC installation completed successfully");
+        if (source == InstallSource::Hawkbit) {
+            emit updateProgress(100, "RAUC installation completed via Hawkbit!");
+        } else if (source == InstallSource::Local) {
+            emit updateProgress(100, "Installation completed successfully");
+        }
+    } else {
+        DLT_LOG_CXX_ERROR(QString("RAUC installation error: %1").arg(m_raucLastError).toUtf8().constData());
+        if (source == InstallSource::Hawkbit) {
+            emit updateProgress(0, QString("RAUC error: %1").arg(m_raucLastError));
+        } else if (source == InstallSource::Local) {
+            emit updateProgress(100, "Installation failed");
+        }
+    }
+    if (source != InstallSource::None) {
+        emit updateCompleted(result == 0);
+    }
+
+    setUpdateInProgress(false);
+    refreshStatus();
+}
+
+void RaucSystemManager::updateBootOrder()
+{
+    grubenv_t env;
+    char order[GRUBENV_MAX_SIZE];
+    QString newOrder = "Unknown";
+    if (grubenv_load(&env, GRUB_CONFIG_PATH.toLocal8Bit().constData()) == 0 &&
+        grubenv_get(&env, "ORDER", order, sizeof(order)) >= 0) {
+        newOrder = QString::fromUtf8(order);
+    }
+
+    if (m_bootOrder != newOrder) {
+        m_bootOrder = newOrder;
+        emit bootOrderChanged();
+    }
+}
+
 void RaucSystemManager::bootToSlotA()
 {
     qDebug() << "Booting to Slot A...";
@@ -244,35 +361,38 @@ void RaucSystemManager::installRaucBundle()
     }
 
     setUpdateInProgress(true);
+    m_installSource = InstallSource::Local;
     DLT_LOG_CXX_INFO("Update progress: Starting RAUC installation...");
     emit updateProgress(10, "Starting RAUC installation...");
 
-    // Create new process for RAUC installation
-    if (m_raucProcess) {
-        m_raucProcess->deleteLater();
-    }
-
-    m_raucProcess = new QProcess(this);
-    connect(m_raucProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-            this, &RaucSystemManager::onRaucProcessFinished);
-    connect(m_raucProcess, &QProcess::errorOccurred,
-            this, &RaucSystemManager::onRaucProcessError);
-
-    // Start RAUC install command
-    QString cmdMsg = QString("Executing: rauc install %1").arg(RAUC_BUNDLE_PATH);
+    // Progress and the result arrive as PropertiesChanged and Completed
+    QString cmdMsg = QString("Calling InstallBundle %1").arg(RAUC_BUNDLE_PATH);
     DLT_LOG_CXX_INFO(cmdMsg.toUtf8().constData());
 
-    m_raucProcess->start("rauc", QStringList() << "install" << RAUC_BUNDLE_PATH);
+    QDBusMessage call = QDBusMessage::createMethodCall(RaucService, RaucPath, RaucInstallerInterface,
+                                                       "InstallBundle");
+    call << RAUC_BUNDLE_PATH << QVariantMap();
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &RaucSystemManager::onInstallReply);
+}
 
-    if (!m_raucProcess->waitForStarted()) {
-        DLT_LOG_CXX_ERROR("Failed to start RAUC installation process");
-        qDebug() << "Failed to start RAUC installation process";
-        setUpdateInProgress(false);
-        emit updateCompleted(false);
-    } else {
-        DLT_LOG_CXX_INFO("RAUC installation process started successfully");
+void RaucSystemManager::onInstallReply(QDBusPendingCallWatcher *watcher)
+{
+    watcher->deleteLater();
+    const QDBusMessage reply = watcher->reply();
+    if (reply.type() == QDBusMessage::ReplyMessage) {
+        DLT_LOG_CXX_INFO("RAUC installation started successfully");
         emit updateProgress(25, "RAUC installation started...");
+        return;
     }
+
+    // Refused before it started (already installing, service missing, ...)
+    DLT_LOG_CXX_ERROR(QString("Failed to start RAUC installation: %1").arg(reply.errorMessage()).toUtf8().constData());
+    qDebug() << "Failed to start RAUC installation:" << reply.errorMessage();
+    m_installSource = InstallSource::None;
+    setUpdateInProgress(false);
+    emit updateProgress(100, "Installation failed");
+    emit updateCompleted(false);
 }
 
 void RaucSystemManager::startSoftwareUpdate()
@@ -309,79 +429,21 @@ void RaucSystemManager::rebootSystem()
     QProcess::startDetached("reboot", QStringList());
 }
 
-void RaucSystemManager::onRaucProcessFinished(int exitCode, QProcess::ExitStatus exitStatus)
-{
-    QString finishMsg = QString("RAUC installation finished with exit code: %1").arg(exitCode);
-    DLT_LOG_CXX_INFO(finishMsg.toUtf8().constData());
-    qDebug() << "RAUC installation finished with exit code:" << exitCode;
-
-    if (exitCode == 0 && exitStatus == QProcess::NormalExit) {
-        DLT_LOG_CXX_INFO("RAUC installation completed successfully");
-        qDebug() << "RAUC installation successful";
-        emit updateProgress(100, "Installation completed successfully");
-        emit updateCompleted(true);
-
-        // Refresh status after successful installation
-        refreshStatus();
-    } else {
-        DLT_LOG_CXX_ERROR("RAUC installation failed");
-        qDebug() << "RAUC installation failed";
-        emit updateProgress(100, "Installation failed");
-        emit updateCompleted(false);
-    }
-
-    setUpdateInProgress(false);
-
-    if (m_raucProcess) {
-        m_raucProcess->deleteLater();
-        m_raucProcess = nullptr;
-    }
-}
-
-void RaucSystemManager::onRaucProcessError(QProcess::ProcessError error)
-{
-    QString errorMsg = QString("RAUC process error: %1").arg(error);
-    DLT_LOG_CXX_ERROR(errorMsg.toUtf8().constData());
-    qDebug() << "RAUC process error:" << error;
-
-    emit updateProgress(100, "Process error occurred");
-    emit updateCompleted(false);
-    setUpdateInProgress(false);
-
-    if (m_raucProcess) {
-        m_raucProcess->deleteLater();
-        m_raucProcess = nullptr;
-    }
-}
-
 void RaucSystemManager::executeGrubScript(const QString &script)
 {
     QStringList parts = script.split('=');
     if (parts.size() == 2) {
-        QProcess process;
-        process.start("grub-editenv", QStringList() << GRUB_CONFIG_PATH << "set" << script);
-        process.waitForFinished();
-
-        if (process.exitCode() != 0) {
-            qDebug() << "Failed to execute GRUB script:" << script << process.errorString();
+        // Written to a temporary file and renamed over the block, so a
+        // power cut never leaves a half-written grubenv
+        const QByteArray assignment = script.toUtf8();
+        const char *assignments[] = { assignment.constData() };
+        const int ret = grubenv_update(GRUB_CONFIG_PATH.toLocal8Bit().constData(), assignments, 1);
+        if (ret < 0) {
+            qDebug() << "Failed to execute GRUB script:" << script << strerror(-ret);
         }
     }
 }
 
-QString RaucSystemManager::executeRaucCommand(const QStringList &arguments)
-{
-    QProcess process;
-    process.start("rauc", arguments);
-    process.waitForFinished();
-
-    if (process.exitCode() == 0) {
-        return process.readAllStandardOutput();
-    } else {
-        qDebug() << "RAUC command failed:" << arguments << process.errorString();
-        return QString();
-    }
-}
-
 void RaucSystemManager::setUpdateInProgress(bool inProgress)
 {
     if (m_updateInProgress != inProgress) {
@@ -461,100 +523,16 @@ void RaucSystemManager::monitorRaucDBus()
     DLT_LOG_CXX_INFO("Starting RAUC D-Bus monitoring for Hawkbit updates");
     qDebug() << "Starting RAUC D-Bus monitoring for Hawkbit updates";
 
-    // Start monitoring timer (every 2 seconds)
-    m_dbusMonitorTimer->start(2000);
+    // The signals are always subscribed; from now on their progress is
+    // reported as a Hawkbit installation until Completed arrives
+    if (m_installSource == InstallSource::None) {
+        m_installSource = InstallSource::Hawkbit;
+    }
+    requestRaucProperties();
 }
 
 bool RaucSystemManager::isRaucInstallationRunning()
 {
-    // Check if RAUC is currently installing by querying D-Bus
-    QProcess process;
-    process.start("gdbus", QStringList()
-        << "call" << "--system"
-        << "--dest" << "de.pengutronix.rauc"
-        << "--object-path" << "/de/pengutronix/rauc/Installer"
-        << "--method" << "org.freedesktop.DBus.Properties.Get"
-        << "de.pengutronix.rauc.Installer" << "Operation");
-    process.waitForFinished(3000);
-
-    QString output = process.readAllStandardOutput().trimmed();
-    qDebug() << "RAUC Operation status:" << output;
-
-    // If RAUC is installing, output will contain 'installing' or 'active'
-    return output.contains("installing", Qt::CaseInsensitive) ||
-           output.contains("active", Qt::CaseInsensitive);
-}
-
-void RaucSystemManager::checkRaucDBusProgress()
-{
-    if (!isRaucInstallationRunning()) {
-        // No installation running, stop monitoring
-        m_dbusMonitorTimer->stop();
-        return;
-    }
-
-    // Get RAUC installation progress via D-Bus
-    QProcess progressProcess;
-    progressProcess.start("gdbus", QStringList()
-        << "call" << "--system"
-        << "--dest" << "de.pengutronix.rauc"
-        << "--object-path" << "/de/pengutronix/rauc/Installer"
-        << "--method" << "org.freedesktop.DBus.Properties.Get"
-        << "de.pengutronix.rauc.Installer" << "Progress");
-    progressProcess.waitForFinished(3000);
-
-    QString progressOutput = progressProcess.readAllStandardOutput().trimmed();
-
-    // Get RAUC last error (if any)
-    QProcess errorProcess;
-    errorProcess.start("gdbus", QStringList()
-        << "call" << "--system"
-        << "--dest" << "de.pengutronix.rauc"
-        << "--object-path" << "/de/pengutronix/rauc/Installer"
-        << "--method" << "org.freedesktop.DBus.Properties.Get"
-        << "de.pengutronix.rauc.Installer" << "LastError");
-    errorProcess.waitForFinished(3000);
-
-    QString errorOutput = errorProcess.readAllStandardOutput().trimmed();
-
-    qDebug() << "RAUC Progress:" << progressOutput;
-    qDebug() << "RAUC LastError:" << errorOutput;
-
-    // Parse progress and emit signals
-    if (progressOutput.contains("(")) {
-        // Extract percentage from D-Bus output format: "(<int32 percentage>, '<string message>')"
-        QString cleaned = progressOutput;
-        cleaned = cleaned.remove(QRegExp("[()']")).split(',').first();
-
-        bool ok;
-        int percentage = cleaned.toInt(&ok);
-
-        if (ok && percentage >= 0) {
-            QString message = "RAUC installation in progress via Hawkbit...";
-
-            // Extract message if available
-            if (progressOutput.contains("'") && progressOutput.split("'").size() > 1) {
-                message = progressOutput.split("'").at(1);
-            }
-
-            if (percentage < 100) {
-                DLT_LOG_CXX_INFO(QString("RAUC Progress: %1% - %2").arg(percentage).arg(message).toUtf8().constData());
-                emit updateProgress(percentage, QString("RAUC Hawkbit: %1").arg(message));
-            } else {
-                // Installation completed
-                DLT_LOG_CXX_INFO("RAUC installation completed via Hawkbit");
-                emit updateProgress(100, "RAUC installation completed via Hawkbit!");
-                emit updateCompleted(true);
-                m_dbusMonitorTimer->stop();
-            }
-        }
-    }
-
-    // Check for errors
-    if (!errorOutput.isEmpty() && !errorOutput.contains("''") && !errorOutput.contains("()")) {
-        DLT_LOG_CXX_ERROR(QString("RAUC installation error: %1").arg(errorOutput).toUtf8().constData());
-        emit updateProgress(0, QString("RAUC error: %1").arg(errorOutput));
-        emit updateCompleted(false);
-        m_dbusMonitorTimer->stop();
-    }
+    // Kept current by PropertiesChanged
+    return m_raucOperation == "installing";
 }
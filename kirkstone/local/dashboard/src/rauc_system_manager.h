@@ -3,10 +3,14 @@
 
 #include <QObject>
 #include <QString>
-#include <QProcess>
+#include <QStringList>
 #include <QTimer>
+#include <QVariantMap>
+#include <QDBusConnection>
 #include <dlt/dlt.h>
 
+class QDBusPendingCallWatcher;
+
 class RaucSystemManager : public QObject
 {
     Q_OBJECT
@@ -70,19 +74,28 @@ signals:
     void bundleModifiedChanged();
 
 private slots:
-    void onRaucProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
-    void onRaucProcessError(QProcess::ProcessError error);
+    // de.pengutronix.rauc.Installer, all asynchronous
+    void onRaucPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                                 const QStringList &invalidated);
+    void onRaucCompleted(int result);
+    void onRaucPropertiesReply(QDBusPendingCallWatcher *watcher);
+    void onSlotStatusReply(QDBusPendingCallWatcher *watcher);
+    void onInstallReply(QDBusPendingCallWatcher *watcher);
 
 private:
-    void updateCurrentBootSlot();
+    // Who asked for the running installation, which decides how its
+    // progress is reported
+    enum class InstallSource { None, Local, Hawkbit };
+
+    void subscribeRauc();
+    void requestRaucProperties();
+    void requestSlotStatus();
+    void applyRaucProperties(const QVariantMap &properties);
     void updateBootOrder();
-    void updateSlotStatus();
     void updateBundleInfo();
     void executeGrubScript(const QString &script);
-    QString executeRaucCommand(const QStringList &arguments);
     void setUpdateInProgress(bool inProgress);
     QString formatBytes(qint64 bytes);
-    void checkRaucDBusProgress();
 
     // Member variables
     QString m_currentBootSlot;
@@ -98,10 +111,13 @@ private:
     QString m_bundleSizeFormatted;
     QString m_bundleModified;
 
-    // Process management
-    QProcess *m_raucProcess;
+    // RAUC D-Bus client
+    QDBusConnection m_bus;
     QTimer *m_statusTimer;
-    QTimer *m_dbusMonitorTimer;
+    bool m_slotStatusPending;
+    InstallSource m_installSource;
+    QString m_raucOperation;
+    QString m_raucLastError;
 
     // Constants
     static const QString RAUC_BUNDLE_PATH;
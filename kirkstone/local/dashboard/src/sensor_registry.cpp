@@ -0,0 +1,209 @@
+#include "sensor_registry.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+// hwmon drivers whose temp1 is the CPU package
+const char *const CpuHwmonDrivers[] = { "coretemp", "k10temp", "zenpower", "cpu_thermal" };
+
+enum Rank {
+    RankCpuPackage,
+    RankCpuOther,
+    RankPackageZone,      // thermal zone of type x86_pkg_temp
+    RankFirstZone,        // thermal_zone0, the previous fallback
+    RankOtherHwmon,
+    RankOtherZone,
+};
+
+bool isThermalZone(int rank)
+{
+    return rank == RankPackageZone || rank == RankFirstZone || rank == RankOtherZone;
+}
+
+// Directory entries starting with prefix, in natural order (hwmon2 before hwmon10)
+std::vector<std::string> listEntries(const std::string &dir, const char *prefix)
+{
+    std::vector<std::string> names;
+    DIR *handle = opendir(dir.c_str());
+    if (!handle) return names;
+    const size_t prefixLength = strlen(prefix);
+    while (const dirent *entry = readdir(handle)) {
+        if (strncmp(entry->d_name, prefix, prefixLength) == 0) {
+            names.emplace_back(entry->d_name);
+        }
+    }
+    closedir(handle);
+    std::sort(names.begin(), names.end(), [](const std::string &a, const std::string &b) {
+        return a.size() != b.size() ? a.size() < b.size() : a < b;
+    });
+    return names;
+}
+
+// First line of a small sysfs attribute, empty if it cannot be read
+std::string readAttribute(const std::string &path, char *buffer, size_t size)
+{
+    proc::ProcFile file;
+    const long length = file.open(path.c_str()) ? file.read(buffer, size) : -1;
+    if (length <= 0) return std::string();
+    const char *end = static_cast<const char *>(memchr(buffer, '\n', size_t(length)));
+    return std::string(buffer, end ? size_t(end - buffer) : size_t(length));
+}
+
+bool endsWith(const std::string &text, const char *suffix)
+{
+    const size_t length = strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+} // namespace
+
+SensorRegistry::SensorRegistry(const std::string &sysfsClassDir)
+    : m_classDir(sysfsClassDir)
+    , m_ueventFd(-1)
+    , m_rescanPending(true)
+{
+}
+
+SensorRegistry::~SensorRegistry()
+{
+    if (m_ueventFd >= 0) {
+        ::close(m_ueventFd);
+    }
+}
+
+bool SensorRegistry::watchUevents()
+{
+    // The kernel uevent multicast group udev itself listens to; polled once
+    // per tick, so no extra thread or notifier is needed
+    m_ueventFd = ::socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_KOBJECT_UEVENT);
+    if (m_ueventFd < 0) return false;
+
+    sockaddr_nl address = {};
+    address.nl_family = AF_NETLINK;
+    address.nl_groups = 1;
+    if (::bind(m_ueventFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        ::close(m_ueventFd);
+        m_ueventFd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool SensorRegistry::drainUevents()
+{
+    // "add@/devices/.../hwmon/hwmon3\0ACTION=add\0...\0SUBSYSTEM=hwmon\0...";
+    // the keys are matched with their terminating NUL
+    bool relevant = false;
+    char message[4096];
+    ssize_t length;
+    while ((length = ::recv(m_ueventFd, message, sizeof(message), 0)) > 0 || (length < 0 && errno == EINTR)) {
+        if (length <= 0) continue;
+        const bool addOrRemove = strncmp(message, "add@", 4) == 0 || strncmp(message, "remove@", 7) == 0;
+        if (addOrRemove && (memmem(message, size_t(length), "SUBSYSTEM=hwmon", 16) ||
+                            memmem(message, size_t(length), "SUBSYSTEM=thermal", 18))) {
+            relevant = true;
+        }
+    }
+    return relevant;
+}
+
+bool SensorRegistry::rescanIfChanged()
+{
+    if (m_ueventFd >= 0 && drainUevents()) {
+        m_rescanPending = true;
+    }
+    if (!m_rescanPending) return false;
+    rescan();
+    return true;
+}
+
+size_t SensorRegistry::rescan()
+{
+    m_rescanPending = false;
+    m_sensors.clear();
+    char buffer[256];
+    scanHwmon(buffer, sizeof(buffer));
+    scanThermal(buffer, sizeof(buffer));
+    return m_sensors.size();
+}
+
+void SensorRegistry::scanHwmon(char *buffer, size_t size)
+{
+    const std::string root = m_classDir + "/hwmon";
+    for (const std::string &hwmon : listEntries(root, "hwmon")) {
+        const std::string dir = root + "/" + hwmon;
+        std::string name = readAttribute(dir + "/name", buffer, size);
+        if (name.empty()) name = hwmon;
+        const bool cpu = std::any_of(std::begin(CpuHwmonDrivers), std::end(CpuHwmonDrivers),
+                                     [&name](const char *driver) { return name == driver; });
+
+        for (const std::string &input : listEntries(dir, "temp")) {
+            if (!endsWith(input, "_input")) continue;
+            const std::string channel = input.substr(0, input.size() - strlen("_input"));   // "temp1"
+            std::string label = readAttribute(dir + "/" + channel + "_label", buffer, size);
+            if (label.empty()) label = channel;
+            const int rank = !cpu ? RankOtherHwmon : channel == "temp1" ? RankCpuPackage : RankCpuOther;
+            addSensor(dir + "/" + input, name + " " + label, rank, buffer, size);
+        }
+    }
+}
+
+void SensorRegistry::scanThermal(char *buffer, size_t size)
+{
+    const std::string root = m_classDir + "/thermal";
+    for (const std::string &zone : listEntries(root, "thermal_zone")) {
+        const std::string dir = root + "/" + zone;
+        const std::string type = readAttribute(dir + "/type", buffer, size);
+        const int rank = type == "x86_pkg_temp" ? RankPackageZone
+                         : zone == "thermal_zone0" ? RankFirstZone
+                                                   : RankOtherZone;
+        addSensor(dir + "/temp", type.empty() ? zone : zone + " " + type, rank, buffer, size);
+    }
+}
+
+void SensorRegistry::addSensor(const std::string &path, const std::string &label, int rank, char *buffer,
+                               size_t size)
+{
+    std::unique_ptr<Sensor> sensor(new Sensor);
+    if (!sensor->input.open(path.c_str())) return;
+    sensor->path = path;
+    sensor->label = label;
+    sensor->rank = rank;
+    const long length = sensor->input.read(buffer, size);
+    sensor->valid = length > 0 && proc::parseValue(buffer, size_t(length), sensor->millidegrees);
+    m_sensors.push_back(std::move(sensor));
+}
+
+bool SensorRegistry::read(char *buffer, size_t size)
+{
+    bool ok = true;
+    for (const std::unique_ptr<Sensor> &sensor : m_sensors) {
+        const long length = sensor->input.read(buffer, size);
+        sensor->valid = length > 0 && proc::parseValue(buffer, size_t(length), sensor->millidegrees);
+        // Some drivers return EAGAIN/ENODATA while a reading is not ready;
+        // only a vanished device (ENODEV) means the set has changed
+        if (length < 0 && errno == ENODEV) ok = false;
+    }
+    if (!ok) m_rescanPending = true;
+    return ok;
+}
+
+const SensorRegistry::Sensor *SensorRegistry::primary() const
+{
+    const Sensor *best = nullptr;
+    for (const std::unique_ptr<Sensor> &sensor : m_sensors) {
+        // hwmon inputs report millidegrees; anything at or below 1 degree is
+        // a disconnected channel rather than a real reading
+        const bool plausible = sensor->valid && (isThermalZone(sensor->rank) || sensor->millidegrees > 1000);
+        if (plausible && (!best || sensor->rank < best->rank)) {
+            best = sensor.get();
+        }
+    }
+    return best;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include "proc_parser.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Temperature inputs under /sys/class/hwmon and /sys/class/thermal. They are
+// discovered once, kept open and re-read with pread() each tick. Discovery
+// runs again only when the kernel reports a hwmon or thermal device being
+// added or removed (uevent), or when an open input stops reading.
+class SensorRegistry {
+public:
+    struct Sensor {
+        std::string label;          // e.g. "coretemp Package id 0", "thermal_zone0 x86_pkg_temp"
+        std::string path;
+        proc::ProcFile input;
+        int rank = 0;               // preference as the dashboard's single temperature
+        bool valid = false;
+        int64_t millidegrees = 0;
+    };
+
+    explicit SensorRegistry(const std::string &sysfsClassDir = "/sys/class");
+    ~SensorRegistry();
+    SensorRegistry(const SensorRegistry &) = delete;
+    SensorRegistry &operator=(const SensorRegistry &) = delete;
+
+    // Starts listening for uevents; without it, rescans only follow read failures
+    bool watchUevents();
+
+    // Rediscovers the inputs if a uevent asked for it; returns true if it did
+    bool rescanIfChanged();
+    // Discovers all inputs; returns how many were found
+    size_t rescan();
+
+    // Reads every sensor into millidegrees/valid using buffer as scratch.
+    // Returns false if an input failed, which schedules a rescan.
+    bool read(char *buffer, size_t size);
+
+    const std::vector<std::unique_ptr<Sensor>> &sensors() const { return m_sensors; }
+    // The sensor reported as "the" temperature, nullptr if there is none
+    const Sensor *primary() const;
+
+private:
+    void scanHwmon(char *buffer, size_t size);
+    void scanThermal(char *buffer, size_t size);
+    void addSensor(const std::string &path, const std::string &label, int rank, char *buffer, size_t size);
+    bool drainUevents();
+
+    std::string m_classDir;
+    std::vector<std::unique_ptr<Sensor>> m_sensors;
+    int m_ueventFd;
+    bool m_rescanPending;
+};
@@ -0,0 +1,110 @@
+#include "sparkline.h"
+#include <QSGGeometryNode>
+#include <QSGFlatColorMaterial>
+#include <algorithm>
+
+Sparkline::Sparkline(QQuickItem *parent)
+    : QQuickItem(parent)
+    , m_series(MetricHistory::Cpu)
+    , m_windowSeconds(600)
+    , m_minimum(0.0)
+    , m_maximum(100.0)
+    , m_color(QColor("#44ff44"))
+    , m_lineWidth(1.5)
+{
+    setFlag(ItemHasContents, true);
+    m_buckets.reserve(MaxBuckets);
+}
+
+template <typename T>
+void Sparkline::assign(T &member, const T &value)
+{
+    if (member == value) return;
+    member = value;
+    emit sparklineChanged();
+    update();
+}
+
+void Sparkline::setHistory(MetricHistory *history)
+{
+    if (m_history == history) return;
+    disconnect(m_historyConnection);
+    m_history = history;
+    if (history) {
+        m_historyConnection = connect(history, &MetricHistory::updated, this, &QQuickItem::update);
+    }
+    emit sparklineChanged();
+    update();
+}
+
+void Sparkline::setSeries(MetricHistory::Series series) { assign(m_series, series); }
+void Sparkline::setWindowSeconds(int seconds) { assign(m_windowSeconds, qMax(1, seconds)); }
+void Sparkline::setMinimum(qreal minimum) { assign(m_minimum, minimum); }
+void Sparkline::setMaximum(qreal maximum) { assign(m_maximum, maximum); }
+void Sparkline::setColor(const QColor &color) { assign(m_color, color); }
+void Sparkline::setLineWidth(qreal width) { assign(m_lineWidth, width); }
+
+void Sparkline::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        update();
+    }
+}
+
+QSGNode *Sparkline::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    auto *node = static_cast<QSGGeometryNode *>(oldNode);
+    if (!node) {
+        node = new QSGGeometryNode;
+        auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawLineStrip);
+        node->setGeometry(geometry);
+        node->setFlag(QSGNode::OwnsGeometry);
+        node->setMaterial(new QSGFlatColorMaterial);
+        node->setFlag(QSGNode::OwnsMaterial);
+    }
+
+    auto *material = static_cast<QSGFlatColorMaterial *>(node->material());
+    if (material->color() != m_color) {
+        material->setColor(m_color);
+        node->markDirty(QSGNode::DirtyMaterial);
+    }
+
+    // One bucket per two pixels, each drawn as its max then its min
+    const int bucketCount = qBound(1, int(width() / 2), MaxBuckets);
+    m_buckets.resize(size_t(bucketCount));
+    const size_t used = m_history
+        ? m_history->ring().downsample(metrics::Series(m_series), qint64(m_windowSeconds) * 1000,
+                                       m_buckets.data(), m_buckets.size())
+        : 0;
+
+    int vertexCount = 0;
+    if (used > 0) {
+        for (const metrics::Bucket &bucket : m_buckets) {
+            if (bucket.count > 0) vertexCount += 2;
+        }
+    }
+
+    QSGGeometry *geometry = node->geometry();
+    geometry->allocate(vertexCount);
+    geometry->setLineWidth(float(m_lineWidth));
+
+    const qreal range = m_maximum > m_minimum ? m_maximum - m_minimum : 1.0;
+    const qreal h = height();
+    const qreal step = width() / bucketCount;
+    auto toY = [&](float value) {
+        return float(h - std::clamp((value - m_minimum) / range, 0.0, 1.0) * h);
+    };
+
+    QSGGeometry::Point2D *vertex = geometry->vertexDataAsPoint2D();
+    for (int i = 0; vertexCount > 0 && i < bucketCount; ++i) {
+        const metrics::Bucket &bucket = m_buckets[size_t(i)];
+        if (bucket.count == 0) continue;
+        const float x = float((i + 0.5) * step);
+        (vertex++)->set(x, toY(bucket.max));
+        (vertex++)->set(x, toY(bucket.min));
+    }
+    node->markDirty(QSGNode::DirtyGeometry);
+    return node;
+}
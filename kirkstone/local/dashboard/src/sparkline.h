@@ -0,0 +1,64 @@
+#pragma once
+#include <QQuickItem>
+#include <QColor>
+#include <QPointer>
+#include <vector>
+#include "metric_history.h"
+
+// Line chart of one MetricHistory series over the last windowSeconds,
+// newest sample at the right edge. The samples are reduced to one min/max
+// bucket per two pixels and drawn as a single line-strip geometry node, so
+// a repaint is one ring read on the render thread and no Canvas painting.
+class Sparkline : public QQuickItem {
+    Q_OBJECT
+    Q_PROPERTY(MetricHistory *history READ history WRITE setHistory NOTIFY sparklineChanged)
+    Q_PROPERTY(MetricHistory::Series series READ series WRITE setSeries NOTIFY sparklineChanged)
+    Q_PROPERTY(int windowSeconds READ windowSeconds WRITE setWindowSeconds NOTIFY sparklineChanged)
+    Q_PROPERTY(qreal minimum READ minimum WRITE setMinimum NOTIFY sparklineChanged)
+    Q_PROPERTY(qreal maximum READ maximum WRITE setMaximum NOTIFY sparklineChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY sparklineChanged)
+    Q_PROPERTY(qreal lineWidth READ lineWidth WRITE setLineWidth NOTIFY sparklineChanged)
+public:
+    explicit Sparkline(QQuickItem *parent = nullptr);
+
+    MetricHistory *history() const { return m_history; }
+    MetricHistory::Series series() const { return m_series; }
+    int windowSeconds() const { return m_windowSeconds; }
+    qreal minimum() const { return m_minimum; }
+    qreal maximum() const { return m_maximum; }
+    QColor color() const { return m_color; }
+    qreal lineWidth() const { return m_lineWidth; }
+
+    void setHistory(MetricHistory *history);
+    void setSeries(MetricHistory::Series series);
+    void setWindowSeconds(int seconds);
+    void setMinimum(qreal minimum);
+    void setMaximum(qreal maximum);
+    void setColor(const QColor &color);
+    void setLineWidth(qreal width);
+
+    static constexpr int MaxBuckets = 512;
+
+signals:
+    void sparklineChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *) override;
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private:
+    template <typename T>
+    void assign(T &member, const T &value);
+
+    QPointer<MetricHistory> m_history;
+    QMetaObject::Connection m_historyConnection;
+    MetricHistory::Series m_series;
+    int m_windowSeconds;
+    qreal m_minimum;
+    qreal m_maximum;
+    QColor m_color;
+    qreal m_lineWidth;
+
+    // Scratch for updatePaintNode (render thread, GUI thread blocked)
+    std::vector<metrics::Bucket> m_buckets;
+};
@@ -0,0 +1,55 @@
+#include "startup_trace.h"
+#include <QQuickWindow>
+#include <QDebug>
+
+DltContext StartupTrace::m_ctx;
+
+StartupTrace::StartupTrace(QObject *parent)
+    : QObject(parent)
+    , m_firstFrameShown(false)
+{
+    m_timer.start();
+    m_marks.reserve(8);
+}
+
+void StartupTrace::mark(const char *phase)
+{
+    m_marks.append({ phase, m_timer.nsecsElapsed() / 1000 });
+}
+
+void StartupTrace::watchFirstFrame(QQuickWindow *window)
+{
+    // frameSwapped comes from the render thread with the threaded render
+    // loop, so it is queued back to this (GUI) thread
+    m_frameConnection = connect(window, &QQuickWindow::frameSwapped,
+                                this, &StartupTrace::onFrameSwapped, Qt::QueuedConnection);
+}
+
+void StartupTrace::onFrameSwapped()
+{
+    if (m_firstFrameShown) return;
+    disconnect(m_frameConnection);
+    mark("first frame");
+    m_firstFrameShown = true;
+
+    // Registered here rather than in the constructor, which runs before
+    // DLT_REGISTER_APP
+    static bool dltContextRegistered = false;
+    if (!dltContextRegistered) {
+        DLT_REGISTER_CONTEXT(StartupTrace::m_ctx, "STRT", "Dashboard Startup");
+        dltContextRegistered = true;
+    }
+
+    qint64 previousUs = 0;
+    for (const Mark &entry : qAsConst(m_marks)) {
+        DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Startup phase"), DLT_STRING(entry.phase),
+                DLT_INT64(entry.elapsedUs / 1000), DLT_STRING("ms, +"),
+                DLT_INT64((entry.elapsedUs - previousUs) / 1000), DLT_STRING("ms"));
+        previousUs = entry.elapsedUs;
+    }
+    DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Time to first frame:"),
+            DLT_INT64(previousUs / 1000), DLT_STRING("ms"));
+    qDebug() << "Time to first frame:" << previousUs / 1000 << "ms";
+
+    emit firstFrameShownChanged();
+}
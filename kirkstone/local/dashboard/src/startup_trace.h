@@ -0,0 +1,44 @@
+#pragma once
+#include <QObject>
+#include <QElapsedTimer>
+#include <QVector>
+#include <dlt/dlt.h>
+
+class QQuickWindow;
+
+// Startup phase timestamps, measured from the construction of this object
+// at the top of main(). The summary, including time-to-first-frame, goes to
+// DLT once the window has presented its first frame. QML reads
+// firstFrameShown to create the cards that were left out of that frame.
+class StartupTrace : public QObject {
+    Q_OBJECT
+    Q_PROPERTY(bool firstFrameShown READ firstFrameShown NOTIFY firstFrameShownChanged)
+public:
+    explicit StartupTrace(QObject *parent = nullptr);
+
+    // Records the end of a startup phase
+    void mark(const char *phase);
+    // Reports the trace after the first frame of window
+    void watchFirstFrame(QQuickWindow *window);
+
+    bool firstFrameShown() const { return m_firstFrameShown; }
+
+    static DltContext m_ctx;
+
+signals:
+    void firstFrameShownChanged();
+
+private slots:
+    void onFrameSwapped();
+
+private:
+    struct Mark {
+        const char *phase;
+        qint64 elapsedUs;
+    };
+
+    QElapsedTimer m_timer;
+    QVector<Mark> m_marks;
+    QMetaObject::Connection m_frameConnection;
+    bool m_firstFrameShown;
+};
@@ -1,10 +1,10 @@
 #include "system_info.h"
+#include "systemd_unit_watcher.h"
 #include <QFile>
 #include <QTextStream>
 #include <QStringList>
 #include <QDebug>
 #include <QProcess>
-#include <QStorageInfo>
 #include <QHostInfo>
 #include <QSysInfo>
 #include <QRegExp>
@@ -13,6 +13,10 @@
 // DLT context definition
 DltContext SystemInfo::m_dltCtx;
 
+static const char HawkbitUnit[] = "rauc-hawkbit-cpp.service";
+// Journal entries of the Hawkbit client kept for the log card and diagnostics
+static const int HawkbitLogLines = 200;
+
 // Helper macros for DLT logging
 #define DLT_LOG_SYS_INFO(str) \
     do { \
@@ -51,8 +55,6 @@ SystemInfo::SystemInfo(QObject *parent)
     , m_buildTime("")
     , m_yoctoVersion("")
     , m_rootDevice("")
-    , m_lastCpuTotal(0)
-    , m_lastCpuIdle(0)
 {
     // Register DLT context (once per process)
     static bool dltContextRegistered = false;
@@ -64,235 +66,113 @@ SystemInfo::SystemInfo(QObject *parent)
 
     DLT_LOG_SYS_INFO("SystemInfo manager initialized");
 
-    // Initialize system details that don't change frequently
+    // Initialize system details that don't change frequently. Hostname and
+    // kernel come from syscalls; the file-based ones are read from the
+    // event loop rather than while the QML scene is being created
     updateSystemDetails();
-    updateBuildInfo();
-    updateRootDeviceInfo();
-    updateSoftwareVersion();
-
-    // Setup timers
-    m_updateTimer = new QTimer(this);
-    connect(m_updateTimer, &QTimer::timeout, this, &SystemInfo::updateSystemInfo);
-    m_updateTimer->start(2000); // Update every 2 seconds
+    QTimer::singleShot(0, this, [this]() {
+        updateBuildInfo();
+        updateRootDeviceInfo();
+        updateSoftwareVersion();
+        m_hawkbitLog->start();
+    });
+
+    m_hawkbitUnit = new SystemdUnitWatcher(HawkbitUnit, this);
+    connect(m_hawkbitUnit, &SystemdUnitWatcher::activeStateChanged, this, &SystemInfo::onHawkbitActiveStateChanged);
+    m_hawkbitLog = new JournalLogModel(HawkbitUnit, HawkbitLogLines, this);
+    connect(m_hawkbitLog, &JournalLogModel::messagesAppended, this, &SystemInfo::onHawkbitLogMessages);
 
     m_timeTimer = new QTimer(this);
     connect(m_timeTimer, &QTimer::timeout, this, &SystemInfo::updateTime);
     m_timeTimer->start(1000); // Update time every second
 
-    // Initial update
-    updateSystemInfo();
+    // Metrics sampling runs on its own thread so file reads and interface
+    // enumeration never stall the GUI thread; results arrive as one snapshot
+    qRegisterMetaType<SystemSnapshot>();
+    m_samplerThread = new QThread(this);
+    m_samplerThread->setObjectName("SystemSampler");
+    m_sampler = new SystemSampler;
+    m_history = new MetricHistory(this);
+    m_sampler->setHistory(&m_history->ring());
+    m_sampler->moveToThread(m_samplerThread);
+    connect(m_samplerThread, &QThread::started, m_sampler, &SystemSampler::start);
+    connect(m_samplerThread, &QThread::finished, m_sampler, &QObject::deleteLater);
+    connect(this, &SystemInfo::sampleRequested, m_sampler, &SystemSampler::requestSample);
+    connect(m_sampler, &SystemSampler::snapshotReady, this, &SystemInfo::applySnapshot);
+    m_samplerThread->start();
+
     updateTime();
 }
 
-void SystemInfo::updateSystemInfo()
+SystemInfo::~SystemInfo()
 {
-    updateCpuUsage();
-    updateCpuCoreUsage();
-    updateMemoryInfo();
-    updateTemperature();
-    updateUptime();
-    updateNetworkInfo();
-    updateDiskInfo();
+    m_samplerThread->quit();
+    m_samplerThread->wait();
 }
 
-void SystemInfo::updateTime()
+void SystemInfo::updateSystemInfo()
 {
-    QString newTime = QDateTime::currentDateTime().toString("hh:mm:ss");
-    if (m_currentTime != newTime) {
-        m_currentTime = newTime;
-        emit currentTimeChanged();
-    }
+    emit sampleRequested();
 }
 
-void SystemInfo::updateCpuUsage()
+void SystemInfo::applySnapshot(const SystemSnapshot &snapshot)
 {
-    QString statContent = readFileContent("/proc/stat");
-    if (statContent.isEmpty()) return;
-
-    QStringList lines = statContent.split('\n');
-    if (lines.isEmpty()) return;
-
-    QStringList cpuData = lines[0].split(' ', Qt::SkipEmptyParts);
-    if (cpuData.size() < 8) return;
-
-    qint64 idle = cpuData[4].toLongLong();
-    qint64 total = 0;
-    for (int i = 1; i < cpuData.size(); ++i) {
-        total += cpuData[i].toLongLong();
-    }
-
-    if (m_lastCpuTotal != 0) {
-        qint64 totalDiff = total - m_lastCpuTotal;
-        qint64 idleDiff = idle - m_lastCpuIdle;
-
-        if (totalDiff > 0) {
-            double newCpuUsage = 100.0 * (totalDiff - idleDiff) / totalDiff;
-            if (qAbs(m_cpuUsage - newCpuUsage) > 0.1) {
-                m_cpuUsage = newCpuUsage;
-                emit cpuUsageChanged();
-            }
+    // Store every changed value first, then notify once for the whole tick
+    bool changed = false;
+    auto assign = [&changed](auto &member, const auto &value) {
+        if (member != value) {
+            member = value;
+            changed = true;
         }
-    }
-
-    m_lastCpuTotal = total;
-    m_lastCpuIdle = idle;
-}
-
-void SystemInfo::updateCpuCoreUsage()
-{
-    QString statContent = readFileContent("/proc/stat");
-    if (statContent.isEmpty()) return;
-
-    QStringList lines = statContent.split('\n');
-    QStringList newCpuCoreUsage;
-
-    // Find all CPU core lines (cpu0, cpu1, cpu2, etc.)
-    for (const QString &line : lines) {
-        if (line.startsWith("cpu") && line != lines[0]) { // Skip the first "cpu" line (total)
-            QStringList cpuData = line.split(' ', Qt::SkipEmptyParts);
-            if (cpuData.size() < 8) continue;
-
-            qint64 idle = cpuData[4].toLongLong();
-            qint64 total = 0;
-            for (int i = 1; i < cpuData.size(); ++i) {
-                total += cpuData[i].toLongLong();
-            }
-
-            // Calculate usage percentage
-            double usage = 0.0;
-            if (total > 0) {
-                usage = 100.0 * (total - idle) / total;
-            }
-
-            newCpuCoreUsage.append(QString::number(usage, 'f', 1));
+    };
+    // Percentages and temperature ignore jitter below 0.1
+    auto assignRounded = [&changed](double &member, double value) {
+        if (qAbs(member - value) > 0.1) {
+            member = value;
+            changed = true;
         }
-    }
+    };
 
-    if (m_cpuCoreUsage != newCpuCoreUsage) {
-        m_cpuCoreUsage = newCpuCoreUsage;
-        emit cpuCoreUsageChanged();
+    if (snapshot.hasCpuUsage) {
+        assignRounded(m_cpuUsage, snapshot.cpuUsage);
     }
-}
-
-void SystemInfo::updateMemoryInfo()
-{
-    QString meminfoContent = readFileContent("/proc/meminfo");
-    if (meminfoContent.isEmpty()) return;
+    assign(m_cpuCoreUsage, snapshot.cpuCoreUsage);
 
-    QStringList lines = meminfoContent.split('\n');
-    qint64 memTotal = 0, memFree = 0, memAvailable = 0, buffers = 0, cached = 0;
+    assign(m_totalMemory, snapshot.totalMemory);
+    assign(m_usedMemory, snapshot.usedMemory);
+    assign(m_freeMemory, snapshot.freeMemory);
+    assignRounded(m_memoryUsage, snapshot.memoryUsage);
 
-    for (const QString &line : lines) {
-        QStringList parts = line.split(':', Qt::SkipEmptyParts);
-        if (parts.size() < 2) continue;
-
-        QString key = parts[0].trimmed();
-        QString valueStr = parts[1].trimmed().split(' ')[0];
-        qint64 value = valueStr.toLongLong() * 1024; // Convert from KB to bytes
-
-        if (key == "MemTotal") memTotal = value;
-        else if (key == "MemFree") memFree = value;
-        else if (key == "MemAvailable") memAvailable = value;
-        else if (key == "Buffers") buffers = value;
-        else if (key == "Cached") cached = value;
+    if (snapshot.hasTemperature) {
+        assignRounded(m_temperature, snapshot.temperature);
+    }
+    assign(m_temperatureSensors, snapshot.temperatureSensors);
+    if (!snapshot.uptime.isEmpty()) {
+        assign(m_uptime, snapshot.uptime);
     }
 
-    qint64 newTotalMemory = memTotal;
-    qint64 newUsedMemory = memTotal - memAvailable;
-    qint64 newFreeMemory = memAvailable;
-    double newMemoryUsage = memTotal > 0 ? (100.0 * newUsedMemory / memTotal) : 0.0;
+    assign(m_networkConnected, snapshot.networkConnected);
+    assign(m_networkInterface, snapshot.networkInterface);
+    assign(m_ipAddress, snapshot.ipAddress);
 
-    if (m_totalMemory != newTotalMemory) {
-        m_totalMemory = newTotalMemory;
-        emit totalMemoryChanged();
-    }
-    if (m_usedMemory != newUsedMemory) {
-        m_usedMemory = newUsedMemory;
-        emit usedMemoryChanged();
-    }
-    if (m_freeMemory != newFreeMemory) {
-        m_freeMemory = newFreeMemory;
-        emit freeMemoryChanged();
-    }
-    if (qAbs(m_memoryUsage - newMemoryUsage) > 0.1) {
-        m_memoryUsage = newMemoryUsage;
-        emit memoryUsageChanged();
-    }
-}
+    assign(m_rootPartitionTotal, snapshot.rootPartitionTotal);
+    assign(m_rootPartitionUsed, snapshot.rootPartitionUsed);
+    assign(m_rootPartitionFree, snapshot.rootPartitionFree);
+    assignRounded(m_rootPartitionUsagePercent, snapshot.rootPartitionUsagePercent);
 
-void SystemInfo::updateTemperature()
-{
-    // Try to read from coretemp (Intel CPU) first
-    QString tempContent = readFileContent("/sys/class/hwmon/hwmon1/temp1_input");
-    if (!tempContent.isEmpty()) {
-        bool ok;
-        double temp = tempContent.trimmed().toDouble(&ok);
-        if (ok && temp > 1000) { // Ensure it's a reasonable temperature value
-            double newTemperature = temp / 1000.0; // Convert from millidegrees to degrees
-            if (qAbs(m_temperature - newTemperature) > 0.1) {
-                m_temperature = newTemperature;
-                emit temperatureChanged();
-            }
-            return;
-        }
-    }
-    // Fallback: try thermal_zone0
-    tempContent = readFileContent("/sys/class/thermal/thermal_zone0/temp");
-    if (!tempContent.isEmpty()) {
-        bool ok;
-        double temp = tempContent.trimmed().toDouble(&ok);
-        if (ok) {
-            double newTemperature = temp / 1000.0;
-            if (qAbs(m_temperature - newTemperature) > 0.1) {
-                m_temperature = newTemperature;
-                emit temperatureChanged();
-            }
-            return;
-        }
-    }
-    // Fallback: try hwmon scan (as before)
-    QProcess process;
-    process.start("find", QStringList() << "/sys/class/hwmon" << "-name" << "temp*_input");
-    process.waitForFinished(1000);
-    QStringList tempFiles = QString::fromUtf8(process.readAllStandardOutput()).split('\n', Qt::SkipEmptyParts);
-    for (const QString &tempFile : tempFiles) {
-        QString content = readFileContent(tempFile);
-        if (!content.isEmpty()) {
-            bool ok;
-            double temp = content.trimmed().toDouble(&ok);
-            if (ok && temp > 1000) {
-                double newTemperature = temp / 1000.0;
-                if (qAbs(m_temperature - newTemperature) > 0.1) {
-                    m_temperature = newTemperature;
-                    emit temperatureChanged();
-                }
-                return;
-            }
-        }
+    if (changed) {
+        emit snapshotChanged();
     }
+    // The sampler pushed this tick to the history before publishing it
+    m_history->notifyUpdated();
 }
 
-void SystemInfo::updateUptime()
+void SystemInfo::updateTime()
 {
-    QString uptimeContent = readFileContent("/proc/uptime");
-    if (uptimeContent.isEmpty()) return;
-
-    QStringList parts = uptimeContent.split(' ');
-    if (parts.isEmpty()) return;
-
-    bool ok;
-    double uptimeSeconds = parts[0].toDouble(&ok);
-    if (!ok) return;
-
-    int days = uptimeSeconds / 86400;
-    int hours = (int(uptimeSeconds) % 86400) / 3600;
-    int minutes = (int(uptimeSeconds) % 3600) / 60;
-    int seconds = int(uptimeSeconds) % 60;
-
-    QString newUptime = QString("%1d %2h %3m %4s").arg(days).arg(hours).arg(minutes).arg(seconds);
-    if (m_uptime != newUptime) {
-        m_uptime = newUptime;
-        emit uptimeChanged();
+    QString newTime = QDateTime::currentDateTime().toString("hh:mm:ss");
+    if (m_currentTime != newTime) {
+        m_currentTime = newTime;
+        emit currentTimeChanged();
     }
 }
 
@@ -316,72 +196,6 @@ void SystemInfo::updateSystemDetails()
     }
 }
 
-void SystemInfo::updateNetworkInfo()
-{
-    bool connected = false;
-    QString interface;
-    QString ipAddr;
-
-    QList<QNetworkInterface> interfaces = QNetworkInterface::allInterfaces();
-    for (const QNetworkInterface &iface : interfaces) {
-        if (iface.flags().testFlag(QNetworkInterface::IsUp) &&
-            iface.flags().testFlag(QNetworkInterface::IsRunning) &&
-            !iface.flags().testFlag(QNetworkInterface::IsLoopBack)) {
-
-            QList<QNetworkAddressEntry> entries = iface.addressEntries();
-            for (const QNetworkAddressEntry &entry : entries) {
-                if (entry.ip().protocol() == QAbstractSocket::IPv4Protocol) {
-                    connected = true;
-                    interface = iface.name();
-                    ipAddr = entry.ip().toString();
-                    break;
-                }
-            }
-            if (connected) break;
-        }
-    }
-
-    if (m_networkConnected != connected) {
-        m_networkConnected = connected;
-        emit networkConnectedChanged();
-    }
-    if (m_networkInterface != interface) {
-        m_networkInterface = interface;
-        emit networkInterfaceChanged();
-    }
-    if (m_ipAddress != ipAddr) {
-        m_ipAddress = ipAddr;
-        emit ipAddressChanged();
-    }
-}
-
-void SystemInfo::updateDiskInfo()
-{
-    QStorageInfo storage("/");
-
-    qint64 newTotal = storage.bytesTotal();
-    qint64 newFree = storage.bytesAvailable();
-    qint64 newUsed = newTotal - newFree;
-    double newUsagePercent = newTotal > 0 ? (100.0 * newUsed / newTotal) : 0.0;
-
-    if (m_rootPartitionTotal != newTotal) {
-        m_rootPartitionTotal = newTotal;
-        emit rootPartitionTotalChanged();
-    }
-    if (m_rootPartitionUsed != newUsed) {
-        m_rootPartitionUsed = newUsed;
-        emit rootPartitionUsedChanged();
-    }
-    if (m_rootPartitionFree != newFree) {
-        m_rootPartitionFree = newFree;
-        emit rootPartitionFreeChanged();
-    }
-    if (qAbs(m_rootPartitionUsagePercent - newUsagePercent) > 0.1) {
-        m_rootPartitionUsagePercent = newUsagePercent;
-        emit rootPartitionUsagePercentChanged();
-    }
-}
-
 QString SystemInfo::readFileContent(const QString &filePath)
 {
     QFile file(filePath);
@@ -479,7 +293,8 @@ QString SystemInfo::formatBytes(qint64 bytes)
 }
 
 void SystemInfo::refresh() {
-    updateSystemInfo();
+    // Cards call this every second; the sampler coalesces back-to-back requests
+    emit sampleRequested();
 }
 
 void SystemInfo::exitApplication() {
@@ -540,18 +355,15 @@ void SystemInfo::startHawkbitUpdater() {
 }
 
 bool SystemInfo::checkHawkbitServiceStatus() {
-    QProcess process;
-    process.start("systemctl", QStringList() << "is-active" << "rauc-hawkbit-cpp.service");
-    process.waitForFinished(3000);
-
-    QString status = process.readAllStandardOutput().trimmed();
-    bool isActive = (status == "active");
+    // Kept current by systemd's PropertiesChanged; no systemctl call
+    return m_hawkbitUnit->isActive();
+}
 
-    DLT_LOG_SYS_INFO(QString("Hawkbit service status check: %1 (active=%2)").arg(status).arg(isActive).toUtf8().constData());
-    qDebug() << "Hawkbit service status:" << status << "Active:" << isActive;
+void SystemInfo::onHawkbitActiveStateChanged() {
+    const bool isActive = m_hawkbitUnit->isActive();
+    DLT_LOG_SYS_INFO(QString("Hawkbit service state: %1 (active=%2)").arg(m_hawkbitUnit->activeState()).arg(isActive).toUtf8().constData());
+    qDebug() << "Hawkbit service state:" << m_hawkbitUnit->activeState() << "Active:" << isActive;
     emit hawkbitServiceStatusChanged(isActive);
-
-    return isActive;
 }
 
 void SystemInfo::stopHawkbitUpdater() {
@@ -578,31 +390,28 @@ void SystemInfo::stopHawkbitUpdater() {
 }
 
 QString SystemInfo::getHawkbitServiceLogs(int lines) {
-    QProcess process;
-    process.start("journalctl", QStringList() << "-u" << "rauc-hawkbit-cpp.service" << "-n" << QString::number(lines) << "--no-pager");
-    process.waitForFinished(5000);
-
-    if (process.exitCode() == 0) {
-        QString logs = process.readAllStandardOutput();
+    // Served from the followed journal; no journalctl run per call
+    if (m_hawkbitLog->count() == 0) {
+        return "No service logs yet";
+    }
+    return m_hawkbitLog->tail(lines);
+}
 
-        // Log key events found in service logs
-        if (logs.contains("Connected to server", Qt::CaseInsensitive)) {
+void SystemInfo::onHawkbitLogMessages(const QStringList &messages) {
+    // Log key events once, as the lines arrive
+    for (const QString &message : messages) {
+        if (message.contains("Connected to server", Qt::CaseInsensitive)) {
             DLT_LOG_SYS_INFO("Hawkbit service connected to server");
         }
-        if (logs.contains("Deployment found", Qt::CaseInsensitive)) {
+        if (message.contains("Deployment found", Qt::CaseInsensitive)) {
             DLT_LOG_SYS_INFO("Hawkbit deployment found");
         }
-        if (logs.contains("rauc install", Qt::CaseInsensitive)) {
+        if (message.contains("rauc install", Qt::CaseInsensitive)) {
             DLT_LOG_SYS_INFO("Hawkbit triggered RAUC installation");
         }
-        if (logs.contains("error", Qt::CaseInsensitive)) {
+        if (message.contains("error", Qt::CaseInsensitive)) {
             DLT_LOG_SYS_WARN("Hawkbit service reported errors - check journalctl");
         }
-
-        return logs;
-    } else {
-        DLT_LOG_SYS_ERROR("Failed to retrieve Hawkbit service logs");
-        return "Failed to retrieve service logs";
     }
 }
 
@@ -5,38 +5,50 @@
 #include <QString>
 #include <QTimer>
 #include <QDateTime>
-#include <QNetworkInterface>
+#include <QThread>
 #include <dlt/dlt.h>
+#include "system_sampler.h"
+#include "metric_history.h"
+#include "journal_log_model.h"
 
+class SystemdUnitWatcher;
+
+// Sampled metrics share one NOTIFY signal, emitted once per snapshot, so a
+// tick re-evaluates the QML bindings in a single pass instead of once per
+// changed property. Details that are read once keep their own signals.
 class SystemInfo : public QObject
 {
     Q_OBJECT
-    Q_PROPERTY(double cpuUsage READ cpuUsage NOTIFY cpuUsageChanged)
-    Q_PROPERTY(QStringList cpuCoreUsage READ cpuCoreUsage NOTIFY cpuCoreUsageChanged)
-    Q_PROPERTY(double memoryUsage READ memoryUsage NOTIFY memoryUsageChanged)
-    Q_PROPERTY(qint64 totalMemory READ totalMemory NOTIFY totalMemoryChanged)
-    Q_PROPERTY(qint64 usedMemory READ usedMemory NOTIFY usedMemoryChanged)
-    Q_PROPERTY(qint64 freeMemory READ freeMemory NOTIFY freeMemoryChanged)
-    Q_PROPERTY(double temperature READ temperature NOTIFY temperatureChanged)
-    Q_PROPERTY(QString uptime READ uptime NOTIFY uptimeChanged)
+    Q_PROPERTY(double cpuUsage READ cpuUsage NOTIFY snapshotChanged)
+    Q_PROPERTY(QStringList cpuCoreUsage READ cpuCoreUsage NOTIFY snapshotChanged)
+    Q_PROPERTY(double memoryUsage READ memoryUsage NOTIFY snapshotChanged)
+    Q_PROPERTY(qint64 totalMemory READ totalMemory NOTIFY snapshotChanged)
+    Q_PROPERTY(qint64 usedMemory READ usedMemory NOTIFY snapshotChanged)
+    Q_PROPERTY(qint64 freeMemory READ freeMemory NOTIFY snapshotChanged)
+    Q_PROPERTY(double temperature READ temperature NOTIFY snapshotChanged)
+    Q_PROPERTY(QVariantList temperatureSensors READ temperatureSensors NOTIFY snapshotChanged)
+    Q_PROPERTY(QString uptime READ uptime NOTIFY snapshotChanged)
     Q_PROPERTY(QString kernelVersion READ kernelVersion NOTIFY kernelVersionChanged)
     Q_PROPERTY(QString hostname READ hostname NOTIFY hostnameChanged)
     Q_PROPERTY(QString architecture READ architecture NOTIFY architectureChanged)
     Q_PROPERTY(QString currentTime READ currentTime NOTIFY currentTimeChanged)
-    Q_PROPERTY(bool networkConnected READ networkConnected NOTIFY networkConnectedChanged)
-    Q_PROPERTY(QString networkInterface READ networkInterface NOTIFY networkInterfaceChanged)
-    Q_PROPERTY(QString ipAddress READ ipAddress NOTIFY ipAddressChanged)
-    Q_PROPERTY(qint64 rootPartitionTotal READ rootPartitionTotal NOTIFY rootPartitionTotalChanged)
-    Q_PROPERTY(qint64 rootPartitionUsed READ rootPartitionUsed NOTIFY rootPartitionUsedChanged)
-    Q_PROPERTY(qint64 rootPartitionFree READ rootPartitionFree NOTIFY rootPartitionFreeChanged)
-    Q_PROPERTY(double rootPartitionUsagePercent READ rootPartitionUsagePercent NOTIFY rootPartitionUsagePercentChanged)
+    Q_PROPERTY(bool networkConnected READ networkConnected NOTIFY snapshotChanged)
+    Q_PROPERTY(QString networkInterface READ networkInterface NOTIFY snapshotChanged)
+    Q_PROPERTY(QString ipAddress READ ipAddress NOTIFY snapshotChanged)
+    Q_PROPERTY(qint64 rootPartitionTotal READ rootPartitionTotal NOTIFY snapshotChanged)
+    Q_PROPERTY(qint64 rootPartitionUsed READ rootPartitionUsed NOTIFY snapshotChanged)
+    Q_PROPERTY(qint64 rootPartitionFree READ rootPartitionFree NOTIFY snapshotChanged)
+    Q_PROPERTY(double rootPartitionUsagePercent READ rootPartitionUsagePercent NOTIFY snapshotChanged)
     Q_PROPERTY(QString buildTime READ buildTime NOTIFY buildTimeChanged)
     Q_PROPERTY(QString yoctoVersion READ yoctoVersion NOTIFY yoctoVersionChanged)
     Q_PROPERTY(QString rootDevice READ rootDevice NOTIFY rootDeviceChanged)
     Q_PROPERTY(QString softwareVersion READ softwareVersion NOTIFY softwareVersionChanged)
+    Q_PROPERTY(MetricHistory *history READ history CONSTANT)
+    Q_PROPERTY(JournalLogModel *hawkbitLog READ hawkbitLog CONSTANT)
 
 public:
     explicit SystemInfo(QObject *parent = nullptr);
+    ~SystemInfo() override;
 
     // Getters
     double cpuUsage() const { return m_cpuUsage; }
@@ -46,6 +58,7 @@ public:
     qint64 usedMemory() const { return m_usedMemory; }
     qint64 freeMemory() const { return m_freeMemory; }
     double temperature() const { return m_temperature; }
+    QVariantList temperatureSensors() const { return m_temperatureSensors; }
     QString uptime() const { return m_uptime; }
     QString kernelVersion() const { return m_kernelVersion; }
     QString hostname() const { return m_hostname; }
@@ -62,6 +75,8 @@ public:
     QString yoctoVersion() const { return m_yoctoVersion; }
     QString rootDevice() const { return m_rootDevice; }
     QString softwareVersion() const { return m_softwareVersion; }
+    MetricHistory *history() const { return m_history; }
+    JournalLogModel *hawkbitLog() const { return m_hawkbitLog; }
 
 public slots:
     void updateSystemInfo();
@@ -80,25 +95,11 @@ public slots:
     Q_INVOKABLE bool testNetworkConnectivity();
 
 signals:
-    void cpuUsageChanged();
-    void cpuCoreUsageChanged();
-    void memoryUsageChanged();
-    void totalMemoryChanged();
-    void usedMemoryChanged();
-    void freeMemoryChanged();
-    void temperatureChanged();
-    void uptimeChanged();
+    void snapshotChanged();
     void kernelVersionChanged();
     void hostnameChanged();
     void architectureChanged();
     void currentTimeChanged();
-    void networkConnectedChanged();
-    void networkInterfaceChanged();
-    void ipAddressChanged();
-    void rootPartitionTotalChanged();
-    void rootPartitionUsedChanged();
-    void rootPartitionFreeChanged();
-    void rootPartitionUsagePercentChanged();
     void buildTimeChanged();
     void yoctoVersionChanged();
     void rootDeviceChanged();
@@ -106,16 +107,15 @@ signals:
     void hawkbitServiceStatusChanged(bool active);
     void hawkbitUpdateDetected();
     void hawkbitUpdateFailed(const QString &error);
+    void sampleRequested();
+
+private slots:
+    void applySnapshot(const SystemSnapshot &snapshot);
+    void onHawkbitLogMessages(const QStringList &messages);
+    void onHawkbitActiveStateChanged();
 
 private:
-    void updateCpuUsage();
-    void updateCpuCoreUsage();
-    void updateMemoryInfo();
-    void updateTemperature();
-    void updateUptime();
     void updateSystemDetails();
-    void updateNetworkInfo();
-    void updateDiskInfo();
     void updateBuildInfo();
     void updateRootDeviceInfo();
     void updateSoftwareVersion();
@@ -129,6 +129,7 @@ private:
     qint64 m_usedMemory;
     qint64 m_freeMemory;
     double m_temperature;
+    QVariantList m_temperatureSensors;
     QString m_uptime;
     QString m_kernelVersion;
     QString m_hostname;
@@ -147,12 +148,16 @@ private:
     QString m_softwareVersion;
 
     // Timers
-    QTimer *m_updateTimer;
     QTimer *m_timeTimer;
 
-    // CPU usage calculation
-    qint64 m_lastCpuTotal;
-    qint64 m_lastCpuIdle;
+    // Metrics are sampled off the GUI thread and applied per snapshot
+    QThread *m_samplerThread;
+    SystemSampler *m_sampler;
+    MetricHistory *m_history;
+
+    // rauc-hawkbit-cpp state and journal, both pushed instead of polled
+    SystemdUnitWatcher *m_hawkbitUnit;
+    JournalLogModel *m_hawkbitLog;
 
     // DLT context
     static DltContext m_dltCtx;
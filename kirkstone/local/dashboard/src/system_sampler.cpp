@@ -0,0 +1,207 @@
+#include "system_sampler.h"
+#include <QVariantMap>
+#include <QTimer>
+#include <QNetworkInterface>
+#include <dlt/dlt.h>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <sys/statvfs.h>
+
+namespace {
+
+DltContext samplerCtx;
+
+const char *const StatPath = "/proc/stat";
+const char *const MeminfoPath = "/proc/meminfo";
+const char *const UptimePath = "/proc/uptime";
+
+} // namespace
+
+SystemSampler::SystemSampler(QObject *parent)
+    : QObject(parent)
+    , m_timer(nullptr)
+    , m_history(nullptr)
+    , m_lastCoreCount(0)
+{
+}
+
+SystemSampler::~SystemSampler() = default;
+
+void SystemSampler::start()
+{
+    static bool dltContextRegistered = false;
+    if (!dltContextRegistered) {
+        DLT_REGISTER_CONTEXT(samplerCtx, "SMPL", "System Metrics Sampler");
+        dltContextRegistered = true;
+    }
+
+    const bool opened = m_stat.open(StatPath) & m_meminfo.open(MeminfoPath) & m_uptime.open(UptimePath);
+    if (!opened) {
+        DLT_LOG(samplerCtx, DLT_LOG_WARN, DLT_STRING("Some /proc metrics are unavailable:"),
+                DLT_STRING(strerror(errno)));
+    }
+
+    if (!m_sensors.watchUevents()) {
+        DLT_LOG(samplerCtx, DLT_LOG_WARN, DLT_STRING("No uevent socket, sensors are rescanned only on read errors:"),
+                DLT_STRING(strerror(errno)));
+    }
+
+    m_timer = new QTimer(this);
+    connect(m_timer, &QTimer::timeout, this, &SystemSampler::sample);
+    m_timer->start(SampleIntervalMs);
+
+    DLT_LOG(samplerCtx, DLT_LOG_INFO, DLT_STRING("System metrics sampler started, interval ms:"),
+            DLT_INT(SampleIntervalMs));
+    sample();
+}
+
+void SystemSampler::requestSample()
+{
+    if (m_sinceLastSample.isValid() && m_sinceLastSample.elapsed() < MinRefreshIntervalMs) {
+        return;
+    }
+    sample();
+}
+
+void SystemSampler::sample()
+{
+    m_sinceLastSample.start();
+
+    SystemSnapshot snapshot;
+    sampleCpu(snapshot);
+    sampleMemory(snapshot);
+    sampleTemperature(snapshot);
+    sampleUptime(snapshot);
+    sampleNetwork(snapshot);
+    sampleDisk(snapshot);
+    recordHistory(snapshot);
+    emit snapshotReady(snapshot);
+}
+
+void SystemSampler::recordHistory(const SystemSnapshot &snapshot)
+{
+    if (!m_history) return;
+
+    // Missing values are NaN so the sparklines leave them out
+    const float missing = std::numeric_limits<float>::quiet_NaN();
+    const float values[metrics::SeriesCount] = {
+        snapshot.hasCpuUsage ? float(snapshot.cpuUsage) : missing,
+        snapshot.totalMemory > 0 ? float(snapshot.memoryUsage) : missing,
+        snapshot.hasTemperature ? float(snapshot.temperature) : missing,
+    };
+    m_history->push(QElapsedTimer::msecsSinceReference(), values);
+}
+
+void SystemSampler::sampleCpu(SystemSnapshot &snapshot)
+{
+    // One pass over /proc/stat for both the total and the per-core usage
+    const long length = m_stat.read(m_buffer, sizeof(m_buffer));
+    proc::CpuTimes cpu;
+    const int cores = length > 0 ? proc::parseStat(m_buffer, size_t(length), cpu, m_cores, proc::MaxCpuCores) : -1;
+    if (cores < 0) return;
+
+    if (m_lastCpu.total != 0) {
+        snapshot.cpuUsage = proc::cpuUsagePercent(m_lastCpu, cpu);
+        snapshot.hasCpuUsage = cpu.total > m_lastCpu.total;
+    }
+    m_lastCpu = cpu;
+
+    // Usage since the previous tick; since boot on the first one
+    snapshot.cpuCoreUsage.reserve(cores);
+    for (int core = 0; core < cores; ++core) {
+        const proc::CpuTimes since = core < m_lastCoreCount ? m_lastCores[core] : proc::CpuTimes();
+        snapshot.cpuCoreUsage.append(QString::number(proc::cpuUsagePercent(since, m_cores[core]), 'f', 1));
+        m_lastCores[core] = m_cores[core];
+    }
+    m_lastCoreCount = cores;
+}
+
+void SystemSampler::sampleMemory(SystemSnapshot &snapshot)
+{
+    const long length = m_meminfo.read(m_buffer, sizeof(m_buffer));
+    if (length <= 0) return;
+
+    uint64_t values[proc::MeminfoFieldCount] = {};
+    m_meminfoParser.parse(m_buffer, size_t(length), values);
+
+    const qint64 total = qint64(values[proc::MemTotal]) * 1024;   // kB to bytes
+    const qint64 available = qint64(values[proc::MemAvailable]) * 1024;
+    snapshot.totalMemory = total;
+    snapshot.usedMemory = total - available;
+    snapshot.freeMemory = available;
+    snapshot.memoryUsage = total > 0 ? (100.0 * snapshot.usedMemory / total) : 0.0;
+}
+
+void SystemSampler::sampleTemperature(SystemSnapshot &snapshot)
+{
+    // Discovery happens on the first tick and after hwmon/thermal uevents only
+    if (m_sensors.rescanIfChanged()) {
+        const SensorRegistry::Sensor *primary = m_sensors.primary();
+        DLT_LOG(samplerCtx, DLT_LOG_INFO, DLT_STRING("Temperature sensors found:"),
+                DLT_UINT(static_cast<unsigned>(m_sensors.sensors().size())), DLT_STRING("primary:"),
+                DLT_STRING(primary ? primary->path.c_str() : "none"));
+    } else {
+        m_sensors.read(m_buffer, sizeof(m_buffer));
+    }
+
+    for (const std::unique_ptr<SensorRegistry::Sensor> &sensor : m_sensors.sensors()) {
+        if (!sensor->valid) continue;
+        QVariantMap entry;
+        entry.insert("label", QString::fromStdString(sensor->label));
+        entry.insert("temperature", sensor->millidegrees / 1000.0);
+        snapshot.temperatureSensors.append(entry);
+    }
+    if (const SensorRegistry::Sensor *primary = m_sensors.primary()) {
+        snapshot.temperature = primary->millidegrees / 1000.0;
+        snapshot.hasTemperature = true;
+    }
+}
+
+void SystemSampler::sampleUptime(SystemSnapshot &snapshot)
+{
+    const long length = m_uptime.read(m_buffer, sizeof(m_buffer));
+    uint64_t uptimeSeconds = 0;
+    if (length <= 0 || !proc::parseUptime(m_buffer, size_t(length), uptimeSeconds)) return;
+
+    const quint64 days = uptimeSeconds / 86400;
+    const quint64 hours = (uptimeSeconds % 86400) / 3600;
+    const quint64 minutes = (uptimeSeconds % 3600) / 60;
+    const quint64 seconds = uptimeSeconds % 60;
+    snapshot.uptime = QString("%1d %2h %3m %4s").arg(days).arg(hours).arg(minutes).arg(seconds);
+}
+
+void SystemSampler::sampleNetwork(SystemSnapshot &snapshot)
+{
+    const QList<QNetworkInterface> interfaces = QNetworkInterface::allInterfaces();
+    for (const QNetworkInterface &iface : interfaces) {
+        if (!iface.flags().testFlag(QNetworkInterface::IsUp) ||
+            !iface.flags().testFlag(QNetworkInterface::IsRunning) ||
+            iface.flags().testFlag(QNetworkInterface::IsLoopBack)) {
+            continue;
+        }
+        const QList<QNetworkAddressEntry> entries = iface.addressEntries();
+        for (const QNetworkAddressEntry &entry : entries) {
+            if (entry.ip().protocol() == QAbstractSocket::IPv4Protocol) {
+                snapshot.networkConnected = true;
+                snapshot.networkInterface = iface.name();
+                snapshot.ipAddress = entry.ip().toString();
+                return;
+            }
+        }
+    }
+}
+
+void SystemSampler::sampleDisk(SystemSnapshot &snapshot)
+{
+    // statvfs directly: QStorageInfo re-reads the mount table to find the root path
+    struct statvfs root;
+    if (statvfs("/", &root) != 0) return;
+
+    const qint64 total = qint64(root.f_blocks) * qint64(root.f_frsize);
+    const qint64 free = qint64(root.f_bavail) * qint64(root.f_frsize);
+    snapshot.rootPartitionTotal = total;
+    snapshot.rootPartitionFree = free;
+    snapshot.rootPartitionUsed = total - free;
+    snapshot.rootPartitionUsagePercent = total > 0 ? (100.0 * snapshot.rootPartitionUsed / total) : 0.0;
+}
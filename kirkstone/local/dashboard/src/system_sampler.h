@@ -0,0 +1,93 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QVariantList>
+#include "proc_parser.h"
+#include "sensor_registry.h"
+#include "metric_ring.h"
+
+class QTimer;
+
+// One tick of system metrics. Built on the sampler thread and handed to the
+// GUI thread by value; nothing in it is touched again after it is published.
+struct SystemSnapshot
+{
+    double cpuUsage = 0.0;
+    bool hasCpuUsage = false;       // false on the first tick (no previous counters)
+    QStringList cpuCoreUsage;
+    qint64 totalMemory = 0;
+    qint64 usedMemory = 0;
+    qint64 freeMemory = 0;
+    double memoryUsage = 0.0;
+    double temperature = 0.0;
+    bool hasTemperature = false;
+    QVariantList temperatureSensors;   // { "label": QString, "temperature": double } per sensor
+    QString uptime;
+    bool networkConnected = false;
+    QString networkInterface;
+    QString ipAddress;
+    qint64 rootPartitionTotal = 0;
+    qint64 rootPartitionUsed = 0;
+    qint64 rootPartitionFree = 0;
+    double rootPartitionUsagePercent = 0.0;
+};
+Q_DECLARE_METATYPE(SystemSnapshot)
+
+// Samples /proc, sysfs, network interfaces and the root file system on its
+// own thread. The /proc and sysfs files stay open and are re-read with
+// pread() from offset 0 each tick, so a tick costs a handful of syscalls
+// and no allocation besides the published strings.
+class SystemSampler : public QObject {
+    Q_OBJECT
+public:
+    explicit SystemSampler(QObject *parent = nullptr);
+    ~SystemSampler() override;
+
+    static constexpr int SampleIntervalMs = 2000;
+    // Refresh requests closer together than this reuse the last snapshot
+    static constexpr int MinRefreshIntervalMs = 500;
+
+    // Every sample is also pushed to ring; set before the thread starts
+    void setHistory(metrics::MetricRing *ring) { m_history = ring; }
+
+public slots:
+    // Run on the sampler thread (connected to QThread::started)
+    void start();
+    // Take a sample now unless one was taken very recently
+    void requestSample();
+
+signals:
+    void snapshotReady(const SystemSnapshot &snapshot);
+
+private:
+    void sample();
+    void sampleCpu(SystemSnapshot &snapshot);
+    void sampleMemory(SystemSnapshot &snapshot);
+    void sampleTemperature(SystemSnapshot &snapshot);
+    void sampleUptime(SystemSnapshot &snapshot);
+    void sampleNetwork(SystemSnapshot &snapshot);
+    void sampleDisk(SystemSnapshot &snapshot);
+    void recordHistory(const SystemSnapshot &snapshot);
+
+    QTimer *m_timer;
+    metrics::MetricRing *m_history;
+    QElapsedTimer m_sinceLastSample;
+
+    proc::ProcFile m_stat;
+    proc::ProcFile m_meminfo;
+    proc::ProcFile m_uptime;
+    proc::MeminfoParser m_meminfoParser;
+    SensorRegistry m_sensors;
+
+    proc::CpuTimes m_lastCpu;
+    proc::CpuTimes m_cores[proc::MaxCpuCores];
+    proc::CpuTimes m_lastCores[proc::MaxCpuCores];
+    int m_lastCoreCount;
+
+    // Large enough for the cpu lines of /proc/stat on big machines; the
+    // interrupt counters after them are cut off, which is fine
+    char m_buffer[16384];
+};
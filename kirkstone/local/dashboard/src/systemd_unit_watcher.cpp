@@ -0,0 +1,134 @@
+#include "systemd_unit_watcher.h"
+#include <QDBusMessage>
+#include <QDBusObjectPath>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusVariant>
+
+DltContext SystemdUnitWatcher::m_ctx;
+
+static const char SystemdService[] = "org.freedesktop.systemd1";
+static const char SystemdPath[] = "/org/freedesktop/systemd1";
+static const char SystemdManagerInterface[] = "org.freedesktop.systemd1.Manager";
+static const char SystemdUnitInterface[] = "org.freedesktop.systemd1.Unit";
+static const char PropertiesInterface[] = "org.freedesktop.DBus.Properties";
+
+SystemdUnitWatcher::SystemdUnitWatcher(const QString &unit, QObject *parent)
+    : QObject(parent)
+    , m_unit(unit)
+    , m_bus(QDBusConnection::systemBus())
+{
+    static bool dltContextRegistered = false;
+    if (!dltContextRegistered) {
+        DLT_REGISTER_CONTEXT(SystemdUnitWatcher::m_ctx, "UNIT", "Systemd Unit Watcher");
+        dltContextRegistered = true;
+    }
+
+    if (!m_bus.isConnected()) {
+        DLT_LOG(m_ctx, DLT_LOG_ERROR, DLT_STRING("No system bus, cannot watch"),
+                DLT_STRING(m_unit.toUtf8().constData()));
+        return;
+    }
+
+    // systemd only emits unit PropertiesChanged while a client is subscribed
+    m_bus.asyncCall(QDBusMessage::createMethodCall(SystemdService, SystemdPath, SystemdManagerInterface,
+                                                   "Subscribe"));
+
+    // LoadUnit resolves the unit's object path even before it is loaded
+    QDBusMessage call = QDBusMessage::createMethodCall(SystemdService, SystemdPath, SystemdManagerInterface,
+                                                       "LoadUnit");
+    call << m_unit;
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &SystemdUnitWatcher::onLoadUnitReply);
+}
+
+void SystemdUnitWatcher::onLoadUnitReply(QDBusPendingCallWatcher *watcher)
+{
+    watcher->deleteLater();
+    QDBusPendingReply<QDBusObjectPath> reply = *watcher;
+    if (reply.isError()) {
+        DLT_LOG(m_ctx, DLT_LOG_ERROR, DLT_STRING("Failed to resolve unit"), DLT_STRING(m_unit.toUtf8().constData()),
+                DLT_STRING(reply.error().message().toUtf8().constData()));
+        return;
+    }
+
+    m_unitPath = reply.value().path();
+    bool connected = m_bus.connect(SystemdService, m_unitPath, PropertiesInterface, "PropertiesChanged", this,
+                                   SLOT(onPropertiesChanged(QString, QVariantMap, QStringList)));
+    DLT_LOG(m_ctx, connected ? DLT_LOG_INFO : DLT_LOG_ERROR,
+            DLT_STRING(connected ? "Watching unit" : "Failed to watch unit"),
+            DLT_STRING(m_unit.toUtf8().constData()), DLT_STRING(m_unitPath.toUtf8().constData()));
+
+    // The current state, once; changes arrive as signals from now on
+    refresh();
+}
+
+void SystemdUnitWatcher::refresh()
+{
+    if (m_unitPath.isEmpty()) {
+        return; // LoadUnit still pending; its reply asks for the state
+    }
+
+    QDBusMessage call = QDBusMessage::createMethodCall(SystemdService, m_unitPath, PropertiesInterface, "Get");
+    call << QString(SystemdUnitInterface) << QString("ActiveState");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &SystemdUnitWatcher::onActiveStateReply);
+}
+
+void SystemdUnitWatcher::onActiveStateReply(QDBusPendingCallWatcher *watcher)
+{
+    watcher->deleteLater();
+    QDBusPendingReply<QDBusVariant> reply = *watcher;
+    if (reply.isError()) {
+        DLT_LOG(m_ctx, DLT_LOG_WARN, DLT_STRING("Failed to read ActiveState of"),
+                DLT_STRING(m_unit.toUtf8().constData()),
+                DLT_STRING(reply.error().message().toUtf8().constData()));
+        return;
+    }
+    applyActiveState(reply.value().variant().toString());
+}
+
+void SystemdUnitWatcher::onPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                                             const QStringList &invalidated)
+{
+    Q_UNUSED(invalidated);
+    if (interface == SystemdUnitInterface && changed.contains("ActiveState")) {
+        applyActiveState(changed.value("ActiveState").toString());
+    }
+}
+
+void SystemdUnitWatcher::applyActiveState(const QString &state)
+{
+    if (m_activeState == state) {
+        return;
+    }
+    m_activeState = state;
+    emit activeStateChanged();
+}
+
+void SystemdUnitWatcher::startUnit()
+{
+    callManager("StartUnit");
+}
+
+void SystemdUnitWatcher::stopUnit()
+{
+    callManager("StopUnit");
+}
+
+void SystemdUnitWatcher::callManager(const char *method)
+{
+    QDBusMessage call = QDBusMessage::createMethodCall(SystemdService, SystemdPath, SystemdManagerInterface, method);
+    call << m_unit << QString("replace");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_bus.asyncCall(call), this);
+    const QByteArray unit = m_unit.toUtf8();
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [method, unit](QDBusPendingCallWatcher *w) {
+        w->deleteLater();
+        // The resulting ActiveState changes arrive as PropertiesChanged
+        const QDBusMessage reply = w->reply();
+        DLT_LOG(m_ctx, reply.type() == QDBusMessage::ErrorMessage ? DLT_LOG_ERROR : DLT_LOG_INFO,
+                DLT_STRING(method), DLT_STRING(unit.constData()), DLT_STRING("result:"),
+                DLT_STRING(reply.type() == QDBusMessage::ErrorMessage ? reply.errorMessage().toUtf8().constData()
+                                                                     : "queued"));
+    });
+}
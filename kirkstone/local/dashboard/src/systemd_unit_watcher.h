@@ -0,0 +1,49 @@
+#pragma once
+#include <QObject>
+#include <QString>
+#include <QVariantMap>
+#include <QDBusConnection>
+#include <dlt/dlt.h>
+
+class QDBusPendingCallWatcher;
+
+// ActiveState of one systemd unit, pushed by systemd over D-Bus instead of
+// polled with systemctl: the unit's PropertiesChanged signal is watched
+// after one LoadUnit call, and the state is read once when that resolves.
+// Every D-Bus call is asynchronous.
+class SystemdUnitWatcher : public QObject {
+    Q_OBJECT
+public:
+    explicit SystemdUnitWatcher(const QString &unit, QObject *parent = nullptr);
+
+    QString unit() const { return m_unit; }
+    QString activeState() const { return m_activeState; }
+    // What systemctl is-active reports as success
+    bool isActive() const { return m_activeState == "active" || m_activeState == "reloading"; }
+
+    // Reads ActiveState again (once the unit path is known)
+    void refresh();
+    // StartUnit/StopUnit with mode "replace"; the state change follows as a signal
+    void startUnit();
+    void stopUnit();
+
+    static DltContext m_ctx;
+
+signals:
+    void activeStateChanged();
+
+private slots:
+    void onLoadUnitReply(QDBusPendingCallWatcher *watcher);
+    void onActiveStateReply(QDBusPendingCallWatcher *watcher);
+    void onPropertiesChanged(const QString &interface, const QVariantMap &changed,
+                             const QStringList &invalidated);
+
+private:
+    void callManager(const char *method);
+    void applyActiveState(const QString &state);
+
+    QString m_unit;
+    QString m_unitPath;
+    QString m_activeState;
+    QDBusConnection m_bus;
+};
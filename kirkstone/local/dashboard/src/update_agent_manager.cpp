@@ -1,4 +1,5 @@
 #include "update_agent_manager.h"
+#include "systemd_unit_watcher.h"
 #include <QDebug>
 #include <QFile>
 #include <QTextStream>
@@ -6,41 +7,34 @@
 #include <QStandardPaths>
 #include <QDBusConnection>
 #include <QDBusMessage>
-#include <QDBusConnectionInterface>
-#include <QDBusInterface>
-#include <QDBusReply>
 #include <QDBusArgument>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
+#include <QDBusVariant>
 
 // DLT context definition
 DltContext UpdateAgentManager::m_ctx;
 
+static const char AgentUnit[] = "update-agent.service";
+static const char UpdateServiceName[] = "org.freedesktop.UpdateService";
+static const char UpdateServicePath[] = "/org/freedesktop/UpdateService";
+static const char RaucService[] = "de.pengutronix.rauc";
+static const char RaucInstallerInterface[] = "de.pengutronix.rauc.Installer";
+static const char PropertiesInterface[] = "org.freedesktop.DBus.Properties";
+
 UpdateAgentManager::UpdateAgentManager(QObject *parent)
     : QObject(parent)
     , m_isServiceRunning(false)
     , m_isUpdateActive(false)  // Start as inactive
     , m_updateStatus("Polling")  // Start with Polling status
     , m_updateProgress(0)      // Start with 0% progress
-    , m_serviceStatusProcess(nullptr)
-    , m_currentOperation("idle")  // Start with idle operation
     , m_dbusConnection(QDBusConnection::systemBus())
-    , m_dbusConnected(false)
+    , m_subscribed(false)
 {
     // Initialize DLT
     DLT_REGISTER_CONTEXT(m_ctx, "UPDM", "Update Agent Manager");
     DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("UpdateAgentManager initialized"));
 
-    // Setup refresh timer
-    m_refreshTimer = new QTimer(this);
-    m_refreshTimer->setInterval(1000); // Check every 2 seconds
-    connect(m_refreshTimer, &QTimer::timeout, this, &UpdateAgentManager::onRefreshTimer);
-    m_refreshTimer->start();
-
-    // Setup operation polling timer (disabled for now to prevent automatic status changes)
-    m_operationPollTimer = new QTimer(this);
-    m_operationPollTimer->setInterval(1000); // Poll operation every 1 second
-    connect(m_operationPollTimer, &QTimer::timeout, this, &UpdateAgentManager::pollOperation);
-    // m_operationPollTimer->start(); // Commented out to prevent automatic polling
-
     // Setup reboot progress timer
     m_rebootProgressTimer = new QTimer(this);
     m_rebootProgressTimer->setInterval(1000); // 1 second interval
@@ -54,11 +48,11 @@ UpdateAgentManager::UpdateAgentManager(QObject *parent)
         }
     });
 
-    // Setup D-Bus monitoring
+    // Setup D-Bus monitoring. Nothing polls: the service state comes from
+    // systemd and the update state from update-service, both as signals.
     setupDBusMonitoring();
-
-    // Initial status check
-    refresh();
+    m_unitWatcher = new SystemdUnitWatcher(AgentUnit, this);
+    connect(m_unitWatcher, &SystemdUnitWatcher::activeStateChanged, this, &UpdateAgentManager::onActiveStateChanged);
 }
 
 UpdateAgentManager::~UpdateAgentManager()
@@ -69,31 +63,13 @@ UpdateAgentManager::~UpdateAgentManager()
 
 void UpdateAgentManager::refresh()
 {
-    checkServiceStatus();
-}
-
-void UpdateAgentManager::checkServiceStatus()
-{
-    if (m_serviceStatusProcess && m_serviceStatusProcess->state() != QProcess::NotRunning) {
-        return; // Already checking
-    }
-
-    if (m_serviceStatusProcess) {
-        m_serviceStatusProcess->deleteLater();
-    }
-
-    m_serviceStatusProcess = new QProcess(this);
-    connect(m_serviceStatusProcess, QOverload<int>::of(&QProcess::finished),
-            this, &UpdateAgentManager::onServiceStatusProcessFinished);
-
-    // Check if update-agent service is running
-    m_serviceStatusProcess->start("systemctl", QStringList() << "is-active" << "update-agent.service");
+    m_unitWatcher->refresh();
 }
 
-void UpdateAgentManager::onServiceStatusProcessFinished(int exitCode)
+void UpdateAgentManager::onActiveStateChanged()
 {
     bool wasRunning = m_isServiceRunning;
-    m_isServiceRunning = (exitCode == 0);
+    m_isServiceRunning = m_unitWatcher->isActive();
 
     if (wasRunning != m_isServiceRunning) {
         DLT_LOG(m_ctx, DLT_LOG_INFO,
@@ -110,47 +86,6 @@ void UpdateAgentManager::onServiceStatusProcessFinished(int exitCode)
             emit updateProgressChanged();
         }
     }
-
-    m_serviceStatusProcess->deleteLater();
-    m_serviceStatusProcess = nullptr;
-}
-
-void UpdateAgentManager::pollOperation()
-{
-    if (!m_dbusConnected) {
-        return;
-    }
-
-    // Get Operation property from UpdateService
-    QDBusInterface updateService("org.freedesktop.UpdateService",
-                                "/org/freedesktop/UpdateService",
-                                "org.freedesktop.UpdateService",
-                                QDBusConnection::systemBus());
-
-    if (!updateService.isValid()) {
-        return;
-    }
-
-    QVariant property = updateService.property("Operation");
-    if (property.isValid()) {
-        QString operation = property.toString();
-        if (operation != m_currentOperation) {
-            m_currentOperation = operation;
-            updateStatusFromOperation(operation);
-            DLT_LOG(m_ctx, DLT_LOG_INFO,
-                    DLT_STRING("Operation changed:"),
-                    DLT_STRING(operation.toUtf8().constData()));
-        }
-    }
-
-    // Also poll Progress property directly from UpdateService (safely)
-    QVariant progressProperty = updateService.property("Progress");
-    if (progressProperty.isValid() && !progressProperty.isNull()) {
-        // Try to extract progress safely without QDBusArgument
-        DLT_LOG(m_ctx, DLT_LOG_DEBUG,
-                DLT_STRING("Progress property type:"),
-                DLT_STRING(progressProperty.typeName()));
-    }
 }
 
 void UpdateAgentManager::setupDBusMonitoring()
@@ -163,8 +98,20 @@ void UpdateAgentManager::setupDBusMonitoring()
         return;
     }
 
-    // Connect to update service signals
-    bool connected = m_dbusConnection.connect(
+    // update-service sends Progress and Completed to subscribers only. It is subscribed to while
+    // RAUC's Operation is "installing" (RAUC broadcasts that itself), so it can still exit when idle.
+    bool connected = m_dbusConnection.connect(RaucService, "/", PropertiesInterface, "PropertiesChanged", this,
+                                              SLOT(onRaucPropertiesChanged(QString, QVariantMap, QStringList)));
+    if (!connected) {
+        DLT_LOG(m_ctx, DLT_LOG_ERROR, DLT_STRING("Failed to connect to RAUC PropertiesChanged signal"));
+    }
+    QDBusMessage get = QDBusMessage::createMethodCall(RaucService, "/", PropertiesInterface, "Get");
+    get << QString(RaucInstallerInterface) << QString("Operation");
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_dbusConnection.asyncCall(get), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, &UpdateAgentManager::onRaucOperationReply);
+
+    // Connect to update service signals (delivered to this connection while subscribed)
+    connected = m_dbusConnection.connect(
         "org.freedesktop.UpdateService",  // service
         "/org/freedesktop/UpdateService", // path
         "org.freedesktop.UpdateService",  // interface
@@ -195,82 +142,71 @@ void UpdateAgentManager::setupDBusMonitoring()
         DLT_LOG(m_ctx, DLT_LOG_ERROR, DLT_STRING("Failed to connect to UpdateService Completed signal"));
     }
 
-    m_dbusConnected = true;
     DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("D-Bus monitoring setup completed"));
 }
 
-void UpdateAgentManager::updateStatusFromOperation(const QString& operation)
+void UpdateAgentManager::onRaucPropertiesChanged(const QString& interface, const QVariantMap& changed,
+                                                 const QStringList& invalidated)
 {
-    QString newStatus = m_updateStatus;
-    bool wasUpdateActive = m_isUpdateActive;
-
-    if (operation == "idle") {
-        m_isUpdateActive = false;
-        newStatus = "Polling";
-        m_updateProgress = 8; // Polling shows 8%
-    } else if (operation == "installing") {
-        m_isUpdateActive = true;
-        newStatus = "Installing";
-        if (!wasUpdateActive) {
-            m_updateProgress = 30; // Installing starts at 30%
-            emit updateStarted();
-            emit updateProgressChanged();
-        }
-    } else if (operation.contains("download", Qt::CaseInsensitive) ||
-               operation.contains("fetch", Qt::CaseInsensitive)) {
-        m_isUpdateActive = true;
-        newStatus = "Download";
-        if (!wasUpdateActive) {
-            m_updateProgress = 20; // Download shows 20%
-            emit updateStarted();
-            emit updateProgressChanged();
-        }
-    } else if (!operation.isEmpty() && operation != "idle") {
-        // Any other non-idle operation indicates activity
-        m_isUpdateActive = true;
-        newStatus = "Download"; // Default to download phase for unknown operations
-        if (!wasUpdateActive) {
-            m_updateProgress = 20; // Default to download progress
-            emit updateStarted();
-            emit updateProgressChanged();
-        }
+    Q_UNUSED(invalidated);
+    if (interface == RaucInstallerInterface && changed.contains("Operation")) {
+        applyRaucOperation(changed.value("Operation").toString());
     }
+}
 
-    if (newStatus != m_updateStatus || wasUpdateActive != m_isUpdateActive) {
-        m_updateStatus = newStatus;
-        emit updateStatusChanged();
-
-        if (m_updateProgress == 0 && m_isUpdateActive && newStatus != "Installing") {
-            emit updateProgressChanged();
-        }
+void UpdateAgentManager::onRaucOperationReply(QDBusPendingCallWatcher* watcher)
+{
+    QDBusPendingReply<QDBusVariant> reply = *watcher;
+    watcher->deleteLater();
+    if (!reply.isError()) {
+        applyRaucOperation(reply.value().variant().toString());
     }
 }
 
+void UpdateAgentManager::applyRaucOperation(const QString& operation)
+{
+    // Unsubscribed again after Completed, which follows the end of the installation. Subscribing
+    // again only replaces the options, so a subscription the broker lost with a restart is renewed.
+    if (operation == "installing") {
+        subscribeUpdateService();
+    }
+}
 
+void UpdateAgentManager::subscribeUpdateService()
+{
+    m_subscribed = true;
+    QDBusMessage call = QDBusMessage::createMethodCall(UpdateServiceName, UpdateServicePath, UpdateServiceName, "Subscribe");
+    call << QVariantMap();
+    QDBusPendingCallWatcher *watcher = new QDBusPendingCallWatcher(m_dbusConnection.asyncCall(call), this);
+    connect(watcher, &QDBusPendingCallWatcher::finished, this, [this](QDBusPendingCallWatcher *finished) {
+        if (finished->isError()) {
+            m_subscribed = false;
+            DLT_LOG(m_ctx, DLT_LOG_ERROR, DLT_STRING("UpdateService Subscribe failed:"),
+                    DLT_STRING(finished->error().message().toUtf8().constData()));
+        } else {
+            DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Subscribed to UpdateService signals"));
+        }
+        finished->deleteLater();
+    });
+}
 
-
-
-void UpdateAgentManager::onRefreshTimer()
+void UpdateAgentManager::unsubscribeUpdateService()
 {
-    refresh();
+    if (!m_subscribed) {
+        return;
+    }
+    m_subscribed = false;
+    // No reply needed; a broker that is gone dropped the subscription already and must not be started again
+    QDBusMessage call = QDBusMessage::createMethodCall(UpdateServiceName, UpdateServicePath, UpdateServiceName, "Unsubscribe");
+    call.setAutoStartService(false);
+    m_dbusConnection.send(call);
+    DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Unsubscribed from UpdateService signals"));
 }
 
 void UpdateAgentManager::startService()
 {
     DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Starting update-agent service"));
-
-    QProcess* startProcess = new QProcess(this);
-    connect(startProcess, QOverload<int>::of(&QProcess::finished),
-            [this, startProcess](int exitCode) {
-        DLT_LOG(m_ctx, DLT_LOG_INFO,
-                DLT_STRING("Start service result:"),
-                DLT_INT(exitCode));
-        startProcess->deleteLater();
-        // Refresh status after a short delay
-        QTimer::singleShot(1000, this, &UpdateAgentManager::refresh);
-    });
-
-    startProcess->start("systemctl", QStringList() << "start" << "update-agent.service");
+    m_unitWatcher->startUnit();
 }
 
 void UpdateAgentManager::testProgressParsing(const QString& testLine)
@@ -410,6 +346,7 @@ void UpdateAgentManager::handleProgressSignal(int percentage)
 void UpdateAgentManager::handleCompletedSignal(bool success, const QString& message)
 {
     DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Handling completed signal - Success:"), DLT_BOOL(success), DLT_STRING(", Message:"), DLT_STRING(message.toUtf8().constData()));
+    unsubscribeUpdateService();
 
     if (success) {
         // Start Rebooting phase at 80%
@@ -448,23 +385,11 @@ void UpdateAgentManager::handleCompletedSignal(bool success, const QString& mess
 
 void UpdateAgentManager::testRealtimeMonitoring()
 {
-    DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Testing real-time monitoring - Operation polling active"));
+    DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Testing real-time monitoring - D-Bus signals active"));
 }
 
 void UpdateAgentManager::stopService()
 {
     DLT_LOG(m_ctx, DLT_LOG_INFO, DLT_STRING("Stopping update-agent service"));
-
-    QProcess* stopProcess = new QProcess(this);
-    connect(stopProcess, QOverload<int>::of(&QProcess::finished),
-            [this, stopProcess](int exitCode) {
-        DLT_LOG(m_ctx, DLT_LOG_INFO,
-                DLT_STRING("Stop service result:"),
-                DLT_INT(exitCode));
-        stopProcess->deleteLater();
-        // Refresh status after a short delay
-        QTimer::singleShot(1000, this, &UpdateAgentManager::refresh);
-    });
-
-    stopProcess->start("systemctl", QStringList() << "stop" << "update-agent.service");
+    m_unitWatcher->stopUnit();
 }
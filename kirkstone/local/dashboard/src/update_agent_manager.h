@@ -1,13 +1,14 @@
 #pragma once
 #include <QObject>
-#include <QProcess>
 #include <QTimer>
-#include <QFileSystemWatcher>
+#include <QVariantMap>
 #include <QDBusConnection>
 #include <QDBusMessage>
-#include <QDBusConnectionInterface>
 #include <dlt/dlt.h>
 
+class QDBusPendingCallWatcher;
+class SystemdUnitWatcher;
+
 class UpdateAgentManager : public QObject {
     Q_OBJECT
     Q_PROPERTY(bool isUpdateActive READ isUpdateActive NOTIFY updateStatusChanged)
@@ -42,37 +43,35 @@ signals:
     void updateCompleted(bool success, const QString& message);
 
 private slots:
-    void onServiceStatusProcessFinished(int exitCode);
-    void onRefreshTimer();
     void onDBusSignal(const QDBusMessage& message);
+    void onActiveStateChanged();
+    void onRaucPropertiesChanged(const QString& interface, const QVariantMap& changed, const QStringList& invalidated);
+    void onRaucOperationReply(QDBusPendingCallWatcher* watcher);
 
 private:
-    // Service monitoring
+    // Service monitoring (systemd unit ActiveState, pushed)
     bool m_isServiceRunning;
-    QProcess* m_serviceStatusProcess;
-    QTimer* m_refreshTimer;
+    SystemdUnitWatcher* m_unitWatcher;
 
     // Update monitoring
     bool m_isUpdateActive;
     QString m_updateStatus;
     int m_updateProgress;
 
-    // Operation monitoring
-    QString m_currentOperation;
-    QTimer* m_operationPollTimer;
-
     // Rebooting progress timer
     QTimer* m_rebootProgressTimer;
 
-    // D-Bus monitoring
+    // D-Bus monitoring; every call on it is asynchronous
     QDBusConnection m_dbusConnection;
-    bool m_dbusConnected;
+
+    // Subscribed to update-service Progress/Completed; only while RAUC installs, so the broker can exit when idle
+    bool m_subscribed;
 
     // Status management
-    void checkServiceStatus();
     void setupDBusMonitoring();
-    void pollOperation();
-    void updateStatusFromOperation(const QString& operation);
+    void applyRaucOperation(const QString& operation);
+    void subscribeUpdateService();
+    void unsubscribeUpdateService();
     void handleProgressSignal(int percentage);
     void handleCompletedSignal(bool success, const QString& message);
 };
@@ -0,0 +1,128 @@
+/*
+ * grubenv benchmark
+ *
+ * Compares reading one variable and setting two variables through the
+ * grub-editenv subprocess (fork/exec + pipe, as the dashboard and RAUC did)
+ * against the library on a copy of the block in a temporary directory.
+ * The subprocess cases are skipped when grub-editenv is not installed.
+ * Usage: grubenv-bench [iterations] [grub-editenv path]
+ */
+#define _GNU_SOURCE
+#include "grubenv.h"
+
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+extern char **environ;
+
+static double now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/* Runs argv, reading its stdout into out when given; returns the exit status */
+static int run(char *const argv[], char *out, size_t out_size)
+{
+	posix_spawn_file_actions_t actions;
+	int pipefd[2];
+	size_t length = 0;
+	pid_t pid;
+	int status = -1;
+
+	if (pipe(pipefd) != 0)
+		return -1;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_adddup2(&actions, pipefd[1], STDOUT_FILENO);
+	posix_spawn_file_actions_addclose(&actions, pipefd[0]);
+	if (posix_spawn(&pid, argv[0], &actions, NULL, argv, environ) != 0)
+		pid = -1;
+	posix_spawn_file_actions_destroy(&actions);
+	close(pipefd[1]);
+
+	if (pid > 0) {
+		ssize_t n;
+		char discard[256];
+		while ((n = read(pipefd[0], out ? out + length : discard,
+				 out ? out_size - 1 - length : sizeof(discard))) > 0)
+			if (out)
+				length += (size_t) n;
+		if (out)
+			out[length] = '\0';
+		waitpid(pid, &status, 0);
+	}
+	close(pipefd[0]);
+	return pid > 0 && WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+static void report(const char *name, double total_us, int iterations)
+{
+	printf("%-28s %10.1f us/op\n", name, total_us / iterations);
+}
+
+int main(int argc, char **argv)
+{
+	const int iterations = argc > 1 ? atoi(argv[1]) : 200;
+	char *editenv = argc > 2 ? argv[2] : "/usr/bin/grub-editenv";
+	char dir[] = "/tmp/grubenv-bench-XXXXXX";
+	char path[sizeof(dir) + 16];
+	char output[GRUBENV_MAX_SIZE];
+	const char *assignments[] = { "ORDER=B A", "B_OK=1" };
+	grubenv_t env;
+	double start;
+
+	if (iterations <= 0 || !mkdtemp(dir)) {
+		fprintf(stderr, "usage: %s [iterations] [grub-editenv path]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	snprintf(path, sizeof(path), "%s/grubenv", dir);
+	grubenv_init(&env, GRUBENV_DEFAULT_SIZE);
+	grubenv_set(&env, "ORDER", "A B");
+	grubenv_set(&env, "A_OK", "1");
+	grubenv_set(&env, "A_TRY", "0");
+	grubenv_set(&env, "B_OK", "1");
+	grubenv_set(&env, "B_TRY", "0");
+	grubenv_save(&env, path);
+
+	printf("%d iterations on %s\n", iterations, path);
+
+	if (access(editenv, X_OK) == 0) {
+		char *list_argv[] = { editenv, path, "list", NULL };
+		char *set_argv[] = { editenv, path, "set", "ORDER=B A", "B_OK=1", NULL };
+
+		start = now_us();
+		for (int i = 0; i < iterations; i++)
+			run(list_argv, output, sizeof(output));
+		report("get (grub-editenv list)", now_us() - start, iterations);
+
+		start = now_us();
+		for (int i = 0; i < iterations; i++)
+			run(set_argv, NULL, 0);
+		report("set (grub-editenv set)", now_us() - start, iterations);
+	} else {
+		printf("%s not found, skipping the subprocess cases\n", editenv);
+	}
+
+	start = now_us();
+	for (int i = 0; i < iterations; i++) {
+		grubenv_load(&env, path);
+		grubenv_get(&env, "ORDER", output, sizeof(output));
+	}
+	report("get (grubenv_load + get)", now_us() - start, iterations);
+
+	start = now_us();
+	for (int i = 0; i < iterations; i++)
+		grubenv_update(path, assignments, 2);
+	report("set (grubenv_update)", now_us() - start, iterations);
+
+	unlink(path);
+	rmdir(dir);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,82 @@
+/*
+ * grubenv - native reader/writer for the GRUB environment block
+ *
+ * The environment block (/grubenv/grubenv on the NUC images) is a file of
+ * fixed size, normally 1 KiB, that starts with "# GRUB Environment Block\n",
+ * holds one "name=value\n" line per variable and is padded with '#' up to
+ * its size. GRUB itself never grows the file, so neither does this library:
+ * a change that does not fit fails with -ENOSPC.
+ *
+ * Values are escaped the way grub-editenv does it: a backslash or newline
+ * in a value is written with a preceding backslash.
+ *
+ * All functions return 0 (or a length) on success and a negative errno
+ * value on failure. Nothing allocates; a grubenv_t can live on the stack.
+ */
+#ifndef GRUBENV_H
+#define GRUBENV_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GRUBENV_SIGNATURE "# GRUB Environment Block\n"
+#define GRUBENV_DEFAULT_SIZE 1024
+/* Largest block accepted by grubenv_load()/grubenv_parse() */
+#define GRUBENV_MAX_SIZE 4096
+
+typedef struct {
+	char block[GRUBENV_MAX_SIZE];
+	size_t size;
+} grubenv_t;
+
+/* Called for each variable with its unescaped value, in block order.
+ * Returning non-zero stops the iteration. */
+typedef int (*grubenv_foreach_fn)(const char *name, const char *value, void *user_data);
+
+/* Empty block of the given size (GRUBENV_DEFAULT_SIZE for a new file) */
+int grubenv_init(grubenv_t *env, size_t size);
+
+/* Takes a copy of data; -EBADMSG if it is not an environment block */
+int grubenv_parse(grubenv_t *env, const char *data, size_t size);
+
+/* Reads and validates the block at path */
+int grubenv_load(grubenv_t *env, const char *path);
+
+/* Writes the block to a temporary file next to path, fsyncs it, renames it
+ * over path and fsyncs the directory, so path always holds either the old
+ * or the new block */
+int grubenv_save(const grubenv_t *env, const char *path);
+
+/* Copies the unescaped value of name into value (always NUL-terminated) and
+ * returns its length; -ENOENT if the variable is not set, -ENOSPC if
+ * value_size is too small */
+int grubenv_get(const grubenv_t *env, const char *name, char *value, size_t value_size);
+
+/* Sets or replaces a variable in place, keeping the order of the others */
+int grubenv_set(grubenv_t *env, const char *name, const char *value);
+
+/* Same as grubenv_set() for a "name=value" assignment as passed to
+ * grub-editenv set */
+int grubenv_set_assignment(grubenv_t *env, const char *assignment);
+
+/* Removes a variable; -ENOENT if it was not set */
+int grubenv_unset(grubenv_t *env, const char *name);
+
+int grubenv_foreach(const grubenv_t *env, grubenv_foreach_fn fn, void *user_data);
+
+/* Writes "name=value\n" for every variable, like grub-editenv list, and
+ * returns the length; -ENOSPC if out_size is too small */
+int grubenv_list(const grubenv_t *env, char *out, size_t out_size);
+
+/* Loads path, applies each "name=value" assignment and saves it again;
+ * nothing is written unless all of them apply */
+int grubenv_update(const char *path, const char *const *assignments, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GRUBENV_H */
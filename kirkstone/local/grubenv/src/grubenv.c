@@ -0,0 +1,379 @@
+#include "grubenv.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SIGNATURE_LENGTH (sizeof(GRUBENV_SIGNATURE) - 1)
+
+/* Start of the '#' padding: variables and comments end at the last newline
+ * that is followed by nothing but '#' */
+static size_t data_end(const grubenv_t *env)
+{
+	size_t end = env->size;
+
+	while (end > SIGNATURE_LENGTH && env->block[end - 1] == '#')
+		end--;
+	/* A '#' run that does not follow a newline belongs to an unterminated
+	 * line, so there is no free space at all */
+	if (end > SIGNATURE_LENGTH && env->block[end - 1] != '\n')
+		return env->size;
+	return end;
+}
+
+/* Offset just past the newline ending the line at pos; backslashes escape
+ * the next character in variable lines */
+static size_t next_line(const grubenv_t *env, size_t pos, size_t end)
+{
+	const int comment = env->block[pos] == '#';
+
+	while (pos < end) {
+		const char c = env->block[pos++];
+		if (c == '\n')
+			break;
+		if (c == '\\' && !comment && pos < end)
+			pos++;
+	}
+	return pos;
+}
+
+/* Finds the line holding name; start/stop span it including its newline */
+static int find_variable(const grubenv_t *env, const char *name, size_t *start, size_t *stop)
+{
+	const size_t name_length = strlen(name);
+	const size_t end = data_end(env);
+	size_t pos = SIGNATURE_LENGTH;
+
+	while (pos < end) {
+		const size_t next = next_line(env, pos, end);
+		if (next - pos > name_length && env->block[pos + name_length] == '=' &&
+		    memcmp(env->block + pos, name, name_length) == 0) {
+			*start = pos;
+			*stop = next;
+			return 1;
+		}
+		pos = next;
+	}
+	return 0;
+}
+
+/* Unescapes the value of the line [start, stop) into value; returns its
+ * length or -ENOSPC */
+static int copy_value(const grubenv_t *env, size_t start, size_t stop, char *value, size_t value_size)
+{
+	const char *p = (const char *) memchr(env->block + start, '=', stop - start) + 1;
+	const char *end = env->block + stop;
+	size_t length = 0;
+
+	if (end > p && end[-1] == '\n')
+		end--;
+	while (p < end) {
+		if (*p == '\\' && p + 1 < end)
+			p++;
+		if (length + 1 >= value_size)
+			return -ENOSPC;
+		value[length++] = *p++;
+	}
+	if (value_size == 0)
+		return -ENOSPC;
+	value[length] = '\0';
+	return (int) length;
+}
+
+static int valid_name(const char *name)
+{
+	return name && *name && *name != '#' && !strpbrk(name, "=\n");
+}
+
+int grubenv_init(grubenv_t *env, size_t size)
+{
+	if (size < SIGNATURE_LENGTH || size > GRUBENV_MAX_SIZE)
+		return -EINVAL;
+
+	memcpy(env->block, GRUBENV_SIGNATURE, SIGNATURE_LENGTH);
+	memset(env->block + SIGNATURE_LENGTH, '#', size - SIGNATURE_LENGTH);
+	env->size = size;
+	return 0;
+}
+
+int grubenv_parse(grubenv_t *env, const char *data, size_t size)
+{
+	if (size > GRUBENV_MAX_SIZE)
+		return -EFBIG;
+	if (size < SIGNATURE_LENGTH || memcmp(data, GRUBENV_SIGNATURE, SIGNATURE_LENGTH) != 0)
+		return -EBADMSG;
+
+	memcpy(env->block, data, size);
+	env->size = size;
+	return 0;
+}
+
+int grubenv_load(grubenv_t *env, const char *path)
+{
+	char data[GRUBENV_MAX_SIZE + 1];
+	size_t size = 0;
+	int fd;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return -errno;
+
+	/* One byte more than accepted, so an oversized file is noticed */
+	while (size < sizeof(data)) {
+		const ssize_t length = read(fd, data + size, sizeof(data) - size);
+		if (length < 0 && errno == EINTR)
+			continue;
+		if (length < 0) {
+			const int err = -errno;
+			close(fd);
+			return err;
+		}
+		if (length == 0)
+			break;
+		size += (size_t) length;
+	}
+	close(fd);
+
+	return grubenv_parse(env, data, size);
+}
+
+static int write_all(int fd, const char *data, size_t size)
+{
+	while (size > 0) {
+		const ssize_t length = write(fd, data, size);
+		if (length < 0 && errno == EINTR)
+			continue;
+		if (length < 0)
+			return -errno;
+		data += length;
+		size -= (size_t) length;
+	}
+	return 0;
+}
+
+static int sync_directory(const char *path)
+{
+	char dir[PATH_MAX];
+	const char *slash = strrchr(path, '/');
+	int fd;
+	int ret = 0;
+
+	if (!slash) {
+		strcpy(dir, ".");
+	} else if (slash == path) {
+		strcpy(dir, "/");
+	} else {
+		const size_t length = (size_t) (slash - path);
+		if (length >= sizeof(dir))
+			return -ENAMETOOLONG;
+		memcpy(dir, path, length);
+		dir[length] = '\0';
+	}
+
+	fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (fd < 0)
+		return -errno;
+	if (fsync(fd) != 0)
+		ret = -errno;
+	close(fd);
+	return ret;
+}
+
+int grubenv_save(const grubenv_t *env, const char *path)
+{
+	char temp[PATH_MAX];
+	struct stat st;
+	int fd;
+	int ret;
+
+	if (snprintf(temp, sizeof(temp), "%s.XXXXXX", path) >= (int) sizeof(temp))
+		return -ENAMETOOLONG;
+
+	fd = mkstemp(temp);
+	if (fd < 0)
+		return -errno;
+	/* mkstemp() creates 0600; keep the mode of the file being replaced.
+	 * File systems without permissions (vfat) refuse, which is harmless. */
+	(void) fchmod(fd, stat(path, &st) == 0 ? (st.st_mode & 07777) : 0644);
+
+	ret = write_all(fd, env->block, env->size);
+	if (ret == 0 && fsync(fd) != 0)
+		ret = -errno;
+	if (close(fd) != 0 && ret == 0)
+		ret = -errno;
+	if (ret == 0 && rename(temp, path) != 0)
+		ret = -errno;
+	if (ret != 0) {
+		unlink(temp);
+		return ret;
+	}
+
+	return sync_directory(path);
+}
+
+int grubenv_get(const grubenv_t *env, const char *name, char *value, size_t value_size)
+{
+	size_t start;
+	size_t stop;
+
+	if (!valid_name(name))
+		return -EINVAL;
+	if (!find_variable(env, name, &start, &stop))
+		return -ENOENT;
+	return copy_value(env, start, stop, value, value_size);
+}
+
+int grubenv_set(grubenv_t *env, const char *name, const char *value)
+{
+	const size_t name_length = valid_name(name) ? strlen(name) : 0;
+	const size_t end = data_end(env);
+	size_t escaped_length = 0;
+	size_t line_length;
+	size_t start = end;
+	size_t stop = end;
+	char *p;
+
+	if (name_length == 0 || !value)
+		return -EINVAL;
+
+	for (const char *c = value; *c; c++)
+		escaped_length += (*c == '\\' || *c == '\n') ? 2 : 1;
+	line_length = name_length + 1 + escaped_length + 1;
+
+	find_variable(env, name, &start, &stop);
+	if (line_length > (stop - start) + (env->size - end))
+		return -ENOSPC;
+
+	/* Shift whatever follows the old line, then pad what was freed */
+	memmove(env->block + start + line_length, env->block + stop, end - stop);
+	if (start + line_length + (end - stop) < end)
+		memset(env->block + start + line_length + (end - stop), '#',
+		       end - (start + line_length + (end - stop)));
+
+	p = env->block + start;
+	memcpy(p, name, name_length);
+	p += name_length;
+	*p++ = '=';
+	for (const char *c = value; *c; c++) {
+		if (*c == '\\' || *c == '\n')
+			*p++ = '\\';
+		*p++ = *c;
+	}
+	*p = '\n';
+	return 0;
+}
+
+int grubenv_set_assignment(grubenv_t *env, const char *assignment)
+{
+	char name[GRUBENV_MAX_SIZE];
+	const char *equals = assignment ? strchr(assignment, '=') : NULL;
+	const size_t name_length = equals ? (size_t) (equals - assignment) : 0;
+
+	if (name_length == 0 || name_length >= sizeof(name))
+		return -EINVAL;
+
+	memcpy(name, assignment, name_length);
+	name[name_length] = '\0';
+	return grubenv_set(env, name, equals + 1);
+}
+
+int grubenv_unset(grubenv_t *env, const char *name)
+{
+	const size_t end = data_end(env);
+	size_t start;
+	size_t stop;
+
+	if (!valid_name(name))
+		return -EINVAL;
+	if (!find_variable(env, name, &start, &stop))
+		return -ENOENT;
+
+	memmove(env->block + start, env->block + stop, end - stop);
+	memset(env->block + end - (stop - start), '#', stop - start);
+	return 0;
+}
+
+int grubenv_foreach(const grubenv_t *env, grubenv_foreach_fn fn, void *user_data)
+{
+	char name[GRUBENV_MAX_SIZE];
+	char value[GRUBENV_MAX_SIZE];
+	const size_t end = data_end(env);
+	size_t pos = SIGNATURE_LENGTH;
+
+	while (pos < end) {
+		const size_t next = next_line(env, pos, end);
+		const char *equals = memchr(env->block + pos, '=', next - pos);
+
+		/* Comments and lines without '=' are skipped, as GRUB does */
+		if (env->block[pos] != '#' && equals && equals > env->block + pos) {
+			const size_t name_length = (size_t) (equals - (env->block + pos));
+			memcpy(name, env->block + pos, name_length);
+			name[name_length] = '\0';
+			copy_value(env, pos, next, value, sizeof(value));
+			if (fn(name, value, user_data) != 0)
+				break;
+		}
+		pos = next;
+	}
+	return 0;
+}
+
+struct list_buffer {
+	char *out;
+	size_t size;
+	size_t length;
+	int overflow;
+};
+
+static int append_variable(const char *name, const char *value, void *user_data)
+{
+	struct list_buffer *buffer = user_data;
+	const size_t name_length = strlen(name);
+	const size_t value_length = strlen(value);
+
+	if (buffer->length + name_length + value_length + 2 >= buffer->size) {
+		buffer->overflow = 1;
+		return 1;
+	}
+	memcpy(buffer->out + buffer->length, name, name_length);
+	buffer->length += name_length;
+	buffer->out[buffer->length++] = '=';
+	memcpy(buffer->out + buffer->length, value, value_length);
+	buffer->length += value_length;
+	buffer->out[buffer->length++] = '\n';
+	return 0;
+}
+
+int grubenv_list(const grubenv_t *env, char *out, size_t out_size)
+{
+	struct list_buffer buffer = { out, out_size, 0, 0 };
+
+	if (out_size == 0)
+		return -ENOSPC;
+	grubenv_foreach(env, append_variable, &buffer);
+	out[buffer.length] = '\0';
+	return buffer.overflow ? -ENOSPC : (int) buffer.length;
+}
+
+int grubenv_update(const char *path, const char *const *assignments, size_t count)
+{
+	grubenv_t env;
+	int ret;
+
+	ret = grubenv_load(&env, path);
+	if (ret != 0)
+		return ret;
+
+	for (size_t i = 0; i < count; i++) {
+		ret = grubenv_set_assignment(&env, assignments[i]);
+		if (ret != 0)
+			return ret;
+	}
+
+	return grubenv_save(&env, path);
+}
@@ -0,0 +1,174 @@
+/*
+ * grubenv unit tests: block format, in-place edits and the atomic save
+ * Usage: grubenv-tests
+ */
+#include "grubenv.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int failures;
+
+#define CHECK(cond)                                                             \
+	do {                                                                    \
+		if (!(cond)) {                                                  \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,  \
+				__LINE__, #cond);                               \
+			failures++;                                             \
+		}                                                               \
+	} while (0)
+
+/* The block grub-editenv writes for the NUC images */
+static const char reference_block_head[] =
+	"# GRUB Environment Block\n"
+	"ORDER=A B\n"
+	"A_OK=1\n"
+	"A_TRY=0\n"
+	"B_OK=1\n"
+	"B_TRY=0\n";
+
+static void make_reference(char *data, size_t size)
+{
+	memset(data, '#', size);
+	memcpy(data, reference_block_head, sizeof(reference_block_head) - 1);
+}
+
+static void test_parse_and_get(void)
+{
+	char data[GRUBENV_DEFAULT_SIZE];
+	char value[64];
+	grubenv_t env;
+
+	make_reference(data, sizeof(data));
+	CHECK(grubenv_parse(&env, data, sizeof(data)) == 0);
+	CHECK(grubenv_get(&env, "ORDER", value, sizeof(value)) == 3);
+	CHECK(strcmp(value, "A B") == 0);
+	CHECK(grubenv_get(&env, "B_TRY", value, sizeof(value)) == 1);
+	CHECK(strcmp(value, "0") == 0);
+	CHECK(grubenv_get(&env, "B", value, sizeof(value)) == -ENOENT);
+	CHECK(grubenv_get(&env, "ORDER", value, 3) == -ENOSPC);
+	CHECK(grubenv_get(&env, "A=B", value, sizeof(value)) == -EINVAL);
+
+	CHECK(grubenv_parse(&env, "# GRUB Environment", 18) == -EBADMSG);
+}
+
+static void test_set_keeps_order_and_size(void)
+{
+	char data[GRUBENV_DEFAULT_SIZE];
+	char list[GRUBENV_DEFAULT_SIZE];
+	grubenv_t env;
+
+	make_reference(data, sizeof(data));
+	grubenv_parse(&env, data, sizeof(data));
+
+	CHECK(grubenv_set(&env, "ORDER", "B A") == 0);
+	CHECK(grubenv_set(&env, "A_TRY", "12") == 0);
+	CHECK(grubenv_set(&env, "A_OK", "") == 0);
+	CHECK(grubenv_set_assignment(&env, "next_entry=rescue") == 0);
+	CHECK(env.size == GRUBENV_DEFAULT_SIZE);
+	CHECK(env.block[env.size - 1] == '#');
+
+	CHECK(grubenv_list(&env, list, sizeof(list)) > 0);
+	CHECK(strcmp(list, "ORDER=B A\nA_OK=\nA_TRY=12\nB_OK=1\nB_TRY=0\nnext_entry=rescue\n") == 0);
+
+	CHECK(grubenv_unset(&env, "A_TRY") == 0);
+	CHECK(grubenv_unset(&env, "A_TRY") == -ENOENT);
+	grubenv_list(&env, list, sizeof(list));
+	CHECK(strcmp(list, "ORDER=B A\nA_OK=\nB_OK=1\nB_TRY=0\nnext_entry=rescue\n") == 0);
+	/* The freed bytes become padding again */
+	CHECK(env.block[strlen(GRUBENV_SIGNATURE) + strlen(list)] == '#');
+}
+
+static void test_escaping(void)
+{
+	char value[64];
+	grubenv_t env;
+
+	grubenv_init(&env, GRUBENV_DEFAULT_SIZE);
+	CHECK(grubenv_set(&env, "cmdline", "a\\b\nc") == 0);
+	CHECK(memcmp(env.block + strlen(GRUBENV_SIGNATURE), "cmdline=a\\\\b\\\nc\n", 16) == 0);
+	CHECK(grubenv_set(&env, "after", "x") == 0);
+	CHECK(grubenv_get(&env, "cmdline", value, sizeof(value)) == 5);
+	CHECK(strcmp(value, "a\\b\nc") == 0);
+	/* The escaped newline must not start a new variable */
+	CHECK(grubenv_get(&env, "c", value, sizeof(value)) == -ENOENT);
+	CHECK(grubenv_get(&env, "after", value, sizeof(value)) == 1);
+}
+
+static void test_full_block(void)
+{
+	char big[GRUBENV_DEFAULT_SIZE];
+	grubenv_t env;
+	grubenv_t before;
+
+	grubenv_init(&env, GRUBENV_DEFAULT_SIZE);
+	CHECK(grubenv_set(&env, "ORDER", "A B") == 0);
+	before = env;
+
+	memset(big, 'x', sizeof(big) - 1);
+	big[sizeof(big) - 1] = '\0';
+	CHECK(grubenv_set(&env, "huge", big) == -ENOSPC);
+	CHECK(memcmp(&env, &before, sizeof(env)) == 0);
+
+	/* Exactly filling the block leaves no padding at all */
+	big[GRUBENV_DEFAULT_SIZE - strlen(GRUBENV_SIGNATURE) - strlen("ORDER=A B\n") - strlen("f=\n")] = '\0';
+	CHECK(grubenv_set(&env, "f", big) == 0);
+	CHECK(env.block[env.size - 1] == '\n');
+	CHECK(grubenv_set(&env, "g", "") == -ENOSPC);
+	CHECK(grubenv_unset(&env, "f") == 0);
+	CHECK(grubenv_set(&env, "g", "") == 0);
+}
+
+static void test_save_and_update(void)
+{
+	char dir[] = "/tmp/grubenv-test-XXXXXX";
+	char path[sizeof(dir) + 16];
+	char value[16];
+	const char *assignments[] = { "ORDER=B A", "B_OK=1" };
+	const char *bad[] = { "ORDER=A B", "novalue" };
+	grubenv_t env;
+	struct stat st;
+
+	CHECK(mkdtemp(dir) != NULL);
+	snprintf(path, sizeof(path), "%s/grubenv", dir);
+
+	grubenv_init(&env, GRUBENV_DEFAULT_SIZE);
+	grubenv_set(&env, "ORDER", "A B");
+	CHECK(grubenv_save(&env, path) == 0);
+	CHECK(stat(path, &st) == 0 && st.st_size == GRUBENV_DEFAULT_SIZE);
+
+	CHECK(grubenv_update(path, assignments, 2) == 0);
+	CHECK(grubenv_load(&env, path) == 0);
+	CHECK(grubenv_get(&env, "ORDER", value, sizeof(value)) == 3 && strcmp(value, "B A") == 0);
+	CHECK(grubenv_get(&env, "B_OK", value, sizeof(value)) == 1);
+
+	/* A bad assignment leaves the file untouched */
+	CHECK(grubenv_update(path, bad, 2) == -EINVAL);
+	CHECK(grubenv_load(&env, path) == 0);
+	CHECK(grubenv_get(&env, "ORDER", value, sizeof(value)) == 3 && strcmp(value, "B A") == 0);
+
+	CHECK(grubenv_load(&env, "/nonexistent/grubenv") == -ENOENT);
+
+	unlink(path);
+	rmdir(dir);
+}
+
+int main(void)
+{
+	test_parse_and_get();
+	test_set_keeps_order_and_size();
+	test_escaping();
+	test_full_block();
+	test_save_and_update();
+
+	if (failures) {
+		fprintf(stderr, "%d check(s) failed\n", failures);
+		return EXIT_FAILURE;
+	}
+	printf("All grubenv tests passed\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,120 @@
+/**
+ * Request latency microbenchmark against a local HTTP stand-in
+ *
+ * Compares the request patterns the agents used before the shared client
+ * (fresh handle, or curl_easy_reset plus full setopt per request) with a
+ * persistent CurlTransport. Usage: http-client-bench [requests] [body bytes]
+ */
+#include "http_client.h"
+#include "local_http_server.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Request = std::function<void()>;
+using Scenario = std::function<Request(const std::string& url)>;
+
+size_t discard(char*, size_t size, size_t nmemb, void*) {
+    return size * nmemb;
+}
+
+// Options the agents set on every request before the shared client
+void configureLegacy(CURL* handle, const std::string& url) {
+    curl_easy_setopt(handle, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, discard);
+    curl_easy_setopt(handle, CURLOPT_TIMEOUT, 30L);
+    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(handle, CURLOPT_SSL_VERIFYHOST, 0L);
+    curl_easy_setopt(handle, CURLOPT_USERAGENT, "host-updater-cpp/1.0");
+}
+
+void run(const char* name, int requests, const std::string& body, const Scenario& scenario) {
+    LocalHttpServer server([&body](const std::string&, const std::string&) {
+        return LocalHttpServer::response(200, body);
+    });
+    if (!server.start()) {
+        fprintf(stderr, "Failed to start local HTTP server\n");
+        exit(1);
+    }
+
+    Request request = scenario(server.url("/controller/v1/bench"));
+    request();  // Warm-up, not measured
+
+    std::vector<double> samples_us;
+    samples_us.reserve(requests);
+    for (int i = 0; i < requests; ++i) {
+        auto start = Clock::now();
+        request();
+        samples_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+    request = nullptr;
+    int connections = server.connections();
+    server.stop();
+
+    std::sort(samples_us.begin(), samples_us.end());
+    double sum = 0.0;
+    for (double sample : samples_us) {
+        sum += sample;
+    }
+    size_t count = samples_us.size();
+    printf("%-20s n=%-6zu mean=%8.1f us  p50=%8.1f us  p99=%8.1f us  connections=%d\n", name, count, sum / count,
+           samples_us[count / 2], samples_us[std::min(count - 1, count * 99 / 100)], connections);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int requests = argc > 1 ? atoi(argv[1]) : 2000;
+    size_t body_size = argc > 2 ? static_cast<size_t>(atoi(argv[2])) : 1024;
+    if (requests <= 0) {
+        fprintf(stderr, "Usage: %s [requests] [body bytes]\n", argv[0]);
+        return 1;
+    }
+    std::string body(body_size, 'x');
+    HttpGlobalInit global_init;
+
+    run("fresh handle", requests, body, [](const std::string& url) -> Request {
+        return [url]() {
+            CURL* handle = curl_easy_init();
+            configureLegacy(handle, url);
+            curl_easy_perform(handle);
+            curl_easy_cleanup(handle);
+        };
+    });
+
+    run("reset per request", requests, body, [](const std::string& url) -> Request {
+        std::shared_ptr<CURL> handle(curl_easy_init(), curl_easy_cleanup);
+        return [url, handle]() {
+            curl_easy_reset(handle.get());
+            configureLegacy(handle.get(), url);
+            curl_easy_perform(handle.get());
+        };
+    });
+
+    run("CurlTransport", requests, body, [](const std::string& url) -> Request {
+        std::shared_ptr<HttpClient> client(new HttpClient(std::unique_ptr<HttpTransport>(new CurlTransport())));
+        std::shared_ptr<HttpResponse> response(new HttpResponse());
+        return [url, client, response]() {
+            client->get(url, *response);
+        };
+    });
+
+    run("CurlTransport+share", requests, body, [](const std::string& url) -> Request {
+        auto share = std::make_shared<HttpShare>();
+        std::shared_ptr<HttpClient> client(new HttpClient(std::unique_ptr<HttpTransport>(new CurlTransport(HttpClientOptions(), share))));
+        std::shared_ptr<HttpResponse> response(new HttpResponse());
+        return [url, client, response]() {
+            client->get(url, *response);
+        };
+    });
+
+    return 0;
+}
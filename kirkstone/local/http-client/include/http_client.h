@@ -0,0 +1,192 @@
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <cstdio>
+#include <cstdint>
+#include <initializer_list>
+#include <functional>
+#include <curl/curl.h>
+
+// Process-wide curl_global_init/cleanup, reference counted
+class HttpGlobalInit {
+public:
+    HttpGlobalInit();
+    ~HttpGlobalInit();
+};
+
+// Header list built once and reused across requests (wraps curl_slist)
+class HttpHeaderList {
+public:
+    HttpHeaderList() : list_(nullptr) {}
+    HttpHeaderList(std::initializer_list<const char*> headers);
+    ~HttpHeaderList();
+
+    HttpHeaderList(const HttpHeaderList&) = delete;
+    HttpHeaderList& operator=(const HttpHeaderList&) = delete;
+
+    void append(const std::string& header);
+    void clear();
+    bool empty() const { return list_ == nullptr; }
+    curl_slist* get() const { return list_; }
+
+private:
+    curl_slist* list_;
+};
+
+// Passed to HttpRequest::progress during a transfer
+struct HttpTransferStatus {
+    uint64_t downloaded;
+    uint64_t total;                   // 0 if unknown
+    long rtt_us;                      // Kernel smoothed RTT of the active connection, 0 if unknown
+    curl_off_t max_recv_speed;        // In/out: receive limit in bytes/s, applied immediately, 0 = unlimited
+
+    HttpTransferStatus() : downloaded(0), total(0), rtt_us(0), max_recv_speed(0) {}
+};
+
+struct HttpRequest {
+    enum class Method { Get, Post };
+
+    Method method;
+    std::string url;
+    std::string body;                 // POST payload
+    const HttpHeaderList* headers;    // Optional, owned by the caller
+    FILE* output_file;                // Stream the body to a file instead of HttpResponse::body
+    std::function<bool(const char*, size_t)> body_sink;  // Receives body chunks as they arrive instead of
+                                                          // HttpResponse::body; return false to abort
+    long timeout_seconds;
+    long connect_timeout_seconds;
+    long low_speed_limit;             // Bytes/s, 0 disables the low speed abort
+    long low_speed_time;
+    bool follow_redirects;
+    curl_off_t max_recv_speed;        // Bytes/s, 0 = unlimited
+    std::function<bool(HttpTransferStatus&)> progress;  // Return false to abort the transfer
+
+    HttpRequest()
+        : method(Method::Get), headers(nullptr), output_file(nullptr), timeout_seconds(30),
+          connect_timeout_seconds(30), low_speed_limit(0), low_speed_time(0), follow_redirects(true),
+          max_recv_speed(0) {}
+};
+
+struct HttpResponse {
+    long status_code;
+    std::string body;
+    std::string etag;
+    uint64_t bytes_received;          // Headers + body
+    bool connection_reused;
+    double total_time_seconds;
+    std::string error;
+
+    HttpResponse() : status_code(0), bytes_received(0), connection_reused(false), total_time_seconds(0.0) {}
+    void clear();
+};
+
+/**
+ * @brief Transport used by HttpClient
+ *
+ * CurlTransport is the production implementation; tests substitute a fake
+ * transport to run the agents without a network.
+ */
+class HttpTransport {
+public:
+    virtual ~HttpTransport() = default;
+
+    // Returns false on transport errors (no HTTP status). HTTP errors are reported via status_code.
+    virtual bool perform(const HttpRequest& request, HttpResponse& response) = 0;
+};
+
+/**
+ * @brief DNS cache and TLS sessions shared between handles
+ *
+ * A single share can be used from several threads; each CurlTransport keeps
+ * its own easy handle and connections, the share serializes access to the
+ * cached data.
+ */
+class HttpShare {
+public:
+    HttpShare();
+    ~HttpShare();
+
+    HttpShare(const HttpShare&) = delete;
+    HttpShare& operator=(const HttpShare&) = delete;
+
+    CURLSH* get() const { return share_; }
+
+private:
+    HttpGlobalInit global_init_;
+    CURLSH* share_;
+    std::mutex locks_[CURL_LOCK_DATA_LAST];
+
+    static void lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlock(CURL* handle, curl_lock_data data, void* userptr);
+};
+
+struct HttpClientOptions {
+    std::string user_agent;
+    bool verify_ssl;
+    long tcp_keepidle_seconds;
+    long tcp_keepintvl_seconds;
+    long dns_cache_timeout_seconds;
+    long max_connects;
+
+    HttpClientOptions()
+        : user_agent("host-updater-cpp/1.0"), verify_ssl(false), tcp_keepidle_seconds(120),
+          tcp_keepintvl_seconds(60), dns_cache_timeout_seconds(300), max_connects(4) {}
+};
+
+/**
+ * @brief libcurl transport with persistent keep-alive connections
+ *
+ * The easy handle is configured once and never reset, so connections,
+ * resolved addresses and TLS sessions survive between requests. Per
+ * request only the URL, method, body, headers and sinks are updated.
+ * Not thread safe: use one transport per thread, optionally sharing an
+ * HttpShare.
+ */
+class CurlTransport : public HttpTransport {
+public:
+    explicit CurlTransport(const HttpClientOptions& options = HttpClientOptions(),
+                           std::shared_ptr<HttpShare> share = nullptr);
+    ~CurlTransport() override;
+
+    CurlTransport(const CurlTransport&) = delete;
+    CurlTransport& operator=(const CurlTransport&) = delete;
+
+    bool isValid() const { return handle_ != nullptr; }
+    bool perform(const HttpRequest& request, HttpResponse& response) override;
+
+private:
+    HttpGlobalInit global_init_;
+    CURL* handle_;
+    std::shared_ptr<HttpShare> share_;
+
+    void applyPersistentOptions(const HttpClientOptions& options);
+    static size_t writeString(char* data, size_t size, size_t nmemb, void* userp);
+    static size_t writeFile(char* data, size_t size, size_t nmemb, void* userp);
+    static size_t writeSink(char* data, size_t size, size_t nmemb, void* userp);
+    static size_t headerCallback(char* buffer, size_t size, size_t nitems, void* userp);
+    static int progressCallback(void* userp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t ultotal, curl_off_t ulnow);
+};
+
+/**
+ * @brief Small request helper on top of an HttpTransport
+ */
+class HttpClient {
+public:
+    explicit HttpClient(std::unique_ptr<HttpTransport> transport);
+
+    bool get(const std::string& url, HttpResponse& response, long timeout_seconds = 30,
+             const HttpHeaderList* headers = nullptr);
+    bool postJson(const std::string& url, const std::string& json, HttpResponse& response, long timeout_seconds = 30);
+    bool perform(const HttpRequest& request, HttpResponse& response);
+
+    HttpTransport& transport() { return *transport_; }
+
+private:
+    std::unique_ptr<HttpTransport> transport_;
+    HttpHeaderList json_headers_;
+};
+
+#endif // HTTP_CLIENT_H
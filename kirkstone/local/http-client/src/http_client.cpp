@@ -0,0 +1,314 @@
+#include "http_client.h"
+#include <dlt/dlt.h>
+#include <strings.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+DLT_DECLARE_CONTEXT(dlt_context_http);
+
+namespace {
+
+std::mutex g_global_mutex;
+int g_global_refs = 0;
+
+struct ProgressContext {
+    CURL* handle;
+    const HttpRequest* request;
+    curl_off_t max_recv_speed;
+};
+
+long activeSocketRtt(CURL* handle) {
+    curl_socket_t sock = CURL_SOCKET_BAD;
+    if (curl_easy_getinfo(handle, CURLINFO_ACTIVESOCKET, &sock) != CURLE_OK || sock == CURL_SOCKET_BAD) {
+        return 0;
+    }
+    struct tcp_info info;
+    socklen_t len = sizeof(info);
+    if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, &info, &len) != 0) {
+        return 0;
+    }
+    return static_cast<long>(info.tcpi_rtt);
+}
+
+} // namespace
+
+HttpGlobalInit::HttpGlobalInit() {
+    std::lock_guard<std::mutex> lock(g_global_mutex);
+    if (g_global_refs++ == 0) {
+        curl_global_init(CURL_GLOBAL_ALL);
+        DLT_REGISTER_CONTEXT(dlt_context_http, "HTTP", "Shared HTTP Client");
+    }
+}
+
+HttpGlobalInit::~HttpGlobalInit() {
+    std::lock_guard<std::mutex> lock(g_global_mutex);
+    if (--g_global_refs == 0) {
+        DLT_UNREGISTER_CONTEXT(dlt_context_http);
+        curl_global_cleanup();
+    }
+}
+
+HttpHeaderList::HttpHeaderList(std::initializer_list<const char*> headers) : list_(nullptr) {
+    for (const char* header : headers) {
+        list_ = curl_slist_append(list_, header);
+    }
+}
+
+HttpHeaderList::~HttpHeaderList() {
+    clear();
+}
+
+void HttpHeaderList::append(const std::string& header) {
+    curl_slist* appended = curl_slist_append(list_, header.c_str());
+    if (appended) {
+        list_ = appended;
+    }
+}
+
+void HttpHeaderList::clear() {
+    curl_slist_free_all(list_);
+    list_ = nullptr;
+}
+
+void HttpResponse::clear() {
+    status_code = 0;
+    body.clear();
+    etag.clear();
+    bytes_received = 0;
+    connection_reused = false;
+    total_time_seconds = 0.0;
+    error.clear();
+}
+
+HttpShare::HttpShare() : share_(curl_share_init()) {
+    if (!share_) {
+        return;
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &HttpShare::lock);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &HttpShare::unlock);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    // No CURL_LOCK_DATA_CONNECT: libcurl does not support a connection cache shared between
+    // threads, and each easy handle keeps its own connections alive anyway
+}
+
+HttpShare::~HttpShare() {
+    if (share_) {
+        curl_share_cleanup(share_);
+    }
+}
+
+void HttpShare::lock(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<HttpShare*>(userptr)->locks_[data].lock();
+}
+
+void HttpShare::unlock(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<HttpShare*>(userptr)->locks_[data].unlock();
+}
+
+CurlTransport::CurlTransport(const HttpClientOptions& options, std::shared_ptr<HttpShare> share)
+    : handle_(curl_easy_init()), share_(share) {
+    if (!handle_) {
+        DLT_LOG(dlt_context_http, DLT_LOG_ERROR, DLT_STRING("Failed to initialize CURL handle"));
+        return;
+    }
+    applyPersistentOptions(options);
+}
+
+CurlTransport::~CurlTransport() {
+    if (handle_) {
+        curl_easy_cleanup(handle_);
+    }
+}
+
+void CurlTransport::applyPersistentOptions(const HttpClientOptions& options) {
+    // Set once: a reset would drop these along with the per-request state
+    curl_easy_setopt(handle_, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(handle_, CURLOPT_NOPROGRESS, 1L);
+    curl_easy_setopt(handle_, CURLOPT_USERAGENT, options.user_agent.c_str());
+    curl_easy_setopt(handle_, CURLOPT_SSL_VERIFYPEER, options.verify_ssl ? 1L : 0L);
+    curl_easy_setopt(handle_, CURLOPT_SSL_VERIFYHOST, options.verify_ssl ? 2L : 0L);
+    curl_easy_setopt(handle_, CURLOPT_SSL_SESSIONID_CACHE, 1L);
+    curl_easy_setopt(handle_, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle_, CURLOPT_TCP_KEEPIDLE, options.tcp_keepidle_seconds);
+    curl_easy_setopt(handle_, CURLOPT_TCP_KEEPINTVL, options.tcp_keepintvl_seconds);
+    curl_easy_setopt(handle_, CURLOPT_DNS_CACHE_TIMEOUT, options.dns_cache_timeout_seconds);
+    curl_easy_setopt(handle_, CURLOPT_MAXCONNECTS, options.max_connects);
+    curl_easy_setopt(handle_, CURLOPT_MAXREDIRS, 3L);
+    curl_easy_setopt(handle_, CURLOPT_HEADERFUNCTION, &CurlTransport::headerCallback);
+    if (share_ && share_->get()) {
+        curl_easy_setopt(handle_, CURLOPT_SHARE, share_->get());
+    }
+}
+
+size_t CurlTransport::writeString(char* data, size_t size, size_t nmemb, void* userp) {
+    size_t total_size = size * nmemb;
+    try {
+        static_cast<std::string*>(userp)->append(data, total_size);
+    } catch (...) {
+        return 0;
+    }
+    return total_size;
+}
+
+size_t CurlTransport::writeFile(char* data, size_t size, size_t nmemb, void* userp) {
+    return fwrite(data, size, nmemb, static_cast<FILE*>(userp));
+}
+
+size_t CurlTransport::writeSink(char* data, size_t size, size_t nmemb, void* userp) {
+    size_t total_size = size * nmemb;
+    const HttpRequest* request = static_cast<const HttpRequest*>(userp);
+    return request->body_sink(data, total_size) ? total_size : 0;
+}
+
+size_t CurlTransport::headerCallback(char* buffer, size_t size, size_t nitems, void* userp) {
+    size_t total_size = size * nitems;
+    HttpResponse* response = static_cast<HttpResponse*>(userp);
+
+    // A new status line starts a new header block (redirects, 100-continue)
+    if (total_size > 5 && strncasecmp(buffer, "HTTP/", 5) == 0) {
+        response->etag.clear();
+        return total_size;
+    }
+
+    static const char kEtagHeader[] = "etag:";
+    const size_t prefix_len = sizeof(kEtagHeader) - 1;
+    if (total_size > prefix_len && strncasecmp(buffer, kEtagHeader, prefix_len) == 0) {
+        size_t begin = prefix_len;
+        size_t end = total_size;
+        while (begin < end && (buffer[begin] == ' ' || buffer[begin] == '\t')) begin++;
+        while (end > begin && (buffer[end - 1] == '\r' || buffer[end - 1] == '\n' || buffer[end - 1] == ' ')) end--;
+        response->etag.assign(buffer + begin, end - begin);
+    }
+    return total_size;
+}
+
+int CurlTransport::progressCallback(void* userp, curl_off_t dltotal, curl_off_t dlnow, curl_off_t, curl_off_t) {
+    ProgressContext* context = static_cast<ProgressContext*>(userp);
+
+    HttpTransferStatus status;
+    status.downloaded = static_cast<uint64_t>(dlnow);
+    status.total = static_cast<uint64_t>(dltotal);
+    status.rtt_us = activeSocketRtt(context->handle);
+    status.max_recv_speed = context->max_recv_speed;
+
+    if (!context->request->progress(status)) {
+        return 1;  // Aborts with CURLE_ABORTED_BY_CALLBACK
+    }
+
+    // libcurl reads the limit on every rate check, so a change takes effect mid-transfer
+    if (status.max_recv_speed != context->max_recv_speed) {
+        context->max_recv_speed = status.max_recv_speed;
+        curl_easy_setopt(context->handle, CURLOPT_MAX_RECV_SPEED_LARGE, context->max_recv_speed);
+    }
+    return 0;
+}
+
+bool CurlTransport::perform(const HttpRequest& request, HttpResponse& response) {
+    response.clear();
+
+    if (!handle_) {
+        response.error = "CURL handle not initialized";
+        return false;
+    }
+
+    curl_easy_setopt(handle_, CURLOPT_URL, request.url.c_str());
+
+    if (request.method == HttpRequest::Method::Post) {
+        curl_easy_setopt(handle_, CURLOPT_POST, 1L);
+        curl_easy_setopt(handle_, CURLOPT_POSTFIELDSIZE, static_cast<long>(request.body.size()));
+        curl_easy_setopt(handle_, CURLOPT_POSTFIELDS, request.body.c_str());
+    } else {
+        curl_easy_setopt(handle_, CURLOPT_HTTPGET, 1L);
+    }
+
+    curl_easy_setopt(handle_, CURLOPT_HTTPHEADER, request.headers ? request.headers->get() : nullptr);
+
+    if (request.output_file) {
+        curl_easy_setopt(handle_, CURLOPT_WRITEFUNCTION, &CurlTransport::writeFile);
+        curl_easy_setopt(handle_, CURLOPT_WRITEDATA, request.output_file);
+    } else if (request.body_sink) {
+        curl_easy_setopt(handle_, CURLOPT_WRITEFUNCTION, &CurlTransport::writeSink);
+        curl_easy_setopt(handle_, CURLOPT_WRITEDATA, &request);
+    } else {
+        curl_easy_setopt(handle_, CURLOPT_WRITEFUNCTION, &CurlTransport::writeString);
+        curl_easy_setopt(handle_, CURLOPT_WRITEDATA, &response.body);
+    }
+    curl_easy_setopt(handle_, CURLOPT_HEADERDATA, &response);
+
+    curl_easy_setopt(handle_, CURLOPT_TIMEOUT, request.timeout_seconds);
+    curl_easy_setopt(handle_, CURLOPT_CONNECTTIMEOUT, request.connect_timeout_seconds);
+    curl_easy_setopt(handle_, CURLOPT_LOW_SPEED_LIMIT, request.low_speed_limit);
+    curl_easy_setopt(handle_, CURLOPT_LOW_SPEED_TIME, request.low_speed_time);
+    curl_easy_setopt(handle_, CURLOPT_FOLLOWLOCATION, request.follow_redirects ? 1L : 0L);
+    curl_easy_setopt(handle_, CURLOPT_MAX_RECV_SPEED_LARGE, request.max_recv_speed);
+
+    ProgressContext progress_context = { handle_, &request, request.max_recv_speed };
+    if (request.progress) {
+        curl_easy_setopt(handle_, CURLOPT_XFERINFOFUNCTION, &CurlTransport::progressCallback);
+        curl_easy_setopt(handle_, CURLOPT_XFERINFODATA, &progress_context);
+        curl_easy_setopt(handle_, CURLOPT_NOPROGRESS, 0L);
+    }
+
+    CURLcode res = curl_easy_perform(handle_);
+
+    if (request.progress) {
+        curl_easy_setopt(handle_, CURLOPT_NOPROGRESS, 1L);
+        curl_easy_setopt(handle_, CURLOPT_XFERINFODATA, nullptr);
+    }
+    curl_easy_setopt(handle_, CURLOPT_MAX_RECV_SPEED_LARGE, static_cast<curl_off_t>(0));
+
+    // Do not keep pointers to caller-owned data past this call
+    curl_easy_setopt(handle_, CURLOPT_HTTPHEADER, nullptr);
+    curl_easy_setopt(handle_, CURLOPT_POSTFIELDS, nullptr);
+    curl_easy_setopt(handle_, CURLOPT_WRITEDATA, nullptr);
+    curl_easy_setopt(handle_, CURLOPT_HEADERDATA, nullptr);
+
+    curl_off_t body_size = 0;
+    long header_size = 0;
+    long new_connects = 0;
+    curl_easy_getinfo(handle_, CURLINFO_SIZE_DOWNLOAD_T, &body_size);
+    curl_easy_getinfo(handle_, CURLINFO_HEADER_SIZE, &header_size);
+    curl_easy_getinfo(handle_, CURLINFO_NUM_CONNECTS, &new_connects);
+    curl_easy_getinfo(handle_, CURLINFO_TOTAL_TIME, &response.total_time_seconds);
+    response.bytes_received = static_cast<uint64_t>(body_size) + static_cast<uint64_t>(header_size);
+    response.connection_reused = new_connects == 0;
+
+    if (res != CURLE_OK) {
+        response.error = curl_easy_strerror(res);
+        DLT_LOG(dlt_context_http, DLT_LOG_ERROR, DLT_STRING("curl_easy_perform() failed: "), DLT_STRING(response.error.c_str()));
+        return false;
+    }
+
+    curl_easy_getinfo(handle_, CURLINFO_RESPONSE_CODE, &response.status_code);
+    DLT_LOG(dlt_context_http, DLT_LOG_DEBUG, DLT_STRING("HTTP "), DLT_INT(response.status_code),
+            DLT_STRING(" reused: "), DLT_BOOL(response.connection_reused), DLT_STRING(" url: "), DLT_STRING(request.url.c_str()));
+    return true;
+}
+
+HttpClient::HttpClient(std::unique_ptr<HttpTransport> transport)
+    : transport_(std::move(transport)), json_headers_{"Content-Type: application/json"} {}
+
+bool HttpClient::get(const std::string& url, HttpResponse& response, long timeout_seconds, const HttpHeaderList* headers) {
+    HttpRequest request;
+    request.url = url;
+    request.headers = headers;
+    request.timeout_seconds = timeout_seconds;
+    return transport_->perform(request, response);
+}
+
+bool HttpClient::postJson(const std::string& url, const std::string& json, HttpResponse& response, long timeout_seconds) {
+    HttpRequest request;
+    request.method = HttpRequest::Method::Post;
+    request.url = url;
+    request.body = json;
+    request.headers = &json_headers_;
+    request.timeout_seconds = timeout_seconds;
+    return transport_->perform(request, response);
+}
+
+bool HttpClient::perform(const HttpRequest& request, HttpResponse& response) {
+    return transport_->perform(request, response);
+}
@@ -0,0 +1,176 @@
+#ifndef LOCAL_HTTP_SERVER_H
+#define LOCAL_HTTP_SERVER_H
+
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @brief Minimal HTTP/1.1 stand-in on 127.0.0.1 for tests and benchmarks
+ *
+ * Supports keep-alive and Content-Length bodies, one thread per connection.
+ * The handler receives the raw request head and body and returns the
+ * complete response (status line, headers and body).
+ */
+class LocalHttpServer {
+public:
+    using Handler = std::function<std::string(const std::string& head, const std::string& body)>;
+
+    explicit LocalHttpServer(Handler handler)
+        : handler_(handler), listen_fd_(-1), port_(0), running_(false), connections_(0), requests_(0) {}
+
+    ~LocalHttpServer() { stop(); }
+
+    static std::string response(int status, const std::string& body, const std::string& extra_headers = "") {
+        return "HTTP/1.1 " + std::to_string(status) + (status == 200 ? " OK" : " Status") + "\r\n" +
+               "Content-Length: " + std::to_string(body.size()) + "\r\n" + extra_headers + "\r\n" + body;
+    }
+
+    bool start() {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (listen_fd_ < 0) {
+            return false;
+        }
+        int one = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        if (bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(listen_fd_, 16) != 0) {
+            close(listen_fd_);
+            listen_fd_ = -1;
+            return false;
+        }
+
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+
+        running_ = true;
+        accept_thread_ = std::thread(&LocalHttpServer::acceptLoop, this);
+        return true;
+    }
+
+    void stop() {
+        if (!running_.exchange(false)) {
+            return;
+        }
+        shutdown(listen_fd_, SHUT_RDWR);
+        close(listen_fd_);
+        accept_thread_.join();
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+        workers_.clear();
+    }
+
+    std::string url(const std::string& path = "/") const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    int connections() const { return connections_; }
+    int requests() const { return requests_; }
+
+private:
+    Handler handler_;
+    int listen_fd_;
+    int port_;
+    std::atomic<bool> running_;
+    std::atomic<int> connections_;
+    std::atomic<int> requests_;
+    std::thread accept_thread_;
+    std::mutex mutex_;
+    std::vector<std::thread> workers_;
+
+    void acceptLoop() {
+        while (running_) {
+            pollfd pfd = { listen_fd_, POLLIN, 0 };
+            if (poll(&pfd, 1, 100) <= 0) {
+                continue;
+            }
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                continue;
+            }
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            connections_++;
+            std::lock_guard<std::mutex> lock(mutex_);
+            workers_.emplace_back(&LocalHttpServer::serveConnection, this, fd);
+        }
+    }
+
+    void serveConnection(int fd) {
+        std::string buffer;
+        char chunk[4096];
+
+        while (running_) {
+            size_t head_end = buffer.find("\r\n\r\n");
+            if (head_end == std::string::npos) {
+                pollfd pfd = { fd, POLLIN, 0 };
+                if (poll(&pfd, 1, 100) <= 0) {
+                    continue;
+                }
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    break;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+                continue;
+            }
+
+            std::string head = buffer.substr(0, head_end);
+            size_t content_length = 0;
+            size_t pos = head.find("Content-Length:");
+            if (pos == std::string::npos) {
+                pos = head.find("content-length:");
+            }
+            if (pos != std::string::npos) {
+                content_length = std::stoul(head.substr(pos + 15));
+            }
+
+            size_t total = head_end + 4 + content_length;
+            while (buffer.size() < total) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    close(fd);
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+
+            std::string body = buffer.substr(head_end + 4, content_length);
+            buffer.erase(0, total);
+            requests_++;
+
+            std::string reply = handler_(head, body);
+            size_t sent = 0;
+            while (sent < reply.size()) {
+                ssize_t n = send(fd, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+                if (n <= 0) {
+                    close(fd);
+                    return;
+                }
+                sent += static_cast<size_t>(n);
+            }
+        }
+        close(fd);
+    }
+};
+
+#endif // LOCAL_HTTP_SERVER_H
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include "http_client.h"
+#include "local_http_server.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+class HttpClientTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        server.reset(new LocalHttpServer([this](const std::string& head, const std::string& body) {
+            return handle(head, body);
+        }));
+        ASSERT_TRUE(server->start());
+    }
+
+    void TearDown() override {
+        server->stop();
+    }
+
+    std::string handle(const std::string& head, const std::string& body) {
+        if (head.compare(0, 4, "POST") == 0) {
+            bool json = head.find("Content-Type: application/json") != std::string::npos;
+            return LocalHttpServer::response(json ? 200 : 415, body);
+        }
+        if (head.find("If-None-Match: \"v1\"") != std::string::npos) {
+            return "HTTP/1.1 304 Not Modified\r\nETag: \"v1\"\r\nContent-Length: 0\r\n\r\n";
+        }
+        return LocalHttpServer::response(200, "{\"config\":{}}", "ETag: \"v1\"\r\n");
+    }
+
+    std::unique_ptr<LocalHttpServer> server;
+};
+
+TEST_F(HttpClientTest, GetReturnsStatusBodyAndEtag) {
+    HttpClient client(std::unique_ptr<HttpTransport>(new CurlTransport()));
+    HttpResponse response;
+
+    ASSERT_TRUE(client.get(server->url("/controller"), response));
+    EXPECT_EQ(response.status_code, 200);
+    EXPECT_EQ(response.body, "{\"config\":{}}");
+    EXPECT_EQ(response.etag, "\"v1\"");
+    EXPECT_GT(response.bytes_received, response.body.size());
+}
+
+TEST_F(HttpClientTest, ReusesConnectionAcrossRequests) {
+    HttpClient client(std::unique_ptr<HttpTransport>(new CurlTransport()));
+    HttpResponse response;
+
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(client.get(server->url(), response));
+        EXPECT_EQ(response.status_code, 200);
+        EXPECT_EQ(response.connection_reused, i > 0);
+    }
+    EXPECT_EQ(server->requests(), 5);
+    EXPECT_EQ(server->connections(), 1);
+}
+
+TEST_F(HttpClientTest, ReusesConnectionBetweenGetAndPost) {
+    HttpClient client(std::unique_ptr<HttpTransport>(new CurlTransport()));
+    HttpResponse response;
+
+    ASSERT_TRUE(client.get(server->url(), response));
+    ASSERT_TRUE(client.postJson(server->url("/feedback"), "{\"id\":\"1\"}", response));
+    EXPECT_EQ(response.status_code, 200);
+    EXPECT_EQ(response.body, "{\"id\":\"1\"}");
+
+    // The handle must go back to GET after a POST
+    ASSERT_TRUE(client.get(server->url(), response));
+    EXPECT_EQ(response.body, "{\"config\":{}}");
+    EXPECT_EQ(server->connections(), 1);
+}
+
+TEST_F(HttpClientTest, SendsPreallocatedHeaders) {
+    HttpClient client(std::unique_ptr<HttpTransport>(new CurlTransport()));
+    HttpHeaderList headers{"If-None-Match: \"v1\""};
+    HttpResponse response;
+
+    ASSERT_TRUE(client.get(server->url(), response, 30, &headers));
+    EXPECT_EQ(response.status_code, 304);
+    EXPECT_TRUE(response.body.empty());
+
+    // The same list can be sent again, and requests without it are unaffected
+    ASSERT_TRUE(client.get(server->url(), response, 30, &headers));
+    EXPECT_EQ(response.status_code, 304);
+    ASSERT_TRUE(client.get(server->url(), response));
+    EXPECT_EQ(response.status_code, 200);
+}
+
+TEST_F(HttpClientTest, SharedTransportsKeepOwnConnections) {
+    // The share holds DNS and TLS sessions only: transports on different threads never hand connections over
+    auto share = std::make_shared<HttpShare>();
+    HttpClient first(std::unique_ptr<HttpTransport>(new CurlTransport(HttpClientOptions(), share)));
+    HttpClient second(std::unique_ptr<HttpTransport>(new CurlTransport(HttpClientOptions(), share)));
+    HttpResponse response;
+
+    ASSERT_TRUE(first.get(server->url(), response));
+    ASSERT_TRUE(second.get(server->url(), response));
+    EXPECT_FALSE(response.connection_reused);
+    ASSERT_TRUE(first.get(server->url(), response));
+    EXPECT_TRUE(response.connection_reused);
+    ASSERT_TRUE(second.get(server->url(), response));
+    EXPECT_TRUE(response.connection_reused);
+    EXPECT_EQ(server->connections(), 2);
+}
+
+TEST_F(HttpClientTest, StreamsBodyToFile) {
+    std::string path = "/tmp/test_http_client_" + std::to_string(getpid());
+    FILE* file = fopen(path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+
+    HttpClient client(std::unique_ptr<HttpTransport>(new CurlTransport()));
+    HttpRequest request;
+    request.url = server->url("/bundle");
+    request.output_file = file;
+    HttpResponse response;
+
+    ASSERT_TRUE(client.perform(request, response));
+    fclose(file);
+
+    std::ifstream input(path);
+    std::stringstream contents;
+    contents << input.rdbuf();
+    EXPECT_EQ(contents.str(), "{\"config\":{}}");
+    EXPECT_TRUE(response.body.empty());
+    std::remove(path.c_str());
+}
+
+TEST_F(HttpClientTest, StreamsBodyToSink) {
+    HttpClient client(std::unique_ptr<HttpTransport>(new CurlTransport()));
+    std::string received;
+    HttpRequest request;
+    request.url = server->url("/controller");
+    request.body_sink = [&received](const char* data, size_t len) {
+        received.append(data, len);
+        return true;
+    };
+    HttpResponse response;
+
+    ASSERT_TRUE(client.perform(request, response));
+    EXPECT_EQ(response.status_code, 200);
+    EXPECT_EQ(received, "{\"config\":{}}");
+    EXPECT_TRUE(response.body.empty());
+
+    request.body_sink = [](const char*, size_t) { return false; };
+    EXPECT_FALSE(client.perform(request, response));
+}
+
+TEST_F(HttpClientTest, ReportsTransportErrors) {
+    std::string url = server->url();
+    server->stop();
+
+    HttpClient client(std::unique_ptr<HttpTransport>(new CurlTransport()));
+    HttpResponse response;
+    EXPECT_FALSE(client.get(url, response, 2));
+    EXPECT_EQ(response.status_code, 0);
+    EXPECT_FALSE(response.error.empty());
+}
+
+TEST_F(HttpClientTest, ReportsProgressAndAppliesRateLimit) {
+    const std::string large_body(4 * 1024 * 1024, 'x');
+    LocalHttpServer bulk([&large_body](const std::string&, const std::string&) {
+        return LocalHttpServer::response(200, large_body);
+    });
+    ASSERT_TRUE(bulk.start());
+
+    HttpClient client(std::unique_ptr<HttpTransport>(new CurlTransport()));
+    HttpRequest request;
+    request.url = bulk.url("/bundle");
+    request.max_recv_speed = 8 * 1024 * 1024;
+
+    int callbacks = 0;
+    uint64_t last_downloaded = 0;
+    request.progress = [&](HttpTransferStatus& status) {
+        callbacks++;
+        last_downloaded = status.downloaded;
+        // Tighten the limit once the transfer is under way
+        if (status.downloaded > 0) {
+            status.max_recv_speed = 2 * 1024 * 1024;
+        }
+        return true;
+    };
+
+    HttpResponse response;
+    ASSERT_TRUE(client.perform(request, response));
+    EXPECT_EQ(response.body.size(), large_body.size());
+    EXPECT_GT(callbacks, 0);
+    EXPECT_EQ(last_downloaded, large_body.size());
+    // 4 MiB at 2 MiB/s: about two seconds
+    EXPECT_GE(response.total_time_seconds, 1.0);
+
+    // The limit does not leak into the next request on the same handle
+    ASSERT_TRUE(client.get(bulk.url("/bundle"), response));
+    EXPECT_LT(response.total_time_seconds, 1.0);
+}
+
+TEST_F(HttpClientTest, ProgressCallbackCanAbort) {
+    HttpClient client(std::unique_ptr<HttpTransport>(new CurlTransport()));
+    HttpRequest request;
+    request.url = server->url("/bundle");
+    request.progress = [](HttpTransferStatus&) { return false; };
+
+    HttpResponse response;
+    EXPECT_FALSE(client.perform(request, response));
+    EXPECT_FALSE(response.error.empty());
+}
@@ -8,6 +8,10 @@
 #include "install.h"
 #include "utils.h"
 
+#if ENABLE_GRUBENV
+#include <grubenv.h>
+#endif
+
 GQuark r_bootchooser_error_quark(void)
 {
 	return g_quark_from_static_string("r_bootchooser_error_quark");
@@ -350,6 +354,77 @@ static gboolean barebox_set_primary(RaucSlot *slot, GError **error)
 	return TRUE;
 }
 
+#if ENABLE_GRUBENV
+/* Reads the environment block directly instead of running grub-editenv
+ * list once per variable */
+static gboolean grub_env_get(const gchar *key, GString **value, GError **error)
+{
+	const gchar *path = r_context()->config->grubenv_path;
+	grubenv_t env;
+	gchar buffer[GRUBENV_MAX_SIZE];
+	gint ret;
+
+	g_return_val_if_fail(key, FALSE);
+	g_return_val_if_fail(value && *value == NULL, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	g_assert_nonnull(path);
+
+	ret = grubenv_load(&env, path);
+	if (ret < 0) {
+		g_set_error(
+				error,
+				G_FILE_ERROR,
+				g_file_error_from_errno(-ret),
+				"Failed to read grub environment %s: %s", path, g_strerror(-ret));
+		return FALSE;
+	}
+
+	ret = grubenv_get(&env, key, buffer, sizeof(buffer));
+	if (ret < 0) {
+		g_set_error(
+				error,
+				R_BOOTCHOOSER_ERROR,
+				R_BOOTCHOOSER_ERROR_PARSE_FAILED,
+				"Variable %s not set in grub environment", key);
+		return FALSE;
+	}
+
+	/* Trailing whitespace is dropped, as g_strchomp() does on the
+	 * grub-editenv list output */
+	while (ret > 0 && g_ascii_isspace(buffer[ret - 1]))
+		ret--;
+
+	*value = g_string_new_len(buffer, ret);
+	return TRUE;
+}
+
+/* Applies all pairs to the block and replaces the file atomically; nothing
+ * is written if one of them does not fit */
+static gboolean grub_env_set(GPtrArray *pairs, GError **error)
+{
+	const gchar *path = r_context()->config->grubenv_path;
+	gint ret;
+
+	g_return_val_if_fail(pairs, FALSE);
+	g_return_val_if_fail(error == NULL || *error == NULL, FALSE);
+
+	g_assert_cmpuint(pairs->len, >, 0);
+	g_assert_nonnull(path);
+
+	ret = grubenv_update(path, (const char *const *) pairs->pdata, pairs->len);
+	if (ret < 0) {
+		g_set_error(
+				error,
+				G_FILE_ERROR,
+				g_file_error_from_errno(-ret),
+				"Failed to update grub environment %s: %s", path, g_strerror(-ret));
+		return FALSE;
+	}
+
+	return TRUE;
+}
+#else
 static gboolean grub_env_get(const gchar *key, GString **value, GError **error)
 {
 	g_autoptr(GPtrArray) sub_args = NULL;
@@ -478,6 +553,7 @@ out:
 	g_ptr_array_remove_index(pairs, 0);
 	return res;
 }
+#endif /* ENABLE_GRUBENV */
 
 /* We assume bootstate to be good if slot is listed in 'ORDER', its
  * _TRY=0 and _OK=1 */
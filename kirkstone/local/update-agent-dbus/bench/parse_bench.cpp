@@ -0,0 +1,147 @@
+/**
+ * Poll response parse benchmark
+ *
+ * Compares the json-c DOM path (ServerAgent::parseUpdateResponse, with and
+ * without first collecting the curl chunks into a string as the old poll
+ * did) against DeploymentParser fed chunk by chunk. Allocations are counted
+ * by interposing malloc, so json-c's own allocations are included.
+ * Usage: parse-bench [iterations] [chunk bytes]
+ */
+#include "server_agent.h"
+#include "deployment_parser.h"
+#include "config.h"
+#include "hawkbit_payloads.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <vector>
+
+#ifdef __GLIBC__
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+}
+
+namespace {
+bool g_counting = false;
+uint64_t g_allocations = 0;
+uint64_t g_allocated_bytes = 0;
+
+void countAllocation(size_t size) {
+    if (g_counting) {
+        g_allocations++;
+        g_allocated_bytes += size;
+    }
+}
+} // namespace
+
+extern "C" {
+void* malloc(size_t size) {
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    countAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+namespace {
+bool g_counting = false;
+uint64_t g_allocations = 0;
+uint64_t g_allocated_bytes = 0;
+} // namespace
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Parse = std::function<void()>;
+
+void run(const char* payload_name, const char* name, int iterations, const Parse& parse) {
+    parse();  // Warm-up: lets reused buffers reach their steady-state capacity
+
+    std::vector<double> samples_us;
+    samples_us.reserve(iterations);
+
+    g_allocations = 0;
+    g_allocated_bytes = 0;
+    for (int i = 0; i < iterations; ++i) {
+        auto start = Clock::now();
+        g_counting = true;
+        parse();
+        g_counting = false;
+        samples_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+
+    std::sort(samples_us.begin(), samples_us.end());
+    double sum = 0.0;
+    for (double sample : samples_us) {
+        sum += sample;
+    }
+    size_t count = samples_us.size();
+    printf("%-10s %-14s mean=%8.2f us  p50=%8.2f us  p99=%8.2f us  allocs=%7.1f  bytes=%9.1f\n", payload_name, name,
+           sum / count, samples_us[count / 2], samples_us[std::min(count - 1, count * 99 / 100)],
+           static_cast<double>(g_allocations) / count, static_cast<double>(g_allocated_bytes) / count);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 5000;
+    size_t chunk_size = argc > 2 ? static_cast<size_t>(atoi(argv[2])) : 16384;  // CURL_MAX_WRITE_SIZE
+    if (iterations <= 0 || chunk_size == 0) {
+        fprintf(stderr, "Usage: %s [iterations] [chunk bytes]\n", argv[0]);
+        return 1;
+    }
+
+    struct Payload {
+        const char* name;
+        std::string json;
+    };
+    const Payload payloads[] = {
+        { "idle", hawkbit_payloads::idle() },
+        { "deployment", hawkbit_payloads::deployment() },
+        { "large", hawkbit_payloads::largeDeployment(50) },
+    };
+
+    ServerAgent agent(HOST_SERVER_URL, HOST_TENANT, DEVICE_ID);
+    DeploymentParser parser;
+    UpdateInfo info;
+    info.reserve();
+
+    for (const Payload& payload : payloads) {
+        const std::string& json = payload.json;
+        printf("%s: %zu bytes\n", payload.name, json.size());
+
+        run(payload.name, "dom", iterations, [&]() {
+            agent.parseUpdateResponse(json, info);
+        });
+
+        run(payload.name, "buffer+dom", iterations, [&]() {
+            std::string body;
+            for (size_t offset = 0; offset < json.size(); offset += chunk_size) {
+                body.append(json, offset, chunk_size);
+            }
+            agent.parseUpdateResponse(body, info);
+        });
+
+        run(payload.name, "stream", iterations, [&]() {
+            parser.reset(info);
+            for (size_t offset = 0; offset < json.size(); offset += chunk_size) {
+                parser.feed(json.data() + offset, std::min(chunk_size, json.size() - offset));
+            }
+            parser.finish();
+        });
+    }
+    return 0;
+}
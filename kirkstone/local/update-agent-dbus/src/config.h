@@ -12,7 +12,11 @@ const std::string HOST_TENANT = "DEFAULT";
 const std::string DEVICE_ID = "nuc-device-001";
 
 // Timing configuration
-const int POLL_INTERVAL_SECONDS = 10;
+const int POLL_INTERVAL_SECONDS = 10;  // Fallback when the server sends no polling sleep
+const int POLL_INTERVAL_MIN_SECONDS = 5;  // Lower clamp for the server-provided interval
+const int POLL_INTERVAL_MAX_SECONDS = 3600;  // Upper clamp for the server-provided interval
+const int POLL_JITTER_PERCENT = 10;  // +/- jitter so a fleet does not poll in lockstep
+const int POLL_STATS_LOG_INTERVAL = 60;  // Log poll statistics every N polls
 const int DOWNLOAD_TIMEOUT_SECONDS = 300;  // 5 minutes
 const int INSTALLATION_TIMEOUT_SECONDS = 600;  // 10 minutes
 const int HTTP_TIMEOUT_SECONDS = 30;
@@ -28,6 +32,24 @@ const std::string UPDATE_BUNDLE_PATH = "/tmp/update_bundle.raucb";
 const std::string LOG_FILE_PATH = "/var/log/update-agent.log";
 const std::string START_SIGNAL_FILE = "/tmp/update-agent-start-signal";
 
+// Feedback queue configuration
+const std::string FEEDBACK_QUEUE_PATH = "/var/lib/update-agent/pending-feedback";  // Survives reboot
+const int FEEDBACK_RETRY_INITIAL_MS = 500;  // First retry delay, doubled per attempt
+const int FEEDBACK_RETRY_MAX_SECONDS = 60;  // Backoff ceiling
+const int FEEDBACK_MAX_ATTEMPTS = 5;  // Started/progress feedback is dropped after this many attempts
+const int FEEDBACK_FLUSH_TIMEOUT_SECONDS = 10;  // Max wait for pending feedback before reboot
+
+// Download shaping configuration
+const long DOWNLOAD_RATE_BACKGROUND_BPS = 256 * 1024;  // hawkBit "skip", 0 = unlimited
+const long DOWNLOAD_RATE_NORMAL_BPS = 1024 * 1024;  // hawkBit "attempt"
+const long DOWNLOAD_RATE_URGENT_BPS = 0;  // hawkBit "forced", unlimited
+const std::string DOWNLOAD_WINDOW = "";  // Local time "HH:MM-HH:MM" (e.g. "01:00-05:00"), empty = always
+const bool DOWNLOAD_ADAPTIVE_ENABLED = true;  // Back off when the uplink RTT rises
+const double DOWNLOAD_ADAPTIVE_RTT_FACTOR = 2.0;  // Congestion when RTT > baseline * factor
+const long DOWNLOAD_ADAPTIVE_MIN_BPS = 32 * 1024;  // Floor for adaptive backoff
+const long DOWNLOAD_ADAPTIVE_STEP_BPS = 64 * 1024;  // Additive increase per quiet interval
+const int DOWNLOAD_ADAPTIVE_INTERVAL_MS = 500;  // RTT sampling interval
+
 // Logging Configuration - Simplified
 const std::string LOG_APP_NAME = "UAGT";
 const std::string LOG_SERVER_CONTEXT = "SRVR";
@@ -0,0 +1,491 @@
+#include "deployment_parser.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+bool isWhitespace(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+bool isNumberChar(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+DeploymentParser::DeploymentParser()
+    : info_(nullptr), state_(State::Error), depth_(0), in_key_(false), field_(Field::None), target_(nullptr),
+      key_len_(0), key_overflow_(false), unicode_value_(0), unicode_digits_(0), high_surrogate_(0),
+      scalar_len_(0), literal_(nullptr), literal_pos_(0), sleep_len_(0),
+      has_deployment_(false), has_execution_id_(false) {}
+
+void DeploymentParser::reset(UpdateInfo& update_info) {
+    info_ = &update_info;
+    info_->clear();
+    state_ = State::Value;
+    depth_ = 0;
+    in_key_ = false;
+    field_ = Field::None;
+    target_ = nullptr;
+    high_surrogate_ = 0;
+    sleep_len_ = 0;
+    has_deployment_ = false;
+    has_execution_id_ = false;
+}
+
+int DeploymentParser::parsePollingSleep(const char* sleep) {
+    // hawkBit format: "HH:MM:SS"
+    int hours = 0, minutes = 0, seconds = 0;
+    char trailing = 0;
+    if (sscanf(sleep, "%d:%d:%d%c", &hours, &minutes, &seconds, &trailing) != 3) {
+        return -1;
+    }
+    if (hours < 0 || minutes < 0 || minutes > 59 || seconds < 0 || seconds > 59) {
+        return -1;
+    }
+    return hours * 3600 + minutes * 60 + seconds;
+}
+
+bool DeploymentParser::feed(const char* data, size_t len) {
+    if (state_ == State::Error) {
+        return false;
+    }
+
+    size_t i = 0;
+    while (i < len) {
+        if (state_ == State::String) {
+            // Copy plain runs in one go; quotes, escapes and control characters go through step()
+            size_t end = i;
+            while (end < len && data[end] != '"' && data[end] != '\\' && static_cast<unsigned char>(data[end]) >= 0x20) {
+                ++end;
+            }
+            if (end > i) {
+                flushSurrogate();
+                appendToString(data + i, end - i);
+                i = end;
+                continue;
+            }
+        } else if ((state_ <= State::CommaOrEnd || state_ == State::Done) && isWhitespace(data[i])) {
+            // Between tokens (pretty-printed responses are mostly indentation)
+            ++i;
+            continue;
+        }
+        if (!step(data[i])) {
+            return fail();
+        }
+        ++i;
+    }
+    return true;
+}
+
+bool DeploymentParser::finish() {
+    if (state_ != State::Done) {
+        fail();
+        if (info_) {
+            info_->clear();
+        }
+        return false;
+    }
+
+    sleep_[sleep_len_] = '\0';
+    info_->polling_sleep_seconds = parsePollingSleep(sleep_);
+    info_->description.assign(info_->filename);  // Filename doubles as description
+    info_->is_available = has_deployment_ && has_execution_id_ && !info_->download_url.empty();
+    return true;
+}
+
+bool DeploymentParser::fail() {
+    state_ = State::Error;
+    return false;
+}
+
+bool DeploymentParser::step(char c) {
+    switch (state_) {
+        case State::Value:
+            if (isWhitespace(c)) return true;
+            return beginValue(c);
+
+        case State::ValueOrEnd:
+            if (isWhitespace(c)) return true;
+            if (c == ']') {
+                --depth_;
+                endValue();
+                return true;
+            }
+            return beginValue(c);
+
+        case State::KeyOrEnd:
+        case State::Key:
+            if (isWhitespace(c)) return true;
+            if (c == '"') {
+                in_key_ = true;
+                key_len_ = 0;
+                key_overflow_ = false;
+                state_ = State::String;
+                return true;
+            }
+            if (c == '}' && state_ == State::KeyOrEnd) {
+                --depth_;
+                endValue();
+                return true;
+            }
+            return false;
+
+        case State::Colon:
+            if (isWhitespace(c)) return true;
+            if (c != ':') return false;
+            state_ = State::Value;
+            return true;
+
+        case State::CommaOrEnd: {
+            if (isWhitespace(c)) return true;
+            Frame& frame = stack_[depth_ - 1];
+            if (c == ',') {
+                if (frame.is_array) {
+                    ++frame.index;
+                    state_ = State::Value;
+                } else {
+                    state_ = State::Key;
+                }
+                return true;
+            }
+            if ((c == '}' && !frame.is_array) || (c == ']' && frame.is_array)) {
+                --depth_;
+                endValue();
+                return true;
+            }
+            return false;
+        }
+
+        case State::String:
+            if (c == '"') {
+                flushSurrogate();
+                if (in_key_) {
+                    in_key_ = false;
+                    stack_[depth_ - 1].key = lookupKey();
+                    state_ = State::Colon;
+                } else {
+                    endValue();
+                }
+                return true;
+            }
+            if (c == '\\') {
+                state_ = State::Escape;
+                return true;
+            }
+            return false;  // Unescaped control character
+
+        case State::Escape: {
+            char decoded;
+            switch (c) {
+                case '"':  decoded = '"';  break;
+                case '\\': decoded = '\\'; break;
+                case '/':  decoded = '/';  break;
+                case 'b':  decoded = '\b'; break;
+                case 'f':  decoded = '\f'; break;
+                case 'n':  decoded = '\n'; break;
+                case 'r':  decoded = '\r'; break;
+                case 't':  decoded = '\t'; break;
+                case 'u':
+                    unicode_value_ = 0;
+                    unicode_digits_ = 0;
+                    state_ = State::Unicode;
+                    return true;
+                default:
+                    return false;
+            }
+            flushSurrogate();
+            appendToString(&decoded, 1);
+            state_ = State::String;
+            return true;
+        }
+
+        case State::Unicode: {
+            int digit = hexValue(c);
+            if (digit < 0) return false;
+            unicode_value_ = (unicode_value_ << 4) | static_cast<unsigned>(digit);
+            if (++unicode_digits_ < 4) return true;
+
+            state_ = State::String;
+            if (unicode_value_ >= 0xD800 && unicode_value_ <= 0xDBFF) {
+                flushSurrogate();
+                high_surrogate_ = unicode_value_;
+            } else if (unicode_value_ >= 0xDC00 && unicode_value_ <= 0xDFFF) {
+                if (high_surrogate_) {
+                    appendCodepoint(0x10000 + ((high_surrogate_ - 0xD800) << 10) + (unicode_value_ - 0xDC00));
+                    high_surrogate_ = 0;
+                } else {
+                    appendCodepoint(0xFFFD);
+                }
+            } else {
+                flushSurrogate();
+                appendCodepoint(unicode_value_);
+            }
+            return true;
+        }
+
+        case State::Number:
+            if (isNumberChar(c)) {
+                if (field_ != Field::None) {
+                    if (scalar_len_ + 1 >= kScalarCapacity) return false;
+                    scalar_[scalar_len_++] = c;
+                }
+                return true;
+            }
+            if (!finishNumber()) return false;
+            endValue();
+            return step(c);  // The delimiter belongs to the enclosing container
+
+        case State::Literal:
+            if (c != literal_[literal_pos_]) return false;
+            if (literal_[++literal_pos_] == '\0') {
+                endValue();
+            }
+            return true;
+
+        case State::Done:
+            return isWhitespace(c);
+
+        case State::Error:
+            return false;
+    }
+    return false;
+}
+
+bool DeploymentParser::beginValue(char c) {
+    Field field = fieldForValue();
+
+    switch (c) {
+        case '{':
+        case '[':
+            if (depth_ == kMaxDepth) return false;
+            if (c == '{' && depth_ == 1 && stack_[0].key == Deployment) {
+                has_deployment_ = true;
+            }
+            stack_[depth_].is_array = (c == '[');
+            stack_[depth_].key = Other;
+            stack_[depth_].index = 0;
+            ++depth_;
+            state_ = (c == '{') ? State::KeyOrEnd : State::ValueOrEnd;
+            return true;
+
+        case '"':
+            in_key_ = false;
+            field_ = field;
+            target_ = targetFor(field);
+            if (target_) {
+                target_->clear();
+            }
+            if (field == Field::PollingSleep) {
+                sleep_len_ = 0;
+            } else if (field == Field::ExecutionId) {
+                has_execution_id_ = true;
+            }
+            state_ = State::String;
+            return true;
+
+        case 't':
+            literal_ = "true";
+            break;
+        case 'f':
+            literal_ = "false";
+            break;
+        case 'n':
+            literal_ = "null";
+            break;
+
+        default:
+            if (c != '-' && (c < '0' || c > '9')) return false;
+            field_ = field;
+            scalar_len_ = 0;
+            if (field == Field::ExecutionId) {
+                has_execution_id_ = true;
+            }
+            if (field_ != Field::None) {
+                scalar_[scalar_len_++] = c;
+            }
+            state_ = State::Number;
+            return true;
+    }
+
+    literal_pos_ = 1;
+    state_ = State::Literal;
+    return true;
+}
+
+void DeploymentParser::endValue() {
+    state_ = depth_ == 0 ? State::Done : State::CommaOrEnd;
+}
+
+DeploymentParser::Field DeploymentParser::fieldForValue() const {
+    struct Pattern {
+        Field field;
+        int length;
+        Key path[6];
+    };
+    static const Pattern kPatterns[] = {
+        { Field::PollingSleep, 3, { Config, Polling, Sleep } },
+        { Field::ExecutionId,  2, { Deployment, Id } },
+        { Field::DownloadType, 3, { Deployment, Deployment, Download } },
+        { Field::Version,      5, { Deployment, Deployment, Chunks, FirstIndex, Version } },
+        { Field::DownloadUrl,  6, { Deployment, Artifacts, FirstIndex, Links, DownloadHttp, Href } },
+        { Field::Filename,     4, { Deployment, Artifacts, FirstIndex, Filename } },
+        { Field::Size,         4, { Deployment, Artifacts, FirstIndex, Size } },
+        { Field::Md5,          5, { Deployment, Artifacts, FirstIndex, Hashes, Md5 } },
+        { Field::Sha1,         5, { Deployment, Artifacts, FirstIndex, Hashes, Sha1 } },
+        { Field::Sha256,       5, { Deployment, Artifacts, FirstIndex, Hashes, Sha256 } },
+    };
+
+    if (depth_ < 2 || depth_ > 6 || stack_[0].key == Other) {
+        return Field::None;
+    }
+
+    Key path[6];
+    for (int i = 0; i < depth_; ++i) {
+        const Frame& frame = stack_[i];
+        path[i] = frame.is_array ? (frame.index == 0 ? FirstIndex : LaterIndex) : frame.key;
+    }
+
+    for (const Pattern& pattern : kPatterns) {
+        if (pattern.length == depth_ && memcmp(pattern.path, path, depth_ * sizeof(Key)) == 0) {
+            return pattern.field;
+        }
+    }
+    return Field::None;
+}
+
+std::string* DeploymentParser::targetFor(Field field) const {
+    switch (field) {
+        case Field::ExecutionId:  return &info_->execution_id;
+        case Field::DownloadType: return &info_->download_type;
+        case Field::Version:      return &info_->version;
+        case Field::DownloadUrl:  return &info_->download_url;
+        case Field::Filename:     return &info_->filename;
+        case Field::Md5:          return &info_->md5_hash;
+        case Field::Sha1:         return &info_->sha1_hash;
+        case Field::Sha256:       return &info_->sha256_hash;
+        default:                  return nullptr;
+    }
+}
+
+DeploymentParser::Key DeploymentParser::lookupKey() const {
+    struct Entry {
+        const char* name;
+        size_t length;
+        Key key;
+    };
+    static const Entry kKeys[] = {
+        { "config", 6, Config },
+        { "polling", 7, Polling },
+        { "sleep", 5, Sleep },
+        { "deployment", 10, Deployment },
+        { "id", 2, Id },
+        { "download", 8, Download },
+        { "chunks", 6, Chunks },
+        { "version", 7, Version },
+        { "artifacts", 9, Artifacts },
+        { "_links", 6, Links },
+        { "links", 5, Links },
+        { "download-http", 13, DownloadHttp },
+        { "href", 4, Href },
+        { "filename", 8, Filename },
+        { "size", 4, Size },
+        { "hashes", 6, Hashes },
+        { "md5", 3, Md5 },
+        { "sha1", 4, Sha1 },
+        { "sha256", 6, Sha256 },
+    };
+
+    if (key_overflow_) {
+        return Other;
+    }
+    for (const Entry& entry : kKeys) {
+        if (entry.length == key_len_ && memcmp(entry.name, key_, key_len_) == 0) {
+            return entry.key;
+        }
+    }
+    return Other;
+}
+
+void DeploymentParser::appendToString(const char* data, size_t len) {
+    if (in_key_) {
+        if (key_len_ + len > kKeyCapacity) {
+            key_overflow_ = true;  // Longer than any key we look for
+            return;
+        }
+        memcpy(key_ + key_len_, data, len);
+        key_len_ += len;
+    } else if (field_ == Field::PollingSleep) {
+        size_t room = kScalarCapacity - 1 - sleep_len_;
+        size_t copy = len < room ? len : room;
+        memcpy(sleep_ + sleep_len_, data, copy);
+        sleep_len_ += copy;
+    } else if (target_) {
+        target_->append(data, len);
+    }
+}
+
+void DeploymentParser::appendCodepoint(unsigned codepoint) {
+    char utf8[4];
+    size_t len;
+    if (codepoint < 0x80) {
+        utf8[0] = static_cast<char>(codepoint);
+        len = 1;
+    } else if (codepoint < 0x800) {
+        utf8[0] = static_cast<char>(0xC0 | (codepoint >> 6));
+        utf8[1] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        len = 2;
+    } else if (codepoint < 0x10000) {
+        utf8[0] = static_cast<char>(0xE0 | (codepoint >> 12));
+        utf8[1] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        utf8[2] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        len = 3;
+    } else {
+        utf8[0] = static_cast<char>(0xF0 | (codepoint >> 18));
+        utf8[1] = static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+        utf8[2] = static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+        utf8[3] = static_cast<char>(0x80 | (codepoint & 0x3F));
+        len = 4;
+    }
+    appendToString(utf8, len);
+}
+
+void DeploymentParser::flushSurrogate() {
+    if (high_surrogate_) {
+        high_surrogate_ = 0;
+        appendCodepoint(0xFFFD);  // Unpaired high surrogate
+    }
+}
+
+bool DeploymentParser::finishNumber() {
+    if (field_ == Field::None) {
+        return true;
+    }
+    scalar_[scalar_len_] = '\0';
+
+    char* end = nullptr;
+    double value = strtod(scalar_, &end);
+    if (end != scalar_ + scalar_len_) {
+        return false;
+    }
+
+    if (field_ == Field::Size) {
+        long long integral = strtoll(scalar_, &end, 10);
+        info_->expected_size = (end == scalar_ + scalar_len_) ? static_cast<long>(integral) : static_cast<long>(value);
+    } else if (std::string* target = targetFor(field_)) {
+        // Numeric ids are kept as their text, as json_object_get_string does
+        target->assign(scalar_, scalar_len_);
+    } else if (field_ == Field::PollingSleep) {
+        sleep_len_ = 0;
+    }
+    return true;
+}
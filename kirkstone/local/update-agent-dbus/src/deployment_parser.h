@@ -0,0 +1,103 @@
+#ifndef DEPLOYMENT_PARSER_H
+#define DEPLOYMENT_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "update_info.h"
+
+/**
+ * @brief Streaming parser for the hawkBit controller base / deployment response
+ *
+ * Push parser fed with body chunks straight from the curl write callback.
+ * It builds no DOM: it tracks the key path and copies only the fields
+ * UpdateInfo needs into its (reused) strings, so polls into a reserved
+ * UpdateInfo do not allocate. Field selection matches
+ * ServerAgent::parseUpdateResponse (first chunk version, first artifact).
+ */
+class DeploymentParser {
+public:
+    DeploymentParser();
+
+    // Start a new document; clears update_info, keeping its capacity
+    void reset(UpdateInfo& update_info);
+    // Feed the next chunk; returns false once the input is malformed
+    bool feed(const char* data, size_t len);
+    // End of input; fills is_available and polling_sleep_seconds, returns false if the document was incomplete or invalid
+    bool finish();
+
+    bool failed() const { return state_ == State::Error; }
+    bool hasDeployment() const { return has_deployment_; }
+
+    // hawkBit "HH:MM:SS", -1 if invalid
+    static int parsePollingSleep(const char* sleep);
+
+private:
+    // Structural states (between tokens) come first, up to CommaOrEnd
+    enum class State {
+        Value, ValueOrEnd, KeyOrEnd, Key, Colon, CommaOrEnd,
+        String, Escape, Unicode, Number, Literal, Done, Error
+    };
+
+    // Keys on the paths we extract; everything else is Other
+    enum Key : uint8_t {
+        Other, Config, Polling, Sleep, Deployment, Id, Download, Chunks, Version,
+        Artifacts, Links, DownloadHttp, Href, Filename, Size, Hashes, Md5, Sha1, Sha256,
+        FirstIndex, LaterIndex
+    };
+
+    enum class Field {
+        None, PollingSleep, ExecutionId, DownloadType, Version, DownloadUrl,
+        Filename, Size, Md5, Sha1, Sha256
+    };
+
+    struct Frame {
+        bool is_array;
+        Key key;        // Object: key of the current member
+        uint32_t index; // Array: index of the current element
+    };
+
+    static const int kMaxDepth = 32;
+    static const size_t kKeyCapacity = 32;
+    static const size_t kScalarCapacity = 32;
+
+    UpdateInfo* info_;
+    State state_;
+    Frame stack_[kMaxDepth];
+    int depth_;
+
+    // Current string token
+    bool in_key_;
+    Field field_;
+    std::string* target_;
+    char key_[kKeyCapacity];
+    size_t key_len_;
+    bool key_overflow_;
+    unsigned unicode_value_;
+    int unicode_digits_;
+    unsigned high_surrogate_;
+
+    // Current number / literal token, and config.polling.sleep
+    char scalar_[kScalarCapacity];
+    size_t scalar_len_;
+    const char* literal_;
+    size_t literal_pos_;
+    char sleep_[kScalarCapacity];
+    size_t sleep_len_;
+
+    bool has_deployment_;
+    bool has_execution_id_;
+
+    bool step(char c);
+    bool beginValue(char c);
+    void endValue();
+    Field fieldForValue() const;
+    std::string* targetFor(Field field) const;
+    Key lookupKey() const;
+    void appendToString(const char* data, size_t len);
+    void appendCodepoint(unsigned codepoint);
+    void flushSurrogate();
+    bool finishNumber();
+    bool fail();
+};
+
+#endif // DEPLOYMENT_PARSER_H
@@ -0,0 +1,199 @@
+#include "download_policy.h"
+#include "config.h"
+#include <dlt/dlt.h>
+#include <algorithm>
+#include <cstdio>
+
+DLT_DECLARE_CONTEXT(dlt_context_download);
+
+namespace {
+
+// RTT increases below this are treated as jitter, not queueing on the uplink
+const long kMinQueueingDelayUs = 5000;
+const double kBackoffFactor = 0.7;
+
+bool parseClock(const char* text, int& minute_of_day) {
+    int hours = 0, minutes = 0;
+    if (sscanf(text, "%d:%d", &hours, &minutes) != 2) {
+        return false;
+    }
+    if (hours < 0 || hours > 23 || minutes < 0 || minutes > 59) {
+        return false;
+    }
+    minute_of_day = hours * 60 + minutes;
+    return true;
+}
+
+int localMinuteOfDay(time_t now) {
+    struct tm local;
+    localtime_r(&now, &local);
+    return local.tm_hour * 60 + local.tm_min;
+}
+
+} // namespace
+
+DownloadPolicyConfig::DownloadPolicyConfig()
+    : background_rate_bps(DOWNLOAD_RATE_BACKGROUND_BPS),
+      normal_rate_bps(DOWNLOAD_RATE_NORMAL_BPS),
+      urgent_rate_bps(DOWNLOAD_RATE_URGENT_BPS),
+      adaptive(DOWNLOAD_ADAPTIVE_ENABLED),
+      rtt_backoff_factor(DOWNLOAD_ADAPTIVE_RTT_FACTOR),
+      adaptive_min_rate_bps(DOWNLOAD_ADAPTIVE_MIN_BPS),
+      adaptive_step_bps(DOWNLOAD_ADAPTIVE_STEP_BPS),
+      adaptive_interval_ms(DOWNLOAD_ADAPTIVE_INTERVAL_MS) {
+    DownloadPolicy::parseWindow(DOWNLOAD_WINDOW, window);
+}
+
+DownloadPolicy::DownloadPolicy(const DownloadPolicyConfig& config) : config_(config) {
+    DLT_REGISTER_CONTEXT(dlt_context_download, "DLPO", "Update Agent Download Policy");
+}
+
+DownloadPolicy::~DownloadPolicy() {
+    DLT_UNREGISTER_CONTEXT(dlt_context_download);
+}
+
+DownloadPriority DownloadPolicy::priorityFromDeployment(const std::string& download_type) {
+    if (download_type == "forced") {
+        return DownloadPriority::Urgent;
+    }
+    if (download_type == "skip") {
+        return DownloadPriority::Background;
+    }
+    return DownloadPriority::Normal;
+}
+
+const char* DownloadPolicy::priorityName(DownloadPriority priority) {
+    switch (priority) {
+        case DownloadPriority::Background: return "background";
+        case DownloadPriority::Normal:     return "normal";
+        case DownloadPriority::Urgent:     return "urgent";
+    }
+    return "unknown";
+}
+
+bool DownloadPolicy::parseWindow(const std::string& spec, DownloadWindow& window) {
+    window = DownloadWindow();
+    if (spec.empty()) {
+        return true;
+    }
+
+    size_t dash = spec.find('-');
+    if (dash == std::string::npos) {
+        return false;
+    }
+
+    DownloadWindow parsed;
+    if (!parseClock(spec.substr(0, dash).c_str(), parsed.start_minute) ||
+        !parseClock(spec.substr(dash + 1).c_str(), parsed.end_minute)) {
+        return false;
+    }
+    window = parsed;
+    return true;
+}
+
+int DownloadPolicy::minutesUntilWindow(time_t now) const {
+    const DownloadWindow& window = config_.window;
+    if (window.start_minute == window.end_minute) {
+        return 0;
+    }
+
+    int minute = localMinuteOfDay(now);
+    bool open = window.start_minute < window.end_minute
+        ? (minute >= window.start_minute && minute < window.end_minute)
+        : (minute >= window.start_minute || minute < window.end_minute);  // Wraps past midnight
+    if (open) {
+        return 0;
+    }
+    return (window.start_minute - minute + 24 * 60) % (24 * 60);
+}
+
+bool DownloadPolicy::isDownloadAllowed(DownloadPriority priority, time_t now) const {
+    return priority == DownloadPriority::Urgent || minutesUntilWindow(now) == 0;
+}
+
+long DownloadPolicy::rateLimit(DownloadPriority priority) const {
+    switch (priority) {
+        case DownloadPriority::Background: return config_.background_rate_bps;
+        case DownloadPriority::Normal:     return config_.normal_rate_bps;
+        case DownloadPriority::Urgent:     return config_.urgent_rate_bps;
+    }
+    return 0;
+}
+
+DownloadShaper::DownloadShaper(const DownloadPolicy& policy, DownloadPriority priority)
+    : policy_(policy), priority_(priority), initial_rate_(policy.rateLimit(priority)),
+      current_rate_(initial_rate_), baseline_rtt_us_(0), smoothed_rtt_us_(0.0), backoffs_(0),
+      last_downloaded_(0), has_sample_(false) {}
+
+bool DownloadShaper::onProgress(HttpTransferStatus& status) {
+    if (!policy_.config().adaptive || status.rtt_us <= 0) {
+        return true;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    if (has_sample_ && now - last_sample_ < std::chrono::milliseconds(policy_.config().adaptive_interval_ms)) {
+        return true;
+    }
+
+    status.max_recv_speed = onRttSample(status.rtt_us, status.downloaded, now);
+    return true;
+}
+
+long DownloadShaper::onRttSample(long rtt_us, uint64_t downloaded, std::chrono::steady_clock::time_point now) {
+    const DownloadPolicyConfig& config = policy_.config();
+    if (rtt_us <= 0) {
+        return current_rate_;
+    }
+
+    if (!has_sample_) {
+        has_sample_ = true;
+        baseline_rtt_us_ = rtt_us;
+        smoothed_rtt_us_ = rtt_us;
+        last_sample_ = now;
+        last_downloaded_ = downloaded;
+        return current_rate_;
+    }
+
+    double elapsed = std::chrono::duration<double>(now - last_sample_).count();
+    long measured_bps = elapsed > 0.0 ? static_cast<long>((downloaded - last_downloaded_) / elapsed) : 0;
+    last_sample_ = now;
+    last_downloaded_ = downloaded;
+
+    baseline_rtt_us_ = std::min(baseline_rtt_us_, rtt_us);
+    smoothed_rtt_us_ = 0.7 * smoothed_rtt_us_ + 0.3 * rtt_us;
+
+    double queueing_us = smoothed_rtt_us_ - baseline_rtt_us_;
+    bool congested = smoothed_rtt_us_ > baseline_rtt_us_ * config.rtt_backoff_factor && queueing_us > kMinQueueingDelayUs;
+    bool settled = smoothed_rtt_us_ < baseline_rtt_us_ * (1.0 + (config.rtt_backoff_factor - 1.0) / 2.0) ||
+                   queueing_us <= kMinQueueingDelayUs;
+
+    if (congested) {
+        long base = current_rate_ > 0 ? current_rate_ : measured_bps;
+        if (base > 0) {
+            current_rate_ = std::max(config.adaptive_min_rate_bps, static_cast<long>(base * kBackoffFactor));
+            backoffs_++;
+            DLT_LOG(dlt_context_download, DLT_LOG_INFO, DLT_STRING("RTT rose to "), DLT_INT64(static_cast<int64_t>(smoothed_rtt_us_)),
+                    DLT_STRING(" us (baseline "), DLT_INT64(baseline_rtt_us_), DLT_STRING(" us), rate limit now "),
+                    DLT_INT64(current_rate_), DLT_STRING(" B/s"));
+        }
+    } else if (settled && current_rate_ > 0 && current_rate_ != initial_rate_) {
+        current_rate_ += config.adaptive_step_bps;
+        if (initial_rate_ > 0) {
+            current_rate_ = std::min(current_rate_, initial_rate_);
+        }
+    }
+
+    return current_rate_;
+}
+
+std::string DownloadShaper::describe() const {
+    auto rate = [](long bps) {
+        return bps > 0 ? std::to_string(bps / 1024) + " KiB/s" : std::string("unlimited");
+    };
+    std::string text = std::string("Download priority ") + DownloadPolicy::priorityName(priority_) +
+                       ", limit " + rate(initial_rate_);
+    if (policy_.config().adaptive) {
+        text += ", adaptive (now " + rate(current_rate_) + ", " + std::to_string(backoffs_) + " backoffs)";
+    }
+    return text;
+}
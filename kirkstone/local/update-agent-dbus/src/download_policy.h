@@ -0,0 +1,98 @@
+#ifndef DOWNLOAD_POLICY_H
+#define DOWNLOAD_POLICY_H
+
+#include <string>
+#include <ctime>
+#include <chrono>
+#include <cstdint>
+#include "http_client.h"
+
+// Priority class of a download, derived from the hawkBit deployment "download" type
+enum class DownloadPriority { Background, Normal, Urgent };
+
+// Daily window in minutes since local midnight; start == end means always open
+struct DownloadWindow {
+    int start_minute;
+    int end_minute;
+
+    DownloadWindow() : start_minute(0), end_minute(0) {}
+};
+
+struct DownloadPolicyConfig {
+    long background_rate_bps;   // 0 = unlimited
+    long normal_rate_bps;
+    long urgent_rate_bps;
+    DownloadWindow window;      // Urgent downloads ignore the window
+    bool adaptive;
+    double rtt_backoff_factor;  // Back off when RTT exceeds baseline * factor
+    long adaptive_min_rate_bps;
+    long adaptive_step_bps;
+    int adaptive_interval_ms;
+
+    DownloadPolicyConfig();    // Defaults from config.h
+};
+
+/**
+ * @brief Decides when and how fast bundles may be downloaded
+ */
+class DownloadPolicy {
+public:
+    explicit DownloadPolicy(const DownloadPolicyConfig& config = DownloadPolicyConfig());
+    ~DownloadPolicy();
+
+    static DownloadPriority priorityFromDeployment(const std::string& download_type);
+    static const char* priorityName(DownloadPriority priority);
+    // "HH:MM-HH:MM", empty string means always open
+    static bool parseWindow(const std::string& spec, DownloadWindow& window);
+
+    bool isDownloadAllowed(DownloadPriority priority, time_t now) const;
+    // Minutes until the window opens, 0 if it is open
+    int minutesUntilWindow(time_t now) const;
+    long rateLimit(DownloadPriority priority) const;
+
+    const DownloadPolicyConfig& config() const { return config_; }
+
+private:
+    DownloadPolicyConfig config_;
+};
+
+/**
+ * @brief Per-download rate controller
+ *
+ * Starts at the class limit and, in adaptive mode, backs off
+ * multiplicatively when the connection RTT rises above the lowest RTT
+ * seen during the transfer (queueing on the shared uplink), then
+ * recovers additively once the RTT settles.
+ */
+class DownloadShaper {
+public:
+    DownloadShaper(const DownloadPolicy& policy, DownloadPriority priority);
+
+    long initialRate() const { return initial_rate_; }
+    long currentRate() const { return current_rate_; }
+    long baselineRttUs() const { return baseline_rtt_us_; }
+    int backoffs() const { return backoffs_; }
+
+    // Progress hook for HttpRequest::progress
+    bool onProgress(HttpTransferStatus& status);
+
+    // Feed one RTT sample taken at the given time; returns the new limit (0 = unlimited)
+    long onRttSample(long rtt_us, uint64_t downloaded, std::chrono::steady_clock::time_point now);
+
+    // Short text for hawkBit feedback details
+    std::string describe() const;
+
+private:
+    const DownloadPolicy& policy_;
+    DownloadPriority priority_;
+    long initial_rate_;
+    long current_rate_;
+    long baseline_rtt_us_;
+    double smoothed_rtt_us_;
+    int backoffs_;
+    uint64_t last_downloaded_;
+    std::chrono::steady_clock::time_point last_sample_;
+    bool has_sample_;
+};
+
+#endif // DOWNLOAD_POLICY_H
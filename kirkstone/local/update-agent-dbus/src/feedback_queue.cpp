@@ -0,0 +1,382 @@
+#include "feedback_queue.h"
+#include "config.h"
+#include <dlt/dlt.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <errno.h>
+
+DLT_DECLARE_CONTEXT(dlt_context_feedback);
+
+namespace {
+
+const char* kindName(FeedbackEntry::Kind kind) {
+    switch (kind) {
+        case FeedbackEntry::Kind::Started:  return "started";
+        case FeedbackEntry::Kind::Progress: return "progress";
+        case FeedbackEntry::Kind::Finished: return "finished";
+    }
+    return "unknown";
+}
+
+// Persisted records are tab separated, one per line
+std::string sanitizeField(const std::string& value) {
+    std::string result = value;
+    std::replace(result.begin(), result.end(), '\t', ' ');
+    std::replace(result.begin(), result.end(), '\n', ' ');
+    std::replace(result.begin(), result.end(), '\r', ' ');
+    return result;
+}
+
+} // namespace
+
+FeedbackQueue::FeedbackQueue(Sender sender, const std::string& persist_path)
+    : sender_(sender), persist_path_(persist_path), running_(false), in_flight_(false),
+      persist_generation_(0), snapshot_generation_(0), written_generation_(0) {
+    DLT_REGISTER_CONTEXT(dlt_context_feedback, "FDBQ", "Update Agent Feedback Queue");
+    loadPersisted();
+}
+
+FeedbackQueue::~FeedbackQueue() {
+    stop();
+    DLT_UNREGISTER_CONTEXT(dlt_context_feedback);
+}
+
+void FeedbackQueue::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) {
+        return;
+    }
+    running_ = true;
+    worker_ = std::thread(&FeedbackQueue::workerLoop, this);
+    DLT_LOG(dlt_context_feedback, DLT_LOG_INFO, DLT_STRING("Feedback worker started, queued entries: "), DLT_UINT(queue_.size()));
+}
+
+void FeedbackQueue::stop() {
+    bool was_running;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        was_running = running_;
+        running_ = false;
+    }
+    if (was_running) {
+        work_cv_.notify_all();
+        if (worker_.joinable()) {
+            worker_.join();
+        }
+    }
+
+    // Final results enqueued without a running worker still have to reach the disk
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (persistPendingLocked()) {
+        persist(lock);
+    }
+    if (was_running) {
+        DLT_LOG(dlt_context_feedback, DLT_LOG_INFO, DLT_STRING("Feedback worker stopped, undelivered entries: "), DLT_UINT(queue_.size()));
+    }
+}
+
+FeedbackResult FeedbackQueue::resultForStatus(long http_status) {
+    if (http_status >= 200 && http_status < 300) {
+        return FeedbackResult::Delivered;
+    }
+    if (http_status >= 400 && http_status < 500 && http_status != 408 && http_status != 429) {
+        return FeedbackResult::Rejected;
+    }
+    return FeedbackResult::Retry;
+}
+
+void FeedbackQueue::enqueueStarted(const std::string& execution_id) {
+    FeedbackEntry entry;
+    entry.kind = FeedbackEntry::Kind::Started;
+    entry.execution_id = execution_id;
+    enqueue(entry);
+}
+
+void FeedbackQueue::enqueueProgress(const std::string& execution_id, int progress, const std::string& message) {
+    FeedbackEntry entry;
+    entry.kind = FeedbackEntry::Kind::Progress;
+    entry.execution_id = execution_id;
+    entry.progress = progress;
+    entry.message = message;
+    enqueue(entry);
+}
+
+void FeedbackQueue::enqueueFinished(const std::string& execution_id, bool success, const std::string& message) {
+    FeedbackEntry entry;
+    entry.kind = FeedbackEntry::Kind::Finished;
+    entry.execution_id = execution_id;
+    entry.progress = 100;
+    entry.success = success;
+    entry.message = message;
+    enqueue(entry);
+}
+
+void FeedbackQueue::enqueue(FeedbackEntry entry) {
+    entry.next_attempt = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Coalesce progress: overwrite the queued value instead of appending
+        if (entry.kind == FeedbackEntry::Kind::Progress) {
+            for (auto& queued : queue_) {
+                if (queued.kind == FeedbackEntry::Kind::Progress && queued.execution_id == entry.execution_id) {
+                    queued.progress = entry.progress;
+                    queued.message = entry.message;
+                    return;
+                }
+            }
+        }
+
+        if (entry.kind == FeedbackEntry::Kind::Finished) {
+            // Started/progress waiting for a retry would otherwise reach the server after the final result;
+            // entries not tried yet are ahead of it and keep their place
+            queue_.erase(std::remove_if(queue_.begin(), queue_.end(), [&entry](const FeedbackEntry& queued) {
+                             return queued.kind != FeedbackEntry::Kind::Finished && queued.attempts > 0 &&
+                                    queued.execution_id == entry.execution_id;
+                         }),
+                         queue_.end());
+        } else if (finishedQueuedLocked(entry.execution_id)) {
+            return;
+        }
+
+        // Written to disk by the worker, never on the caller's thread
+        insertByNextAttempt(entry);
+        if (entry.kind == FeedbackEntry::Kind::Finished) {
+            ++persist_generation_;
+        }
+    }
+    work_cv_.notify_one();
+}
+
+void FeedbackQueue::insertByNextAttempt(const FeedbackEntry& entry) {
+    // The queue stays sorted by next_attempt and FIFO among equal times, so the
+    // worker only ever waits on the front entry
+    auto pos = std::upper_bound(queue_.begin(), queue_.end(), entry.next_attempt,
+                                [](std::chrono::steady_clock::time_point when, const FeedbackEntry& queued) {
+                                    return when < queued.next_attempt;
+                                });
+    queue_.insert(pos, entry);
+}
+
+bool FeedbackQueue::flush(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool drained = drained_cv_.wait_for(lock, timeout, [this] { return queue_.empty() && !in_flight_ && !persistPendingLocked(); });
+    // Called before a reboot: make sure whatever is still pending is on disk
+    if (persistPendingLocked()) {
+        persist(lock);
+    }
+    return drained;
+}
+
+bool FeedbackQueue::hasPendingResult(const std::string& execution_id) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (in_flight_ && current_.kind == FeedbackEntry::Kind::Finished && current_.execution_id == execution_id) {
+        return true;
+    }
+    return finishedQueuedLocked(execution_id);
+}
+
+bool FeedbackQueue::finishedQueuedLocked(const std::string& execution_id) const {
+    return std::any_of(queue_.begin(), queue_.end(), [&execution_id](const FeedbackEntry& queued) {
+        return queued.kind == FeedbackEntry::Kind::Finished && queued.execution_id == execution_id;
+    });
+}
+
+size_t FeedbackQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size() + (in_flight_ ? 1 : 0);
+}
+
+void FeedbackQueue::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (running_) {
+        if (persistPendingLocked()) {
+            persist(lock);
+            continue;
+        }
+
+        if (queue_.empty()) {
+            drained_cv_.notify_all();
+            work_cv_.wait(lock, [this] { return !running_ || !queue_.empty() || persistPendingLocked(); });
+            continue;
+        }
+
+        auto next_attempt = queue_.front().next_attempt;
+        if (next_attempt > std::chrono::steady_clock::now()) {
+            work_cv_.wait_until(lock, next_attempt);
+            continue;
+        }
+
+        current_ = queue_.front();
+        queue_.pop_front();
+        in_flight_ = true;
+
+        lock.unlock();
+        FeedbackResult result = sender_(current_);
+        lock.lock();
+
+        in_flight_ = false;
+
+        if (result == FeedbackResult::Delivered) {
+            DLT_LOG(dlt_context_feedback, DLT_LOG_DEBUG, DLT_STRING("Feedback delivered: "), DLT_STRING(kindName(current_.kind)),
+                    DLT_STRING(" execution: "), DLT_STRING(current_.execution_id.c_str()));
+            if (current_.kind == FeedbackEntry::Kind::Finished) {
+                ++persist_generation_;
+            }
+            continue;
+        }
+
+        if (result == FeedbackResult::Rejected) {
+            // Retrying cannot succeed; keeping the entry would only delay everything else
+            DLT_LOG(dlt_context_feedback, DLT_LOG_WARN, DLT_STRING("Feedback rejected by server, dropping: "), DLT_STRING(kindName(current_.kind)),
+                    DLT_STRING(" execution: "), DLT_STRING(current_.execution_id.c_str()));
+            if (current_.kind == FeedbackEntry::Kind::Finished) {
+                ++persist_generation_;
+            }
+            continue;
+        }
+
+        // The final result was enqueued while this entry was being sent and goes first
+        if (current_.kind != FeedbackEntry::Kind::Finished && finishedQueuedLocked(current_.execution_id)) {
+            continue;
+        }
+
+        if (current_.kind == FeedbackEntry::Kind::Progress) {
+            // A newer value for the same execution supersedes the failed one
+            bool superseded = std::any_of(queue_.begin(), queue_.end(), [this](const FeedbackEntry& queued) {
+                return queued.kind == FeedbackEntry::Kind::Progress && queued.execution_id == current_.execution_id;
+            });
+            if (superseded) {
+                continue;
+            }
+        }
+
+        // Started/progress feedback is best effort, final results are retried until delivered
+        if (current_.kind != FeedbackEntry::Kind::Finished && current_.attempts + 1 >= FEEDBACK_MAX_ATTEMPTS) {
+            DLT_LOG(dlt_context_feedback, DLT_LOG_WARN, DLT_STRING("Dropping undeliverable feedback: "), DLT_STRING(kindName(current_.kind)),
+                    DLT_STRING(" execution: "), DLT_STRING(current_.execution_id.c_str()));
+            continue;
+        }
+
+        scheduleRetry(current_);
+        insertByNextAttempt(current_);
+    }
+
+    drained_cv_.notify_all();
+}
+
+void FeedbackQueue::scheduleRetry(FeedbackEntry& entry) {
+    entry.attempts++;
+
+    long long delay_ms = static_cast<long long>(FEEDBACK_RETRY_INITIAL_MS) << std::min(entry.attempts - 1, 16);
+    delay_ms = std::min(delay_ms, static_cast<long long>(FEEDBACK_RETRY_MAX_SECONDS) * 1000);
+    entry.next_attempt = std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms);
+
+    DLT_LOG(dlt_context_feedback, DLT_LOG_WARN, DLT_STRING("Feedback send failed, retry "), DLT_INT(entry.attempts),
+            DLT_STRING(" in "), DLT_INT64(delay_ms), DLT_STRING(" ms: "), DLT_STRING(kindName(entry.kind)));
+}
+
+void FeedbackQueue::loadPersisted() {
+    if (persist_path_.empty()) {
+        return;
+    }
+
+    std::ifstream file(persist_path_);
+    if (!file.is_open()) {
+        return;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        // Format: <execution_id>\t<success 0|1>\t<message>
+        size_t first_tab = line.find('\t');
+        if (first_tab == std::string::npos) {
+            continue;
+        }
+        size_t second_tab = line.find('\t', first_tab + 1);
+        if (second_tab == std::string::npos) {
+            continue;
+        }
+
+        FeedbackEntry entry;
+        entry.kind = FeedbackEntry::Kind::Finished;
+        entry.execution_id = line.substr(0, first_tab);
+        entry.progress = 100;
+        entry.success = line.compare(first_tab + 1, second_tab - first_tab - 1, "1") == 0;
+        entry.message = line.substr(second_tab + 1);
+        entry.next_attempt = std::chrono::steady_clock::now();
+        queue_.push_back(entry);
+    }
+
+    DLT_LOG(dlt_context_feedback, DLT_LOG_INFO, DLT_STRING("Loaded persisted final results: "), DLT_UINT(queue_.size()));
+}
+
+void FeedbackQueue::persist(std::unique_lock<std::mutex>& lock) {
+    // Snapshot under the queue lock, write without it
+    std::string contents;
+    auto append = [&contents](const FeedbackEntry& entry) {
+        if (entry.kind != FeedbackEntry::Kind::Finished) {
+            return;
+        }
+        contents += sanitizeField(entry.execution_id) + "\t" + (entry.success ? "1" : "0") + "\t" + sanitizeField(entry.message) + "\n";
+    };
+    if (in_flight_) {
+        append(current_);
+    }
+    for (const auto& queued : queue_) {
+        append(queued);
+    }
+    uint64_t generation = persist_generation_;
+    snapshot_generation_ = generation;
+
+    lock.unlock();
+    {
+        std::lock_guard<std::mutex> persist_lock(persist_mutex_);
+        // A newer snapshot taken by another thread may already be on disk
+        if (generation > written_generation_) {
+            writePersisted(contents);
+            written_generation_ = generation;
+        }
+    }
+    lock.lock();
+    drained_cv_.notify_all();
+}
+
+void FeedbackQueue::writePersisted(const std::string& contents) {
+    if (persist_path_.empty()) {
+        return;
+    }
+
+    if (contents.empty()) {
+        unlink(persist_path_.c_str());
+        return;
+    }
+
+    size_t slash = persist_path_.rfind('/');
+    if (slash != std::string::npos && slash > 0) {
+        mkdir(persist_path_.substr(0, slash).c_str(), 0755);
+    }
+
+    // Write to a temporary file and rename so a crash never leaves a torn record
+    std::string tmp_path = persist_path_ + ".tmp";
+    FILE* file = fopen(tmp_path.c_str(), "w");
+    if (!file) {
+        DLT_LOG(dlt_context_feedback, DLT_LOG_ERROR, DLT_STRING("Failed to persist feedback: "), DLT_STRING(strerror(errno)));
+        return;
+    }
+
+    bool ok = fwrite(contents.data(), 1, contents.size(), file) == contents.size();
+    ok = fflush(file) == 0 && ok;
+    ok = fsync(fileno(file)) == 0 && ok;
+    fclose(file);
+
+    if (!ok || rename(tmp_path.c_str(), persist_path_.c_str()) != 0) {
+        DLT_LOG(dlt_context_feedback, DLT_LOG_ERROR, DLT_STRING("Failed to persist feedback: "), DLT_STRING(strerror(errno)));
+        unlink(tmp_path.c_str());
+    }
+}
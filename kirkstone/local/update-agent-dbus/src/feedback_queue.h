@@ -0,0 +1,104 @@
+#ifndef FEEDBACK_QUEUE_H
+#define FEEDBACK_QUEUE_H
+
+#include <string>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <functional>
+#include <condition_variable>
+
+// Single feedback message destined for the hawkBit feedback endpoint
+struct FeedbackEntry {
+    enum class Kind { Started, Progress, Finished };
+
+    Kind kind;
+    std::string execution_id;
+    int progress;
+    bool success;
+    std::string message;
+    int attempts;
+    std::chrono::steady_clock::time_point next_attempt;
+
+    FeedbackEntry() : kind(Kind::Progress), progress(0), success(false), attempts(0) {}
+};
+
+// Outcome of one delivery attempt
+enum class FeedbackResult {
+    Delivered,
+    Retry,      // transport error, 5xx, 408 or 429: try again later
+    Rejected    // any other 4xx (e.g. the action was cancelled or deleted): never accepted
+};
+
+/**
+ * @brief Asynchronous hawkBit feedback queue
+ *
+ * Feedback is delivered by a worker thread so callers on the D-Bus signal
+ * path never wait on HTTP. Progress updates for the same execution id are
+ * coalesced (only the latest value is sent), failed sends are retried with
+ * exponential backoff, and unsent final results are persisted so they
+ * survive the reboot that follows a successful installation. Entries the
+ * server rejects are dropped, and an entry waiting for its retry never holds
+ * back the ones behind it. A final result drops the started/progress entries
+ * of its execution that wait for a retry, so they never arrive after it.
+ */
+class FeedbackQueue {
+public:
+    using Sender = std::function<FeedbackResult(const FeedbackEntry&)>;
+
+    // Maps the HTTP status of a feedback POST (0 for a transport error) to a result
+    static FeedbackResult resultForStatus(long http_status);
+
+    FeedbackQueue(Sender sender, const std::string& persist_path);
+    ~FeedbackQueue();
+
+    void start();
+    void stop();
+
+    void enqueueStarted(const std::string& execution_id);
+    void enqueueProgress(const std::string& execution_id, int progress, const std::string& message = "");
+    void enqueueFinished(const std::string& execution_id, bool success, const std::string& message = "");
+
+    // Wait until the queue is drained or the timeout expires
+    bool flush(std::chrono::milliseconds timeout);
+
+    // True while a final result for the execution is still waiting to be delivered
+    bool hasPendingResult(const std::string& execution_id) const;
+    size_t size() const;
+
+private:
+    Sender sender_;
+    std::string persist_path_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable drained_cv_;
+    std::deque<FeedbackEntry> queue_;
+    FeedbackEntry current_;
+    std::thread worker_;
+    bool running_;
+    bool in_flight_;
+
+    // Persistence runs with mutex_ released. persist_generation_ is bumped
+    // whenever the set of final results changes; a snapshot is only written if
+    // no newer one has been written meanwhile (file writes are serialized by
+    // persist_mutex_).
+    uint64_t persist_generation_;
+    uint64_t snapshot_generation_;
+    std::mutex persist_mutex_;
+    uint64_t written_generation_;
+
+    void workerLoop();
+    void enqueue(FeedbackEntry entry);
+    void insertByNextAttempt(const FeedbackEntry& entry);
+    bool finishedQueuedLocked(const std::string& execution_id) const;
+    void scheduleRetry(FeedbackEntry& entry);
+    void loadPersisted();
+    bool persistPendingLocked() const { return persist_generation_ != snapshot_generation_; }
+    void persist(std::unique_lock<std::mutex>& lock);
+    void writePersisted(const std::string& contents);
+};
+
+#endif // FEEDBACK_QUEUE_H
@@ -1,12 +1,17 @@
 #include "server_agent.h"
 #include "service_agent.h"
+#include "feedback_queue.h"
+#include "download_policy.h"
 #include "config.h"
 #include <dlt/dlt.h>
 #include <chrono>
+#include <ctime>
 #include <thread>
 #include <iostream>
 #include <signal.h>
 #include <atomic>
+#include <algorithm>
+#include <random>
 
 DLT_DECLARE_CONTEXT(dlt_context_main);
 
@@ -21,10 +26,13 @@ class UpdateAgent {
 public:
     UpdateAgent()
         : server_agent_(HOST_SERVER_URL, HOST_TENANT, DEVICE_ID),
-          service_agent_() {
+          service_agent_(),
+          feedback_queue_([this](const FeedbackEntry& entry) { return sendFeedbackEntry(entry); },
+                          FEEDBACK_QUEUE_PATH) {
 
         DLT_REGISTER_CONTEXT(dlt_context_main, "MAIN", "Update Agent Main");
         DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Initializing Update Orchestrator"));
+        update_info_.reserve();
 
         // Set up ServiceAgent callbacks
         service_agent_.setProgressCallback([this](int progress) {
@@ -38,11 +46,15 @@ public:
 
     ~UpdateAgent() {
         DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Shutting down Update Orchestrator"));
+        feedback_queue_.stop();
         service_agent_.disconnect();
         DLT_UNREGISTER_CONTEXT(dlt_context_main);
     }
 
     bool initialize() {
+        // Deliver final results persisted before the last reboot
+        feedback_queue_.start();
+
         DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Connecting to update service"));
 
         if (!service_agent_.connect()) {
@@ -67,8 +79,16 @@ public:
                 // Process D-Bus messages to handle update-service signals
                 service_agent_.processMessages();
 
-                checkForUpdates();
-                std::this_thread::sleep_for(std::chrono::seconds(POLL_INTERVAL_SECONDS));
+                auto now = std::chrono::steady_clock::now();
+                if (now >= next_poll_time_) {
+                    checkForUpdates();
+                    next_poll_time_ = std::chrono::steady_clock::now() + nextPollInterval();
+                    now = std::chrono::steady_clock::now();
+                }
+
+                // D-Bus messages are still serviced every POLL_INTERVAL_SECONDS even when the server asks for a longer sleep
+                auto until_poll = next_poll_time_ > now ? next_poll_time_ - now : std::chrono::steady_clock::duration::zero();
+                std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(until_poll, std::chrono::seconds(POLL_INTERVAL_SECONDS)));
             } catch (const std::exception& e) {
                 DLT_LOG(dlt_context_main, DLT_LOG_ERROR, DLT_STRING("Exception in main loop: "), DLT_STRING(e.what()));
                 std::this_thread::sleep_for(std::chrono::seconds(30)); // Wait before retrying
@@ -81,9 +101,61 @@ public:
 private:
     ServerAgent server_agent_;
     ServiceAgent service_agent_;
+    FeedbackQueue feedback_queue_;
+    UpdateInfo update_info_; // Reused across polls so parsing does not allocate
+    DownloadPolicy download_policy_;
+    std::string deferred_execution_id_; // Deployment waiting for the download window
     std::string current_execution_id_;
     bool installation_in_progress_ = false;
     bool installation_started_ = false; // Flag to stop polling after installation starts
+    int server_poll_sleep_seconds_ = -1; // Last polling sleep sent by the server, -1 if unknown
+    std::chrono::steady_clock::time_point next_poll_time_ = std::chrono::steady_clock::now();
+    std::mt19937 jitter_rng_{std::random_device{}()};
+
+    std::chrono::milliseconds nextPollInterval() {
+        int seconds = POLL_INTERVAL_SECONDS;
+        if (server_poll_sleep_seconds_ > 0) {
+            seconds = std::max(POLL_INTERVAL_MIN_SECONDS, std::min(server_poll_sleep_seconds_, POLL_INTERVAL_MAX_SECONDS));
+        }
+
+        long long interval_ms = static_cast<long long>(seconds) * 1000;
+        long long jitter_ms = interval_ms * POLL_JITTER_PERCENT / 100;
+        if (jitter_ms > 0) {
+            std::uniform_int_distribution<long long> jitter(-jitter_ms, jitter_ms);
+            interval_ms += jitter(jitter_rng_);
+        }
+        return std::chrono::milliseconds(interval_ms);
+    }
+
+    void logPollStats() {
+        const PollStats& stats = server_agent_.getPollStats();
+        if (stats.polls == 0 || stats.polls % POLL_STATS_LOG_INTERVAL != 0) {
+            return;
+        }
+        DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Poll stats - polls: "), DLT_UINT64(stats.polls),
+                DLT_STRING(", not modified: "), DLT_UINT64(stats.not_modified),
+                DLT_STRING(", errors: "), DLT_UINT64(stats.errors),
+                DLT_STRING(", bytes: "), DLT_UINT64(stats.bytes_received),
+                DLT_STRING(", parses: "), DLT_UINT64(stats.parses),
+                DLT_STRING(", avg parse us: "), DLT_UINT64(stats.parses ? stats.parse_time_us / stats.parses : 0),
+                DLT_STRING(", max parse us: "), DLT_UINT64(stats.max_parse_time_us));
+    }
+
+    FeedbackResult sendFeedbackEntry(const FeedbackEntry& entry) {
+        long http_status = 0;
+        switch (entry.kind) {
+            case FeedbackEntry::Kind::Started:
+                server_agent_.sendStartedFeedback(entry.execution_id, &http_status);
+                break;
+            case FeedbackEntry::Kind::Progress:
+                server_agent_.sendProgressFeedback(entry.execution_id, entry.progress, entry.message, &http_status);
+                break;
+            case FeedbackEntry::Kind::Finished:
+                server_agent_.sendFinishedFeedback(entry.execution_id, entry.success, entry.message, &http_status);
+                break;
+        }
+        return FeedbackQueue::resultForStatus(http_status);
+    }
 
     void checkForUpdates() {
         if (installation_started_) {
@@ -98,23 +170,38 @@ private:
 
         DLT_LOG(dlt_context_main, DLT_LOG_DEBUG, DLT_STRING("Polling for updates"));
 
-        std::string response;
-        if (!server_agent_.pollForUpdates(response)) {
+        UpdateInfo& update_info = update_info_;
+        bool polled = server_agent_.pollForUpdates(update_info);
+        logPollStats();
+        if (!polled) {
             DLT_LOG(dlt_context_main, DLT_LOG_WARN, DLT_STRING("Failed to poll for updates"));
             return;
         }
 
-        UpdateInfo update_info;
-        if (!server_agent_.parseUpdateResponse(response, update_info)) {
-            DLT_LOG(dlt_context_main, DLT_LOG_DEBUG, DLT_STRING("No updates available"));
+        // Unchanged since the last poll: nothing was parsed
+        if (server_agent_.lastPollNotModified()) {
+            DLT_LOG(dlt_context_main, DLT_LOG_DEBUG, DLT_STRING("Controller base not modified"));
             return;
         }
 
+        if (update_info.polling_sleep_seconds > 0) {
+            server_poll_sleep_seconds_ = update_info.polling_sleep_seconds;
+        }
+
         if (!update_info.is_available) {
             DLT_LOG(dlt_context_main, DLT_LOG_DEBUG, DLT_STRING("No new updates"));
             return;
         }
 
+        // hawkBit keeps offering the deployment until it receives the final result
+        if (feedback_queue_.hasPendingResult(update_info.execution_id)) {
+            DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Final result for execution still pending delivery, skipping: "),
+                    DLT_STRING(update_info.execution_id.c_str()));
+            // Re-evaluate the deployment on the next poll instead of getting a 304 for it
+            server_agent_.invalidatePollCache();
+            return;
+        }
+
         DLT_LOG(dlt_context_main, DLT_LOG_INFO,
                 DLT_STRING("Update available - ID: "), DLT_STRING(update_info.execution_id.c_str()),
                 DLT_STRING(", Version: "), DLT_STRING(update_info.version.c_str()));
@@ -123,6 +210,23 @@ private:
     }
 
     void processUpdate(const UpdateInfo& update_info) {
+        DownloadPriority priority = DownloadPolicy::priorityFromDeployment(update_info.download_type);
+
+        if (!download_policy_.isDownloadAllowed(priority, time(nullptr))) {
+            int minutes = download_policy_.minutesUntilWindow(time(nullptr));
+            DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Outside download window, deferring for "), DLT_INT(minutes),
+                    DLT_STRING(" min: "), DLT_STRING(update_info.execution_id.c_str()));
+            // Report the deferral once per deployment; polling continues until the window opens
+            if (deferred_execution_id_ != update_info.execution_id) {
+                deferred_execution_id_ = update_info.execution_id;
+                feedback_queue_.enqueueProgress(update_info.execution_id, 0,
+                                                "Download deferred to window, opens in " + std::to_string(minutes) + " min");
+            }
+            server_agent_.invalidatePollCache();
+            return;
+        }
+        deferred_execution_id_.clear();
+
         current_execution_id_ = update_info.execution_id;
         installation_in_progress_ = true;
         installation_started_ = true; // Disable polling permanently once installation starts
@@ -130,26 +234,30 @@ private:
         DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Installation started - polling disabled until system reset"));
 
         // Send started feedback
-        server_agent_.sendStartedFeedback(current_execution_id_);
+        feedback_queue_.enqueueStarted(current_execution_id_);
 
         // Download bundle
         DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Downloading bundle"));
 
-        if (!server_agent_.downloadBundle(update_info.download_url, UPDATE_BUNDLE_PATH, update_info.expected_size)) {
+        DownloadShaper shaper(download_policy_, priority);
+        feedback_queue_.enqueueProgress(current_execution_id_, 0, shaper.describe());
+
+        if (!server_agent_.downloadBundle(update_info.download_url, UPDATE_BUNDLE_PATH, update_info.expected_size, &shaper)) {
             DLT_LOG(dlt_context_main, DLT_LOG_ERROR, DLT_STRING("Failed to download bundle"));
-            server_agent_.sendFinishedFeedback(current_execution_id_, false, "Download failed");
+            feedback_queue_.enqueueFinished(current_execution_id_, false, "Download failed: " + shaper.describe());
             installation_in_progress_ = false;
             return;
         }
 
         DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Bundle downloaded successfully"));
+        feedback_queue_.enqueueProgress(current_execution_id_, 0, "Download complete: " + shaper.describe());
 
         // Install bundle via ServiceAgent
         DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Starting bundle installation"));
 
         if (!service_agent_.installBundle(UPDATE_BUNDLE_PATH)) {
             DLT_LOG(dlt_context_main, DLT_LOG_ERROR, DLT_STRING("Failed to start bundle installation"));
-            server_agent_.sendFinishedFeedback(current_execution_id_, false, "Installation failed to start");
+            feedback_queue_.enqueueFinished(current_execution_id_, false, "Installation failed to start");
             installation_in_progress_ = false;
             return;
         }
@@ -161,8 +269,9 @@ private:
     void handleInstallProgress(int progress) {
         DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Installation progress: "), DLT_INT(progress), DLT_STRING("%"));
 
+        // Called from the D-Bus dispatch path: queue only, the worker thread does the HTTP
         if (!current_execution_id_.empty()) {
-            server_agent_.sendProgressFeedback(current_execution_id_, progress);
+            feedback_queue_.enqueueProgress(current_execution_id_, progress);
         }
     }
 
@@ -173,8 +282,8 @@ private:
 
         if (!current_execution_id_.empty()) {
             // Send progress 100% before final feedback
-            server_agent_.sendProgressFeedback(current_execution_id_, 100, "Installation completed");
-            server_agent_.sendFinishedFeedback(current_execution_id_, success, message);
+            feedback_queue_.enqueueProgress(current_execution_id_, 100, "Installation completed");
+            feedback_queue_.enqueueFinished(current_execution_id_, success, message);
             current_execution_id_.clear();
         }
 
@@ -191,6 +300,11 @@ private:
                 DLT_LOG(dlt_context_main, DLT_LOG_ERROR, DLT_STRING("Failed to clean up downloaded bundle file"));
             }
 
+            // Give the worker a chance to deliver the final result; anything left is persisted
+            if (!feedback_queue_.flush(std::chrono::seconds(FEEDBACK_FLUSH_TIMEOUT_SECONDS))) {
+                DLT_LOG(dlt_context_main, DLT_LOG_WARN, DLT_STRING("Feedback not fully delivered before reboot, will resend after boot"));
+            }
+
             // Reboot system to boot into new image
             DLT_LOG(dlt_context_main, DLT_LOG_INFO, DLT_STRING("Update completed successfully. Rebooting system to new image..."));
             std::this_thread::sleep_for(std::chrono::seconds(REBOOT_DELAY_SECONDS)); // Brief delay for log message
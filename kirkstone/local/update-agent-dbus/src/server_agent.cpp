@@ -12,64 +12,40 @@
 
 DLT_DECLARE_CONTEXT(dlt_context);
 
+namespace {
+
+std::unique_ptr<HttpTransport> makeTransport(const std::shared_ptr<HttpShare>& share) {
+    HttpClientOptions options;
+    options.verify_ssl = ENABLE_SSL_VERIFICATION;
+    return std::unique_ptr<HttpTransport>(new CurlTransport(options, share));
+}
+
+} // namespace
+
 ServerAgent::ServerAgent(const std::string& server_url, const std::string& tenant, const std::string& device_id)
-    : server_url_(server_url), tenant_(tenant), device_id_(device_id), curl_handle_(nullptr) {
+    : ServerAgent(server_url, tenant, device_id, nullptr, nullptr) {}
+
+ServerAgent::ServerAgent(const std::string& server_url, const std::string& tenant, const std::string& device_id,
+                         std::unique_ptr<HttpTransport> transport, std::unique_ptr<HttpTransport> feedback_transport)
+    : server_url_(server_url), tenant_(tenant), device_id_(device_id),
+      http_share_(std::make_shared<HttpShare>()),
+      http_client_(transport ? std::move(transport) : makeTransport(http_share_)),
+      feedback_client_(feedback_transport ? std::move(feedback_transport) : makeTransport(http_share_)),
+      last_poll_not_modified_(false) {
     DLT_REGISTER_CONTEXT(dlt_context, "SVRA", "Update Agent Logic");
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Initializing update agent"));
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Server URL: "), DLT_STRING(server_url_.c_str()));
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Tenant: "), DLT_STRING(tenant_.c_str()));
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Device ID: "), DLT_STRING(device_id_.c_str()));
-
-    curl_global_init(CURL_GLOBAL_ALL);
-    curl_handle_ = curl_easy_init();
-
-    if (curl_handle_) {
-        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("CURL handle initialized successfully"));
-    } else {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Failed to initialize CURL handle"));
-    }
 }
 
 ServerAgent::~ServerAgent() {
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Cleaning up update agent"));
-    if (curl_handle_) {
-        curl_easy_cleanup(curl_handle_);
-        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("CURL handle cleaned up"));
-    }
-    curl_global_cleanup();
     DLT_UNREGISTER_CONTEXT(dlt_context);
 }
 
-size_t ServerAgent::writeCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    if (!userp) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("writeCallback: userp is null"));
-        return 0;
-    }
-
-    if (!contents) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("writeCallback: contents is null"));
-        return 0;
-    }
-
-    size_t total_size = size * nmemb;
-
-    try {
-        userp->append((char*)contents, total_size);
-        return total_size;
-    } catch (const std::exception& e) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Exception in writeCallback: "), DLT_STRING(e.what()));
-        return 0;
-    } catch (...) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Unknown exception in writeCallback"));
-        return 0;
-    }
-}
-
-size_t ServerAgent::writeFileCallback(void* contents, size_t size, size_t nmemb, FILE* file) {
-    if (!contents || !file || size == 0 || nmemb == 0) {
-        return 0;
-    }
-    return fwrite(contents, size, nmemb, file);
+int ServerAgent::parsePollingSleep(const std::string& sleep) {
+    return DeploymentParser::parsePollingSleep(sleep.c_str());
 }
 
 std::string ServerAgent::buildPollUrl() const {
@@ -84,92 +60,124 @@ std::string ServerAgent::buildFeedbackUrl(const std::string& execution_id) const
     return url;
 }
 
-void ServerAgent::setupDownloadCurlOptions() {
-    if (!curl_handle_) return;
-
-    // Based on host-updater reference implementation
-
-    // Basic options
-    curl_easy_setopt(curl_handle_, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl_handle_, CURLOPT_MAXREDIRS, 3L);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, DOWNLOAD_TIMEOUT_SECONDS);
+void ServerAgent::updatePollHeaders(const std::string& etag) {
+    if (etag == poll_etag_) {
+        return;
+    }
+    poll_etag_ = etag;
+    poll_headers_.clear();
+    if (!poll_etag_.empty()) {
+        // Conditional request: the server answers 304 without a body if nothing changed
+        poll_headers_.append("If-None-Match: " + poll_etag_);
+    }
+}
 
-    // Connection timeout
-    curl_easy_setopt(curl_handle_, CURLOPT_CONNECTTIMEOUT, 30L);
+bool ServerAgent::performPoll(HttpRequest& request, HttpResponse& http_response) {
+    last_poll_not_modified_ = false;
+    poll_stats_.polls++;
 
-    // Low speed limit (abort if speed drops below 1KB/s for 60 seconds)
-    curl_easy_setopt(curl_handle_, CURLOPT_LOW_SPEED_LIMIT, 1024L);
-    curl_easy_setopt(curl_handle_, CURLOPT_LOW_SPEED_TIME, 60L);
+    request.url = buildPollUrl();
+    request.headers = poll_headers_.empty() ? nullptr : &poll_headers_;
+    request.timeout_seconds = HTTP_TIMEOUT_SECONDS;
+    request.follow_redirects = FOLLOW_REDIRECTS;
 
-    // SSL options
-    curl_easy_setopt(curl_handle_, CURLOPT_SSL_VERIFYPEER, ENABLE_SSL_VERIFICATION ? 1L : 0L);
-    curl_easy_setopt(curl_handle_, CURLOPT_SSL_VERIFYHOST, ENABLE_SSL_VERIFICATION ? 2L : 0L);
+    DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Polling for updates from: "), DLT_STRING(request.url.c_str()));
 
-    // User agent
-    curl_easy_setopt(curl_handle_, CURLOPT_USERAGENT, "host-updater-cpp/1.0");
+    bool performed = http_client_.perform(request, http_response);
+    poll_stats_.bytes_received += http_response.bytes_received;
 
-    // Accept ranges for resumable downloads
-    curl_easy_setopt(curl_handle_, CURLOPT_RANGE, NULL); // Clear any previous range
+    if (!performed) {
+        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Poll request failed: "), DLT_STRING(http_response.error.c_str()));
+        poll_stats_.errors++;
+        return false;
+    }
 
-    // Disable progress meter to avoid interference with DLT logging
-    curl_easy_setopt(curl_handle_, CURLOPT_NOPROGRESS, 1L);
+    long http_code = http_response.status_code;
+    DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Poll response HTTP code: "), DLT_INT(http_code));
 
-    // Enable TCP keep-alive
-    curl_easy_setopt(curl_handle_, CURLOPT_TCP_KEEPALIVE, 1L);
-    curl_easy_setopt(curl_handle_, CURLOPT_TCP_KEEPIDLE, 120L);
-    curl_easy_setopt(curl_handle_, CURLOPT_TCP_KEEPINTVL, 60L);
+    if (http_code == 200) {
+        updatePollHeaders(http_response.etag);
+        return true;
+    } else if (http_code == 304) {
+        last_poll_not_modified_ = true;
+        poll_stats_.not_modified++;
+        DLT_LOG(dlt_context, DLT_LOG_DEBUG, DLT_STRING("Poll response not modified (HTTP 304)"));
+        return true;
+    } else if (http_code == 204) {
+        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("No updates available (HTTP 204)"));
+        return true;
+    } else {
+        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("HTTP error: "), DLT_INT(http_code));
+        poll_stats_.errors++;
+        return false;
+    }
+}
 
-    DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("CURL download options configured"));
+void ServerAgent::recordParseTime(std::chrono::steady_clock::duration elapsed) {
+    uint64_t parse_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    poll_stats_.parses++;
+    poll_stats_.parse_time_us += parse_us;
+    if (parse_us > poll_stats_.max_parse_time_us) {
+        poll_stats_.max_parse_time_us = parse_us;
+    }
 }
 
 bool ServerAgent::pollForUpdates(std::string& response) {
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
+    response.clear();
+
+    HttpRequest request;
+    HttpResponse http_response;
+    if (!performPoll(request, http_response)) {
         return false;
     }
 
-    // Reset CURL handle to clean state
-    curl_easy_reset(curl_handle_);
-
-    response.clear();
-    std::string url = buildPollUrl();
+    if (http_response.status_code == 200) {
+        response.swap(http_response.body);
+        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Poll successful, response length: "), DLT_UINT(response.length()));
+    }
+    return true;
+}
 
-    DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Polling for updates from: "), DLT_STRING(url.c_str()));
+bool ServerAgent::pollForUpdates(UpdateInfo& update_info) {
+    poll_parser_.reset(update_info);
 
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, HTTP_TIMEOUT_SECONDS);
-    curl_easy_setopt(curl_handle_, CURLOPT_FOLLOWLOCATION, FOLLOW_REDIRECTS ? 1L : 0L);
+    // Parse while curl delivers the body; the status code decides afterwards whether the result counts
+    std::chrono::steady_clock::duration parse_time(0);
+    HttpRequest request;
+    request.body_sink = [this, &parse_time](const char* data, size_t len) {
+        auto start = std::chrono::steady_clock::now();
+        poll_parser_.feed(data, len);
+        parse_time += std::chrono::steady_clock::now() - start;
+        return true;
+    };
 
-    CURLcode res = curl_easy_perform(curl_handle_);
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("curl_easy_perform() failed: "), DLT_STRING(curl_easy_strerror(res)));
-        return false;
+    HttpResponse http_response;
+    bool polled = performPoll(request, http_response);
+    if (!polled || http_response.status_code != 200) {
+        update_info.clear();
+        return polled;
     }
 
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
-
-    DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Poll response HTTP code: "), DLT_INT(http_code));
+    auto finish_start = std::chrono::steady_clock::now();
+    bool parsed = poll_parser_.finish();
+    recordParseTime(parse_time + (std::chrono::steady_clock::now() - finish_start));
 
-    if (http_code == 200) {
-        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Poll successful, response length: "), DLT_UINT(response.length()));
-        DLT_LOG(dlt_context, DLT_LOG_DEBUG, DLT_STRING("Poll response: "), DLT_STRING(response.c_str()));
-        return true;
-    } else if (http_code == 204) {
-        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("No updates available (HTTP 204)"));
-        return true;
-    } else {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("HTTP error: "), DLT_INT(http_code));
-        return false;
+    if (!parsed) {
+        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Failed to parse poll response, length: "),
+                DLT_UINT64(http_response.bytes_received));
+    } else if (update_info.is_available) {
+        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Deployment "), DLT_STRING(update_info.execution_id.c_str()),
+                DLT_STRING(" version "), DLT_STRING(update_info.version.c_str()),
+                DLT_STRING(" from "), DLT_STRING(update_info.download_url.c_str()));
+    } else if (poll_parser_.hasDeployment()) {
+        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Deployment without execution ID or download URL"));
     }
+    return true;
 }
 
 bool ServerAgent::parseUpdateResponse(const std::string& response, UpdateInfo& update_info) {
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Parsing update response"));
     DLT_LOG(dlt_context, DLT_LOG_DEBUG, DLT_STRING("Response length: "), DLT_UINT(response.length()));
-    DLT_LOG(dlt_context, DLT_LOG_DEBUG, DLT_STRING("Response content: "), DLT_STRING(response.c_str()));
 
     update_info.is_available = false;
 
@@ -178,7 +186,10 @@ bool ServerAgent::parseUpdateResponse(const std::string& response, UpdateInfo& u
         return false;
     }
 
+    auto parse_start = std::chrono::steady_clock::now();
     json_object* root = json_tokener_parse(response.c_str());
+    recordParseTime(std::chrono::steady_clock::now() - parse_start);
+
     if (!root) {
         DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Failed to parse JSON response"));
         return false;
@@ -186,6 +197,17 @@ bool ServerAgent::parseUpdateResponse(const std::string& response, UpdateInfo& u
 
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("JSON parsed successfully"));
 
+    // Server-provided polling interval: config.polling.sleep
+    json_object* config_obj;
+    json_object* polling_obj;
+    json_object* sleep_obj;
+    if (json_object_object_get_ex(root, "config", &config_obj) &&
+        json_object_object_get_ex(config_obj, "polling", &polling_obj) &&
+        json_object_object_get_ex(polling_obj, "sleep", &sleep_obj)) {
+        update_info.polling_sleep_seconds = parsePollingSleep(json_object_get_string(sleep_obj));
+        DLT_LOG(dlt_context, DLT_LOG_DEBUG, DLT_STRING("Server polling sleep: "), DLT_INT(update_info.polling_sleep_seconds), DLT_STRING(" s"));
+    }
+
     // Check if there's a deployment
     json_object* deployment_obj;
     if (json_object_object_get_ex(root, "deployment", &deployment_obj)) {
@@ -223,6 +245,13 @@ bool ServerAgent::parseDeploymentInfo(json_object* deployment_obj, UpdateInfo& u
     // Get deployment info
     json_object* deployment_info_obj;
     if (json_object_object_get_ex(deployment_obj, "deployment", &deployment_info_obj)) {
+        // Download type drives the download priority class
+        json_object* download_obj;
+        if (json_object_object_get_ex(deployment_info_obj, "download", &download_obj)) {
+            update_info.download_type = json_object_get_string(download_obj);
+            DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Download type: "), DLT_STRING(update_info.download_type.c_str()));
+        }
+
         // Get version
         json_object* version_obj;
         if (json_object_object_get_ex(deployment_info_obj, "chunks", &version_obj)) {
@@ -329,13 +358,35 @@ bool ServerAgent::parseArtifactInfo(json_object* artifact_obj, UpdateInfo& updat
     return success;
 }
 
-bool ServerAgent::sendStartedFeedback(const std::string& execution_id) {
-    DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Sending started feedback for execution: "), DLT_STRING(execution_id.c_str()));
+bool ServerAgent::postFeedback(const std::string& execution_id, json_object* root, const char* kind, long* http_status) {
+    std::string json(json_object_to_json_string(root));
+    json_object_put(root);
+    DLT_LOG(dlt_context, DLT_LOG_DEBUG, DLT_STRING(kind), DLT_STRING(" JSON: "), DLT_STRING(json.c_str()));
 
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
+    std::lock_guard<std::mutex> lock(feedback_mutex_);
+    HttpResponse response;
+    if (http_status) {
+        *http_status = 0;
+    }
+    if (!feedback_client_.postJson(buildFeedbackUrl(execution_id), json, response, HTTP_TIMEOUT_SECONDS)) {
+        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING(kind), DLT_STRING(" send failed: "), DLT_STRING(response.error.c_str()));
         return false;
     }
+    if (http_status) {
+        *http_status = response.status_code;
+    }
+
+    if (response.status_code == 200) {
+        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING(kind), DLT_STRING(" sent successfully"));
+        return true;
+    } else {
+        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING(kind), DLT_STRING(" HTTP error: "), DLT_INT(response.status_code));
+        return false;
+    }
+}
+
+bool ServerAgent::sendStartedFeedback(const std::string& execution_id, long* http_status) {
+    DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Sending started feedback for execution: "), DLT_STRING(execution_id.c_str()));
 
     json_object* root = json_object_new_object();
     json_object* execution = json_object_new_object();
@@ -349,50 +400,12 @@ bool ServerAgent::sendStartedFeedback(const std::string& execution_id) {
     json_object_object_add(root, "id", json_object_new_string(execution_id.c_str()));
     json_object_object_add(root, "execution", execution);
 
-    const char* json_string = json_object_to_json_string(root);
-    DLT_LOG(dlt_context, DLT_LOG_DEBUG, DLT_STRING("Started feedback JSON: "), DLT_STRING(json_string));
-
-    // Copy the JSON string before freeing the object
-    std::string json_copy(json_string);
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    // Minimal CURL configuration for POST request - avoid curl_easy_reset to prevent SEGFAULT
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, buildFeedbackUrl(execution_id).c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_POSTFIELDS, json_copy.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, 30L);
-
-    CURLcode res = curl_easy_perform(curl_handle_);
-    curl_slist_free_all(headers);
-    json_object_put(root);
-
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Started feedback send failed: "), DLT_STRING(curl_easy_strerror(res)));
-        return false;
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code == 200) {
-        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Started feedback sent successfully"));
-        return true;
-    } else {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Started feedback HTTP error: "), DLT_INT(http_code));
-        return false;
-    }
+    return postFeedback(execution_id, root, "Started feedback", http_status);
 }
 
-bool ServerAgent::sendProgressFeedback(const std::string& execution_id, int progress, const std::string& message) {
+bool ServerAgent::sendProgressFeedback(const std::string& execution_id, int progress, const std::string& message, long* http_status) {
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Sending progress feedback for execution: "), DLT_STRING(execution_id.c_str()), DLT_STRING(" Progress: "), DLT_INT(progress), DLT_STRING("%"));
 
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
-        return false;
-    }
-
     json_object* root = json_object_new_object();
     json_object* execution = json_object_new_object();
     json_object* result = json_object_new_object();
@@ -410,50 +423,12 @@ bool ServerAgent::sendProgressFeedback(const std::string& execution_id, int prog
     json_object_object_add(root, "id", json_object_new_string(execution_id.c_str()));
     json_object_object_add(root, "execution", execution);
 
-    const char* json_string = json_object_to_json_string(root);
-    DLT_LOG(dlt_context, DLT_LOG_DEBUG, DLT_STRING("Progress feedback JSON: "), DLT_STRING(json_string));
-
-    // Copy the JSON string before freeing the object
-    std::string json_copy(json_string);
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    // Minimal CURL configuration for POST request - avoid curl_easy_reset to prevent SEGFAULT
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, buildFeedbackUrl(execution_id).c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_POSTFIELDS, json_copy.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, 30L);
-
-    CURLcode res = curl_easy_perform(curl_handle_);
-    curl_slist_free_all(headers);
-    json_object_put(root);
-
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Progress feedback send failed: "), DLT_STRING(curl_easy_strerror(res)));
-        return false;
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code == 200) {
-        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Progress feedback sent successfully: "), DLT_INT(progress), DLT_STRING("%"));
-        return true;
-    } else {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Progress feedback HTTP error: "), DLT_INT(http_code));
-        return false;
-    }
+    return postFeedback(execution_id, root, "Progress feedback", http_status);
 }
 
-bool ServerAgent::sendFinishedFeedback(const std::string& execution_id, bool success, const std::string& message) {
+bool ServerAgent::sendFinishedFeedback(const std::string& execution_id, bool success, const std::string& message, long* http_status) {
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Sending finished feedback for execution: "), DLT_STRING(execution_id.c_str()), DLT_STRING(" Success: "), DLT_BOOL(success));
 
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
-        return false;
-    }
-
     json_object* root = json_object_new_object();
     json_object* execution = json_object_new_object();
     json_object* result = json_object_new_object();
@@ -471,40 +446,7 @@ bool ServerAgent::sendFinishedFeedback(const std::string& execution_id, bool suc
     json_object_object_add(root, "id", json_object_new_string(execution_id.c_str()));
     json_object_object_add(root, "execution", execution);
 
-    const char* json_string = json_object_to_json_string(root);
-    DLT_LOG(dlt_context, DLT_LOG_DEBUG, DLT_STRING("Finished feedback JSON: "), DLT_STRING(json_string));
-
-    // Copy the JSON string before freeing the object
-    std::string json_copy(json_string);
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    // Minimal CURL configuration for POST request - avoid curl_easy_reset to prevent SEGFAULT
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, buildFeedbackUrl(execution_id).c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_POSTFIELDS, json_copy.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, 30L);
-
-    CURLcode res = curl_easy_perform(curl_handle_);
-    curl_slist_free_all(headers);
-    json_object_put(root);
-
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Finished feedback send failed: "), DLT_STRING(curl_easy_strerror(res)));
-        return false;
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code == 200) {
-        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Finished feedback sent successfully: "), DLT_STRING(success ? "success" : "failure"));
-        return true;
-    } else {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Finished feedback HTTP error: "), DLT_INT(http_code));
-        return false;
-    }
+    return postFeedback(execution_id, root, "Finished feedback", http_status);
 }
 
 bool ServerAgent::downloadBundle(const std::string& download_url, const std::string& local_path) {
@@ -512,6 +454,10 @@ bool ServerAgent::downloadBundle(const std::string& download_url, const std::str
 }
 
 bool ServerAgent::downloadBundle(const std::string& download_url, const std::string& local_path, long expected_size) {
+    return downloadBundle(download_url, local_path, expected_size, nullptr);
+}
+
+bool ServerAgent::downloadBundle(const std::string& download_url, const std::string& local_path, long expected_size, DownloadShaper* shaper) {
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("=== Starting bundle download ==="));
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Download URL: "), DLT_STRING(download_url.c_str()));
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Local path: "), DLT_STRING(local_path.c_str()));
@@ -522,11 +468,6 @@ bool ServerAgent::downloadBundle(const std::string& download_url, const std::str
         return false;
     }
 
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
-        return false;
-    }
-
     // Remove existing file if present
     if (access(local_path.c_str(), F_OK) == 0) {
         DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Removing existing file"));
@@ -546,26 +487,27 @@ bool ServerAgent::downloadBundle(const std::string& download_url, const std::str
 
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("File opened successfully for writing"));
 
-    // Reset CURL handle to clean state
-    curl_easy_reset(curl_handle_);
-
-    // Configure CURL options step by step
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, download_url.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEFUNCTION, writeFileCallback);
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEDATA, file);
-    curl_easy_setopt(curl_handle_, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, 300L); // 5 minute timeout
-    curl_easy_setopt(curl_handle_, CURLOPT_CONNECTTIMEOUT, 30L);
-    curl_easy_setopt(curl_handle_, CURLOPT_USERAGENT, "host-updater-cpp/1.0");
-    curl_easy_setopt(curl_handle_, CURLOPT_SSL_VERIFYPEER, 0L); // Disable for debugging
-    curl_easy_setopt(curl_handle_, CURLOPT_SSL_VERIFYHOST, 0L);
-    curl_easy_setopt(curl_handle_, CURLOPT_NOPROGRESS, 1L);
+    HttpRequest request;
+    request.url = download_url;
+    request.output_file = file;
+    request.timeout_seconds = DOWNLOAD_TIMEOUT_SECONDS;
+    request.connect_timeout_seconds = 30;
+    // Abort if speed drops below 1KB/s for 60 seconds
+    request.low_speed_limit = 1024;
+    request.low_speed_time = 60;
+    request.follow_redirects = true;
+    if (shaper) {
+        request.max_recv_speed = shaper->initialRate();
+        request.progress = [shaper](HttpTransferStatus& status) { return shaper->onProgress(status); };
+        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING(shaper->describe().c_str()));
+    }
 
-    DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("CURL configured, starting download..."));
+    DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Request configured, starting download..."));
 
     // Perform download
     auto start_time = std::chrono::steady_clock::now();
-    CURLcode res = curl_easy_perform(curl_handle_);
+    HttpResponse response;
+    bool performed = http_client_.perform(request, response);
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
@@ -577,17 +519,18 @@ bool ServerAgent::downloadBundle(const std::string& download_url, const std::str
     }
 
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Download completed in "), DLT_INT(duration.count()), DLT_STRING(" ms"));
+    if (shaper) {
+        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING(shaper->describe().c_str()));
+    }
 
-    // Check CURL result
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("CURL error: "), DLT_STRING(curl_easy_strerror(res)));
+    if (!performed) {
+        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Download failed: "), DLT_STRING(response.error.c_str()));
         remove(local_path.c_str()); // Clean up partial file
         return false;
     }
 
     // Check HTTP status
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
+    long http_code = response.status_code;
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("HTTP response code: "), DLT_INT(http_code));
 
     if (http_code != 200) {
@@ -629,13 +572,6 @@ bool ServerAgent::downloadBundle(const std::string& download_url, const std::str
 bool ServerAgent::sendFeedback(const std::string& execution_id, const std::string& status, const std::string& message) {
     DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Sending feedback for execution: "), DLT_STRING(execution_id.c_str()));
 
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
-        return false;
-    }
-
-    std::string url = buildFeedbackUrl(execution_id);
-
     // Create JSON payload
     json_object* root = json_object_new_object();
     json_object* execution = json_object_new_object();
@@ -653,34 +589,5 @@ bool ServerAgent::sendFeedback(const std::string& execution_id, const std::strin
         json_object_object_add(result, "message", json_object_new_string(message.c_str()));
     }
 
-    const char* json_string = json_object_to_json_string(root);
-    DLT_LOG(dlt_context, DLT_LOG_DEBUG, DLT_STRING("Feedback JSON: "), DLT_STRING(json_string));
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_POSTFIELDS, json_string);
-    curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, 30L);
-
-    CURLcode res = curl_easy_perform(curl_handle_);
-    curl_slist_free_all(headers);
-    json_object_put(root);
-
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Feedback send failed: "), DLT_STRING(curl_easy_strerror(res)));
-        return false;
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code == 200) {
-        DLT_LOG(dlt_context, DLT_LOG_INFO, DLT_STRING("Feedback sent successfully"));
-        return true;
-    } else {
-        DLT_LOG(dlt_context, DLT_LOG_ERROR, DLT_STRING("Feedback HTTP error: "), DLT_INT(http_code));
-        return false;
-    }
+    return postFeedback(execution_id, root, "Feedback");
 }
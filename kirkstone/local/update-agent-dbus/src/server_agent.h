@@ -4,51 +4,79 @@
 #include <string>
 #include <memory>
 #include <vector>
-#include <curl/curl.h>
+#include <mutex>
+#include <cstdint>
+#include <chrono>
 #include <json-c/json.h>
+#include "http_client.h"
+#include "download_policy.h"
+#include "deployment_parser.h"
+#include "update_info.h"
 
-// Update information structure
-struct UpdateInfo {
-    std::string execution_id;
-    std::string download_url;
-    std::string version;
-    std::string description;
-    std::string filename;
-    long expected_size;
-    std::string md5_hash;
-    std::string sha1_hash;
-    std::string sha256_hash;
-    bool is_available;
-
-    UpdateInfo() : expected_size(0), is_available(false) {}
+// Poll cost counters
+struct PollStats {
+    uint64_t polls;
+    uint64_t not_modified;
+    uint64_t errors;
+    uint64_t bytes_received;
+    uint64_t parses;
+    uint64_t parse_time_us;
+    uint64_t max_parse_time_us;
+
+    PollStats() : polls(0), not_modified(0), errors(0), bytes_received(0), parses(0), parse_time_us(0), max_parse_time_us(0) {}
 };
 
 class ServerAgent {
 public:
     ServerAgent(const std::string& server_url, const std::string& tenant, const std::string& device_id);
+    // Transports are injectable for tests; the default uses keep-alive curl handles sharing DNS and TLS sessions
+    ServerAgent(const std::string& server_url, const std::string& tenant, const std::string& device_id,
+                std::unique_ptr<HttpTransport> transport, std::unique_ptr<HttpTransport> feedback_transport);
     ~ServerAgent();
 
     bool pollForUpdates(std::string& response);
+    // Streams the body through DeploymentParser into update_info (cleared first, string capacity reused).
+    // Returns false on transport/HTTP errors; update_info.is_available tells whether a deployment is pending
+    bool pollForUpdates(UpdateInfo& update_info);
     bool downloadBundle(const std::string& download_url, const std::string& local_path);
     bool downloadBundle(const std::string& download_url, const std::string& local_path, long expected_size);
+    // Rate limited by the shaper, which may adjust the limit during the transfer
+    bool downloadBundle(const std::string& download_url, const std::string& local_path, long expected_size, DownloadShaper* shaper);
     bool sendFeedback(const std::string& execution_id, const std::string& status, const std::string& message = "");
 
+    // Reference json-c DOM parser for a complete response body
     bool parseUpdateResponse(const std::string& response, UpdateInfo& update_info);
-    bool sendProgressFeedback(const std::string& execution_id, int progress, const std::string& message = "");
-    bool sendStartedFeedback(const std::string& execution_id);
-    bool sendFinishedFeedback(const std::string& execution_id, bool success, const std::string& message = "");
+    // http_status, if given, receives the response status (0 on a transport error)
+    bool sendProgressFeedback(const std::string& execution_id, int progress, const std::string& message = "", long* http_status = nullptr);
+    bool sendStartedFeedback(const std::string& execution_id, long* http_status = nullptr);
+    bool sendFinishedFeedback(const std::string& execution_id, bool success, const std::string& message = "", long* http_status = nullptr);
+
+    // True if the last poll returned 304 Not Modified (response body is empty)
+    bool lastPollNotModified() const { return last_poll_not_modified_; }
+    void invalidatePollCache() { updatePollHeaders(""); }
+    const PollStats& getPollStats() const { return poll_stats_; }
+    static int parsePollingSleep(const std::string& sleep);
 
 private:
     std::string server_url_;
     std::string tenant_;
     std::string device_id_;
-    CURL* curl_handle_;
+    std::shared_ptr<HttpShare> http_share_;  // DNS cache and TLS sessions shared by both clients
+    HttpClient http_client_;
+    HttpClient feedback_client_;  // Feedback is sent from the feedback worker thread
+    std::mutex feedback_mutex_;
+    HttpHeaderList poll_headers_;  // Rebuilt only when the ETag changes
+    std::string poll_etag_;
+    bool last_poll_not_modified_;
+    PollStats poll_stats_;
+    DeploymentParser poll_parser_;
 
-    static size_t writeCallback(void* contents, size_t size, size_t nmemb, std::string* userp);
-    static size_t writeFileCallback(void* contents, size_t size, size_t nmemb, FILE* file);
     std::string buildPollUrl() const;
     std::string buildFeedbackUrl(const std::string& execution_id) const;
-    void setupDownloadCurlOptions();
+    void updatePollHeaders(const std::string& etag);
+    bool performPoll(HttpRequest& request, HttpResponse& http_response);
+    void recordParseTime(std::chrono::steady_clock::duration elapsed);
+    bool postFeedback(const std::string& execution_id, json_object* root, const char* kind, long* http_status = nullptr);
 
     bool parseDeploymentInfo(json_object* deployment_obj, UpdateInfo& update_info);
     bool parseArtifactInfo(json_object* artifact_obj, UpdateInfo& update_info);
@@ -1,10 +1,17 @@
 #include "service_agent.h"
 #include <dlt/dlt.h>
+#include <chrono>
 #include <cstring>
+#include <thread>
 #include <unistd.h> // For access()
 
 DLT_DECLARE_CONTEXT(dlt_context_updater);
 
+// Reply of a broker that released its name to exit while idle; a new call activates a new broker
+static const char* BROKER_EXITING_ERROR = "org.freedesktop.UpdateService.Error.Exiting";
+static const int BROKER_EXITING_ATTEMPTS = 3;
+static const int BROKER_EXITING_RETRY_DELAY_MS = 100;
+
 ServiceAgent::ServiceAgent() : connection_(nullptr), connected_(false) {
     DLT_REGISTER_CONTEXT(dlt_context_updater, "SVCA", "Service Agent - Update Service Broker Client");
     DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("Initializing Service Agent (Update Service Broker Client)"));
@@ -42,21 +49,7 @@ bool ServiceAgent::connect() {
 
     DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("Update service broker is available"));
 
-    // Add message filter for update service broker signals
-    dbus_bus_add_match(connection_,
-        "type='signal',interface='org.freedesktop.UpdateService'",
-        &error);
-
-    if (dbus_error_is_set(&error)) {
-        DLT_LOG(dlt_context_updater, DLT_LOG_ERROR, DLT_STRING("DBus match error: "), DLT_STRING(error.message));
-        dbus_error_free(&error);
-        dbus_connection_unref(connection_);
-        connection_ = nullptr;
-        return false;
-    }
-
-    DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("DBus signal filter added"));
-
+    // No match rule: Progress and Completed are addressed to us while subscribed (see installBundle)
     dbus_connection_add_filter(connection_, messageHandler, this, nullptr);
     connected_ = true;
     DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("Successfully connected to update service broker DBus"));
@@ -101,7 +94,7 @@ bool ServiceAgent::sendMethodCall(const std::string& method, const std::string&
 
     DLT_LOG(dlt_context_updater, DLT_LOG_DEBUG, DLT_STRING("DBus message created, sending..."));
 
-    DBusMessage* reply = dbus_connection_send_with_reply_and_block(connection_, message, -1, nullptr);
+    DBusMessage* reply = callBroker(message, -1, nullptr);
     dbus_message_unref(message);
 
     if (!reply) {
@@ -146,23 +139,18 @@ bool ServiceAgent::sendMethodCallWithPath(const std::string& method, const std::
     DLT_LOG(dlt_context_updater, DLT_LOG_DEBUG, DLT_STRING("DBus message created with path, sending..."));
 
     // Send with timeout (30 seconds)
-    DBusMessage* reply = dbus_connection_send_with_reply_and_block(connection_, message, 30000, nullptr);
+    DBusError error;
+    dbus_error_init(&error);
+    DBusMessage* reply = callBroker(message, 30000, &error);
     dbus_message_unref(message);
 
     if (!reply) {
-        DLT_LOG(dlt_context_updater, DLT_LOG_ERROR, DLT_STRING("Failed to get reply for method: "), DLT_STRING(method.c_str()), DLT_STRING(" (timeout or no response)"));
-        return false;
-    }
-
-    // Check if reply is an error
-    if (dbus_message_get_type(reply) == DBUS_MESSAGE_TYPE_ERROR) {
-        DBusError error;
-        dbus_error_init(&error);
-        if (dbus_set_error_from_message(&error, reply)) {
+        if (dbus_error_is_set(&error)) {
             DLT_LOG(dlt_context_updater, DLT_LOG_ERROR, DLT_STRING("DBus error reply: "), DLT_STRING(error.name), DLT_STRING(" - "), DLT_STRING(error.message));
             dbus_error_free(&error);
+        } else {
+            DLT_LOG(dlt_context_updater, DLT_LOG_ERROR, DLT_STRING("Failed to get reply for method: "), DLT_STRING(method.c_str()), DLT_STRING(" (timeout or no response)"));
         }
-        dbus_message_unref(reply);
         return false;
     }
 
@@ -171,6 +159,32 @@ bool ServiceAgent::sendMethodCallWithPath(const std::string& method, const std::
     return true;
 }
 
+DBusMessage* ServiceAgent::callBroker(DBusMessage* message, int timeout_ms, DBusError* error) {
+    DBusError call_error;
+    dbus_error_init(&call_error);
+    for (int attempt = 1;; attempt++) {
+        // A sent message is locked and keeps its serial: every attempt sends a fresh copy
+        DBusMessage* call = dbus_message_copy(message);
+        if (!call) {
+            return nullptr;
+        }
+        DBusMessage* reply = dbus_connection_send_with_reply_and_block(connection_, call, timeout_ms, &call_error);
+        dbus_message_unref(call);
+        if (reply || !dbus_error_has_name(&call_error, BROKER_EXITING_ERROR) || attempt == BROKER_EXITING_ATTEMPTS) {
+            if (error) {
+                dbus_move_error(&call_error, error);
+            } else {
+                dbus_error_free(&call_error);
+            }
+            return reply;
+        }
+        dbus_error_free(&call_error);
+        DLT_LOG(dlt_context_updater, DLT_LOG_WARN, DLT_STRING("Update service broker is exiting, retrying call: "),
+                DLT_STRING(dbus_message_get_member(message)));
+        std::this_thread::sleep_for(std::chrono::milliseconds(BROKER_EXITING_RETRY_DELAY_MS));
+    }
+}
+
 bool ServiceAgent::checkService() {
     if (!connected_) {
         DLT_LOG(dlt_context_updater, DLT_LOG_WARN, DLT_STRING("Not connected to DBus"));
@@ -224,17 +238,81 @@ bool ServiceAgent::installBundle(const std::string& bundle_path) {
         return false;
     }
 
+    // The broker sends Progress and Completed to subscribers only; subscribe before RAUC can report anything
+    if (!subscribe()) {
+        DLT_LOG(dlt_context_updater, DLT_LOG_ERROR, DLT_STRING("Failed to subscribe to update service signals"));
+        return false;
+    }
+
     bool result = sendMethodCallWithPath("Install", bundle_path, "org.freedesktop.UpdateService");
 
     if (result) {
         DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("Bundle installation started successfully"));
     } else {
         DLT_LOG(dlt_context_updater, DLT_LOG_ERROR, DLT_STRING("Bundle installation failed to start"));
+        unsubscribe();
     }
 
     return result;
 }
 
+bool ServiceAgent::subscribe() {
+    DBusMessage* message = dbus_message_new_method_call(
+        "org.freedesktop.UpdateService",
+        "/org/freedesktop/UpdateService",
+        "org.freedesktop.UpdateService",
+        "Subscribe"
+    );
+    if (!message) {
+        return false;
+    }
+
+    // Default options: every Progress percentage and Completed
+    DBusMessageIter iter, options;
+    dbus_message_iter_init_append(message, &iter);
+    if (!dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "{sv}", &options) ||
+        !dbus_message_iter_close_container(&iter, &options)) {
+        dbus_message_unref(message);
+        return false;
+    }
+
+    DBusError error;
+    dbus_error_init(&error);
+    DBusMessage* reply = callBroker(message, 5000, &error);
+    dbus_message_unref(message);
+    if (!reply) {
+        DLT_LOG(dlt_context_updater, DLT_LOG_ERROR, DLT_STRING("Subscribe failed: "),
+                DLT_STRING(dbus_error_is_set(&error) ? error.message : "no reply"));
+        dbus_error_free(&error);
+        return false;
+    }
+    dbus_message_unref(reply);
+    DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("Subscribed to update service signals"));
+    return true;
+}
+
+void ServiceAgent::unsubscribe() {
+    if (!connection_) {
+        return;
+    }
+    DBusMessage* message = dbus_message_new_method_call(
+        "org.freedesktop.UpdateService",
+        "/org/freedesktop/UpdateService",
+        "org.freedesktop.UpdateService",
+        "Unsubscribe"
+    );
+    if (!message) {
+        return;
+    }
+    // Called from the signal handler: do not wait for the reply. A broker that already exited
+    // dropped the subscription with it.
+    dbus_message_set_no_reply(message, TRUE);
+    dbus_message_set_auto_start(message, FALSE);
+    dbus_connection_send(connection_, message, nullptr);
+    dbus_message_unref(message);
+    DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("Unsubscribed from update service signals"));
+}
+
 bool ServiceAgent::getStatus(std::string& status) {
     if (!connected_) {
         DLT_LOG(dlt_context_updater, DLT_LOG_WARN, DLT_STRING("Not connected to DBus"));
@@ -284,7 +362,7 @@ bool ServiceAgent::getStatus(std::string& status) {
     DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("Interface: org.freedesktop.DBus.Properties"));
     DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("Property: Operation"));
 
-    DBusMessage* reply = dbus_connection_send_with_reply_and_block(connection_, message, 5000, &error); // Reduced to 5 seconds
+    DBusMessage* reply = callBroker(message, 5000, &error); // Reduced to 5 seconds
     dbus_message_unref(message);
 
     if (!reply) {
@@ -339,7 +417,7 @@ bool ServiceAgent::getBootSlot(std::string& boot_slot) {
     if (!message) {
         return false;
     }
-    DBusMessage* reply = dbus_connection_send_with_reply_and_block(connection_, message, -1, nullptr);
+    DBusMessage* reply = callBroker(message, -1, nullptr);
     dbus_message_unref(message);
     if (!reply) {
         return false;
@@ -395,7 +473,7 @@ bool ServiceAgent::markGood() {
         return false;
     }
 
-    DBusMessage* reply = dbus_connection_send_with_reply_and_block(connection_, message, 30000, nullptr);
+    DBusMessage* reply = callBroker(message, 30000, nullptr);
     dbus_message_unref(message);
 
     if (!reply) {
@@ -447,7 +525,7 @@ bool ServiceAgent::markBad() {
         return false;
     }
 
-    DBusMessage* reply = dbus_connection_send_with_reply_and_block(connection_, message, 30000, nullptr);
+    DBusMessage* reply = callBroker(message, 30000, nullptr);
     dbus_message_unref(message);
 
     if (!reply) {
@@ -547,6 +625,9 @@ void ServiceAgent::handleSignal(DBusMessage* message) {
 
             DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("Completed signal: Success="), DLT_BOOL(success), DLT_STRING(", Message: "), DLT_STRING(message_text.c_str()));
 
+            // The installation is over: let the broker exit when idle
+            unsubscribe();
+
             if (completed_callback_) {
                 DLT_LOG(dlt_context_updater, DLT_LOG_INFO, DLT_STRING("Calling completed callback"));
                 completed_callback_(success, message_text);
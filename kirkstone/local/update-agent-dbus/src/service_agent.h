@@ -33,8 +33,13 @@ private:
     std::function<void(int)> progress_callback_;
     std::function<void(bool, const std::string&)> completed_callback_;
 
+    // Blocking call to the broker; retried while an idle broker answers Error.Exiting
+    DBusMessage* callBroker(DBusMessage* message, int timeout_ms, DBusError* error);
     bool sendMethodCall(const std::string& method, const std::string& interface);
     bool sendMethodCallWithPath(const std::string& method, const std::string& path, const std::string& interface);
+    // Progress/Completed subscription for the duration of one installation
+    bool subscribe();
+    void unsubscribe();
     static DBusHandlerResult messageHandler(DBusConnection* connection, DBusMessage* message, void* user_data);
     void handleSignal(DBusMessage* message);
 };
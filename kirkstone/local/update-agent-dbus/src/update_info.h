@@ -0,0 +1,53 @@
+#ifndef UPDATE_INFO_H
+#define UPDATE_INFO_H
+
+#include <string>
+
+// Update information structure
+struct UpdateInfo {
+    std::string execution_id;
+    std::string download_url;
+    std::string version;
+    std::string description;
+    std::string filename;
+    long expected_size;
+    std::string md5_hash;
+    std::string sha1_hash;
+    std::string sha256_hash;
+    bool is_available;
+    std::string download_type;  // hawkBit deployment "download": forced, attempt or skip
+    int polling_sleep_seconds;  // config.polling.sleep from the server, -1 if absent
+
+    UpdateInfo() : expected_size(0), is_available(false), polling_sleep_seconds(-1) {}
+
+    // Reserve typical hawkBit field sizes so repeated polls into the same instance do not allocate
+    void reserve() {
+        execution_id.reserve(64);
+        download_url.reserve(512);
+        version.reserve(64);
+        description.reserve(128);
+        filename.reserve(128);
+        md5_hash.reserve(32);
+        sha1_hash.reserve(40);
+        sha256_hash.reserve(64);
+        download_type.reserve(16);
+    }
+
+    // Reset to defaults, keeping string capacity
+    void clear() {
+        execution_id.clear();
+        download_url.clear();
+        version.clear();
+        description.clear();
+        filename.clear();
+        expected_size = 0;
+        md5_hash.clear();
+        sha1_hash.clear();
+        sha256_hash.clear();
+        is_available = false;
+        download_type.clear();
+        polling_sleep_seconds = -1;
+    }
+};
+
+#endif // UPDATE_INFO_H
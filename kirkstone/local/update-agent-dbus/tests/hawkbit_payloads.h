@@ -0,0 +1,95 @@
+#ifndef HAWKBIT_PAYLOADS_H
+#define HAWKBIT_PAYLOADS_H
+
+#include <string>
+
+// Representative controller responses, shared by the parser tests and the parse benchmark
+namespace hawkbit_payloads {
+
+// Idle poll: no deployment pending
+inline std::string idle() {
+    return R"({
+  "config" : {
+    "polling" : {
+      "sleep" : "00:05:00"
+    }
+  },
+  "_links" : {
+    "configData" : {
+      "href" : "https://hawkbit.example.com/DEFAULT/controller/v1/nuc-device-001/configData"
+    }
+  }
+})";
+}
+
+// Single bundle deployment as the agent expects it
+inline std::string deployment() {
+    return R"({
+  "config" : { "polling" : { "sleep" : "00:00:30" } },
+  "deployment" : {
+    "id" : "8147",
+    "deployment" : {
+      "download" : "forced",
+      "update" : "forced",
+      "maintenanceWindow" : "available",
+      "chunks" : [ {
+        "part" : "os",
+        "version" : "1.4.2",
+        "name" : "nuc-image",
+        "metadata" : [ { "key" : "channel", "value" : "stable" } ]
+      } ]
+    },
+    "actionHistory" : {
+      "status" : "RUNNING",
+      "messages" : [ "Update Server: Assignment initiated by user 'admin'", "Update Server: Target retrieved" ]
+    },
+    "artifacts" : [ {
+      "filename" : "nuc-image-1.4.2.raucb",
+      "hashes" : {
+        "sha1" : "2d86c2a659e364e9abba49ea6ffcd53dd5559f05",
+        "md5" : "0d1b08c34858921bc7c662b228acb7ba",
+        "sha256" : "a03b221c6c6eae7122ca51695d456d5222e524889136394944b2f9763b483615"
+      },
+      "size" : 524288000,
+      "_links" : {
+        "download-http" : {
+          "href" : "https://hawkbit.example.com/DEFAULT/controller/v1/nuc-device-001/softwaremodules/23/artifacts/nuc-image-1.4.2.raucb"
+        },
+        "md5sum-http" : {
+          "href" : "https://hawkbit.example.com/DEFAULT/controller/v1/nuc-device-001/softwaremodules/23/artifacts/nuc-image-1.4.2.raucb.MD5SUM"
+        }
+      }
+    } ]
+  }
+})";
+}
+
+// Deployment with many modules, artifacts and a long action history
+inline std::string largeDeployment(int entries) {
+    std::string chunks;
+    std::string artifacts;
+    std::string messages;
+    for (int i = 0; i < entries; ++i) {
+        std::string n = std::to_string(i);
+        if (i > 0) {
+            chunks += ",";
+            artifacts += ",";
+            messages += ",";
+        }
+        chunks += R"({ "part" : "app-)" + n + R"(", "version" : "3.)" + n + R"(.0", "name" : "module-)" + n +
+                  R"(", "metadata" : [ { "key" : "k)" + n + R"(", "value" : "vé)" + n + R"(" } ] })";
+        artifacts += R"({ "filename" : "bundle-)" + n + R"(.raucb", "hashes" : { "sha1" : "2d86c2a659e364e9abba49ea6ffcd53dd5559f05", )"
+                     R"("md5" : "0d1b08c34858921bc7c662b228acb7ba", "sha256" : "a03b221c6c6eae7122ca51695d456d5222e524889136394944b2f9763b483615" }, )"
+                     R"("size" : )" + std::to_string(1048576 + i) + R"(, "_links" : { "download-http" : { "href" : "https://hawkbit.example.com/DEFAULT/controller/v1/nuc-device-001/softwaremodules/)" +
+                     n + R"(/artifacts/bundle-)" + n + R"(.raucb" } } })";
+        messages += R"("Update Server: retry )" + n + R"( \"scheduled\"")";
+    }
+    return R"({ "config" : { "polling" : { "sleep" : "00:01:00" } }, "deployment" : { "id" : "9001", )"
+           R"("deployment" : { "download" : "attempt", "update" : "attempt", "chunks" : [ )" + chunks + R"( ] }, )"
+           R"("actionHistory" : { "status" : "RUNNING", "messages" : [ )" + messages + R"( ] }, )"
+           R"("artifacts" : [ )" + artifacts + R"( ] } })";
+}
+
+} // namespace hawkbit_payloads
+
+#endif // HAWKBIT_PAYLOADS_H
@@ -0,0 +1,177 @@
+#include <gtest/gtest.h>
+#include "deployment_parser.h"
+#include "server_agent.h"
+#include "config.h"
+#include "hawkbit_payloads.h"
+#include <string>
+
+class DeploymentParserTest : public ::testing::Test {
+protected:
+    bool parseInChunks(const std::string& json, size_t chunk_size, UpdateInfo& info) {
+        parser.reset(info);
+        for (size_t offset = 0; offset < json.size(); offset += chunk_size) {
+            if (!parser.feed(json.data() + offset, std::min(chunk_size, json.size() - offset))) {
+                break;
+            }
+        }
+        return parser.finish();
+    }
+
+    void expectSameInfo(const UpdateInfo& a, const UpdateInfo& b) {
+        EXPECT_EQ(a.execution_id, b.execution_id);
+        EXPECT_EQ(a.download_url, b.download_url);
+        EXPECT_EQ(a.version, b.version);
+        EXPECT_EQ(a.description, b.description);
+        EXPECT_EQ(a.filename, b.filename);
+        EXPECT_EQ(a.expected_size, b.expected_size);
+        EXPECT_EQ(a.md5_hash, b.md5_hash);
+        EXPECT_EQ(a.sha1_hash, b.sha1_hash);
+        EXPECT_EQ(a.sha256_hash, b.sha256_hash);
+        EXPECT_EQ(a.is_available, b.is_available);
+        EXPECT_EQ(a.download_type, b.download_type);
+        EXPECT_EQ(a.polling_sleep_seconds, b.polling_sleep_seconds);
+    }
+
+    DeploymentParser parser;
+};
+
+TEST_F(DeploymentParserTest, ExtractsDeploymentFields) {
+    UpdateInfo info;
+    ASSERT_TRUE(parseInChunks(hawkbit_payloads::deployment(), 4096, info));
+
+    EXPECT_TRUE(info.is_available);
+    EXPECT_EQ(info.execution_id, "8147");
+    EXPECT_EQ(info.download_type, "forced");
+    EXPECT_EQ(info.version, "1.4.2");
+    EXPECT_EQ(info.filename, "nuc-image-1.4.2.raucb");
+    EXPECT_EQ(info.description, info.filename);
+    EXPECT_EQ(info.expected_size, 524288000);
+    EXPECT_EQ(info.md5_hash, "0d1b08c34858921bc7c662b228acb7ba");
+    EXPECT_EQ(info.sha1_hash, "2d86c2a659e364e9abba49ea6ffcd53dd5559f05");
+    EXPECT_EQ(info.sha256_hash, "a03b221c6c6eae7122ca51695d456d5222e524889136394944b2f9763b483615");
+    EXPECT_EQ(info.download_url,
+              "https://hawkbit.example.com/DEFAULT/controller/v1/nuc-device-001/softwaremodules/23/artifacts/nuc-image-1.4.2.raucb");
+    EXPECT_EQ(info.polling_sleep_seconds, 30);
+}
+
+TEST_F(DeploymentParserTest, IdleResponseHasNoDeployment) {
+    UpdateInfo info;
+    ASSERT_TRUE(parseInChunks(hawkbit_payloads::idle(), 4096, info));
+    EXPECT_FALSE(info.is_available);
+    EXPECT_FALSE(parser.hasDeployment());
+    EXPECT_EQ(info.polling_sleep_seconds, 300);
+}
+
+TEST_F(DeploymentParserTest, MatchesDomParser) {
+    ServerAgent agent(HOST_SERVER_URL, HOST_TENANT, DEVICE_ID);
+    const std::string payloads[] = {
+        hawkbit_payloads::idle(),
+        hawkbit_payloads::deployment(),
+        hawkbit_payloads::largeDeployment(20),
+    };
+
+    for (const std::string& payload : payloads) {
+        UpdateInfo dom;
+        agent.parseUpdateResponse(payload, dom);
+        UpdateInfo streamed;
+        ASSERT_TRUE(parseInChunks(payload, 4096, streamed));
+        expectSameInfo(streamed, dom);
+    }
+}
+
+TEST_F(DeploymentParserTest, ChunkBoundariesDoNotMatter) {
+    const std::string payload = hawkbit_payloads::largeDeployment(3);
+    UpdateInfo whole;
+    ASSERT_TRUE(parseInChunks(payload, payload.size(), whole));
+
+    for (size_t chunk_size : {1u, 2u, 3u, 7u, 64u}) {
+        UpdateInfo chunked;
+        ASSERT_TRUE(parseInChunks(payload, chunk_size, chunked)) << "chunk size " << chunk_size;
+        expectSameInfo(chunked, whole);
+    }
+    EXPECT_EQ(whole.version, "3.0.0");
+    EXPECT_EQ(whole.filename, "bundle-0.raucb");
+    EXPECT_EQ(whole.expected_size, 1048576);
+}
+
+TEST_F(DeploymentParserTest, DecodesEscapes) {
+    UpdateInfo info;
+    ASSERT_TRUE(parseInChunks(R"({"deployment":{"id":"a\"b\\c\/d","deployment":{"chunks":[{"version":"caf\u00e9 \ud83d\ude00 😀"}]},)"
+                              R"("artifacts":[{"filename":"x\ty","_links":{"download-http":{"href":"http://h/x"}}}]}})",
+                              5, info));
+    EXPECT_EQ(info.execution_id, "a\"b\\c/d");
+    EXPECT_EQ(info.version, "caf\xc3\xa9 \xf0\x9f\x98\x80 \xf0\x9f\x98\x80");
+    EXPECT_EQ(info.filename, "x\ty");
+    EXPECT_TRUE(info.is_available);
+}
+
+TEST_F(DeploymentParserTest, NumericIdKeptAsText) {
+    UpdateInfo info;
+    ASSERT_TRUE(parseInChunks(R"({"deployment":{"id":77,"artifacts":[{"size":1.5e3,"links":{"download-http":{"href":"u"}}}]}})",
+                              4096, info));
+    EXPECT_EQ(info.execution_id, "77");
+    EXPECT_EQ(info.expected_size, 1500);
+    EXPECT_TRUE(info.is_available);
+}
+
+TEST_F(DeploymentParserTest, OnlyFirstChunkAndArtifactAreUsed) {
+    UpdateInfo info;
+    ASSERT_TRUE(parseInChunks(R"({"deployment":{"id":"1","deployment":{"chunks":[{"version":"1"},{"version":"2"}]},)"
+                              R"("artifacts":[{"filename":"a","_links":{"download-http":{"href":"u1"}}},)"
+                              R"({"filename":"b","_links":{"download-http":{"href":"u2"}}}]},)"
+                              R"("other":{"deployment":{"id":"x"}}})",
+                              4096, info));
+    EXPECT_EQ(info.version, "1");
+    EXPECT_EQ(info.filename, "a");
+    EXPECT_EQ(info.download_url, "u1");
+    EXPECT_EQ(info.execution_id, "1");
+}
+
+TEST_F(DeploymentParserTest, RejectsMalformedInput) {
+    const char* inputs[] = {
+        "",
+        "{",
+        R"({"deployment":{"id":"1",}})",
+        R"({"deployment" "x"})",
+        R"({"a":[1,]})",
+        R"({"a":tru})",
+        "{\"a\":\"line\nbreak\"}",
+        R"({"a":"\x"})",
+        R"({} {})",
+    };
+    for (const char* input : inputs) {
+        UpdateInfo info;
+        EXPECT_FALSE(parseInChunks(input, 4096, info)) << input;
+        EXPECT_FALSE(info.is_available);
+        EXPECT_TRUE(info.execution_id.empty());
+    }
+}
+
+TEST_F(DeploymentParserTest, RejectsExcessiveNesting) {
+    UpdateInfo info;
+    std::string deep(100, '[');
+    deep += std::string(100, ']');
+    EXPECT_FALSE(parseInChunks(deep, 4096, info));
+}
+
+TEST_F(DeploymentParserTest, ResetKeepsCapacityAndClearsFields) {
+    UpdateInfo info;
+    info.reserve();
+    ASSERT_TRUE(parseInChunks(hawkbit_payloads::deployment(), 4096, info));
+    const char* url_buffer = info.download_url.data();
+    size_t url_capacity = info.download_url.capacity();
+
+    ASSERT_TRUE(parseInChunks(hawkbit_payloads::idle(), 4096, info));
+    EXPECT_TRUE(info.download_url.empty());
+    EXPECT_TRUE(info.execution_id.empty());
+    EXPECT_EQ(info.download_url.capacity(), url_capacity);
+
+    ASSERT_TRUE(parseInChunks(hawkbit_payloads::deployment(), 4096, info));
+    EXPECT_EQ(info.download_url.data(), url_buffer);
+}
+
+TEST_F(DeploymentParserTest, ParsePollingSleep) {
+    EXPECT_EQ(DeploymentParser::parsePollingSleep("01:02:03"), 3723);
+    EXPECT_EQ(DeploymentParser::parsePollingSleep("00:00:30x"), -1);
+    EXPECT_EQ(DeploymentParser::parsePollingSleep(""), -1);
+}
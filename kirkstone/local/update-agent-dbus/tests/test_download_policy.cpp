@@ -0,0 +1,158 @@
+#include <gtest/gtest.h>
+#include "download_policy.h"
+#include <chrono>
+#include <ctime>
+
+namespace {
+
+time_t localTime(int hour, int minute) {
+    struct tm local = {};
+    local.tm_year = 2024 - 1900;
+    local.tm_mon = 0;
+    local.tm_mday = 15;
+    local.tm_hour = hour;
+    local.tm_min = minute;
+    local.tm_isdst = -1;
+    return mktime(&local);
+}
+
+DownloadPolicyConfig testConfig() {
+    DownloadPolicyConfig config;
+    config.background_rate_bps = 100 * 1024;
+    config.normal_rate_bps = 1000 * 1024;
+    config.urgent_rate_bps = 0;
+    config.window = DownloadWindow();
+    config.adaptive = true;
+    config.rtt_backoff_factor = 2.0;
+    config.adaptive_min_rate_bps = 50 * 1024;
+    config.adaptive_step_bps = 100 * 1024;
+    config.adaptive_interval_ms = 500;
+    return config;
+}
+
+} // namespace
+
+TEST(DownloadPolicyTest, ParseWindow) {
+    DownloadWindow window;
+    ASSERT_TRUE(DownloadPolicy::parseWindow("01:30-05:00", window));
+    EXPECT_EQ(window.start_minute, 90);
+    EXPECT_EQ(window.end_minute, 300);
+
+    ASSERT_TRUE(DownloadPolicy::parseWindow("", window));
+    EXPECT_EQ(window.start_minute, window.end_minute);
+
+    EXPECT_FALSE(DownloadPolicy::parseWindow("01:30", window));
+    EXPECT_FALSE(DownloadPolicy::parseWindow("25:00-05:00", window));
+    EXPECT_FALSE(DownloadPolicy::parseWindow("01:30-05:61", window));
+    EXPECT_FALSE(DownloadPolicy::parseWindow("night", window));
+    EXPECT_EQ(window.start_minute, window.end_minute);
+}
+
+TEST(DownloadPolicyTest, WindowAlwaysOpenWhenUnset) {
+    DownloadPolicy policy(testConfig());
+    EXPECT_EQ(policy.minutesUntilWindow(localTime(12, 0)), 0);
+    EXPECT_TRUE(policy.isDownloadAllowed(DownloadPriority::Background, localTime(12, 0)));
+}
+
+TEST(DownloadPolicyTest, WindowWrapsPastMidnight) {
+    DownloadPolicyConfig config = testConfig();
+    ASSERT_TRUE(DownloadPolicy::parseWindow("22:00-06:00", config.window));
+    DownloadPolicy policy(config);
+
+    EXPECT_EQ(policy.minutesUntilWindow(localTime(23, 0)), 0);
+    EXPECT_EQ(policy.minutesUntilWindow(localTime(3, 0)), 0);
+    EXPECT_EQ(policy.minutesUntilWindow(localTime(6, 0)), 16 * 60);
+    EXPECT_EQ(policy.minutesUntilWindow(localTime(21, 30)), 30);
+
+    EXPECT_FALSE(policy.isDownloadAllowed(DownloadPriority::Normal, localTime(12, 0)));
+    EXPECT_TRUE(policy.isDownloadAllowed(DownloadPriority::Normal, localTime(23, 0)));
+}
+
+TEST(DownloadPolicyTest, UrgentIgnoresWindow) {
+    DownloadPolicyConfig config = testConfig();
+    ASSERT_TRUE(DownloadPolicy::parseWindow("02:00-04:00", config.window));
+    DownloadPolicy policy(config);
+
+    EXPECT_FALSE(policy.isDownloadAllowed(DownloadPriority::Background, localTime(12, 0)));
+    EXPECT_FALSE(policy.isDownloadAllowed(DownloadPriority::Normal, localTime(12, 0)));
+    EXPECT_TRUE(policy.isDownloadAllowed(DownloadPriority::Urgent, localTime(12, 0)));
+}
+
+TEST(DownloadPolicyTest, PriorityFromDeploymentType) {
+    EXPECT_EQ(DownloadPolicy::priorityFromDeployment("forced"), DownloadPriority::Urgent);
+    EXPECT_EQ(DownloadPolicy::priorityFromDeployment("attempt"), DownloadPriority::Normal);
+    EXPECT_EQ(DownloadPolicy::priorityFromDeployment("skip"), DownloadPriority::Background);
+    EXPECT_EQ(DownloadPolicy::priorityFromDeployment(""), DownloadPriority::Normal);
+
+    DownloadPolicy policy(testConfig());
+    EXPECT_EQ(policy.rateLimit(DownloadPriority::Background), 100 * 1024);
+    EXPECT_EQ(policy.rateLimit(DownloadPriority::Normal), 1000 * 1024);
+    EXPECT_EQ(policy.rateLimit(DownloadPriority::Urgent), 0);
+}
+
+TEST(DownloadPolicyTest, ShaperBacksOffOnRttRiseAndRecovers) {
+    DownloadPolicy policy(testConfig());
+    DownloadShaper shaper(policy, DownloadPriority::Normal);
+    auto t = std::chrono::steady_clock::now();
+    uint64_t downloaded = 0;
+    auto sample = [&](long rtt_us) {
+        t += std::chrono::milliseconds(500);
+        downloaded += 256 * 1024;
+        return shaper.onRttSample(rtt_us, downloaded, t);
+    };
+
+    EXPECT_EQ(sample(10000), 1000 * 1024);
+    EXPECT_EQ(sample(11000), 1000 * 1024);
+    EXPECT_EQ(shaper.backoffs(), 0);
+
+    // Queueing delay builds up on the uplink
+    for (int i = 0; i < 5; ++i) {
+        sample(60000);
+    }
+    EXPECT_GT(shaper.backoffs(), 0);
+    EXPECT_LT(shaper.currentRate(), 1000 * 1024);
+    EXPECT_GE(shaper.currentRate(), 50 * 1024);
+    EXPECT_EQ(shaper.baselineRttUs(), 10000);
+
+    // RTT settles, limit climbs back to the class limit
+    for (int i = 0; i < 30; ++i) {
+        sample(10000);
+    }
+    EXPECT_EQ(shaper.currentRate(), 1000 * 1024);
+}
+
+TEST(DownloadPolicyTest, ShaperIgnoresSmallRttJitter) {
+    DownloadPolicy policy(testConfig());
+    DownloadShaper shaper(policy, DownloadPriority::Background);
+    auto t = std::chrono::steady_clock::now();
+
+    // 1 ms -> 3 ms exceeds the factor but is below the queueing threshold
+    shaper.onRttSample(1000, 0, t);
+    for (int i = 1; i <= 5; ++i) {
+        shaper.onRttSample(3000, i * 50000, t + std::chrono::milliseconds(500 * i));
+    }
+    EXPECT_EQ(shaper.backoffs(), 0);
+    EXPECT_EQ(shaper.currentRate(), 100 * 1024);
+}
+
+TEST(DownloadPolicyTest, AdaptiveDisabledKeepsClassLimit) {
+    DownloadPolicyConfig config = testConfig();
+    config.adaptive = false;
+    DownloadPolicy policy(config);
+    DownloadShaper shaper(policy, DownloadPriority::Normal);
+
+    HttpTransferStatus status;
+    status.downloaded = 1024;
+    status.total = 4096;
+    status.rtt_us = 80000;
+    status.max_recv_speed = shaper.initialRate();
+    EXPECT_TRUE(shaper.onProgress(status));
+    EXPECT_EQ(status.max_recv_speed, 1000 * 1024);
+    EXPECT_EQ(shaper.describe(), "Download priority normal, limit 1000 KiB/s");
+}
+
+TEST(DownloadPolicyTest, DescribeReportsAdaptiveState) {
+    DownloadPolicy policy(testConfig());
+    DownloadShaper shaper(policy, DownloadPriority::Urgent);
+    EXPECT_EQ(shaper.describe(), "Download priority urgent, limit unlimited, adaptive (now unlimited, 0 backoffs)");
+}
@@ -0,0 +1,330 @@
+#include <gtest/gtest.h>
+#include "feedback_queue.h"
+#include "config.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+class FeedbackQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        persist_path = "/tmp/test_feedback_queue_" + std::to_string(getpid());
+        std::remove(persist_path.c_str());
+    }
+
+    void TearDown() override {
+        std::remove(persist_path.c_str());
+    }
+
+    FeedbackQueue::Sender recordingSender(FeedbackResult result = FeedbackResult::Delivered) {
+        return [this, result](const FeedbackEntry& entry) {
+            std::lock_guard<std::mutex> lock(sent_mutex);
+            sent.push_back(entry);
+            return result;
+        };
+    }
+
+    std::vector<FeedbackEntry> sentEntries() {
+        std::lock_guard<std::mutex> lock(sent_mutex);
+        return sent;
+    }
+
+    std::string persist_path;
+    std::mutex sent_mutex;
+    std::vector<FeedbackEntry> sent;
+};
+
+TEST_F(FeedbackQueueTest, DeliversEntriesInOrder) {
+    FeedbackQueue queue(recordingSender(), persist_path);
+    queue.start();
+
+    queue.enqueueStarted("exec-1");
+    queue.enqueueProgress("exec-1", 50);
+    queue.enqueueFinished("exec-1", true, "done");
+
+    ASSERT_TRUE(queue.flush(std::chrono::seconds(5)));
+
+    auto entries = sentEntries();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[0].kind, FeedbackEntry::Kind::Started);
+    EXPECT_EQ(entries[1].kind, FeedbackEntry::Kind::Progress);
+    EXPECT_EQ(entries[1].progress, 50);
+    EXPECT_EQ(entries[2].kind, FeedbackEntry::Kind::Finished);
+    EXPECT_TRUE(entries[2].success);
+    EXPECT_EQ(entries[2].message, "done");
+}
+
+TEST_F(FeedbackQueueTest, CoalescesProgressPerExecution) {
+    // Progress is enqueued before the worker starts, so it must collapse to the latest value
+    FeedbackQueue queue(recordingSender(), persist_path);
+
+    for (int progress = 0; progress <= 100; progress += 10) {
+        queue.enqueueProgress("exec-1", progress);
+    }
+    queue.enqueueProgress("exec-2", 5);
+    EXPECT_EQ(queue.size(), 2u);
+
+    queue.start();
+    ASSERT_TRUE(queue.flush(std::chrono::seconds(5)));
+
+    auto entries = sentEntries();
+    ASSERT_EQ(entries.size(), 2u);
+    EXPECT_EQ(entries[0].execution_id, "exec-1");
+    EXPECT_EQ(entries[0].progress, 100);
+    EXPECT_EQ(entries[1].execution_id, "exec-2");
+    EXPECT_EQ(entries[1].progress, 5);
+}
+
+TEST_F(FeedbackQueueTest, EnqueueDoesNotBlockOnSlowSender) {
+    std::mutex gate_mutex;
+    std::condition_variable gate_cv;
+    bool released = false;
+
+    FeedbackQueue queue([&](const FeedbackEntry&) {
+        std::unique_lock<std::mutex> lock(gate_mutex);
+        gate_cv.wait(lock, [&] { return released; });
+        return FeedbackResult::Delivered;
+    }, persist_path);
+    queue.start();
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int progress = 0; progress < 100; ++progress) {
+        queue.enqueueProgress("exec-1", progress);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 100);
+
+    {
+        std::lock_guard<std::mutex> lock(gate_mutex);
+        released = true;
+    }
+    gate_cv.notify_all();
+    EXPECT_TRUE(queue.flush(std::chrono::seconds(5)));
+}
+
+TEST_F(FeedbackQueueTest, RetriesFailedSendWithBackoff) {
+    std::atomic<int> calls{0};
+    FeedbackQueue queue([&](const FeedbackEntry&) {
+        return ++calls >= 3 ? FeedbackResult::Delivered : FeedbackResult::Retry;
+    }, persist_path);
+    queue.start();
+
+    auto begin = std::chrono::steady_clock::now();
+    queue.enqueueFinished("exec-1", false, "failed");
+    ASSERT_TRUE(queue.flush(std::chrono::seconds(10)));
+    auto elapsed = std::chrono::steady_clock::now() - begin;
+
+    EXPECT_EQ(calls.load(), 3);
+    // Two retries: initial delay plus the doubled delay
+    EXPECT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), FEEDBACK_RETRY_INITIAL_MS * 3);
+}
+
+TEST_F(FeedbackQueueTest, DropsUndeliverableProgress) {
+    std::atomic<int> calls{0};
+    FeedbackQueue queue([&](const FeedbackEntry&) {
+        ++calls;
+        return FeedbackResult::Retry;
+    }, persist_path);
+    queue.start();
+
+    queue.enqueueProgress("exec-1", 10);
+    ASSERT_TRUE(queue.flush(std::chrono::seconds(30)));
+    EXPECT_EQ(calls.load(), FEEDBACK_MAX_ATTEMPTS);
+}
+
+TEST_F(FeedbackQueueTest, PersistsUnsentFinalResult) {
+    {
+        FeedbackQueue queue(recordingSender(FeedbackResult::Retry), persist_path);
+        queue.enqueueProgress("exec-1", 40);
+        queue.enqueueFinished("exec-1", true, "Installation\tcompleted\n");
+        EXPECT_TRUE(queue.hasPendingResult("exec-1"));
+        EXPECT_FALSE(queue.hasPendingResult("exec-2"));
+    }
+
+    std::ifstream file(persist_path);
+    ASSERT_TRUE(file.is_open()) << "Final result must be written to disk";
+
+    // A new queue (e.g. after reboot) picks the result up and delivers it
+    sent.clear();
+    FeedbackQueue restored(recordingSender(), persist_path);
+    EXPECT_TRUE(restored.hasPendingResult("exec-1"));
+    EXPECT_EQ(restored.size(), 1u);
+
+    restored.start();
+    ASSERT_TRUE(restored.flush(std::chrono::seconds(5)));
+
+    auto entries = sentEntries();
+    ASSERT_EQ(entries.size(), 1u);
+    EXPECT_EQ(entries[0].kind, FeedbackEntry::Kind::Finished);
+    EXPECT_EQ(entries[0].execution_id, "exec-1");
+    EXPECT_TRUE(entries[0].success);
+    EXPECT_EQ(entries[0].message, "Installation completed ");
+    EXPECT_FALSE(restored.hasPendingResult("exec-1"));
+
+    // Delivered results are removed from disk
+    std::ifstream after(persist_path);
+    EXPECT_FALSE(after.is_open());
+}
+
+TEST_F(FeedbackQueueTest, ClassifiesHttpStatus) {
+    EXPECT_EQ(FeedbackQueue::resultForStatus(200), FeedbackResult::Delivered);
+    EXPECT_EQ(FeedbackQueue::resultForStatus(0), FeedbackResult::Retry);
+    EXPECT_EQ(FeedbackQueue::resultForStatus(500), FeedbackResult::Retry);
+    EXPECT_EQ(FeedbackQueue::resultForStatus(503), FeedbackResult::Retry);
+    EXPECT_EQ(FeedbackQueue::resultForStatus(408), FeedbackResult::Retry);
+    EXPECT_EQ(FeedbackQueue::resultForStatus(429), FeedbackResult::Retry);
+    EXPECT_EQ(FeedbackQueue::resultForStatus(400), FeedbackResult::Rejected);
+    EXPECT_EQ(FeedbackQueue::resultForStatus(404), FeedbackResult::Rejected);
+    EXPECT_EQ(FeedbackQueue::resultForStatus(410), FeedbackResult::Rejected);
+}
+
+TEST_F(FeedbackQueueTest, DropsRejectedFinalResult) {
+    std::atomic<int> calls{0};
+    FeedbackQueue queue([&](const FeedbackEntry& entry) {
+        ++calls;
+        return entry.execution_id == "exec-1" ? FeedbackResult::Rejected : FeedbackResult::Delivered;
+    }, persist_path);
+
+    queue.enqueueFinished("exec-1", true, "done");
+    queue.enqueueStarted("exec-2");
+    queue.start();
+    ASSERT_TRUE(queue.flush(std::chrono::seconds(5)));
+
+    // One attempt each, the rejected result is neither retried nor kept on disk
+    EXPECT_EQ(calls.load(), 2);
+    EXPECT_FALSE(queue.hasPendingResult("exec-1"));
+    std::ifstream file(persist_path);
+    EXPECT_FALSE(file.is_open());
+}
+
+TEST_F(FeedbackQueueTest, BackedOffResultDoesNotBlockLaterEntries) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::string> attempts;
+    FeedbackQueue queue([&](const FeedbackEntry& entry) {
+        std::lock_guard<std::mutex> lock(mutex);
+        attempts.push_back(entry.execution_id);
+        cv.notify_all();
+        return entry.execution_id == "exec-1" ? FeedbackResult::Retry : FeedbackResult::Delivered;
+    }, persist_path);
+    queue.start();
+
+    queue.enqueueFinished("exec-1", true, "done");
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return attempts.size() == 1; }));
+    }
+
+    // exec-1 now waits FEEDBACK_RETRY_INITIAL_MS; the new deployment goes first
+    queue.enqueueStarted("exec-2");
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return attempts.size() >= 2; }));
+        EXPECT_EQ(attempts[1], "exec-2");
+    }
+    EXPECT_TRUE(queue.hasPendingResult("exec-1"));
+}
+
+TEST_F(FeedbackQueueTest, FlushPersistsWhileSenderIsBusy) {
+    std::mutex gate_mutex;
+    std::condition_variable gate_cv;
+    bool released = false;
+    FeedbackQueue queue([&](const FeedbackEntry&) {
+        std::unique_lock<std::mutex> lock(gate_mutex);
+        gate_cv.wait(lock, [&] { return released; });
+        return FeedbackResult::Delivered;
+    }, persist_path);
+    queue.start();
+
+    // The worker is stuck in the first send, so only flush() can write the result
+    queue.enqueueStarted("exec-1");
+    queue.enqueueFinished("exec-1", true, "done");
+    EXPECT_FALSE(queue.flush(std::chrono::milliseconds(100)));
+    {
+        std::ifstream file(persist_path);
+        EXPECT_TRUE(file.is_open());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(gate_mutex);
+        released = true;
+    }
+    gate_cv.notify_all();
+    ASSERT_TRUE(queue.flush(std::chrono::seconds(5)));
+    std::ifstream after(persist_path);
+    EXPECT_FALSE(after.is_open());
+}
+
+TEST_F(FeedbackQueueTest, FinishedIsNotOvertakenByRetriedProgress) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<FeedbackEntry> attempts;
+    FeedbackQueue queue([&](const FeedbackEntry& entry) {
+        std::lock_guard<std::mutex> lock(mutex);
+        attempts.push_back(entry);
+        cv.notify_all();
+        return entry.kind == FeedbackEntry::Kind::Progress ? FeedbackResult::Retry : FeedbackResult::Delivered;
+    }, persist_path);
+    queue.start();
+
+    queue.enqueueProgress("exec-1", 50);
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(cv.wait_for(lock, std::chrono::seconds(5), [&] { return attempts.size() == 1; }));
+    }
+
+    // The progress waits FEEDBACK_RETRY_INITIAL_MS, the result is sent right away and must stay last
+    queue.enqueueFinished("exec-1", true, "done");
+    ASSERT_TRUE(queue.flush(std::chrono::seconds(5)));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    ASSERT_EQ(attempts.size(), 2u);
+    EXPECT_EQ(attempts[0].kind, FeedbackEntry::Kind::Progress);
+    EXPECT_EQ(attempts[1].kind, FeedbackEntry::Kind::Finished);
+}
+
+TEST_F(FeedbackQueueTest, ProgressFailingAfterFinishedIsDropped) {
+    std::mutex gate_mutex;
+    std::condition_variable gate_cv;
+    bool sending = false;
+    bool released = false;
+    std::vector<FeedbackEntry::Kind> attempts;
+    FeedbackQueue queue([&](const FeedbackEntry& entry) {
+        std::unique_lock<std::mutex> lock(gate_mutex);
+        attempts.push_back(entry.kind);
+        if (entry.kind != FeedbackEntry::Kind::Progress) {
+            return FeedbackResult::Delivered;
+        }
+        sending = true;
+        gate_cv.notify_all();
+        gate_cv.wait(lock, [&] { return released; });
+        return FeedbackResult::Retry;
+    }, persist_path);
+    queue.start();
+
+    // The result is enqueued while the progress is in flight; the failed progress is not retried
+    queue.enqueueProgress("exec-1", 50);
+    {
+        std::unique_lock<std::mutex> lock(gate_mutex);
+        ASSERT_TRUE(gate_cv.wait_for(lock, std::chrono::seconds(5), [&] { return sending; }));
+    }
+    queue.enqueueFinished("exec-1", false, "failed");
+    queue.enqueueProgress("exec-1", 60);
+    {
+        std::lock_guard<std::mutex> lock(gate_mutex);
+        released = true;
+    }
+    gate_cv.notify_all();
+    ASSERT_TRUE(queue.flush(std::chrono::seconds(5)));
+
+    std::lock_guard<std::mutex> lock(gate_mutex);
+    ASSERT_EQ(attempts.size(), 2u);
+    EXPECT_EQ(attempts[0], FeedbackEntry::Kind::Progress);
+    EXPECT_EQ(attempts[1], FeedbackEntry::Kind::Finished);
+}
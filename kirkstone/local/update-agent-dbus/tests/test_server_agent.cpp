@@ -28,6 +28,48 @@
 
 namespace {
 
+/**
+ * @class FakeHttpTransport
+ * @brief 네트워크 없이 ServerAgent 요청을 기록하는 전송 계층
+ */
+class FakeHttpTransport : public HttpTransport {
+public:
+    bool perform(const HttpRequest& request, HttpResponse& response) override {
+        response.clear();
+        urls.push_back(request.url);
+        bodies.push_back(request.body);
+
+        std::string if_none_match;
+        for (curl_slist* header = request.headers ? request.headers->get() : nullptr; header; header = header->next) {
+            const std::string line(header->data);
+            if (line.compare(0, 15, "If-None-Match: ") == 0) {
+                if_none_match = line.substr(15);
+            }
+        }
+        sent_etags.push_back(if_none_match);
+
+        if (!etag.empty() && if_none_match == etag) {
+            response.status_code = 304;
+        } else {
+            response.status_code = 200;
+            response.etag = etag;
+            if (request.body_sink) {
+                request.body_sink(body.data(), body.size());
+            } else {
+                response.body = body;
+            }
+        }
+        response.bytes_received = request.body_sink && response.status_code == 200 ? body.size() : response.body.size();
+        return true;
+    }
+
+    std::string body = "{}";
+    std::string etag;
+    std::vector<std::string> urls;
+    std::vector<std::string> bodies;
+    std::vector<std::string> sent_etags;
+};
+
 /**
  * @class ServerAgentTest
  * @brief ServerAgent 테스트 클래스
@@ -377,4 +419,165 @@ TEST_F(ServerAgentTest, EmptyParameterHandling) {
     }) << "빈 execution_id에 대해서도 예외가 발생하지 않아야 합니다";
 }
 
+/**
+ * @brief 폴링 주기 문자열 파싱 테스트
+ *
+ * hawkBit config.polling.sleep ("HH:MM:SS") 형식을
+ * 초 단위로 올바르게 변환하는지 검증합니다.
+ */
+TEST_F(ServerAgentTest, ParsePollingSleep) {
+    EXPECT_EQ(ServerAgent::parsePollingSleep("00:01:00"), 60);
+    EXPECT_EQ(ServerAgent::parsePollingSleep("00:00:05"), 5);
+    EXPECT_EQ(ServerAgent::parsePollingSleep("01:30:15"), 5415);
+
+    // 잘못된 형식은 -1을 반환해야 함
+    const std::vector<std::string> invalid_values = {"", "60", "00:60:00", "00:00:61", "aa:bb:cc", "00:01:00x"};
+    for (const auto& value : invalid_values) {
+        EXPECT_EQ(ServerAgent::parsePollingSleep(value), -1)
+            << "잘못된 폴링 주기 '" << value << "'는 -1이어야 합니다";
+    }
+}
+
+/**
+ * @brief 서버 폴링 주기 추출 및 파싱 통계 테스트
+ *
+ * 응답의 config.polling.sleep이 UpdateInfo에 반영되고
+ * 파싱 횟수가 통계에 집계되는지 검증합니다.
+ */
+TEST_F(ServerAgentTest, ParseResponseRecordsPollingSleepAndStats) {
+    // Given: 초기 통계는 모두 0
+    const PollStats& stats = server_agent_->getPollStats();
+    EXPECT_EQ(stats.polls, 0u);
+    EXPECT_EQ(stats.parses, 0u);
+    EXPECT_FALSE(server_agent_->lastPollNotModified());
+
+    // When: 폴링 주기가 포함된 응답 파싱
+    UpdateInfo update_info;
+    server_agent_->parseUpdateResponse(createValidJsonResponse(), update_info);
+
+    // Then: 폴링 주기와 파싱 통계가 반영되어야 함
+    EXPECT_EQ(update_info.polling_sleep_seconds, 60)
+        << "config.polling.sleep 값이 초 단위로 저장되어야 합니다";
+    EXPECT_EQ(stats.parses, 1u)
+        << "파싱 횟수가 집계되어야 합니다";
+    EXPECT_GE(stats.max_parse_time_us, stats.parse_time_us / stats.parses);
+}
+
+/**
+ * @brief ETag 조건부 폴링 테스트
+ *
+ * 첫 응답의 ETag를 다음 폴링에서 If-None-Match로 보내고,
+ * 304 응답 시 본문 없이 성공 처리하는지 검증합니다.
+ */
+TEST_F(ServerAgentTest, ConditionalPollWithEtag) {
+    // Given: ETag를 반환하는 가짜 전송 계층
+    auto* transport = new FakeHttpTransport();
+    transport->body = createValidJsonResponse();
+    transport->etag = "\"abc\"";
+    ServerAgent agent(test_server_url_, test_tenant_, test_device_id_,
+                      std::unique_ptr<HttpTransport>(transport),
+                      std::unique_ptr<HttpTransport>(new FakeHttpTransport()));
+
+    // When: 두 번 폴링
+    std::string response;
+    ASSERT_TRUE(agent.pollForUpdates(response));
+    EXPECT_FALSE(agent.lastPollNotModified());
+    EXPECT_EQ(response, transport->body);
+
+    ASSERT_TRUE(agent.pollForUpdates(response));
+
+    // Then: 두 번째 요청은 조건부 요청이고 304로 처리되어야 함
+    ASSERT_EQ(transport->sent_etags.size(), 2u);
+    EXPECT_TRUE(transport->sent_etags[0].empty()) << "첫 폴링은 조건부 요청이 아니어야 합니다";
+    EXPECT_EQ(transport->sent_etags[1], "\"abc\"") << "두 번째 폴링은 If-None-Match를 보내야 합니다";
+    EXPECT_TRUE(agent.lastPollNotModified());
+    EXPECT_TRUE(response.empty());
+    EXPECT_EQ(agent.getPollStats().polls, 2u);
+    EXPECT_EQ(agent.getPollStats().not_modified, 1u);
+    EXPECT_EQ(transport->urls[0], test_server_url_ + "/" + test_tenant_ + "/controller/v1/" + test_device_id_);
+
+    // 캐시 무효화 후에는 다시 전체 응답을 받아야 함
+    agent.invalidatePollCache();
+    ASSERT_TRUE(agent.pollForUpdates(response));
+    EXPECT_TRUE(transport->sent_etags[2].empty());
+    EXPECT_FALSE(agent.lastPollNotModified());
+}
+
+/**
+ * @brief 스트리밍 폴링 파싱 테스트
+ *
+ * 본문을 문자열로 모으지 않고 DeploymentParser로 바로 파싱하여
+ * UpdateInfo를 채우고, 304 응답 시 UpdateInfo를 비우는지 검증합니다.
+ */
+TEST_F(ServerAgentTest, StreamingPollParsesDeployment) {
+    // Given: 배포 정보를 반환하는 가짜 전송 계층
+    auto* transport = new FakeHttpTransport();
+    transport->body = R"({
+        "config": { "polling": { "sleep": "00:05:00" } },
+        "deployment": {
+            "id": "42",
+            "deployment": { "download": "attempt", "chunks": [{ "version": "2.1.0" }] },
+            "artifacts": [{
+                "filename": "update.raucb",
+                "size": 2048,
+                "_links": { "download-http": { "href": "http://hawkbit.example.com/update.raucb" } }
+            }]
+        }
+    })";
+    transport->etag = "\"v1\"";
+    ServerAgent agent(test_server_url_, test_tenant_, test_device_id_,
+                      std::unique_ptr<HttpTransport>(transport),
+                      std::unique_ptr<HttpTransport>(new FakeHttpTransport()));
+
+    // When: 스트리밍 폴링
+    UpdateInfo update_info;
+    ASSERT_TRUE(agent.pollForUpdates(update_info));
+
+    // Then: 배포 정보가 채워져야 함
+    EXPECT_TRUE(update_info.is_available) << "배포가 있으면 is_available이 true여야 합니다";
+    EXPECT_EQ(update_info.execution_id, "42");
+    EXPECT_EQ(update_info.version, "2.1.0");
+    EXPECT_EQ(update_info.download_type, "attempt");
+    EXPECT_EQ(update_info.download_url, "http://hawkbit.example.com/update.raucb");
+    EXPECT_EQ(update_info.expected_size, 2048);
+    EXPECT_EQ(update_info.polling_sleep_seconds, 300);
+    EXPECT_EQ(agent.getPollStats().parses, 1u) << "스트리밍 파싱도 통계에 집계되어야 합니다";
+
+    // 304 응답이면 이전 결과가 남지 않아야 함
+    ASSERT_TRUE(agent.pollForUpdates(update_info));
+    EXPECT_TRUE(agent.lastPollNotModified());
+    EXPECT_FALSE(update_info.is_available);
+    EXPECT_TRUE(update_info.execution_id.empty());
+}
+
+/**
+ * @brief 피드백 전송 계층 분리 테스트
+ *
+ * 피드백은 별도 전송 계층으로 JSON POST 되어야 합니다.
+ */
+TEST_F(ServerAgentTest, FeedbackUsesFeedbackTransport) {
+    auto* transport = new FakeHttpTransport();
+    auto* feedback_transport = new FakeHttpTransport();
+    ServerAgent agent(test_server_url_, test_tenant_, test_device_id_,
+                      std::unique_ptr<HttpTransport>(transport),
+                      std::unique_ptr<HttpTransport>(feedback_transport));
+
+    EXPECT_TRUE(agent.sendProgressFeedback("exec-1", 40, "installing"));
+
+    EXPECT_TRUE(transport->urls.empty()) << "피드백은 폴링 전송 계층을 사용하지 않아야 합니다";
+    ASSERT_EQ(feedback_transport->urls.size(), 1u);
+    EXPECT_NE(feedback_transport->urls[0].find("/deploymentBase/exec-1/feedback"), std::string::npos);
+
+    json_object* root = json_tokener_parse(feedback_transport->bodies[0].c_str());
+    ASSERT_NE(root, nullptr) << "피드백 본문은 JSON이어야 합니다";
+    json_object* execution = nullptr;
+    json_object* result = nullptr;
+    json_object* progress = nullptr;
+    ASSERT_TRUE(json_object_object_get_ex(root, "execution", &execution));
+    ASSERT_TRUE(json_object_object_get_ex(execution, "result", &result));
+    ASSERT_TRUE(json_object_object_get_ex(result, "progress", &progress));
+    EXPECT_EQ(json_object_get_int(progress), 40) << "진행률이 JSON 본문에 포함되어야 합니다";
+    json_object_put(root);
+}
+
 } // namespace
@@ -11,69 +11,35 @@
 
 DLT_DECLARE_CONTEXT(dlt_context_client);
 
+namespace {
+
+std::unique_ptr<HttpTransport> makeTransport() {
+    HttpClientOptions options;
+    options.verify_ssl = ENABLE_SSL_VERIFICATION;
+    return std::unique_ptr<HttpTransport>(new CurlTransport(options));
+}
+
+} // namespace
+
 UpdateClient::UpdateClient(const std::string& server_url, const std::string& tenant, const std::string& device_id)
-    : server_url_(server_url), tenant_(tenant), device_id_(device_id), curl_handle_(nullptr) {
+    : UpdateClient(server_url, tenant, device_id, nullptr) {}
+
+UpdateClient::UpdateClient(const std::string& server_url, const std::string& tenant, const std::string& device_id,
+                           std::unique_ptr<HttpTransport> transport)
+    : server_url_(server_url), tenant_(tenant), device_id_(device_id),
+      http_client_(transport ? std::move(transport) : makeTransport()) {
     DLT_REGISTER_CONTEXT(dlt_context_client, "UCLI", "Update Client Logic");
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Initializing update client"));
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Server URL: "), DLT_STRING(server_url_.c_str()));
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Tenant: "), DLT_STRING(tenant_.c_str()));
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Device ID: "), DLT_STRING(device_id_.c_str()));
-
-    curl_global_init(CURL_GLOBAL_ALL);
-    curl_handle_ = curl_easy_init();
-
-    if (curl_handle_) {
-        DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("CURL handle initialized successfully"));
-    } else {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Failed to initialize CURL handle"));
-    }
 }
 
 UpdateClient::~UpdateClient() {
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Cleaning up update client"));
-    if (curl_handle_) {
-        curl_easy_cleanup(curl_handle_);
-        DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("CURL handle cleaned up"));
-    }
-    curl_global_cleanup();
     DLT_UNREGISTER_CONTEXT(dlt_context_client);
 }
 
-size_t UpdateClient::writeCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
-    // If userp is null, this is a feedback request that doesn't need response data
-    if (!userp) {
-        return size * nmemb; // Just consume the data
-    }
-
-    if (!contents) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("writeCallback: contents is null"));
-        return 0;
-    }
-
-    size_t total_size = size * nmemb;
-    if (total_size == 0) {
-        return 0;
-    }
-
-    try {
-        userp->append((char*)contents, total_size);
-        return total_size;
-    } catch (const std::exception& e) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Exception in writeCallback: "), DLT_STRING(e.what()));
-        return 0;
-    } catch (...) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Unknown exception in writeCallback"));
-        return 0;
-    }
-}
-
-size_t UpdateClient::writeFileCallback(void* contents, size_t size, size_t nmemb, FILE* file) {
-    if (!contents || !file || size == 0 || nmemb == 0) {
-        return 0;
-    }
-    return fwrite(contents, size, nmemb, file);
-}
-
 std::string UpdateClient::buildPollUrl() const {
     std::string url = server_url_ + "/" + tenant_ + "/controller/v1/" + device_id_;
     DLT_LOG(dlt_context_client, DLT_LOG_DEBUG, DLT_STRING("Built poll URL: "), DLT_STRING(url.c_str()));
@@ -86,81 +52,30 @@ std::string UpdateClient::buildFeedbackUrl(const std::string& execution_id) cons
     return url;
 }
 
-void UpdateClient::setupDownloadCurlOptions() {
-    if (!curl_handle_) return;
-
-    // Based on host-updater reference implementation
-
-    // Basic options
-    curl_easy_setopt(curl_handle_, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl_handle_, CURLOPT_MAXREDIRS, 3L);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, DOWNLOAD_TIMEOUT_SECONDS);
-
-    // Connection timeout
-    curl_easy_setopt(curl_handle_, CURLOPT_CONNECTTIMEOUT, 30L);
-
-    // Low speed limit (abort if speed drops below 1KB/s for 60 seconds)
-    curl_easy_setopt(curl_handle_, CURLOPT_LOW_SPEED_LIMIT, 1024L);
-    curl_easy_setopt(curl_handle_, CURLOPT_LOW_SPEED_TIME, 60L);
-
-    // SSL options
-    curl_easy_setopt(curl_handle_, CURLOPT_SSL_VERIFYPEER, ENABLE_SSL_VERIFICATION ? 1L : 0L);
-    curl_easy_setopt(curl_handle_, CURLOPT_SSL_VERIFYHOST, ENABLE_SSL_VERIFICATION ? 2L : 0L);
-
-    // User agent
-    curl_easy_setopt(curl_handle_, CURLOPT_USERAGENT, "host-updater-cpp/1.0");
-
-    // Accept ranges for resumable downloads
-    curl_easy_setopt(curl_handle_, CURLOPT_RANGE, NULL); // Clear any previous range
-
-    // Disable progress meter to avoid interference with DLT logging
-    curl_easy_setopt(curl_handle_, CURLOPT_NOPROGRESS, 1L);
-
-    // Enable TCP keep-alive
-    curl_easy_setopt(curl_handle_, CURLOPT_TCP_KEEPALIVE, 1L);
-    curl_easy_setopt(curl_handle_, CURLOPT_TCP_KEEPIDLE, 120L);
-    curl_easy_setopt(curl_handle_, CURLOPT_TCP_KEEPINTVL, 60L);
-
-    DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("CURL download options configured"));
-}
-
 bool UpdateClient::pollForUpdates(std::string& response) {
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
-        return false;
-    }
-
-    // Reset CURL handle to clean state
-    curl_easy_reset(curl_handle_);
-
     response.clear();
     std::string url = buildPollUrl();
 
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Polling for updates from: "), DLT_STRING(url.c_str()));
 
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEDATA, &response);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, HTTP_TIMEOUT_SECONDS);
-    curl_easy_setopt(curl_handle_, CURLOPT_FOLLOWLOCATION, FOLLOW_REDIRECTS ? 1L : 0L);
-    curl_easy_setopt(curl_handle_, CURLOPT_SSL_VERIFYPEER, ENABLE_SSL_VERIFICATION ? 1L : 0L);
-    curl_easy_setopt(curl_handle_, CURLOPT_SSL_VERIFYHOST, ENABLE_SSL_VERIFICATION ? 2L : 0L);
-    curl_easy_setopt(curl_handle_, CURLOPT_USERAGENT, "host-updater-cpp/1.0");
-
-    CURLcode res = curl_easy_perform(curl_handle_);
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("curl_easy_perform() failed: "), DLT_STRING(curl_easy_strerror(res)));
+    HttpRequest request;
+    request.url = url;
+    request.timeout_seconds = HTTP_TIMEOUT_SECONDS;
+    request.follow_redirects = FOLLOW_REDIRECTS;
+
+    HttpResponse http_response;
+    if (!http_client_.perform(request, http_response)) {
+        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Poll request failed: "), DLT_STRING(http_response.error.c_str()));
         return false;
     }
 
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
+    long http_code = http_response.status_code;
 
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Poll response HTTP code: "), DLT_INT(http_code));
 
     if (http_code == 200) {
+        response.swap(http_response.body);
         DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Poll successful, response length: "), DLT_UINT(response.length()));
-        DLT_LOG(dlt_context_client, DLT_LOG_DEBUG, DLT_STRING("Poll response: "), DLT_STRING(response.c_str()));
         return true;
     } else if (http_code == 204) {
         DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("No updates available (HTTP 204)"));
@@ -174,7 +89,6 @@ bool UpdateClient::pollForUpdates(std::string& response) {
 bool UpdateClient::parseUpdateResponse(const std::string& response, UpdateInfo& update_info) {
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Parsing update response"));
     DLT_LOG(dlt_context_client, DLT_LOG_DEBUG, DLT_STRING("Response length: "), DLT_UINT(response.length()));
-    DLT_LOG(dlt_context_client, DLT_LOG_DEBUG, DLT_STRING("Response content: "), DLT_STRING(response.c_str()));
 
     update_info.is_available = false;
 
@@ -334,13 +248,28 @@ bool UpdateClient::parseArtifactInfo(json_object* artifact_obj, UpdateInfo& upda
     return success;
 }
 
-bool UpdateClient::sendStartedFeedback(const std::string& execution_id) {
-    DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Sending started feedback for execution: "), DLT_STRING(execution_id.c_str()));
+bool UpdateClient::postFeedback(const std::string& execution_id, json_object* root, const char* kind) {
+    std::string json(json_object_to_json_string(root));
+    json_object_put(root);
+    DLT_LOG(dlt_context_client, DLT_LOG_DEBUG, DLT_STRING(kind), DLT_STRING(" JSON: "), DLT_STRING(json.c_str()));
+
+    HttpResponse response;
+    if (!http_client_.postJson(buildFeedbackUrl(execution_id), json, response, HTTP_TIMEOUT_SECONDS)) {
+        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING(kind), DLT_STRING(" send failed: "), DLT_STRING(response.error.c_str()));
+        return false;
+    }
 
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
+    if (response.status_code == 200) {
+        DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING(kind), DLT_STRING(" sent successfully"));
+        return true;
+    } else {
+        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING(kind), DLT_STRING(" HTTP error: "), DLT_INT(response.status_code));
         return false;
     }
+}
+
+bool UpdateClient::sendStartedFeedback(const std::string& execution_id) {
+    DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Sending started feedback for execution: "), DLT_STRING(execution_id.c_str()));
 
     json_object* root = json_object_new_object();
     json_object* execution = json_object_new_object();
@@ -354,55 +283,12 @@ bool UpdateClient::sendStartedFeedback(const std::string& execution_id) {
     json_object_object_add(root, "id", json_object_new_string(execution_id.c_str()));
     json_object_object_add(root, "execution", execution);
 
-    const char* json_string = json_object_to_json_string(root);
-    DLT_LOG(dlt_context_client, DLT_LOG_DEBUG, DLT_STRING("Started feedback JSON: "), DLT_STRING(json_string));
-
-    // Copy the JSON string before freeing the object
-    std::string json_copy(json_string);
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    // Reset CURL handle to clean state before each request
-    curl_easy_reset(curl_handle_);
-
-    // Configure CURL options for POST request
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, buildFeedbackUrl(execution_id).c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_POSTFIELDS, json_copy.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEDATA, nullptr); // No response data needed
-
-    CURLcode res = curl_easy_perform(curl_handle_);
-    curl_slist_free_all(headers);
-    json_object_put(root);
-
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Started feedback send failed: "), DLT_STRING(curl_easy_strerror(res)));
-        return false;
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code == 200) {
-        DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Started feedback sent successfully"));
-        return true;
-    } else {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Started feedback HTTP error: "), DLT_INT(http_code));
-        return false;
-    }
+    return postFeedback(execution_id, root, "Started feedback");
 }
 
 bool UpdateClient::sendProgressFeedback(const std::string& execution_id, int progress, const std::string& message) {
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Sending progress feedback for execution: "), DLT_STRING(execution_id.c_str()), DLT_STRING(" Progress: "), DLT_INT(progress), DLT_STRING("%"));
 
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
-        return false;
-    }
-
     json_object* root = json_object_new_object();
     json_object* execution = json_object_new_object();
     json_object* result = json_object_new_object();
@@ -420,55 +306,12 @@ bool UpdateClient::sendProgressFeedback(const std::string& execution_id, int pro
     json_object_object_add(root, "id", json_object_new_string(execution_id.c_str()));
     json_object_object_add(root, "execution", execution);
 
-    const char* json_string = json_object_to_json_string(root);
-    DLT_LOG(dlt_context_client, DLT_LOG_DEBUG, DLT_STRING("Progress feedback JSON: "), DLT_STRING(json_string));
-
-    // Copy the JSON string before freeing the object
-    std::string json_copy(json_string);
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    // Reset CURL handle to clean state before each request
-    curl_easy_reset(curl_handle_);
-
-    // Configure CURL options for POST request
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, buildFeedbackUrl(execution_id).c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_POSTFIELDS, json_copy.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEDATA, nullptr); // No response data needed
-
-    CURLcode res = curl_easy_perform(curl_handle_);
-    curl_slist_free_all(headers);
-    json_object_put(root);
-
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Progress feedback send failed: "), DLT_STRING(curl_easy_strerror(res)));
-        return false;
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code == 200) {
-        DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Progress feedback sent successfully: "), DLT_INT(progress), DLT_STRING("%"));
-        return true;
-    } else {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Progress feedback HTTP error: "), DLT_INT(http_code));
-        return false;
-    }
+    return postFeedback(execution_id, root, "Progress feedback");
 }
 
 bool UpdateClient::sendFinishedFeedback(const std::string& execution_id, bool success, const std::string& message) {
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Sending finished feedback for execution: "), DLT_STRING(execution_id.c_str()), DLT_STRING(" Success: "), DLT_BOOL(success));
 
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
-        return false;
-    }
-
     json_object* root = json_object_new_object();
     json_object* execution = json_object_new_object();
     json_object* result = json_object_new_object();
@@ -486,45 +329,7 @@ bool UpdateClient::sendFinishedFeedback(const std::string& execution_id, bool su
     json_object_object_add(root, "id", json_object_new_string(execution_id.c_str()));
     json_object_object_add(root, "execution", execution);
 
-    const char* json_string = json_object_to_json_string(root);
-    DLT_LOG(dlt_context_client, DLT_LOG_DEBUG, DLT_STRING("Finished feedback JSON: "), DLT_STRING(json_string));
-
-    // Copy the JSON string before freeing the object
-    std::string json_copy(json_string);
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    // Reset CURL handle to clean state before each request
-    curl_easy_reset(curl_handle_);
-
-    // Configure CURL options for POST request
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, buildFeedbackUrl(execution_id).c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_POSTFIELDS, json_copy.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEDATA, nullptr); // No response data needed
-
-    CURLcode res = curl_easy_perform(curl_handle_);
-    curl_slist_free_all(headers);
-    json_object_put(root);
-
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Finished feedback send failed: "), DLT_STRING(curl_easy_strerror(res)));
-        return false;
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code == 200) {
-        DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Finished feedback sent successfully: "), DLT_STRING(success ? "success" : "failure"));
-        return true;
-    } else {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Finished feedback HTTP error: "), DLT_INT(http_code));
-        return false;
-    }
+    return postFeedback(execution_id, root, "Finished feedback");
 }
 
 bool UpdateClient::downloadBundle(const std::string& download_url, const std::string& local_path) {
@@ -542,11 +347,6 @@ bool UpdateClient::downloadBundle(const std::string& download_url, const std::st
         return false;
     }
 
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
-        return false;
-    }
-
     // Remove existing file if present
     if (access(local_path.c_str(), F_OK) == 0) {
         DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Removing existing file"));
@@ -566,26 +366,22 @@ bool UpdateClient::downloadBundle(const std::string& download_url, const std::st
 
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("File opened successfully for writing"));
 
-    // Reset CURL handle to clean state
-    curl_easy_reset(curl_handle_);
+    HttpRequest request;
+    request.url = download_url;
+    request.output_file = file;
+    request.timeout_seconds = DOWNLOAD_TIMEOUT_SECONDS;
+    request.connect_timeout_seconds = 30;
+    // Abort if speed drops below 1KB/s for 60 seconds
+    request.low_speed_limit = 1024;
+    request.low_speed_time = 60;
+    request.follow_redirects = true;
 
-    // Configure CURL options step by step
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, download_url.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEFUNCTION, writeFileCallback);
-    curl_easy_setopt(curl_handle_, CURLOPT_WRITEDATA, file);
-    curl_easy_setopt(curl_handle_, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, 300L); // 5 minute timeout
-    curl_easy_setopt(curl_handle_, CURLOPT_CONNECTTIMEOUT, 30L);
-    curl_easy_setopt(curl_handle_, CURLOPT_USERAGENT, "host-updater-cpp/1.0");
-    curl_easy_setopt(curl_handle_, CURLOPT_SSL_VERIFYPEER, 0L); // Disable for debugging
-    curl_easy_setopt(curl_handle_, CURLOPT_SSL_VERIFYHOST, 0L);
-    curl_easy_setopt(curl_handle_, CURLOPT_NOPROGRESS, 1L);
-
-    DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("CURL configured, starting download..."));
+    DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Request configured, starting download..."));
 
     // Perform download
     auto start_time = std::chrono::steady_clock::now();
-    CURLcode res = curl_easy_perform(curl_handle_);
+    HttpResponse response;
+    bool performed = http_client_.perform(request, response);
     auto end_time = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
 
@@ -598,16 +394,14 @@ bool UpdateClient::downloadBundle(const std::string& download_url, const std::st
 
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Download completed in "), DLT_INT(duration.count()), DLT_STRING(" ms"));
 
-    // Check CURL result
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("CURL error: "), DLT_STRING(curl_easy_strerror(res)));
+    if (!performed) {
+        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Download failed: "), DLT_STRING(response.error.c_str()));
         remove(local_path.c_str()); // Clean up partial file
         return false;
     }
 
     // Check HTTP status
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
+    long http_code = response.status_code;
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("HTTP response code: "), DLT_INT(http_code));
 
     if (http_code != 200) {
@@ -649,13 +443,6 @@ bool UpdateClient::downloadBundle(const std::string& download_url, const std::st
 bool UpdateClient::sendFeedback(const std::string& execution_id, const std::string& status, const std::string& message) {
     DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Sending feedback for execution: "), DLT_STRING(execution_id.c_str()));
 
-    if (!curl_handle_) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("CURL handle not initialized"));
-        return false;
-    }
-
-    std::string url = buildFeedbackUrl(execution_id);
-
     // Create JSON payload
     json_object* root = json_object_new_object();
     json_object* execution = json_object_new_object();
@@ -673,34 +460,5 @@ bool UpdateClient::sendFeedback(const std::string& execution_id, const std::stri
         json_object_object_add(result, "message", json_object_new_string(message.c_str()));
     }
 
-    const char* json_string = json_object_to_json_string(root);
-    DLT_LOG(dlt_context_client, DLT_LOG_DEBUG, DLT_STRING("Feedback JSON: "), DLT_STRING(json_string));
-
-    struct curl_slist* headers = nullptr;
-    headers = curl_slist_append(headers, "Content-Type: application/json");
-
-    curl_easy_setopt(curl_handle_, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl_handle_, CURLOPT_POSTFIELDS, json_string);
-    curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl_handle_, CURLOPT_TIMEOUT, 30L);
-
-    CURLcode res = curl_easy_perform(curl_handle_);
-    curl_slist_free_all(headers);
-    json_object_put(root);
-
-    if (res != CURLE_OK) {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Feedback send failed: "), DLT_STRING(curl_easy_strerror(res)));
-        return false;
-    }
-
-    long http_code = 0;
-    curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &http_code);
-
-    if (http_code == 200) {
-        DLT_LOG(dlt_context_client, DLT_LOG_INFO, DLT_STRING("Feedback sent successfully"));
-        return true;
-    } else {
-        DLT_LOG(dlt_context_client, DLT_LOG_ERROR, DLT_STRING("Feedback HTTP error: "), DLT_INT(http_code));
-        return false;
-    }
+    return postFeedback(execution_id, root, "Feedback");
 }
@@ -4,8 +4,8 @@
 #include <string>
 #include <memory>
 #include <vector>
-#include <curl/curl.h>
 #include <json-c/json.h>
+#include "http_client.h"
 
 // Update information structure
 struct UpdateInfo {
@@ -26,6 +26,8 @@ struct UpdateInfo {
 class UpdateClient {
 public:
     UpdateClient(const std::string& server_url, const std::string& tenant, const std::string& device_id);
+    UpdateClient(const std::string& server_url, const std::string& tenant, const std::string& device_id,
+                 std::unique_ptr<HttpTransport> transport);
     ~UpdateClient();
 
     bool pollForUpdates(std::string& response);
@@ -42,13 +44,11 @@ private:
     std::string server_url_;
     std::string tenant_;
     std::string device_id_;
-    CURL* curl_handle_;
+    HttpClient http_client_;  // Keep-alive connection reused by polls, feedback and downloads
 
-    static size_t writeCallback(void* contents, size_t size, size_t nmemb, std::string* userp);
-    static size_t writeFileCallback(void* contents, size_t size, size_t nmemb, FILE* file);
     std::string buildPollUrl() const;
     std::string buildFeedbackUrl(const std::string& execution_id) const;
-    void setupDownloadCurlOptions();
+    bool postFeedback(const std::string& execution_id, json_object* root, const char* kind);
 
     bool parseDeploymentInfo(json_object* deployment_obj, UpdateInfo& update_info);
     bool parseArtifactInfo(json_object* artifact_obj, UpdateInfo& update_info);
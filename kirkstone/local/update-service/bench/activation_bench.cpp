@@ -0,0 +1,225 @@
+/**
+ * D-Bus activation benchmark
+ *
+ * Starts a private dbus-daemon whose service directory activates the
+ * update-service binary, the way the system bus does on a target, with a
+ * mock RAUC on the bus. Each round calls GetSlotStatus while the broker is
+ * not running and times the reply: bus activation, process start-up,
+ * connecting to RAUC and forwarding the call. A second call shows the warm
+ * latency. The broker is then left alone until it releases its name after
+ * the idle interval (UPDATE_SERVICE_IDLE_EXIT_SEC); a broker that does not
+ * exit is terminated so the next round starts cold.
+ * Usage: activation-bench [rounds] [idle seconds] [update-service binary]
+ */
+#include "bench_utils.h"
+#include "mock_rauc.h"
+#include <dbus/dbus.h>
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* BROKER_NAME = "org.freedesktop.UpdateService";
+
+bool writeFile(const std::string& path, const std::string& content) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    bool ok = fputs(content.c_str(), file) >= 0;
+    return fclose(file) == 0 && ok;
+}
+
+// Bus configuration with a fixed socket path, so the address is known before the daemon starts
+bool writeBusConfig(const std::string& dir, const std::string& binary) {
+    if (mkdir((dir + "/services").c_str(), 0700) != 0) {
+        return false;
+    }
+    std::string config =
+        "<!DOCTYPE busconfig PUBLIC \"-//freedesktop//DTD D-Bus Bus Configuration 1.0//EN\"\n"
+        " \"http://www.freedesktop.org/standards/dbus/1.0/busconfig.dtd\">\n"
+        "<busconfig>\n"
+        "  <type>session</type>\n"
+        "  <listen>unix:path=" + dir + "/bus</listen>\n"
+        "  <servicedir>" + dir + "/services</servicedir>\n"
+        "  <policy context=\"default\">\n"
+        "    <allow send_destination=\"*\" eavesdrop=\"true\"/>\n"
+        "    <allow eavesdrop=\"true\"/>\n"
+        "    <allow own=\"*\"/>\n"
+        "  </policy>\n"
+        "</busconfig>\n";
+    std::string service =
+        "[D-BUS Service]\n"
+        "Name=org.freedesktop.UpdateService\n"
+        "Exec=" + binary + "\n";
+    return writeFile(dir + "/bus.conf", config) &&
+           writeFile(dir + "/services/org.freedesktop.UpdateService.service", service);
+}
+
+void removeBusFiles(const std::string& dir) {
+    unlink((dir + "/services/org.freedesktop.UpdateService.service").c_str());
+    rmdir((dir + "/services").c_str());
+    unlink((dir + "/bus.conf").c_str());
+    unlink((dir + "/bus").c_str());
+    rmdir(dir.c_str());
+}
+
+pid_t startActivatingBus(const std::string& dir) {
+    std::string command = "dbus-daemon --config-file=" + dir + "/bus.conf --fork --print-pid=1";
+    FILE* daemon = popen(command.c_str(), "r");
+    if (!daemon) {
+        return 0;
+    }
+    char pid_line[32] = {};
+    bool ok = fgets(pid_line, sizeof(pid_line), daemon) != nullptr;
+    pclose(daemon);
+    return ok ? static_cast<pid_t>(atoi(pid_line)) : 0;
+}
+
+// Round trip of a GetSlotStatus call in ms, -1 on an error reply (printed)
+double timeGetSlotStatus(DBusConnection* client) {
+    DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, "/org/freedesktop/UpdateService",
+                                                     "org.freedesktop.UpdateService", "GetSlotStatus");
+    DBusError error;
+    dbus_error_init(&error);
+    auto start = Clock::now();
+    DBusMessage* reply = dbus_connection_send_with_reply_and_block(client, call, 25000, &error);
+    double elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    dbus_message_unref(call);
+    if (!reply) {
+        fprintf(stderr, "GetSlotStatus failed: %s\n", error.message);
+        dbus_error_free(&error);
+        return -1.0;
+    }
+    dbus_message_unref(reply);
+    return elapsed_ms;
+}
+
+// Owner of the broker name, 0 if none
+pid_t brokerPid(DBusConnection* client) {
+    DBusMessage* call = dbus_message_new_method_call(DBUS_SERVICE_DBUS, DBUS_PATH_DBUS, DBUS_INTERFACE_DBUS,
+                                                     "GetConnectionUnixProcessID");
+    dbus_message_append_args(call, DBUS_TYPE_STRING, &BROKER_NAME, DBUS_TYPE_INVALID);
+    DBusMessage* reply = dbus_connection_send_with_reply_and_block(client, call, 1000, nullptr);
+    dbus_message_unref(call);
+    dbus_uint32_t pid = 0;
+    if (reply) {
+        dbus_message_get_args(reply, nullptr, DBUS_TYPE_UINT32, &pid, DBUS_TYPE_INVALID);
+        dbus_message_unref(reply);
+    }
+    return static_cast<pid_t>(pid);
+}
+
+// Seconds until the broker released its name, -1 if it was still running after timeout_s
+double waitForIdleExit(DBusConnection* client, int timeout_s) {
+    auto start = Clock::now();
+    while (Clock::now() - start < std::chrono::seconds(timeout_s)) {
+        if (!dbus_bus_name_has_owner(client, BROKER_NAME, nullptr)) {
+            return std::chrono::duration<double>(Clock::now() - start).count();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return -1.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 5;
+    int idle_seconds = argc > 2 ? atoi(argv[2]) : 1;
+    std::string binary = argc > 3 ? argv[3] : UPDATE_SERVICE_BINARY;
+    if (rounds <= 0 || idle_seconds <= 0) {
+        fprintf(stderr, "Usage: %s [rounds] [idle seconds] [update-service binary]\n", argv[0]);
+        return 1;
+    }
+
+    char dir_template[] = "/tmp/update-service-activation-XXXXXX";
+    if (!mkdtemp(dir_template)) {
+        fprintf(stderr, "Failed to create a temporary directory\n");
+        return 1;
+    }
+    std::string dir = dir_template;
+    if (!writeBusConfig(dir, binary)) {
+        fprintf(stderr, "Failed to write the bus configuration in %s\n", dir.c_str());
+        removeBusFiles(dir);
+        return 1;
+    }
+
+    // The activated broker inherits the daemon's environment, and so ours
+    std::string address = "unix:path=" + dir + "/bus";
+    setenv("DBUS_SYSTEM_BUS_ADDRESS", address.c_str(), 1);
+    setenv("UPDATE_SERVICE_IDLE_EXIT_SEC", std::to_string(idle_seconds).c_str(), 1);
+    setenv("UPDATE_SERVICE_QUEUE_FILE", "", 1);
+    pid_t bus_pid = startActivatingBus(dir);
+    if (bus_pid <= 0) {
+        fprintf(stderr, "Failed to start a private dbus-daemon\n");
+        removeBusFiles(dir);
+        return 1;
+    }
+    dbus_threads_init_default();
+
+    bench::MockRauc rauc;
+    DBusConnection* client = rauc.start() ? dbus_bus_get_private(DBUS_BUS_SYSTEM, nullptr) : nullptr;
+    if (!client) {
+        fprintf(stderr, "Mock RAUC or client connection failed on %s\n", address.c_str());
+        rauc.stop();
+        kill(bus_pid, SIGTERM);
+        removeBusFiles(dir);
+        return 1;
+    }
+    dbus_connection_set_exit_on_disconnect(client, FALSE);
+
+    std::vector<double> cold_ms, warm_ms;
+    int failures = 0;
+    int no_exit = 0;
+    for (int round = 0; round < rounds; ++round) {
+        double cold = timeGetSlotStatus(client);
+        double warm = cold >= 0 ? timeGetSlotStatus(client) : -1.0;
+        if (cold < 0 || warm < 0) {
+            failures++;
+        } else {
+            cold_ms.push_back(cold);
+            warm_ms.push_back(warm);
+        }
+
+        double exit_s = waitForIdleExit(client, idle_seconds + 5);
+        if (exit_s < 0) {
+            no_exit++;
+            pid_t pid = brokerPid(client);
+            if (pid > 0) {
+                kill(pid, SIGTERM);
+            }
+            waitForIdleExit(client, 5);
+        }
+        printf("round %d: first reply %.2f ms, warm %.2f ms, ", round + 1, cold, warm);
+        if (exit_s < 0) {
+            printf("no idle exit (terminated)\n");
+        } else {
+            printf("idle exit after %.2f s\n", exit_s);
+        }
+    }
+
+    std::sort(cold_ms.begin(), cold_ms.end());
+    std::sort(warm_ms.begin(), warm_ms.end());
+    printf("activation: rounds=%d failures=%d  first reply p50=%.2f ms max=%.2f ms  warm p50=%.2f ms  "
+           "idle exits=%d/%d\n",
+           rounds, failures, bench::percentile(cold_ms, 50), cold_ms.empty() ? 0.0 : cold_ms.back(),
+           bench::percentile(warm_ms, 50), rounds - no_exit, rounds);
+
+    dbus_connection_close(client);
+    dbus_connection_unref(client);
+    rauc.stop();
+    kill(bus_pid, SIGTERM);
+    removeBusFiles(dir);
+    return failures == 0 && no_exit == 0 ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+// Helpers shared by the benchmarks: private bus start-up and per-thread counters
+namespace bench {
+
+// Forks a private dbus-daemon; the caller sets DBUS_SYSTEM_BUS_ADDRESS and kills pid when done
+inline bool startBus(std::string& address, pid_t& pid) {
+    FILE* daemon = popen("dbus-daemon --session --fork --print-address=1 --print-pid=1", "r");
+    if (!daemon) {
+        return false;
+    }
+    char address_line[512] = {};
+    char pid_line[32] = {};
+    bool ok = fgets(address_line, sizeof(address_line), daemon) && fgets(pid_line, sizeof(pid_line), daemon);
+    pclose(daemon);
+    if (!ok) {
+        return false;
+    }
+    address_line[strcspn(address_line, "\n")] = '\0';
+    address = address_line;
+    pid = static_cast<pid_t>(atoi(pid_line));
+    return !address.empty() && pid > 0;
+}
+
+// Voluntary + involuntary context switches of a thread of this process, -1 if unknown
+inline long threadWakeups(long tid) {
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/self/task/%ld/status", tid);
+    FILE* status = fopen(path, "r");
+    if (!status) {
+        return -1;
+    }
+    long total = 0;
+    char line[256];
+    while (fgets(line, sizeof(line), status)) {
+        long value = 0;
+        if (sscanf(line, "voluntary_ctxt_switches: %ld", &value) == 1 ||
+            sscanf(line, "nonvoluntary_ctxt_switches: %ld", &value) == 1) {
+            total += value;
+        }
+    }
+    fclose(status);
+    return total;
+}
+
+inline double cpuSeconds(clockid_t clock) {
+    timespec now = {};
+    clock_gettime(clock, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Value at `percent` of sorted samples (nearest rank)
+inline double percentile(const std::vector<double>& sorted, int percent) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t count = sorted.size();
+    return sorted[std::min(count - 1, count * percent / 100)];
+}
+
+} // namespace bench
+
+#endif // BENCH_UTILS_H
@@ -0,0 +1,296 @@
+/**
+ * Broker load and latency benchmark
+ *
+ * Starts a private dbus-daemon with a mock RAUC on it and runs UpdateService
+ * on a worker thread. N client connections call the broker concurrently,
+ * each cycling through
+ *   Get            Properties.Get(Operation), answered from the property cache
+ *   Install        forwarded to RAUC Install
+ *   GetSlotStatus  forwarded to RAUC GetSlotStatus (two slots)
+ * while the mock RAUC emits Progress signals at a fixed rate and a listener
+ * times how long the broker takes to forward each one. Reports calls/s,
+ * p50/p99 latency per method and for forwarded signals, and the CPU time and
+ * wakeups (context switches) of the service thread. Logging cost depends on
+ * the DLT level (DLT_STUB_LEVEL with the sandbox stub, dlt-control on a target).
+ * Usage: load-bench [clients] [seconds] [progress signals/s]
+ */
+#include "update_service.h"
+#include "bench_utils.h"
+#include "mock_rauc.h"
+#include <dbus/dbus.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <pthread.h>
+#include <string>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* BROKER_NAME = "org.freedesktop.UpdateService";
+const char* BROKER_PATH = "/org/freedesktop/UpdateService";
+const char* BROKER_INTERFACE = "org.freedesktop.UpdateService";
+const char* PROPERTIES_INTERFACE = "org.freedesktop.DBus.Properties";
+
+enum Method { GET, INSTALL, GET_SLOT_STATUS, METHOD_COUNT };
+const char* METHOD_NAMES[METHOD_COUNT] = { "Get", "Install", "GetSlotStatus" };
+
+std::atomic<long> g_service_tid(0);
+
+int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+DBusMessage* brokerCall(Method method) {
+    switch (method) {
+    case GET: {
+        DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, PROPERTIES_INTERFACE, "Get");
+        const char* property_name = "Operation";
+        dbus_message_append_args(call, DBUS_TYPE_STRING, &BROKER_INTERFACE, DBUS_TYPE_STRING, &property_name,
+                                 DBUS_TYPE_INVALID);
+        return call;
+    }
+    case INSTALL: {
+        DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "Install");
+        const char* bundle = "/data/load-bench.raucb";
+        dbus_message_append_args(call, DBUS_TYPE_STRING, &bundle, DBUS_TYPE_INVALID);
+        return call;
+    }
+    default:
+        return dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "GetSlotStatus");
+    }
+}
+
+struct ClientResult {
+    std::vector<double> samples_us[METHOD_COUNT];
+    int failures = 0;
+};
+
+// One client connection calling the broker back to back until the deadline
+void runClient(int index, Clock::time_point deadline, ClientResult& result) {
+    DBusConnection* connection = dbus_bus_get_private(DBUS_BUS_SYSTEM, nullptr);
+    if (!connection) {
+        result.failures++;
+        return;
+    }
+    dbus_connection_set_exit_on_disconnect(connection, FALSE);
+    for (int i = index; Clock::now() < deadline; ++i) {
+        Method method = static_cast<Method>(i % METHOD_COUNT);
+        DBusMessage* call = brokerCall(method);
+        auto start = Clock::now();
+        DBusMessage* reply = dbus_connection_send_with_reply_and_block(connection, call, 5000, nullptr);
+        double elapsed_us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+        dbus_message_unref(call);
+        if (reply) {
+            result.samples_us[method].push_back(elapsed_us);
+            dbus_message_unref(reply);
+        } else {
+            result.failures++;
+        }
+    }
+    dbus_connection_close(connection);
+    dbus_connection_unref(connection);
+}
+
+/**
+ * Pairs each forwarded Progress with the RAUC signal it came from. The
+ * flood sends percentage i % 100 for signal i, so a gap in the sequence is
+ * a dropped signal rather than a mismatch.
+ */
+struct SignalTiming {
+    explicit SignalTiming(size_t count) : sent_ns(new std::atomic<int64_t>[count]), total(count) {
+        for (size_t i = 0; i < count; ++i) {
+            sent_ns[i] = 0;
+        }
+    }
+
+    std::unique_ptr<std::atomic<int64_t>[]> sent_ns;
+    size_t total;
+    std::atomic<size_t> sent{0};
+    size_t next = 0;
+    size_t forwarded = 0;
+    size_t dropped = 0;
+    std::vector<double> latency_us;
+
+    void received(int percentage, int64_t at_ns) {
+        if (percentage < 0 || percentage >= 100) {
+            return;  // not from the flood (a polled Progress)
+        }
+        while (next < total && static_cast<int>(next % 100) != percentage) {
+            next++;
+            dropped++;
+        }
+        if (next >= total) {
+            return;
+        }
+        int64_t sent_at = sent_ns[next++].load();
+        if (sent_at > 0) {
+            forwarded++;
+            latency_us.push_back((at_ns - sent_at) / 1e3);
+        }
+    }
+};
+
+void listen(DBusConnection* listener, SignalTiming& timing, const std::atomic<bool>& flooding) {
+    auto quiet_since = Clock::now();
+    while (flooding || (timing.forwarded + timing.dropped < timing.sent &&
+                        Clock::now() - quiet_since < std::chrono::seconds(1))) {
+        dbus_connection_read_write(listener, 50);
+        while (DBusMessage* message = dbus_connection_pop_message(listener)) {
+            dbus_int32_t percentage = -1;
+            if (dbus_message_is_signal(message, BROKER_INTERFACE, "Progress") &&
+                dbus_message_get_args(message, nullptr, DBUS_TYPE_INT32, &percentage, DBUS_TYPE_INVALID)) {
+                timing.received(percentage, nowNs());
+                quiet_since = Clock::now();
+            }
+            dbus_message_unref(message);
+        }
+    }
+}
+
+void printLatency(const char* name, std::vector<double>& samples_us, const char* unit) {
+    std::sort(samples_us.begin(), samples_us.end());
+    printf("  %-14s %s=%zu  p50=%.1f us  p99=%.1f us  max=%.1f us\n", name, unit, samples_us.size(),
+           bench::percentile(samples_us, 50), bench::percentile(samples_us, 99),
+           samples_us.empty() ? 0.0 : samples_us.back());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int clients = argc > 1 ? atoi(argv[1]) : 8;
+    int seconds = argc > 2 ? atoi(argv[2]) : 10;
+    int signal_rate = argc > 3 ? atoi(argv[3]) : 1000;
+    if (clients <= 0 || seconds <= 0 || signal_rate < 0) {
+        fprintf(stderr, "Usage: %s [clients] [seconds] [progress signals/s]\n", argv[0]);
+        return 1;
+    }
+
+    std::string address;
+    pid_t bus_pid = 0;
+    if (!bench::startBus(address, bus_pid)) {
+        fprintf(stderr, "Failed to start a private dbus-daemon\n");
+        return 1;
+    }
+    setenv("DBUS_SYSTEM_BUS_ADDRESS", address.c_str(), 1);
+    setenv("UPDATE_SERVICE_QUEUE_FILE", "", 1);
+    // The listener counts broadcast Progress through a match rule
+    setenv("UPDATE_SERVICE_BROADCAST_SIGNALS", "1", 1);
+    dbus_threads_init_default();
+
+    bench::MockRauc rauc;
+    DBusConnection* listener = rauc.start() ? dbus_bus_get_private(DBUS_BUS_SYSTEM, nullptr) : nullptr;
+    if (!listener) {
+        fprintf(stderr, "Mock RAUC or listener connection failed on %s\n", address.c_str());
+        rauc.stop();
+        kill(bus_pid, SIGTERM);
+        return 1;
+    }
+    dbus_bus_add_match(listener,
+                       "type='signal',sender='org.freedesktop.UpdateService',"
+                       "interface='org.freedesktop.UpdateService',member='Progress'",
+                       nullptr);
+    dbus_connection_flush(listener);
+
+    UpdateService service;
+    if (!service.initialize()) {
+        fprintf(stderr, "Failed to initialize UpdateService on %s\n", address.c_str());
+        dbus_connection_close(listener);
+        dbus_connection_unref(listener);
+        rauc.stop();
+        kill(bus_pid, SIGTERM);
+        return 1;
+    }
+    std::thread loop([&service]() {
+        g_service_tid = syscall(SYS_gettid);
+        service.run();
+    });
+    clockid_t service_clock;
+    if (pthread_getcpuclockid(loop.native_handle(), &service_clock) != 0) {
+        service_clock = CLOCK_PROCESS_CPUTIME_ID;
+    }
+
+    // Let start-up traffic (RAUC probe, property cache fill) settle before measuring
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    {
+        ClientResult warm_up;
+        runClient(0, Clock::now() + std::chrono::milliseconds(100), warm_up);
+    }
+
+    SignalTiming timing(static_cast<size_t>(signal_rate) * seconds);
+    std::atomic<bool> flooding(true);
+    long wakeups_before = bench::threadWakeups(g_service_tid.load());
+    double cpu_before = bench::cpuSeconds(service_clock);
+    Clock::time_point start = Clock::now();
+    Clock::time_point deadline = start + std::chrono::seconds(seconds);
+
+    std::thread listening([&]() { listen(listener, timing, flooding); });
+    std::thread flood([&]() {
+        // Paced rather than as fast as possible, so latency is forwarding time and not bus backlog
+        for (size_t i = 0; i < timing.total; ++i) {
+            std::this_thread::sleep_until(start + std::chrono::nanoseconds(static_cast<int64_t>(i * 1e9 / signal_rate)));
+            timing.sent_ns[i] = nowNs();
+            rauc.sendProgress(static_cast<int>(i % 100));
+            timing.sent = i + 1;
+        }
+        rauc.flush();
+        flooding = false;
+    });
+    std::vector<ClientResult> results(clients);
+    std::vector<std::thread> client_threads;
+    for (int i = 0; i < clients; ++i) {
+        client_threads.emplace_back(runClient, i, deadline, std::ref(results[i]));
+    }
+    for (std::thread& thread : client_threads) {
+        thread.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    flood.join();
+    listening.join();
+    double cpu = bench::cpuSeconds(service_clock) - cpu_before;
+    long wakeups = bench::threadWakeups(g_service_tid.load()) - wakeups_before;
+
+    ClientResult total;
+    for (ClientResult& result : results) {
+        total.failures += result.failures;
+        for (int method = 0; method < METHOD_COUNT; ++method) {
+            total.samples_us[method].insert(total.samples_us[method].end(), result.samples_us[method].begin(),
+                                            result.samples_us[method].end());
+        }
+    }
+    size_t calls = 0;
+    for (int method = 0; method < METHOD_COUNT; ++method) {
+        calls += total.samples_us[method].size();
+    }
+
+    printf("load: clients=%d in %.1f s, calls=%zu failures=%d = %.0f calls/s\n", clients, elapsed, calls,
+           total.failures, calls / elapsed);
+    for (int method = 0; method < METHOD_COUNT; ++method) {
+        printLatency(METHOD_NAMES[method], total.samples_us[method], "calls");
+    }
+    printf("progress: rate=%d/s sent=%zu forwarded=%zu dropped=%zu\n", signal_rate, timing.sent.load(),
+           timing.forwarded, timing.dropped);
+    printLatency("forwarding", timing.latency_us, "signals");
+    size_t operations = calls + timing.forwarded;
+    printf("service thread: CPU %.2f s (%.1f %%), %.1f us per call or signal, %ld wakeups (%.0f/s)\n", cpu,
+           cpu * 100.0 / elapsed, operations > 0 ? cpu * 1e6 / operations : 0.0, wakeups, wakeups / elapsed);
+
+    dbus_connection_close(listener);
+    dbus_connection_unref(listener);
+    service.stop();
+    loop.join();
+    rauc.stop();
+    kill(bus_pid, SIGTERM);
+    return total.failures == 0 && timing.dropped == 0 ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+/**
+ * Main loop wakeup and latency benchmark
+ *
+ * Starts a private dbus-daemon, points the system bus address at it and runs
+ * UpdateService on a worker thread, with the client owning the RAUC name
+ * so the broker considers RAUC connected. Wakeups are read from the service
+ * thread's context switch counters in /proc, so the figure is independent of
+ * how the loop is implemented. Latency is the client round trip of a
+ * Properties.Get that the broker answers itself (unknown property), which
+ * isolates main loop dispatch from RAUC.
+ * Usage: loop-bench [idle seconds] [calls]
+ */
+#include "update_service.h"
+#include "bench_utils.h"
+#include <dbus/dbus.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::atomic<long> g_service_tid(0);
+
+bool callBroker(DBusConnection* connection) {
+    DBusMessage* call = dbus_message_new_method_call("org.freedesktop.UpdateService", "/org/freedesktop/UpdateService",
+                                                     "org.freedesktop.DBus.Properties", "Get");
+    const char* interface_name = "org.freedesktop.UpdateService";
+    const char* property_name = "LoopBench";
+    dbus_message_append_args(call, DBUS_TYPE_STRING, &interface_name, DBUS_TYPE_STRING, &property_name,
+                             DBUS_TYPE_INVALID);
+    DBusPendingCall* pending = nullptr;
+    if (!dbus_connection_send_with_reply(connection, call, &pending, 5000) || !pending) {
+        dbus_message_unref(call);
+        return false;
+    }
+    dbus_message_unref(call);
+    dbus_pending_call_block(pending);
+    DBusMessage* reply = dbus_pending_call_steal_reply(pending);
+    dbus_pending_call_unref(pending);
+    if (!reply) {
+        return false;
+    }
+    // The broker answers with UnknownProperty; a NoReply error means the call timed out
+    bool answered = !dbus_message_is_error(reply, DBUS_ERROR_NO_REPLY);
+    dbus_message_unref(reply);
+    return answered;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int idle_seconds = argc > 1 ? atoi(argv[1]) : 10;
+    int calls = argc > 2 ? atoi(argv[2]) : 2000;
+    if (idle_seconds <= 0 || calls <= 0) {
+        fprintf(stderr, "Usage: %s [idle seconds] [calls]\n", argv[0]);
+        return 1;
+    }
+
+    std::string address;
+    pid_t bus_pid = 0;
+    if (!bench::startBus(address, bus_pid)) {
+        fprintf(stderr, "Failed to start a private dbus-daemon\n");
+        return 1;
+    }
+    setenv("DBUS_SYSTEM_BUS_ADDRESS", address.c_str(), 1);
+    dbus_threads_init_default();
+
+    // The client also owns the RAUC name, so the broker sees RAUC as present and
+    // its reconnect timer stays off; calls below never reach RAUC
+    DBusError error;
+    dbus_error_init(&error);
+    DBusConnection* client = dbus_bus_get_private(DBUS_BUS_SYSTEM, &error);
+    if (!client) {
+        fprintf(stderr, "Client connection failed: %s\n", error.message);
+        dbus_error_free(&error);
+        kill(bus_pid, SIGTERM);
+        return 1;
+    }
+    dbus_bus_request_name(client, "de.pengutronix.rauc", DBUS_NAME_FLAG_DO_NOT_QUEUE, nullptr);
+
+    UpdateService service;
+    if (!service.initialize()) {
+        fprintf(stderr, "Failed to initialize UpdateService on %s\n", address.c_str());
+        dbus_connection_close(client);
+        dbus_connection_unref(client);
+        kill(bus_pid, SIGTERM);
+        return 1;
+    }
+    std::thread loop([&service]() {
+        g_service_tid = syscall(SYS_gettid);
+        service.run();
+    });
+
+    // Let start-up traffic (RAUC probe, name request) settle before sampling
+    while (g_service_tid.load() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    callBroker(client);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    long before = bench::threadWakeups(g_service_tid.load());
+    std::this_thread::sleep_for(std::chrono::seconds(idle_seconds));
+    long after = bench::threadWakeups(g_service_tid.load());
+    printf("idle: %ld wakeups in %d s = %.1f wakeups/min\n", after - before, idle_seconds,
+           (after - before) * 60.0 / idle_seconds);
+
+    std::vector<double> samples_us;
+    samples_us.reserve(calls);
+    int failures = 0;
+    for (int i = 0; i < calls; ++i) {
+        auto start = Clock::now();
+        if (!callBroker(client)) {
+            failures++;
+            continue;
+        }
+        samples_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+    }
+
+    if (!samples_us.empty()) {
+        std::sort(samples_us.begin(), samples_us.end());
+        double sum = 0.0;
+        for (double sample : samples_us) {
+            sum += sample;
+        }
+        size_t count = samples_us.size();
+        printf("round trip: calls=%zu failures=%d mean=%.1f us  p50=%.1f us  p99=%.1f us  max=%.1f us\n", count,
+               failures, sum / count, bench::percentile(samples_us, 50), bench::percentile(samples_us, 99),
+               samples_us.back());
+    } else {
+        printf("round trip: all %d calls failed\n", calls);
+    }
+
+    dbus_connection_close(client);
+    dbus_connection_unref(client);
+    service.stop();
+    loop.join();
+    kill(bus_pid, SIGTERM);
+    return failures == 0 ? 0 : 1;
+}
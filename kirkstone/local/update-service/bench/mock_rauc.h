@@ -0,0 +1,167 @@
+#ifndef MOCK_RAUC_H
+#define MOCK_RAUC_H
+
+#include <dbus/dbus.h>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace bench {
+
+const char* const RAUC_INTERFACE = "de.pengutronix.rauc.Installer";
+
+inline void appendEntry(DBusMessageIter* dict, const char* key, int type, const char* signature, const void* value) {
+    DBusMessageIter entry, variant;
+    dbus_message_iter_open_container(dict, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, signature, &variant);
+    dbus_message_iter_append_basic(&variant, type, value);
+    dbus_message_iter_close_container(&entry, &variant);
+    dbus_message_iter_close_container(dict, &entry);
+}
+
+/**
+ * Mock RAUC for the benchmarks: owns de.pengutronix.rauc, answers
+ * Properties.Get, Install and GetSlotStatus on its own thread and emits
+ * Progress signals on request. Replies are fixed, so the figures measure
+ * the broker and the bus rather than RAUC.
+ */
+class MockRauc {
+public:
+    ~MockRauc() { stop(); }
+
+    bool start() {
+        connection_ = dbus_bus_get_private(DBUS_BUS_SYSTEM, nullptr);
+        if (!connection_) {
+            return false;
+        }
+        dbus_connection_set_exit_on_disconnect(connection_, FALSE);
+        if (dbus_bus_request_name(connection_, "de.pengutronix.rauc", DBUS_NAME_FLAG_DO_NOT_QUEUE, nullptr) !=
+            DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER) {
+            return false;
+        }
+        static const DBusObjectPathVTable vtable = { nullptr, handleMessage, nullptr, nullptr, nullptr, nullptr };
+        dbus_connection_register_object_path(connection_, "/", &vtable, this);
+
+        running_ = true;
+        thread_ = std::thread([this]() {
+            while (running_ && dbus_connection_read_write_dispatch(connection_, 20)) {
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        if (connection_) {
+            dbus_connection_close(connection_);
+            dbus_connection_unref(connection_);
+            connection_ = nullptr;
+        }
+    }
+
+    void sendProgress(int percentage) {
+        DBusMessage* signal = dbus_message_new_signal("/", RAUC_INTERFACE, "Progress");
+        dbus_int32_t value = percentage;
+        dbus_message_append_args(signal, DBUS_TYPE_INT32, &value, DBUS_TYPE_INVALID);
+        dbus_connection_send(connection_, signal, nullptr);
+        dbus_message_unref(signal);
+    }
+
+    void flush() { dbus_connection_flush(connection_); }
+
+private:
+    DBusConnection* connection_ = nullptr;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+
+    static DBusMessage* propertyReply(DBusMessage* call) {
+        const char* interface_name = nullptr;
+        const char* property_name = nullptr;
+        if (!dbus_message_get_args(call, nullptr, DBUS_TYPE_STRING, &interface_name, DBUS_TYPE_STRING,
+                                   &property_name, DBUS_TYPE_INVALID)) {
+            return dbus_message_new_error(call, DBUS_ERROR_INVALID_ARGS, "Expected (ss)");
+        }
+        DBusMessage* reply = dbus_message_new_method_return(call);
+        DBusMessageIter iter, variant;
+        dbus_message_iter_init_append(reply, &iter);
+        if (strcmp(property_name, "Progress") == 0) {
+            // Outside the 0..99 the flood uses, so a polled value is never taken for a forwarded signal
+            DBusMessageIter progress;
+            dbus_int32_t percentage = 100;
+            dbus_int32_t depth = 1;
+            const char* message = "Installing done.";
+            dbus_message_iter_open_container(&iter, DBUS_TYPE_VARIANT, "(isi)", &variant);
+            dbus_message_iter_open_container(&variant, DBUS_TYPE_STRUCT, nullptr, &progress);
+            dbus_message_iter_append_basic(&progress, DBUS_TYPE_INT32, &percentage);
+            dbus_message_iter_append_basic(&progress, DBUS_TYPE_STRING, &message);
+            dbus_message_iter_append_basic(&progress, DBUS_TYPE_INT32, &depth);
+            dbus_message_iter_close_container(&variant, &progress);
+        } else {
+            const char* value = strcmp(property_name, "Operation") == 0    ? "idle"
+                                : strcmp(property_name, "Compatible") == 0 ? "load-bench"
+                                : strcmp(property_name, "BootSlot") == 0   ? "A"
+                                                                           : "";
+            dbus_message_iter_open_container(&iter, DBUS_TYPE_VARIANT, "s", &variant);
+            dbus_message_iter_append_basic(&variant, DBUS_TYPE_STRING, &value);
+        }
+        dbus_message_iter_close_container(&iter, &variant);
+        return reply;
+    }
+
+    // a(sa{sv}) with the fields rauc status reports for a redundant rootfs
+    static DBusMessage* slotStatusReply(DBusMessage* call) {
+        DBusMessage* reply = dbus_message_new_method_return(call);
+        DBusMessageIter iter, slots, slot, dict;
+        dbus_message_iter_init_append(reply, &iter);
+        dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "(sa{sv})", &slots);
+        for (int i = 0; i < 2; ++i) {
+            const char* name = i == 0 ? "rootfs.0" : "rootfs.1";
+            const char* bootname = i == 0 ? "A" : "B";
+            const char* device = i == 0 ? "/dev/mmcblk0p2" : "/dev/mmcblk0p3";
+            const char* state = i == 0 ? "booted" : "inactive";
+            const char* status = "ok";
+            const char* sha256 = "8b0f8e6c3e7a1d2f4c5b6a79808f1e2d3c4b5a6978877665544332211000fedc";
+            dbus_uint64_t size = 268435456;
+            dbus_message_iter_open_container(&slots, DBUS_TYPE_STRUCT, nullptr, &slot);
+            dbus_message_iter_append_basic(&slot, DBUS_TYPE_STRING, &name);
+            dbus_message_iter_open_container(&slot, DBUS_TYPE_ARRAY, "{sv}", &dict);
+            appendEntry(&dict, "bootname", DBUS_TYPE_STRING, "s", &bootname);
+            appendEntry(&dict, "device", DBUS_TYPE_STRING, "s", &device);
+            appendEntry(&dict, "state", DBUS_TYPE_STRING, "s", &state);
+            appendEntry(&dict, "boot-status", DBUS_TYPE_STRING, "s", &status);
+            appendEntry(&dict, "sha256", DBUS_TYPE_STRING, "s", &sha256);
+            appendEntry(&dict, "size", DBUS_TYPE_UINT64, "t", &size);
+            dbus_message_iter_close_container(&slot, &dict);
+            dbus_message_iter_close_container(&slots, &slot);
+        }
+        dbus_message_iter_close_container(&iter, &slots);
+        return reply;
+    }
+
+    static DBusHandlerResult handleMessage(DBusConnection* connection, DBusMessage* message, void*) {
+        if (dbus_message_get_type(message) != DBUS_MESSAGE_TYPE_METHOD_CALL) {
+            return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+        }
+        DBusMessage* reply;
+        if (dbus_message_is_method_call(message, "org.freedesktop.DBus.Properties", "Get")) {
+            reply = propertyReply(message);
+        } else if (dbus_message_is_method_call(message, RAUC_INTERFACE, "Install")) {
+            reply = dbus_message_new_method_return(message);
+        } else if (dbus_message_is_method_call(message, RAUC_INTERFACE, "GetSlotStatus")) {
+            reply = slotStatusReply(message);
+        } else {
+            reply = dbus_message_new_error(message, DBUS_ERROR_UNKNOWN_METHOD, dbus_message_get_member(message));
+        }
+        dbus_connection_send(connection, reply, nullptr);
+        dbus_message_unref(reply);
+        return DBUS_HANDLER_RESULT_HANDLED;
+    }
+};
+
+} // namespace bench
+
+#endif // MOCK_RAUC_H
@@ -0,0 +1,171 @@
+/**
+ * Signal forwarding throughput benchmark
+ *
+ * Starts a private dbus-daemon and runs UpdateService on a worker thread. A
+ * sender connection owns the RAUC name and emits RAUC signals as fast as
+ * the bus takes them; a listener connection counts the Progress signals
+ * the broker forwards. Throughput is bounded by dbus-daemon, so the CPU
+ * time the service thread spends per forwarded signal is reported as well.
+ * Two RAUC sources are measured:
+ *   progress    de.pengutronix.rauc.Installer.Progress(i)
+ *   properties  PropertiesChanged with a new Progress (isi) each time
+ * Logging cost depends on the DLT level (DLT_STUB_LEVEL with the sandbox
+ * stub, dlt-control on a target).
+ * Usage: signal-bench [signals]
+ */
+#include "update_service.h"
+#include "bench_utils.h"
+#include <dbus/dbus.h>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* RAUC_INTERFACE = "de.pengutronix.rauc.Installer";
+
+DBusMessage* raucProgressSignal(int percentage) {
+    DBusMessage* signal = dbus_message_new_signal("/", RAUC_INTERFACE, "Progress");
+    dbus_int32_t value = percentage;
+    dbus_message_append_args(signal, DBUS_TYPE_INT32, &value, DBUS_TYPE_INVALID);
+    return signal;
+}
+
+// PropertiesChanged("de.pengutronix.rauc.Installer", {"Progress": <(percentage, "Copying", 1)>}, [])
+DBusMessage* raucPropertiesChanged(int percentage) {
+    DBusMessage* signal = dbus_message_new_signal("/", "org.freedesktop.DBus.Properties", "PropertiesChanged");
+    DBusMessageIter args, changed, entry, variant, progress, invalidated;
+    const char* key = "Progress";
+    const char* text = "Copying";
+    dbus_int32_t value = percentage;
+    dbus_int32_t depth = 1;
+    dbus_message_iter_init_append(signal, &args);
+    dbus_message_iter_append_basic(&args, DBUS_TYPE_STRING, &RAUC_INTERFACE);
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "{sv}", &changed);
+    dbus_message_iter_open_container(&changed, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "(isi)", &variant);
+    dbus_message_iter_open_container(&variant, DBUS_TYPE_STRUCT, nullptr, &progress);
+    dbus_message_iter_append_basic(&progress, DBUS_TYPE_INT32, &value);
+    dbus_message_iter_append_basic(&progress, DBUS_TYPE_STRING, &text);
+    dbus_message_iter_append_basic(&progress, DBUS_TYPE_INT32, &depth);
+    dbus_message_iter_close_container(&variant, &progress);
+    dbus_message_iter_close_container(&entry, &variant);
+    dbus_message_iter_close_container(&changed, &entry);
+    dbus_message_iter_close_container(&args, &changed);
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "s", &invalidated);
+    dbus_message_iter_close_container(&args, &invalidated);
+    return signal;
+}
+
+// Progress signals the broker forwarded, until `expected` arrived or none came for a second
+int countForwarded(DBusConnection* listener, int expected, Clock::time_point& last) {
+    int received = 0;
+    auto quiet_since = Clock::now();
+    while (received < expected && Clock::now() - quiet_since < std::chrono::seconds(1)) {
+        dbus_connection_read_write(listener, 100);
+        while (DBusMessage* message = dbus_connection_pop_message(listener)) {
+            if (dbus_message_is_signal(message, "org.freedesktop.UpdateService", "Progress")) {
+                received++;
+                last = quiet_since = Clock::now();
+            }
+            dbus_message_unref(message);
+        }
+    }
+    return received;
+}
+
+void runMode(const char* name, DBusConnection* rauc, DBusConnection* listener, int signals,
+             DBusMessage* (*build)(int), clockid_t service_clock) {
+    double cpu_before = bench::cpuSeconds(service_clock);
+    Clock::time_point first = Clock::now();
+    Clock::time_point last = first;
+    std::thread sender([=]() {
+        for (int i = 0; i < signals; ++i) {
+            // Consecutive values always differ, so the broker never drops one as unchanged
+            DBusMessage* signal = build(i % 100);
+            dbus_connection_send(rauc, signal, nullptr);
+            dbus_message_unref(signal);
+        }
+        dbus_connection_flush(rauc);
+    });
+    int received = countForwarded(listener, signals, last);
+    sender.join();
+    double cpu = bench::cpuSeconds(service_clock) - cpu_before;
+
+    double seconds = std::chrono::duration<double>(last - first).count();
+    printf("%-10s sent=%d forwarded=%d in %.3f s = %.0f signals/s, service CPU %.1f us/signal\n", name, signals,
+           received, seconds, seconds > 0 ? received / seconds : 0.0, received > 0 ? cpu * 1e6 / received : 0.0);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int signals = argc > 1 ? atoi(argv[1]) : 20000;
+    if (signals <= 0) {
+        fprintf(stderr, "Usage: %s [signals]\n", argv[0]);
+        return 1;
+    }
+
+    std::string address;
+    pid_t bus_pid = 0;
+    if (!bench::startBus(address, bus_pid)) {
+        fprintf(stderr, "Failed to start a private dbus-daemon\n");
+        return 1;
+    }
+    setenv("DBUS_SYSTEM_BUS_ADDRESS", address.c_str(), 1);
+    // The listener counts broadcast Progress through a match rule
+    setenv("UPDATE_SERVICE_BROADCAST_SIGNALS", "1", 1);
+    dbus_threads_init_default();
+
+    DBusError error;
+    dbus_error_init(&error);
+    DBusConnection* rauc = dbus_bus_get_private(DBUS_BUS_SYSTEM, &error);
+    DBusConnection* listener = rauc ? dbus_bus_get_private(DBUS_BUS_SYSTEM, &error) : nullptr;
+    if (!listener) {
+        fprintf(stderr, "Client connection failed: %s\n", error.message);
+        dbus_error_free(&error);
+        kill(bus_pid, SIGTERM);
+        return 1;
+    }
+    dbus_bus_request_name(rauc, "de.pengutronix.rauc", DBUS_NAME_FLAG_DO_NOT_QUEUE, nullptr);
+    dbus_bus_add_match(listener,
+                       "type='signal',sender='org.freedesktop.UpdateService',"
+                       "interface='org.freedesktop.UpdateService',member='Progress'",
+                       nullptr);
+    dbus_connection_flush(listener);
+
+    UpdateService service;
+    if (!service.initialize()) {
+        fprintf(stderr, "Failed to initialize UpdateService on %s\n", address.c_str());
+        kill(bus_pid, SIGTERM);
+        return 1;
+    }
+    std::thread loop([&service]() { service.run(); });
+    clockid_t service_clock;
+    if (pthread_getcpuclockid(loop.native_handle(), &service_clock) != 0) {
+        service_clock = CLOCK_PROCESS_CPUTIME_ID;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    runMode("progress", rauc, listener, signals, raucProgressSignal, service_clock);
+    runMode("properties", rauc, listener, signals, raucPropertiesChanged, service_clock);
+
+    dbus_connection_close(listener);
+    dbus_connection_unref(listener);
+    dbus_connection_close(rauc);
+    dbus_connection_unref(rauc);
+    service.stop();
+    loop.join();
+    kill(bus_pid, SIGTERM);
+    return 0;
+}
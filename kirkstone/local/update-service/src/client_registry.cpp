@@ -0,0 +1,96 @@
+#include "client_registry.h"
+#include <cstdlib>
+
+bool ClientRegistry::subscribe(const std::string& name, const Options& options) {
+    auto it = clients_.find(name);
+    if (it != clients_.end()) {
+        it->second.options = options;
+        return false;
+    }
+    clients_[name].options = options;
+    return true;
+}
+
+bool ClientRegistry::unsubscribe(const std::string& name) {
+    return clients_.erase(name) > 0;
+}
+
+std::vector<std::string> ClientRegistry::progressTargets(int percentage, Clock::time_point now) {
+    std::vector<std::string> targets;
+    for (auto& entry : clients_) {
+        Client& client = entry.second;
+        if (!client.options.progress) {
+            continue;
+        }
+
+        bool boundary = percentage == 0 || percentage == 100;
+        int reference = client.pending >= 0 ? client.pending : client.last_sent;
+        if (!boundary && reference >= 0 &&
+            static_cast<uint32_t>(std::abs(percentage - reference)) < client.options.progress_step) {
+            coalesced_++;
+            continue;
+        }
+
+        if (!intervalPassed(client, now)) {
+            if (client.pending >= 0) {
+                coalesced_++;
+            }
+            client.pending = percentage;
+            continue;
+        }
+
+        if (client.pending >= 0) {
+            coalesced_++;
+        }
+        client.pending = -1;
+        client.last_sent = percentage;
+        client.last_sent_at = now;
+        targets.push_back(entry.first);
+    }
+    return targets;
+}
+
+std::vector<std::pair<std::string, int>> ClientRegistry::takeDueProgress(Clock::time_point now) {
+    std::vector<std::pair<std::string, int>> due;
+    for (auto& entry : clients_) {
+        Client& client = entry.second;
+        if (client.pending >= 0 && intervalPassed(client, now)) {
+            due.emplace_back(entry.first, client.pending);
+            client.last_sent = client.pending;
+            client.last_sent_at = now;
+            client.pending = -1;
+        }
+    }
+    return due;
+}
+
+bool ClientRegistry::hasPendingProgress() const {
+    for (const auto& entry : clients_) {
+        if (entry.second.pending >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<std::string> ClientRegistry::completedTargets() {
+    std::vector<std::string> targets;
+    for (auto& entry : clients_) {
+        Client& client = entry.second;
+        // A coalesced value is stale once the installation has finished
+        if (client.pending >= 0) {
+            coalesced_++;
+        }
+        client.pending = -1;
+        client.last_sent = -1;
+        if (client.options.completed) {
+            targets.push_back(entry.first);
+        }
+    }
+    return targets;
+}
+
+bool ClientRegistry::intervalPassed(const Client& client, Clock::time_point now) {
+    return client.last_sent < 0 ||
+           now - client.last_sent_at >= std::chrono::milliseconds(client.options.progress_interval_ms);
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Clients subscribed to unicast update signals
+ *
+ * Each client (by unique bus name) chooses what it wants: progress at a
+ * percentage granularity and at most once per interval, and/or the
+ * completion signal. Progress that arrives inside a client's interval is
+ * coalesced: only the latest value is kept and delivered when the interval
+ * has passed. 0 % and 100 % always pass the granularity filter.
+ *
+ * Pure bookkeeping; UpdateService sends the signals.
+ */
+class ClientRegistry {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        bool progress = true;
+        uint32_t progress_step = 1;          // minimum percentage change
+        uint32_t progress_interval_ms = 0;   // minimum time between Progress signals
+        bool completed = true;
+    };
+
+    /**
+     * @brief Add or update a client
+     * @return true if the client was not subscribed yet
+     */
+    bool subscribe(const std::string& name, const Options& options);
+
+    /**
+     * @brief Remove a client
+     * @return true if it was subscribed
+     */
+    bool unsubscribe(const std::string& name);
+
+    size_t size() const { return clients_.size(); }
+
+    /**
+     * @brief Offer a new percentage
+     * @return Clients to send it to now; others skip it or get it from takeDueProgress()
+     */
+    std::vector<std::string> progressTargets(int percentage, Clock::time_point now);
+
+    /**
+     * @brief Coalesced percentages whose client interval has passed
+     */
+    std::vector<std::pair<std::string, int>> takeDueProgress(Clock::time_point now);
+
+    bool hasPendingProgress() const;
+
+    /**
+     * @brief Clients that want Completed; resets progress state for the next installation
+     */
+    std::vector<std::string> completedTargets();
+
+    // Progress values not sent to a client (below its step or replaced within its interval)
+    uint64_t coalesced() const { return coalesced_; }
+
+private:
+    struct Client {
+        Options options;
+        int last_sent = -1;
+        int pending = -1;
+        Clock::time_point last_sent_at;
+    };
+
+    std::map<std::string, Client> clients_;
+    uint64_t coalesced_ = 0;
+
+    static bool intervalPassed(const Client& client, Clock::time_point now);
+};
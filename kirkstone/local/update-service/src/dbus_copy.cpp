@@ -0,0 +1,186 @@
+#include "dbus_copy.h"
+#include <cstring>
+#include <unistd.h>
+
+namespace dbus_copy {
+
+namespace {
+
+bool copyArray(DBusMessageIter* source, DBusMessageIter* target, const char* signature) {
+    // open_container() wants the element signature NUL terminated; it fits on the stack
+    const char* element = signature + 1;
+    int element_length = completeTypeLength(element);
+    if (element_length == 0 || element_length > DBUS_MAXIMUM_SIGNATURE_LENGTH) {
+        return false;
+    }
+    char element_signature[DBUS_MAXIMUM_SIGNATURE_LENGTH + 1];
+    memcpy(element_signature, element, element_length);
+    element_signature[element_length] = '\0';
+
+    DBusMessageIter source_elements, target_elements;
+    dbus_message_iter_recurse(source, &source_elements);
+    if (!dbus_message_iter_open_container(target, DBUS_TYPE_ARRAY, element_signature, &target_elements)) {
+        return false;
+    }
+
+    bool ok = true;
+    // '(' and '{' are signature characters, not type codes, and must not reach dbus_type_is_fixed()
+    int element_type = element_signature[0];
+    bool fixed = element_type != DBUS_STRUCT_BEGIN_CHAR && element_type != DBUS_DICT_ENTRY_BEGIN_CHAR &&
+                 element_type != DBUS_TYPE_UNIX_FD && dbus_type_is_fixed(element_type);
+    if (fixed) {
+        // Fixed-size elements (ay, ai, at, ...) are copied as one block
+        const void* values = nullptr;
+        int count = 0;
+        dbus_message_iter_get_fixed_array(&source_elements, &values, &count);
+        if (count > 0) {
+            ok = dbus_message_iter_append_fixed_array(&target_elements, element_type, &values, count);
+        }
+    } else {
+        while (ok && dbus_message_iter_get_arg_type(&source_elements) != DBUS_TYPE_INVALID) {
+            ok = copyValue(&source_elements, &target_elements, element_signature);
+            dbus_message_iter_next(&source_elements);
+        }
+    }
+
+    if (!ok) {
+        dbus_message_iter_abandon_container(target, &target_elements);
+        return false;
+    }
+    return dbus_message_iter_close_container(target, &target_elements);
+}
+
+bool copyStruct(DBusMessageIter* source, DBusMessageIter* target, int type, const char* signature) {
+    DBusMessageIter source_fields, target_fields;
+    dbus_message_iter_recurse(source, &source_fields);
+    if (!dbus_message_iter_open_container(target, type, nullptr, &target_fields)) {
+        return false;
+    }
+
+    // Walk the member types inside "(...)" or "{..}" alongside the values
+    bool ok = true;
+    const char* field = signature + 1;
+    while (ok && dbus_message_iter_get_arg_type(&source_fields) != DBUS_TYPE_INVALID) {
+        ok = copyValue(&source_fields, &target_fields, field);
+        field += completeTypeLength(field);
+        dbus_message_iter_next(&source_fields);
+    }
+
+    if (!ok) {
+        dbus_message_iter_abandon_container(target, &target_fields);
+        return false;
+    }
+    return dbus_message_iter_close_container(target, &target_fields);
+}
+
+bool copyVariant(DBusMessageIter* source, DBusMessageIter* target) {
+    DBusMessageIter source_value, target_value;
+    dbus_message_iter_recurse(source, &source_value);
+
+    // The contained signature lives in the message; basic types are rebuilt on the
+    // stack and only container values pay for libdbus' allocated copy
+    int value_type = dbus_message_iter_get_arg_type(&source_value);
+    char basic_signature[2] = { static_cast<char>(value_type), '\0' };
+    char* allocated_signature = nullptr;
+    const char* value_signature = basic_signature;
+    if (!dbus_type_is_basic(value_type)) {
+        allocated_signature = dbus_message_iter_get_signature(&source_value);
+        if (!allocated_signature) {
+            return false;
+        }
+        value_signature = allocated_signature;
+    }
+
+    bool ok = dbus_message_iter_open_container(target, DBUS_TYPE_VARIANT, value_signature, &target_value);
+    if (ok) {
+        ok = copyValue(&source_value, &target_value, value_signature);
+        if (ok) {
+            ok = dbus_message_iter_close_container(target, &target_value);
+        } else {
+            dbus_message_iter_abandon_container(target, &target_value);
+        }
+    }
+
+    if (allocated_signature) {
+        dbus_free(allocated_signature);
+    }
+    return ok;
+}
+
+} // namespace
+
+bool copyArguments(DBusMessage* source, DBusMessage* target) {
+    DBusMessageIter source_args, target_args;
+    if (!dbus_message_iter_init(source, &source_args)) {
+        return true;  // No arguments
+    }
+    dbus_message_iter_init_append(target, &target_args);
+
+    const char* signature = dbus_message_get_signature(source);
+    do {
+        if (!copyValue(&source_args, &target_args, signature)) {
+            return false;
+        }
+        signature += completeTypeLength(signature);
+    } while (dbus_message_iter_next(&source_args));
+    return true;
+}
+
+bool copyValue(DBusMessageIter* source, DBusMessageIter* target, const char* signature) {
+    int type = dbus_message_iter_get_arg_type(source);
+    int signature_type = type == DBUS_TYPE_STRUCT ? DBUS_STRUCT_BEGIN_CHAR
+                       : type == DBUS_TYPE_DICT_ENTRY ? DBUS_DICT_ENTRY_BEGIN_CHAR
+                       : type;
+    if (type == DBUS_TYPE_INVALID || !signature || signature[0] != signature_type) {
+        return false;
+    }
+
+    switch (type) {
+    case DBUS_TYPE_ARRAY:
+        return copyArray(source, target, signature);
+    case DBUS_TYPE_STRUCT:
+    case DBUS_TYPE_DICT_ENTRY:
+        return copyStruct(source, target, type, signature);
+    case DBUS_TYPE_VARIANT:
+        return copyVariant(source, target);
+    case DBUS_TYPE_UNIX_FD: {
+        // get_basic() hands out a duplicate and append_basic() duplicates again
+        int fd = -1;
+        dbus_message_iter_get_basic(source, &fd);
+        bool ok = dbus_message_iter_append_basic(target, DBUS_TYPE_UNIX_FD, &fd);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return ok;
+    }
+    default: {
+        // Strings point into the source message; append copies them into the target
+        DBusBasicValue value;
+        dbus_message_iter_get_basic(source, &value);
+        return dbus_message_iter_append_basic(target, type, &value);
+    }
+    }
+}
+
+int completeTypeLength(const char* signature) {
+    const char* end = signature;
+    while (*end == DBUS_TYPE_ARRAY) {
+        end++;
+    }
+    if (*end == DBUS_STRUCT_BEGIN_CHAR || *end == DBUS_DICT_ENTRY_BEGIN_CHAR) {
+        int depth = 0;
+        do {
+            if (*end == DBUS_STRUCT_BEGIN_CHAR || *end == DBUS_DICT_ENTRY_BEGIN_CHAR) {
+                depth++;
+            } else if (*end == DBUS_STRUCT_END_CHAR || *end == DBUS_DICT_ENTRY_END_CHAR) {
+                depth--;
+            }
+            end++;
+        } while (depth > 0 && *end != '\0');
+    } else if (*end != '\0') {
+        end++;
+    }
+    return static_cast<int>(end - signature);
+}
+
+} // namespace dbus_copy
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <dbus/dbus.h>
+
+/**
+ * @brief Generic D-Bus value copying for forwarded calls and replies
+ *
+ * Copies arguments iterator to iterator for the whole type system: basic
+ * types, arrays, dicts, structs, variants and nested combinations. Container
+ * signatures are taken from the enclosing signature rather than asked from
+ * libdbus, and arrays of fixed-size types are copied as one block, so only
+ * variants holding a container need a (libdbus-allocated) signature lookup.
+ */
+namespace dbus_copy {
+
+/**
+ * @brief Append all arguments of source to target
+ * @return false if a value could not be appended (out of memory)
+ */
+bool copyArguments(DBusMessage* source, DBusMessage* target);
+
+/**
+ * @brief Copy the single complete value at source to target
+ * @param signature Signature of the value; only the first complete type is used
+ * @return false if a value could not be appended (out of memory)
+ */
+bool copyValue(DBusMessageIter* source, DBusMessageIter* target, const char* signature);
+
+/**
+ * @brief Length of the first complete type in a signature ("a{sv}i" -> 5)
+ */
+int completeTypeLength(const char* signature);
+
+} // namespace dbus_copy
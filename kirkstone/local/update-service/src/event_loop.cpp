@@ -0,0 +1,376 @@
+#include "event_loop.h"
+#include <dlt/dlt.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+DLT_DECLARE_CONTEXT(dlt_context_loop);
+
+namespace {
+const int MAX_EVENTS = 16;
+}
+
+EventLoop::EventLoop()
+    : epoll_fd_(-1)
+    , wakeup_fd_(-1)
+    , quit_requested_(false)
+    , next_timer_id_(1) {
+
+    DLT_REGISTER_CONTEXT(dlt_context_loop, "LOOP", "Update Service event loop");
+}
+
+EventLoop::~EventLoop() {
+    while (!connections_.empty()) {
+        detach(connections_.back());
+    }
+    if (wakeup_fd_ >= 0) {
+        close(wakeup_fd_);
+    }
+    if (epoll_fd_ >= 0) {
+        close(epoll_fd_);
+    }
+    DLT_UNREGISTER_CONTEXT(dlt_context_loop);
+}
+
+bool EventLoop::initialize() {
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd_ < 0) {
+        DLT_LOG(dlt_context_loop, DLT_LOG_ERROR, DLT_STRING("epoll_create1 failed: "), DLT_STRING(strerror(errno)));
+        return false;
+    }
+
+    wakeup_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeup_fd_ < 0) {
+        DLT_LOG(dlt_context_loop, DLT_LOG_ERROR, DLT_STRING("eventfd failed: "), DLT_STRING(strerror(errno)));
+        return false;
+    }
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = wakeup_fd_;
+    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &event) < 0) {
+        DLT_LOG(dlt_context_loop, DLT_LOG_ERROR, DLT_STRING("Failed to watch wakeup fd: "), DLT_STRING(strerror(errno)));
+        return false;
+    }
+    return true;
+}
+
+bool EventLoop::attach(DBusConnection* connection) {
+    if (!connection) {
+        return false;
+    }
+    if (std::find(connections_.begin(), connections_.end(), connection) != connections_.end()) {
+        return true;
+    }
+
+    if (!dbus_connection_set_watch_functions(connection, addWatch, removeWatch, toggleWatch, this, nullptr) ||
+        !dbus_connection_set_timeout_functions(connection, addTimeout, removeTimeout, toggleTimeout, this, nullptr)) {
+        DLT_LOG(dlt_context_loop, DLT_LOG_ERROR, DLT_STRING("Failed to install D-Bus watch/timeout functions"));
+        dbus_connection_set_watch_functions(connection, nullptr, nullptr, nullptr, nullptr, nullptr);
+        dbus_connection_set_timeout_functions(connection, nullptr, nullptr, nullptr, nullptr, nullptr);
+        return false;
+    }
+    dbus_connection_set_wakeup_main_function(connection, wakeupMain, this, nullptr);
+
+    dbus_connection_ref(connection);
+    connections_.push_back(connection);
+    return true;
+}
+
+void EventLoop::detach(DBusConnection* connection) {
+    auto it = std::find(connections_.begin(), connections_.end(), connection);
+    if (it == connections_.end()) {
+        return;
+    }
+    connections_.erase(it);
+
+    // Clearing the functions makes libdbus call removeWatch/removeTimeout for everything it added
+    dbus_connection_set_watch_functions(connection, nullptr, nullptr, nullptr, nullptr, nullptr);
+    dbus_connection_set_timeout_functions(connection, nullptr, nullptr, nullptr, nullptr, nullptr);
+    dbus_connection_set_wakeup_main_function(connection, nullptr, nullptr, nullptr);
+    dbus_connection_unref(connection);
+}
+
+int EventLoop::addTimer(int interval_ms, TimerCallback callback) {
+    std::unique_ptr<Timer> timer(new Timer());
+    timer->interval_ms = interval_ms;
+    timer->callback = std::move(callback);
+
+    int timer_id = next_timer_id_++;
+    timers_[timer_id] = std::move(timer);
+    return timer_id;
+}
+
+void EventLoop::setTimerEnabled(int timer_id, bool enabled) {
+    auto it = timers_.find(timer_id);
+    if (it == timers_.end() || it->second->enabled == enabled) {
+        return;
+    }
+    it->second->enabled = enabled;
+    it->second->deadline = Clock::now() + std::chrono::milliseconds(it->second->interval_ms);
+}
+
+void EventLoop::run() {
+    epoll_event events[MAX_EVENTS];
+
+    while (!quit_requested_) {
+        // Blocking calls made by handlers may have queued incoming messages without
+        // leaving anything readable on the socket, so drain the queues before sleeping
+        dispatchPending();
+        if (quit_requested_) {
+            break;
+        }
+
+        int count = epoll_wait(epoll_fd_, events, MAX_EVENTS, nextTimeoutMs());
+        stats_.wakeups++;
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            DLT_LOG(dlt_context_loop, DLT_LOG_ERROR, DLT_STRING("epoll_wait failed: "), DLT_STRING(strerror(errno)));
+            break;
+        }
+
+        for (int i = 0; i < count; ++i) {
+            int fd = events[i].data.fd;
+            if (fd == wakeup_fd_) {
+                uint64_t value;
+                while (read(wakeup_fd_, &value, sizeof(value)) > 0) {
+                }
+            } else {
+                handleFdEvents(fd, events[i].events);
+            }
+        }
+
+        fireExpiredTimers();
+    }
+}
+
+void EventLoop::quit() {
+    quit_requested_ = true;
+    wakeup();
+}
+
+void EventLoop::wakeup() {
+    if (wakeup_fd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(wakeup_fd_, &one, sizeof(one));
+        (void)written;  // EAGAIN only means a wakeup is already pending
+    }
+}
+
+void EventLoop::updateFd(int fd) {
+    auto it = fd_watches_.find(fd);
+    if (it == fd_watches_.end()) {
+        return;
+    }
+
+    uint32_t events = 0;
+    for (DBusWatch* watch : it->second.watches) {
+        if (!dbus_watch_get_enabled(watch)) {
+            continue;
+        }
+        unsigned int flags = dbus_watch_get_flags(watch);
+        if (flags & DBUS_WATCH_READABLE) {
+            events |= EPOLLIN;
+        }
+        if (flags & DBUS_WATCH_WRITABLE) {
+            events |= EPOLLOUT;
+        }
+    }
+
+    uint32_t previous = it->second.events;
+    if (events == previous) {
+        return;
+    }
+    it->second.events = events;
+
+    // A registered fd reports EPOLLHUP even with an empty mask, so fully idle fds are removed
+    if (events == 0) {
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        return;
+    }
+
+    epoll_event event = {};
+    event.events = events;
+    event.data.fd = fd;
+    if (epoll_ctl(epoll_fd_, previous == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &event) < 0) {
+        DLT_LOG(dlt_context_loop, DLT_LOG_ERROR, DLT_STRING("epoll_ctl failed for fd "), DLT_INT(fd),
+                DLT_STRING(": "), DLT_STRING(strerror(errno)));
+    }
+}
+
+void EventLoop::handleFdEvents(int fd, uint32_t events) {
+    auto it = fd_watches_.find(fd);
+    if (it == fd_watches_.end()) {
+        return;
+    }
+
+    // Handling one watch can remove others on the same fd, so work on a copy
+    // and skip any watch that is gone by the time we reach it
+    std::vector<DBusWatch*> watches = it->second.watches;
+    for (DBusWatch* watch : watches) {
+        auto current = fd_watches_.find(fd);
+        if (current == fd_watches_.end() ||
+            std::find(current->second.watches.begin(), current->second.watches.end(), watch) == current->second.watches.end() ||
+            !dbus_watch_get_enabled(watch)) {
+            continue;
+        }
+
+        unsigned int watch_flags = dbus_watch_get_flags(watch);
+        unsigned int flags = 0;
+        if ((events & EPOLLIN) && (watch_flags & DBUS_WATCH_READABLE)) {
+            flags |= DBUS_WATCH_READABLE;
+        }
+        if ((events & EPOLLOUT) && (watch_flags & DBUS_WATCH_WRITABLE)) {
+            flags |= DBUS_WATCH_WRITABLE;
+        }
+        if (events & EPOLLHUP) {
+            flags |= DBUS_WATCH_HANGUP;
+        }
+        if (events & EPOLLERR) {
+            flags |= DBUS_WATCH_ERROR;
+        }
+
+        if (flags != 0) {
+            stats_.watch_events++;
+            dbus_watch_handle(watch, flags);
+        }
+    }
+}
+
+int EventLoop::nextTimeoutMs() const {
+    bool any = false;
+    Clock::time_point earliest;
+    for (const auto& entry : timers_) {
+        const Timer& timer = *entry.second;
+        if (timer.enabled && (!any || timer.deadline < earliest)) {
+            earliest = timer.deadline;
+            any = true;
+        }
+    }
+    if (!any) {
+        return -1;
+    }
+
+    auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(earliest - Clock::now()).count();
+    if (remaining <= 0) {
+        return 0;
+    }
+    // Round up so we never wake just before the deadline and spin
+    return static_cast<int>((remaining + 999) / 1000);
+}
+
+void EventLoop::fireExpiredTimers() {
+    Clock::time_point now = Clock::now();
+
+    std::vector<int> expired;
+    for (const auto& entry : timers_) {
+        if (entry.second->enabled && entry.second->deadline <= now) {
+            expired.push_back(entry.first);
+        }
+    }
+
+    for (int timer_id : expired) {
+        // Earlier callbacks may have removed or disabled this timer
+        auto it = timers_.find(timer_id);
+        if (it == timers_.end() || !it->second->enabled) {
+            continue;
+        }
+        Timer& timer = *it->second;
+        timer.deadline = now + std::chrono::milliseconds(timer.interval_ms);
+        stats_.timer_fires++;
+
+        if (timer.timeout) {
+            dbus_timeout_handle(timer.timeout);
+        } else if (timer.callback) {
+            TimerCallback callback = timer.callback;
+            callback();
+        }
+    }
+}
+
+void EventLoop::dispatchPending() {
+    std::vector<DBusConnection*> connections = connections_;
+    for (DBusConnection* connection : connections) {
+        while (!quit_requested_ && dbus_connection_get_dispatch_status(connection) == DBUS_DISPATCH_DATA_REMAINS) {
+            dbus_connection_dispatch(connection);
+            stats_.dispatches++;
+        }
+    }
+}
+
+dbus_bool_t EventLoop::addWatch(DBusWatch* watch, void* data) {
+    EventLoop* loop = static_cast<EventLoop*>(data);
+    int fd = dbus_watch_get_unix_fd(watch);
+    loop->fd_watches_[fd].watches.push_back(watch);
+    loop->updateFd(fd);
+    return TRUE;
+}
+
+void EventLoop::removeWatch(DBusWatch* watch, void* data) {
+    EventLoop* loop = static_cast<EventLoop*>(data);
+    int fd = dbus_watch_get_unix_fd(watch);
+    auto it = loop->fd_watches_.find(fd);
+    if (it == loop->fd_watches_.end()) {
+        return;
+    }
+
+    std::vector<DBusWatch*>& watches = it->second.watches;
+    watches.erase(std::remove(watches.begin(), watches.end(), watch), watches.end());
+    if (watches.empty()) {
+        // The fd may already be closed; a failed EPOLL_CTL_DEL is harmless then
+        if (it->second.events != 0) {
+            epoll_ctl(loop->epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        }
+        loop->fd_watches_.erase(it);
+    } else {
+        loop->updateFd(fd);
+    }
+}
+
+void EventLoop::toggleWatch(DBusWatch* watch, void* data) {
+    EventLoop* loop = static_cast<EventLoop*>(data);
+    loop->updateFd(dbus_watch_get_unix_fd(watch));
+}
+
+dbus_bool_t EventLoop::addTimeout(DBusTimeout* timeout, void* data) {
+    EventLoop* loop = static_cast<EventLoop*>(data);
+    std::unique_ptr<Timer> timer(new Timer());
+    timer->interval_ms = dbus_timeout_get_interval(timeout);
+    timer->enabled = dbus_timeout_get_enabled(timeout);
+    timer->deadline = Clock::now() + std::chrono::milliseconds(timer->interval_ms);
+    timer->timeout = timeout;
+
+    int timer_id = loop->next_timer_id_++;
+    loop->timers_[timer_id] = std::move(timer);
+    dbus_timeout_set_data(timeout, reinterpret_cast<void*>(static_cast<intptr_t>(timer_id)), nullptr);
+    return TRUE;
+}
+
+void EventLoop::removeTimeout(DBusTimeout* timeout, void* data) {
+    EventLoop* loop = static_cast<EventLoop*>(data);
+    int timer_id = static_cast<int>(reinterpret_cast<intptr_t>(dbus_timeout_get_data(timeout)));
+    loop->timers_.erase(timer_id);
+}
+
+void EventLoop::toggleTimeout(DBusTimeout* timeout, void* data) {
+    EventLoop* loop = static_cast<EventLoop*>(data);
+    int timer_id = static_cast<int>(reinterpret_cast<intptr_t>(dbus_timeout_get_data(timeout)));
+    auto it = loop->timers_.find(timer_id);
+    if (it == loop->timers_.end()) {
+        return;
+    }
+    it->second->interval_ms = dbus_timeout_get_interval(timeout);
+    it->second->enabled = dbus_timeout_get_enabled(timeout);
+    it->second->deadline = Clock::now() + std::chrono::milliseconds(it->second->interval_ms);
+}
+
+void EventLoop::wakeupMain(void* data) {
+    static_cast<EventLoop*>(data)->wakeup();
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <dbus/dbus.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief epoll based main loop for libdbus connections
+ *
+ * Connections are driven through their watch, timeout and wakeup hooks, so
+ * the loop blocks in epoll_wait until a socket becomes readable, a libdbus
+ * or service timer expires, or quit() is called. There is no polling
+ * interval: an idle loop does not wake up at all.
+ *
+ * Single threaded: everything except quit() must be called from the thread
+ * that runs the loop.
+ */
+class EventLoop {
+public:
+    using TimerCallback = std::function<void()>;
+
+    struct Stats {
+        uint64_t wakeups = 0;       // epoll_wait returns
+        uint64_t watch_events = 0;  // dbus_watch_handle calls
+        uint64_t dispatches = 0;    // messages dispatched
+        uint64_t timer_fires = 0;   // libdbus timeouts and service timers
+    };
+
+    EventLoop();
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    /**
+     * @brief Create the epoll and wakeup descriptors
+     * @return true if successful, false otherwise
+     */
+    bool initialize();
+
+    /**
+     * @brief Drive a connection from this loop
+     *
+     * Attaching a connection that is already attached is a no-op, which
+     * matters because dbus_bus_get() hands out the same shared connection
+     * for the service and RAUC sides.
+     */
+    bool attach(DBusConnection* connection);
+
+    /**
+     * @brief Stop driving a connection and drop its watches and timeouts
+     */
+    void detach(DBusConnection* connection);
+
+    /**
+     * @brief Add a repeating timer, initially disabled
+     * @return Timer id for setTimerEnabled()
+     */
+    int addTimer(int interval_ms, TimerCallback callback);
+
+    /**
+     * @brief Enable or disable a timer; enabling restarts its interval
+     */
+    void setTimerEnabled(int timer_id, bool enabled);
+
+    /**
+     * @brief Run until quit() is called
+     */
+    void run();
+
+    /**
+     * @brief Make run() return; safe to call from other threads and signal handlers
+     */
+    void quit();
+
+    const Stats& stats() const { return stats_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // All libdbus watches registered on one file descriptor (read and write
+    // watches share the socket, and epoll accepts each fd only once)
+    struct FdWatches {
+        std::vector<DBusWatch*> watches;
+        uint32_t events = 0;
+    };
+
+    struct Timer {
+        int interval_ms = 0;
+        bool enabled = false;
+        Clock::time_point deadline;
+        DBusTimeout* timeout = nullptr;  // set for libdbus timeouts
+        TimerCallback callback;          // set for service timers
+    };
+
+    int epoll_fd_;
+    int wakeup_fd_;
+    std::atomic<bool> quit_requested_;
+    std::vector<DBusConnection*> connections_;
+    std::map<int, FdWatches> fd_watches_;
+    std::map<int, std::unique_ptr<Timer>> timers_;
+    int next_timer_id_;
+    Stats stats_;
+
+    void updateFd(int fd);
+    void handleFdEvents(int fd, uint32_t events);
+    int nextTimeoutMs() const;
+    void fireExpiredTimers();
+    void dispatchPending();
+    void wakeup();
+
+    // libdbus hooks
+    static dbus_bool_t addWatch(DBusWatch* watch, void* data);
+    static void removeWatch(DBusWatch* watch, void* data);
+    static void toggleWatch(DBusWatch* watch, void* data);
+    static dbus_bool_t addTimeout(DBusTimeout* timeout, void* data);
+    static void removeTimeout(DBusTimeout* timeout, void* data);
+    static void toggleTimeout(DBusTimeout* timeout, void* data);
+    static void wakeupMain(void* data);
+};
@@ -0,0 +1,162 @@
+#include "install_queue.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+// Start order: running first, then higher priority, then older
+bool startsBefore(const InstallQueue::Job& a, const InstallQueue::Job& b) {
+    if (a.state != b.state) {
+        return a.state == InstallQueue::State::Running;
+    }
+    if (a.priority != b.priority) {
+        return a.priority > b.priority;
+    }
+    return a.id < b.id;
+}
+
+} // namespace
+
+InstallQueue::InstallQueue(const std::string& state_file)
+    : state_file_(state_file) {
+}
+
+size_t InstallQueue::load() {
+    jobs_.clear();
+    if (state_file_.empty()) {
+        return 0;
+    }
+    std::ifstream in(state_file_);
+    std::string line;
+
+    // "next-id <n>", then one "<id>\t<priority>\t<state>\t<hash>\t<bundle>" line per job
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        if (line.compare(0, 8, "next-id ") == 0) {
+            next_id_ = std::max<uint32_t>(next_id_, static_cast<uint32_t>(strtoul(line.c_str() + 8, nullptr, 10)));
+            continue;
+        }
+        Job job;
+        std::string id, priority, state;
+        if (!std::getline(fields, id, '\t') || !std::getline(fields, priority, '\t') ||
+            !std::getline(fields, state, '\t') || !std::getline(fields, job.hash, '\t') ||
+            !std::getline(fields, job.bundle) || job.bundle.empty()) {
+            continue;
+        }
+        job.id = static_cast<uint32_t>(strtoul(id.c_str(), nullptr, 10));
+        job.priority = static_cast<int32_t>(strtol(priority.c_str(), nullptr, 10));
+        next_id_ = std::max(next_id_, job.id + 1);
+        if (job.id == 0 || state != stateName(State::Queued)) {
+            continue;
+        }
+        jobs_.push_back(job);
+    }
+    save();
+    return jobs_.size();
+}
+
+InstallQueue::Added InstallQueue::add(const std::string& bundle, const std::string& hash, int32_t priority) {
+    const std::string& key = hash.empty() ? bundle : hash;
+    for (Job& job : jobs_) {
+        if (job.hash == key) {
+            job.priority = std::max(job.priority, priority);
+            save();
+            return { job.id, true };
+        }
+    }
+
+    Job job;
+    job.id = next_id_++;
+    job.priority = priority;
+    job.bundle = bundle;
+    job.hash = key;
+    jobs_.push_back(job);
+    save();
+    return { job.id, false };
+}
+
+bool InstallQueue::cancel(uint32_t id) {
+    auto it = findJob(id);
+    if (it == jobs_.end() || it->state == State::Running) {
+        return false;
+    }
+    jobs_.erase(it);
+    save();
+    return true;
+}
+
+const InstallQueue::Job* InstallQueue::startNext() {
+    if (jobs_.empty() || running()) {
+        return nullptr;
+    }
+    auto next = std::min_element(jobs_.begin(), jobs_.end(), startsBefore);
+    next->state = State::Running;
+    save();
+    return &*next;
+}
+
+uint32_t InstallQueue::finishRunning() {
+    auto it = std::find_if(jobs_.begin(), jobs_.end(), [](const Job& job) { return job.state == State::Running; });
+    if (it == jobs_.end()) {
+        return 0;
+    }
+    uint32_t id = it->id;
+    jobs_.erase(it);
+    save();
+    return id;
+}
+
+const InstallQueue::Job* InstallQueue::running() const {
+    for (const Job& job : jobs_) {
+        if (job.state == State::Running) {
+            return &job;
+        }
+    }
+    return nullptr;
+}
+
+const InstallQueue::Job* InstallQueue::find(uint32_t id) const {
+    for (const Job& job : jobs_) {
+        if (job.id == id) {
+            return &job;
+        }
+    }
+    return nullptr;
+}
+
+std::vector<InstallQueue::Job> InstallQueue::jobs() const {
+    std::vector<Job> ordered = jobs_;
+    std::sort(ordered.begin(), ordered.end(), startsBefore);
+    return ordered;
+}
+
+const char* InstallQueue::stateName(State state) {
+    return state == State::Running ? "running" : "queued";
+}
+
+std::vector<InstallQueue::Job>::iterator InstallQueue::findJob(uint32_t id) {
+    return std::find_if(jobs_.begin(), jobs_.end(), [id](const Job& job) { return job.id == id; });
+}
+
+void InstallQueue::save() const {
+    if (state_file_.empty()) {
+        return;
+    }
+    std::string temporary = state_file_ + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        out << "next-id " << next_id_ << '\n';
+        for (const Job& job : jobs_) {
+            out << job.id << '\t' << job.priority << '\t' << stateName(job.state) << '\t' << job.hash << '\t'
+                << job.bundle << '\n';
+        }
+        if (!out.flush()) {
+            save_failed_ = true;
+            return;
+        }
+    }
+    save_failed_ = std::rename(temporary.c_str(), state_file_.c_str()) != 0;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Installation jobs waiting for RAUC, kept across broker restarts
+ *
+ * RAUC installs one bundle at a time. Jobs are started by priority (higher
+ * first), in submission order within a priority. A job for a bundle that is
+ * already queued or running (same hash, or same source when no hash was
+ * given) is not added twice: the existing job is returned and takes the
+ * higher of the two priorities.
+ *
+ * Every change is written to the state file (when one is set) through a
+ * temporary file and rename. A job that was running when the broker stopped
+ * is not restored: its result was never seen and RAUC may have finished it.
+ *
+ * Pure bookkeeping; UpdateService starts the jobs and reports the results.
+ */
+class InstallQueue {
+public:
+    enum class State { Queued, Running };
+
+    struct Job {
+        uint32_t id = 0;
+        int32_t priority = 0;
+        State state = State::Queued;
+        std::string bundle;  // path or URL passed to RAUC InstallBundle
+        std::string hash;    // deduplication key, defaults to bundle
+    };
+
+    struct Added {
+        uint32_t id;
+        bool deduplicated;  // an existing job was returned
+    };
+
+    /**
+     * @param state_file Where jobs are persisted; empty keeps them in memory only
+     */
+    explicit InstallQueue(const std::string& state_file = std::string());
+
+    /**
+     * @brief Restore queued jobs from the state file
+     * @return Number of jobs restored
+     */
+    size_t load();
+
+    /**
+     * @brief Queue a bundle, or return the queued/running job for the same hash
+     */
+    Added add(const std::string& bundle, const std::string& hash, int32_t priority);
+
+    /**
+     * @brief Remove a queued job; a running installation cannot be cancelled
+     * @return false if the job is unknown or running
+     */
+    bool cancel(uint32_t id);
+
+    /**
+     * @brief Mark the next job running
+     * @return The job, or nullptr if one is already running or none is queued
+     */
+    const Job* startNext();
+
+    /**
+     * @brief Remove the running job
+     * @return Its id, 0 if none was running
+     */
+    uint32_t finishRunning();
+
+    const Job* running() const;
+    const Job* find(uint32_t id) const;
+
+    /**
+     * @brief All jobs in start order: the running job first, then the queue
+     */
+    std::vector<Job> jobs() const;
+
+    size_t size() const { return jobs_.size(); }
+
+    // The last write of the state file failed (jobs are then only kept in memory)
+    bool saveFailed() const { return save_failed_; }
+
+    static const char* stateName(State state);
+
+private:
+    std::string state_file_;
+    std::vector<Job> jobs_;
+    uint32_t next_id_ = 1;
+    mutable bool save_failed_ = false;
+
+    std::vector<Job>::iterator findJob(uint32_t id);
+    void save() const;
+};
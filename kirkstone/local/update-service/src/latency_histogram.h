@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed-bucket latency histogram for forwarded calls
+ *
+ * Buckets are roughly logarithmic from 100 us to 30 s; the last bucket
+ * collects everything slower than the largest bound.
+ */
+class LatencyHistogram {
+public:
+    static const size_t BUCKETS = 16;
+
+    /**
+     * @brief Upper bounds of the first BUCKETS - 1 buckets in microseconds
+     */
+    static const uint64_t* bucketBounds() {
+        static const uint64_t bounds[BUCKETS - 1] = {
+            100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000,
+            100000, 250000, 500000, 1000000, 5000000, 30000000
+        };
+        return bounds;
+    }
+
+    void record(uint64_t micros, bool failed) {
+        const uint64_t* bounds = bucketBounds();
+        size_t bucket = 0;
+        while (bucket < BUCKETS - 1 && micros > bounds[bucket]) {
+            bucket++;
+        }
+        buckets_[bucket]++;
+        count_++;
+        if (failed) {
+            failures_++;
+        }
+        total_us_ += micros;
+        if (micros > max_us_) {
+            max_us_ = micros;
+        }
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t failures() const { return failures_; }
+    uint64_t totalMicros() const { return total_us_; }
+    uint64_t maxMicros() const { return max_us_; }
+    const std::array<uint64_t, BUCKETS>& buckets() const { return buckets_; }
+
+private:
+    uint64_t count_ = 0;
+    uint64_t failures_ = 0;
+    uint64_t total_us_ = 0;
+    uint64_t max_us_ = 0;
+    std::array<uint64_t, BUCKETS> buckets_ = {};
+};
@@ -0,0 +1,85 @@
+#include "logging.h"
+#include <cstdlib>
+#include <cstring>
+
+DLT_DECLARE_CONTEXT(dlt_context_service)
+DLT_DECLARE_CONTEXT(dlt_context_calls)
+DLT_DECLARE_CONTEXT(dlt_context_signals)
+
+namespace usvc_log {
+
+namespace {
+
+struct Sampler {
+    const char* name;
+    uint32_t every;
+    uint32_t count;
+};
+
+Sampler samplers[] = {
+    { "service", 1, 0 },
+    { "calls", 1, 0 },
+    { "signals", 1, 0 },
+};
+
+Sampler& samplerFor(Subsystem subsystem) {
+    return samplers[static_cast<int>(subsystem)];
+}
+
+} // namespace
+
+void registerContexts() {
+    DLT_REGISTER_CONTEXT(dlt_context_service, "USVC", "Update Service");
+    DLT_REGISTER_CONTEXT(dlt_context_calls, "UCAL", "Update Service forwarded calls");
+    DLT_REGISTER_CONTEXT(dlt_context_signals, "USIG", "Update Service signals and progress");
+    configureSampling(getenv("UPDATE_SERVICE_LOG_SAMPLING"));
+}
+
+void unregisterContexts() {
+    DLT_UNREGISTER_CONTEXT(dlt_context_signals);
+    DLT_UNREGISTER_CONTEXT(dlt_context_calls);
+    DLT_UNREGISTER_CONTEXT(dlt_context_service);
+}
+
+void configureSampling(const char* spec) {
+    while (spec && *spec) {
+        const char* end = strchr(spec, ',');
+        size_t length = end ? static_cast<size_t>(end - spec) : strlen(spec);
+        const char* equals = static_cast<const char*>(memchr(spec, '=', length));
+        if (equals) {
+            size_t name_length = static_cast<size_t>(equals - spec);
+            char* rate_end = nullptr;
+            unsigned long every = strtoul(equals + 1, &rate_end, 10);
+            if (every > 0 && every <= UINT32_MAX && rate_end == spec + length) {
+                for (Sampler& sampler : samplers) {
+                    if (strlen(sampler.name) == name_length && strncmp(sampler.name, spec, name_length) == 0) {
+                        sampler.every = static_cast<uint32_t>(every);
+                        sampler.count = 0;
+                    }
+                }
+            }
+        }
+        spec = end ? end + 1 : nullptr;
+    }
+}
+
+void setSampling(Subsystem subsystem, uint32_t every) {
+    Sampler& sampler = samplerFor(subsystem);
+    sampler.every = every > 0 ? every : 1;
+    sampler.count = 0;
+}
+
+uint32_t sampling(Subsystem subsystem) {
+    return samplerFor(subsystem).every;
+}
+
+bool sample(Subsystem subsystem) {
+    Sampler& sampler = samplerFor(subsystem);
+    bool selected = sampler.count == 0;
+    if (++sampler.count >= sampler.every) {
+        sampler.count = 0;
+    }
+    return selected;
+}
+
+} // namespace usvc_log
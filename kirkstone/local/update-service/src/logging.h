@@ -0,0 +1,75 @@
+#pragma once
+
+#include <dlt/dlt.h>
+#include <cstdint>
+
+/**
+ * @brief DLT logging for the update service
+ *
+ * One DLT context per subsystem, so each can be given its own level with
+ * dlt-control:
+ *   service  USVC  lifecycle, RAUC connection, errors not tied to a call
+ *   calls    UCAL  forwarded method calls and property reads
+ *   signals  USIG  RAUC signals, progress and client subscriptions
+ *
+ * The macros expand to DLT_LOG, which checks the context's level before any
+ * argument is evaluated, and take DLT's typed arguments (DLT_STRING,
+ * DLT_INT, ...) instead of a preformatted std::string:
+ *
+ *   usvc_info(calls, "RAUC call failed: ", DLT_STRING(method));
+ *
+ * The _sampled variants are for lines written once per call or signal. With
+ * UPDATE_SERVICE_LOG_SAMPLING="signals=100,calls=10" only every 100th
+ * (10th) of those lines is written for that subsystem; the default is 1,
+ * every line. Sampling counters are not thread safe: log from the service
+ * thread only.
+ */
+
+DLT_IMPORT_CONTEXT(dlt_context_service)
+DLT_IMPORT_CONTEXT(dlt_context_calls)
+DLT_IMPORT_CONTEXT(dlt_context_signals)
+
+namespace usvc_log {
+
+enum class Subsystem { service, calls, signals };
+
+/**
+ * @brief Register the subsystem contexts and read UPDATE_SERVICE_LOG_SAMPLING
+ */
+void registerContexts();
+void unregisterContexts();
+
+/**
+ * @brief Parse a sampling spec ("signals=100,calls=10"); unknown names and bad rates are ignored
+ */
+void configureSampling(const char* spec);
+
+void setSampling(Subsystem subsystem, uint32_t every);
+uint32_t sampling(Subsystem subsystem);
+
+/**
+ * @brief True for the first and then every Nth call for the subsystem
+ */
+bool sample(Subsystem subsystem);
+
+} // namespace usvc_log
+
+#define usvc_log_at(subsystem, level, text, ...) \
+    DLT_LOG(dlt_context_##subsystem, level, DLT_CSTRING(text), ##__VA_ARGS__)
+
+#define usvc_error(subsystem, text, ...) usvc_log_at(subsystem, DLT_LOG_ERROR, text, ##__VA_ARGS__)
+#define usvc_warn(subsystem, text, ...) usvc_log_at(subsystem, DLT_LOG_WARN, text, ##__VA_ARGS__)
+#define usvc_info(subsystem, text, ...) usvc_log_at(subsystem, DLT_LOG_INFO, text, ##__VA_ARGS__)
+#define usvc_debug(subsystem, text, ...) usvc_log_at(subsystem, DLT_LOG_DEBUG, text, ##__VA_ARGS__)
+
+// The sampling counter only advances for lines the level would let through
+#define usvc_log_sampled(subsystem, level, text, ...)                                              \
+    do {                                                                                            \
+        if (DLT_IS_LOG_LEVEL_ENABLED(dlt_context_##subsystem, level) &&                             \
+            usvc_log::sample(usvc_log::Subsystem::subsystem)) {                                     \
+            usvc_log_at(subsystem, level, text, ##__VA_ARGS__);                                     \
+        }                                                                                           \
+    } while (0)
+
+#define usvc_info_sampled(subsystem, text, ...) usvc_log_sampled(subsystem, DLT_LOG_INFO, text, ##__VA_ARGS__)
+#define usvc_debug_sampled(subsystem, text, ...) usvc_log_sampled(subsystem, DLT_LOG_DEBUG, text, ##__VA_ARGS__)
@@ -0,0 +1,108 @@
+#include "property_cache.h"
+#include "dbus_copy.h"
+
+namespace {
+
+const char* const CACHEABLE_PROPERTIES[] = {
+    "Operation", "LastError", "Progress", "Compatible", "Variant", "BootSlot", nullptr
+};
+
+// Fixed for the boot: RAUC reads them from system.conf and the kernel command line
+const char* const IMMUTABLE_PROPERTIES[] = { "Compatible", "Variant", "BootSlot", nullptr };
+
+bool contains(const char* const* names, const std::string& name) {
+    for (; *names; ++names) {
+        if (name == *names) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+PropertyCache::~PropertyCache() {
+    for (auto& entry : values_) {
+        dbus_message_unref(entry.second);
+    }
+}
+
+DBusMessage* PropertyCache::lookup(const std::string& name) {
+    auto it = values_.find(name);
+    if (it == values_.end()) {
+        misses_++;
+        return nullptr;
+    }
+    hits_++;
+    return it->second;
+}
+
+void PropertyCache::store(const std::string& name, DBusMessage* get_reply) {
+    if (!isCacheable(name) || !dbus_message_has_signature(get_reply, DBUS_TYPE_VARIANT_AS_STRING)) {
+        return;
+    }
+    invalidate(name);
+    values_[name] = dbus_message_ref(get_reply);
+}
+
+bool PropertyCache::storeVariant(const std::string& name, DBusMessageIter* variant) {
+    if (!isCacheable(name) || dbus_message_iter_get_arg_type(variant) != DBUS_TYPE_VARIANT) {
+        return false;
+    }
+
+    // A bare method return is never sent; it only carries the copied value
+    DBusMessage* holder = dbus_message_new(DBUS_MESSAGE_TYPE_METHOD_RETURN);
+    if (!holder) {
+        return false;
+    }
+    DBusMessageIter target;
+    dbus_message_iter_init_append(holder, &target);
+    if (!dbus_copy::copyValue(variant, &target, DBUS_TYPE_VARIANT_AS_STRING)) {
+        dbus_message_unref(holder);
+        return false;
+    }
+
+    invalidate(name);
+    values_[name] = holder;
+    return true;
+}
+
+void PropertyCache::invalidate(const std::string& name) {
+    auto it = values_.find(name);
+    if (it != values_.end()) {
+        dbus_message_unref(it->second);
+        values_.erase(it);
+    }
+}
+
+void PropertyCache::invalidateMutable() {
+    for (auto it = values_.begin(); it != values_.end();) {
+        if (isImmutable(it->first)) {
+            ++it;
+        } else {
+            dbus_message_unref(it->second);
+            it = values_.erase(it);
+        }
+    }
+}
+
+bool PropertyCache::complete() const {
+    for (const char* const* name = CACHEABLE_PROPERTIES; *name; ++name) {
+        if (values_.find(*name) == values_.end()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PropertyCache::isCacheable(const std::string& name) {
+    return contains(CACHEABLE_PROPERTIES, name);
+}
+
+bool PropertyCache::isImmutable(const std::string& name) {
+    return contains(IMMUTABLE_PROPERTIES, name);
+}
+
+const char* const* PropertyCache::names() {
+    return CACHEABLE_PROPERTIES;
+}
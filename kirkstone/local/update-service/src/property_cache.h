@@ -0,0 +1,73 @@
+#pragma once
+
+#include <dbus/dbus.h>
+#include <cstdint>
+#include <map>
+#include <string>
+
+/**
+ * @brief Local copy of RAUC's Installer properties
+ *
+ * Compatible, Variant and BootSlot are fixed for the boot and stay cached
+ * once read. Operation, LastError and Progress are only trustworthy while
+ * RAUC's PropertiesChanged is subscribed: the broker updates them from
+ * those signals and drops them when RAUC restarts or disconnects.
+ *
+ * Each value is kept as a message whose only argument is the property
+ * variant, so a RAUC Properties.Get reply can be stored as is.
+ */
+class PropertyCache {
+public:
+    PropertyCache() = default;
+    ~PropertyCache();
+
+    PropertyCache(const PropertyCache&) = delete;
+    PropertyCache& operator=(const PropertyCache&) = delete;
+
+    /**
+     * @brief Cached value holder for a property, or nullptr (borrowed reference)
+     */
+    DBusMessage* lookup(const std::string& name);
+
+    /**
+     * @brief Keep a Properties.Get reply (single variant argument) as the value
+     */
+    void store(const std::string& name, DBusMessage* get_reply);
+
+    /**
+     * @brief Copy the variant at iter (e.g. from PropertiesChanged) as the value
+     * @return false if the value could not be copied
+     */
+    bool storeVariant(const std::string& name, DBusMessageIter* variant);
+
+    void invalidate(const std::string& name);
+
+    /**
+     * @brief True if every cacheable property has a value (GetAll can be answered locally)
+     */
+    bool complete() const;
+
+    /**
+     * @brief Drop Operation, LastError and Progress (RAUC restarted or went away)
+     */
+    void invalidateMutable();
+
+    /**
+     * @brief True for the RAUC properties the broker serves from this cache
+     */
+    static bool isCacheable(const std::string& name);
+    static bool isImmutable(const std::string& name);
+
+    /**
+     * @brief Names of all cacheable properties, nullptr terminated
+     */
+    static const char* const* names();
+
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+private:
+    std::map<std::string, DBusMessage*> values_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
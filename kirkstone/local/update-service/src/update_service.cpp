@@ -1,10 +1,10 @@
 #include "update_service.h"
-#include <dlt/dlt.h>
+#include "dbus_copy.h"
+#include "logging.h"
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
-#include <unistd.h>
-
-DLT_DECLARE_CONTEXT(dlt_context_service);
+#include <vector>
 
 // D-Bus service constants following freedesktop.org conventions
 static const char* SERVICE_NAME = "org.freedesktop.UpdateService";
@@ -17,25 +17,106 @@ static const char* RAUC_OBJECT_PATH = "/";
 static const char* RAUC_INTERFACE_NAME = "de.pengutronix.rauc.Installer";
 static const char* RAUC_PROPERTIES_INTERFACE = "org.freedesktop.DBus.Properties";
 
+// Event loop timer intervals
+static const int RAUC_RECONNECT_INTERVAL_MS = 5000;
+// Progress is pushed by RAUC's PropertiesChanged; poll only after this long without a change
+static const int PROGRESS_FALLBACK_POLL_MS = 2000;
+static const int PROGRESS_POLL_TIMEOUT_MS = 1000;
+
+// RAUC properties whose changes are forwarded to our clients
+static const char* const FORWARDED_PROPERTIES[] = { "Progress", "Operation", "LastError" };
+
+static bool isForwardedProperty(const char* name) {
+    for (const char* forwarded : FORWARDED_PROPERTIES) {
+        if (strcmp(name, forwarded) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Granularity of coalesced Progress delivery to subscribed clients
+static const int COALESCE_TICK_MS = 50;
+
+// Lets the broker notice a subscribed client leaving the bus
+static std::string clientMatchRule(const std::string& name) {
+    return "type='signal',sender='org.freedesktop.DBus',interface='org.freedesktop.DBus',"
+           "member='NameOwnerChanged',arg0='" + name + "'";
+}
+
+// Reply timeout for forwarded RAUC calls (InstallBundle/InspectBundle may download)
+static const int RAUC_CALL_TIMEOUT_MS = 30000;
+
+// Install job queue state, overridden by UPDATE_SERVICE_QUEUE_FILE (empty: memory only)
+static const char* INSTALL_QUEUE_FILE = "/var/lib/update-service/install-queue";
+
+static std::string installQueueFile() {
+    const char* file = getenv("UPDATE_SERVICE_QUEUE_FILE");
+    return file ? file : INSTALL_QUEUE_FILE;
+}
+
+// Exit after this long without client calls when idle, set by UPDATE_SERVICE_IDLE_EXIT_SEC (0: never).
+// Meant for D-Bus activation: the bus starts the broker again on the next call.
+static int idleExitMs() {
+    const char* seconds = getenv("UPDATE_SERVICE_IDLE_EXIT_SEC");
+    int value = seconds ? atoi(seconds) : 0;
+    return value > 0 ? value * 1000 : 0;
+}
+
+// Progress, Completed and PropertiesChanged go to subscribed clients only; UPDATE_SERVICE_BROADCAST_SIGNALS=1
+// also broadcasts them for listeners that rely on match rules instead of Subscribe.
+static bool broadcastSignals() {
+    const char* value = getenv("UPDATE_SERVICE_BROADCAST_SIGNALS");
+    return value && atoi(value) != 0;
+}
+
+// Job bundles and hashes are stored one per line, tab separated
+static bool isQueueField(const char* value) {
+    return strpbrk(value, "\t\n") == nullptr;
+}
+
 UpdateService::UpdateService()
     : service_connection_(nullptr)
     , rauc_connection_(nullptr)
-    , running_(false)
+    , reconnect_timer_(0)
+    , progress_timer_(0)
+    , coalesce_timer_(0)
+    , idle_timer_(0)
+    , idle_exit_ms_(idleExitMs())
+    , broadcast_signals_(broadcastSignals())
+    , install_queue_(installQueueFile())
+    , job_call_(nullptr)
     , connected_to_rauc_(false)
+    , rauc_wanted_(idle_exit_ms_ == 0)
+    , name_released_(false)
     , installation_active_(false)
-    , last_progress_percentage_(-1) {
+    , install_calls_(0)
+    , last_progress_percentage_(-1)
+    , progress_poll_(nullptr) {
 
-    DLT_REGISTER_CONTEXT(dlt_context_service, "USVC", "Update Service");
-    logInfo("Update Service initializing");
+    usvc_log::registerContexts();
+    usvc_info(service, "Update Service initializing");
 }
 
 UpdateService::~UpdateService() {
     stop();
-    DLT_UNREGISTER_CONTEXT(dlt_context_service);
+    shutdown();
+    usvc_log::unregisterContexts();
 }
 
 bool UpdateService::initialize() {
-    logInfo("Initializing Update Service");
+    usvc_info(service, "Initializing Update Service");
+
+    if (!loop_.initialize()) {
+        usvc_error(service, "Failed to create event loop");
+        return false;
+    }
+    reconnect_timer_ = loop_.addTimer(RAUC_RECONNECT_INTERVAL_MS, [this]() { reconnectToRauc(); });
+    progress_timer_ = loop_.addTimer(PROGRESS_FALLBACK_POLL_MS, [this]() { pollAndForwardProgress(); });
+    coalesce_timer_ = loop_.addTimer(COALESCE_TICK_MS, [this]() { flushCoalescedProgress(); });
+    if (idle_exit_ms_ > 0) {
+        idle_timer_ = loop_.addTimer(idle_exit_ms_, [this]() { exitIfIdle(); });
+    }
 
     // Initialize D-Bus error
     DBusError error;
@@ -44,82 +125,114 @@ bool UpdateService::initialize() {
     // Connect to system bus for our service
     service_connection_ = dbus_bus_get(DBUS_BUS_SYSTEM, &error);
     if (dbus_error_is_set(&error)) {
-        logError("Failed to connect to D-Bus system bus: " + std::string(error.message));
+        usvc_error(service, "Failed to connect to D-Bus system bus: ", DLT_STRING(error.message));
         dbus_error_free(&error);
         return false;
     }
 
-    // Connect to RAUC (non-blocking - will retry in main loop if needed)
-    if (!connectToRauc()) {
-        logInfo("RAUC service not immediately available - will retry during operation");
+    // Register our service first: an activating client's call is delivered once we own the name
+    if (!registerService()) {
+        usvc_error(service, "Failed to register Update Service");
+        return false;
+    }
+
+    // Connect to RAUC (non-blocking - will retry in main loop if needed). With idle exit the
+    // broker was started for a client call, and RAUC is connected when a call first needs it.
+    if (!rauc_wanted_) {
+        usvc_info(service, "Idle exit after ms: ", DLT_INT(idle_exit_ms_), DLT_CSTRING("- connecting to RAUC on demand"));
+    } else if (!connectToRauc()) {
+        usvc_info(service, "RAUC service not immediately available - will retry during operation");
         connected_to_rauc_ = false;
     }
 
-    // Register our service
-    if (!registerService()) {
-        logError("Failed to register Update Service");
-        return false;
+    size_t restored = install_queue_.load();
+    if (install_queue_.saveFailed()) {
+        usvc_warn(service, "Install queue is not persistent, cannot write: ", DLT_STRING(installQueueFile().c_str()));
+    } else if (restored > 0) {
+        usvc_info(service, "Restored queued install jobs: ", DLT_UINT64(restored));
     }
 
-    logInfo("Update Service initialized successfully");
+    usvc_info(service, "Update Service initialized successfully");
     return true;
 }
 
 bool UpdateService::connectToRauc() {
-    logInfo("Connecting to RAUC service");
+    usvc_info(service, "Connecting to RAUC service");
 
     DBusError error;
     dbus_error_init(&error);
 
-    // Get separate connection for RAUC communication
-    rauc_connection_ = dbus_bus_get(DBUS_BUS_SYSTEM, &error);
-    if (dbus_error_is_set(&error)) {
-        logError("Failed to connect to D-Bus for RAUC: " + std::string(error.message));
-        dbus_error_free(&error);
-        return false;
+    // Get separate connection for RAUC communication (kept across retries)
+    if (!rauc_connection_) {
+        rauc_connection_ = dbus_bus_get(DBUS_BUS_SYSTEM, &error);
+        if (dbus_error_is_set(&error)) {
+            usvc_error(service, "Failed to connect to D-Bus for RAUC: ", DLT_STRING(error.message));
+            dbus_error_free(&error);
+            rauc_connection_ = nullptr;
+            return false;
+        }
     }
 
-    // Check if RAUC service is available
+    // Check if RAUC service is available (no error is set when the name simply has no owner)
     if (!dbus_bus_name_has_owner(rauc_connection_, RAUC_SERVICE_NAME, &error)) {
-        logError("RAUC service is not available: " + std::string(error.message));
+        usvc_error(service, "RAUC service is not available: ",
+                   DLT_STRING(dbus_error_is_set(&error) ? error.message : "no owner"));
         dbus_error_free(&error);
         return false;
     }
 
+    // Match rules are sent without an error argument, so libdbus does not wait for the bus to
+    // confirm each one (three round trips on the first call after activation). The bus applies
+    // them before any call we forward to RAUC afterwards, so no resulting signal is missed.
+
     // Add signal filter for RAUC signals - EXACTLY like the working version
     dbus_bus_add_match(rauc_connection_,
         "type='signal',interface='de.pengutronix.rauc.Installer'",
-        &error);
+        nullptr);
 
-    if (dbus_error_is_set(&error)) {
-        logError("Failed to add RAUC signal filter: " + std::string(error.message));
-        dbus_error_free(&error);
-        return false;
-    }
+    usvc_info(service, "Added RAUC signal filter: type='signal',interface='de.pengutronix.rauc.Installer'");
+
+    // Property changes (Progress, Operation, LastError) replace polling the Progress property
+    dbus_bus_add_match(rauc_connection_,
+        "type='signal',sender='de.pengutronix.rauc',path='/',"
+        "interface='org.freedesktop.DBus.Properties',member='PropertiesChanged',"
+        "arg0='de.pengutronix.rauc.Installer'",
+        nullptr);
 
-    logInfo("Added RAUC signal filter: type='signal',interface='de.pengutronix.rauc.Installer'");
+    // A restarted RAUC does not announce its fresh Operation/LastError/Progress
+    dbus_bus_add_match(rauc_connection_,
+        "type='signal',sender='org.freedesktop.DBus',interface='org.freedesktop.DBus',"
+        "member='NameOwnerChanged',arg0='de.pengutronix.rauc'",
+        nullptr);
 
     // Add signal handler
     dbus_connection_add_filter(rauc_connection_, raucSignalHandler, this, nullptr);
-    logInfo("RAUC signal handler registered");
+    usvc_info(service, "RAUC signal handler registered");
 
     connected_to_rauc_ = true;
-    logInfo("Successfully connected to RAUC service");
+    usvc_info(service, "Successfully connected to RAUC service");
     return true;
 }
 
 void UpdateService::disconnectFromRauc() {
     if (rauc_connection_) {
-        dbus_connection_remove_filter(rauc_connection_, raucSignalHandler, this);
+        // dbus_bus_get() shares one connection with the service side; keep it attached then
+        if (rauc_connection_ != service_connection_) {
+            loop_.detach(rauc_connection_);
+        }
+        if (connected_to_rauc_) {
+            dbus_connection_remove_filter(rauc_connection_, raucSignalHandler, this);
+        }
         dbus_connection_unref(rauc_connection_);
         rauc_connection_ = nullptr;
         connected_to_rauc_ = false;
-        logInfo("Disconnected from RAUC service");
+        property_cache_.invalidateMutable();
+        usvc_info(service, "Disconnected from RAUC service");
     }
 }
 
 bool UpdateService::registerService() {
-    logInfo("Registering Update Service D-Bus interface");
+    usvc_info(service, "Registering Update Service D-Bus interface");
 
     DBusError error;
     dbus_error_init(&error);
@@ -130,13 +243,13 @@ bool UpdateService::registerService() {
                                       &error);
 
     if (dbus_error_is_set(&error)) {
-        logError("Failed to request service name: " + std::string(error.message));
+        usvc_error(service, "Failed to request service name: ", DLT_STRING(error.message));
         dbus_error_free(&error);
         return false;
     }
 
     if (result != DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER) {
-        logError("Failed to become primary owner of service name");
+        usvc_error(service, "Failed to become primary owner of service name");
         return false;
     }
 
@@ -152,162 +265,245 @@ bool UpdateService::registerService() {
 
     if (!dbus_connection_register_object_path(service_connection_, OBJECT_PATH,
                                             &vtable, this)) {
-        logError("Failed to register object path");
+        usvc_error(service, "Failed to register object path");
         return false;
     }
 
-    logInfo("Update Service registered successfully");
+    // Drops subscriptions of clients that leave the bus
+    if (!dbus_connection_add_filter(service_connection_, clientSignalHandler, this, nullptr)) {
+        usvc_error(service, "Failed to add client signal filter");
+        return false;
+    }
+
+    usvc_info(service, "Update Service registered successfully");
     return true;
 }
 
 void UpdateService::unregisterService() {
     if (service_connection_) {
+        dbus_connection_remove_filter(service_connection_, clientSignalHandler, this);
         dbus_connection_unregister_object_path(service_connection_, OBJECT_PATH);
         dbus_bus_release_name(service_connection_, SERVICE_NAME, nullptr);
-        logInfo("Update Service unregistered");
+        usvc_info(service, "Update Service unregistered");
     }
 }
 
 void UpdateService::run() {
-    logInfo("Starting Update Service main loop");
-    logInfo("Service connection active: " + std::string(service_connection_ ? "YES" : "NO"));
-    logInfo("RAUC connection active: " + std::string(connected_to_rauc_ ? "YES" : "NO"));
-    running_ = true;
-
-    int loop_count = 0;
-    while (running_) {
-        // Handle D-Bus messages for our service
-        dbus_connection_read_write_dispatch(service_connection_, 100);
-
-        // Handle RAUC signals with more detailed logging
-        if (connected_to_rauc_) {
-            // Process RAUC messages more frequently
-            int rauc_dispatch_count = 0;
-            while (dbus_connection_get_dispatch_status(rauc_connection_) == DBUS_DISPATCH_DATA_REMAINS) {
-                dbus_connection_dispatch(rauc_connection_);
-                rauc_dispatch_count++;
-            }
-
-            // Read new RAUC messages
-            dbus_connection_read_write(rauc_connection_, 10);
-
-            // Log RAUC message processing periodically
-            if (rauc_dispatch_count > 0 && loop_count % 100 == 0) {
-                logInfo("RAUC messages processed: " + std::to_string(rauc_dispatch_count));
-            }
-        } else {
-            // Log connection loss periodically
-            if (loop_count % 500 == 0) { // Every ~5 seconds
-                logError("RAUC connection lost - attempting to reconnect...");
-                if (connectToRauc()) {
-                    logInfo("RAUC connection restored successfully");
-                } else {
-                    logError("Failed to restore RAUC connection");
-                }
-            }
-        }
+    usvc_info(service, "Starting Update Service main loop, service connection: ", DLT_BOOL(service_connection_ != nullptr),
+              DLT_STRING("RAUC connection:"), DLT_BOOL(connected_to_rauc_));
 
-        // Poll Progress property if installation is active (every 100ms = every 10 loops)
-        if (connected_to_rauc_ && installation_active_ && loop_count % 10 == 0) {
-            pollAndForwardProgress();
-        }
+    if (!loop_.attach(service_connection_)) {
+        usvc_error(service, "Failed to attach service connection to event loop");
+        shutdown();
+        return;
+    }
+    if (connected_to_rauc_) {
+        loop_.attach(rauc_connection_);
+    }
+    loop_.setTimerEnabled(reconnect_timer_, rauc_wanted_ && !connected_to_rauc_);
+    loop_.setTimerEnabled(progress_timer_, connected_to_rauc_ && installation_active_);
+    if (idle_exit_ms_ > 0) {
+        loop_.setTimerEnabled(idle_timer_, true);
+    }
+    startNextJob();
 
-        // Periodic status logging (every ~10 seconds for debugging)
-        if (loop_count % 1000 == 0) {
-            logInfo("=== Update Service Status ===");
-            logInfo("Service running: " + std::string(running_ ? "YES" : "NO"));
-            logInfo("Service connection: " + std::string(service_connection_ ? "ACTIVE" : "INACTIVE"));
-            logInfo("RAUC connection: " + std::string(connected_to_rauc_ ? "ACTIVE" : "INACTIVE"));
-            logInfo("Installation active: " + std::string(installation_active_ ? "YES" : "NO"));
-            logInfo("Loop count: " + std::to_string(loop_count));
-            logInfo("=== WAITING FOR D-BUS MESSAGES ===");
-        }
+    // Blocks in epoll_wait until a message arrives, a timer is due or stop() is called
+    loop_.run();
 
-        // Small sleep to prevent busy waiting
-        usleep(10000); // 10ms
-        loop_count++;
-    }
+    const EventLoop::Stats& stats = loop_.stats();
+    usvc_info(service, "Event loop stats: wakeups=", DLT_UINT64(stats.wakeups),
+              DLT_CSTRING("watch_events="), DLT_UINT64(stats.watch_events),
+              DLT_CSTRING("dispatches="), DLT_UINT64(stats.dispatches),
+              DLT_CSTRING("timer_fires="), DLT_UINT64(stats.timer_fires));
+    usvc_info(service, "Property cache: hits=", DLT_UINT64(property_cache_.hits()),
+              DLT_CSTRING("misses="), DLT_UINT64(property_cache_.misses()));
 
-    logInfo("Update Service main loop stopped");
+    shutdown();
+    usvc_info(service, "Update Service main loop stopped");
 }
 
 void UpdateService::stop() {
-    logInfo("Stopping Update Service");
-    running_ = false;
+    // Only a flag and an eventfd write: this runs from the signal handler in main.cpp
+    loop_.quit();
+}
 
+void UpdateService::shutdown() {
+    if (!service_connection_ && !rauc_connection_) {
+        return;
+    }
+    usvc_info(service, "Stopping Update Service");
+
+    loop_.setTimerEnabled(reconnect_timer_, false);
+    loop_.setTimerEnabled(progress_timer_, false);
+    loop_.setTimerEnabled(coalesce_timer_, false);
+    if (idle_exit_ms_ > 0) {
+        loop_.setTimerEnabled(idle_timer_, false);
+    }
+    cancelProgressPoll();
+    cancelJobCall();
+    cancelPendingForwards();
     disconnectFromRauc();
     unregisterService();
 
     if (service_connection_) {
+        loop_.detach(service_connection_);
         dbus_connection_unref(service_connection_);
         service_connection_ = nullptr;
     }
 }
 
+void UpdateService::reconnectToRauc() {
+    usvc_error(service, "RAUC connection lost - attempting to reconnect...");
+    if (connectToRauc()) {
+        usvc_info(service, "RAUC connection restored successfully");
+        loop_.attach(rauc_connection_);
+        loop_.setTimerEnabled(reconnect_timer_, false);
+        loop_.setTimerEnabled(progress_timer_, installation_active_);
+        startNextJob();
+    } else {
+        usvc_error(service, "Failed to restore RAUC connection");
+    }
+}
+
+bool UpdateService::requireRauc() {
+    if (connected_to_rauc_) {
+        return true;
+    }
+    if (rauc_wanted_) {
+        return false;  // not available, the reconnect timer is retrying
+    }
+    rauc_wanted_ = true;
+    if (!connectToRauc()) {
+        usvc_error(service, "RAUC service not available on first use - will retry");
+        loop_.setTimerEnabled(reconnect_timer_, true);
+        return false;
+    }
+    loop_.attach(rauc_connection_);
+    loop_.setTimerEnabled(progress_timer_, installation_active_);
+    return true;
+}
+
+bool UpdateService::isIdle() const {
+    return clients_.size() == 0 && in_flight_.empty() && install_queue_.size() == 0 && !installation_active_ &&
+           !job_call_;
+}
+
+void UpdateService::exitIfIdle() {
+    // Checked again one interval later
+    if (!isIdle()) {
+        return;
+    }
+    if (!name_released_) {
+        // From here on the bus activates a new instance for new calls. Calls it routed to us
+        // before the release are queued on the connection by now: they are answered with
+        // Error.Exiting (see handleMethodCall), so nothing starts here that the new instance,
+        // which loads the same install queue, could start again.
+        dbus_bus_release_name(service_connection_, SERVICE_NAME, nullptr);
+        name_released_ = true;
+        usvc_info(service, "Idle for ms: ", DLT_INT(idle_exit_ms_), DLT_CSTRING("- released the service name"));
+        while (dbus_connection_dispatch(service_connection_) == DBUS_DISPATCH_DATA_REMAINS) {
+        }
+    }
+    usvc_info(service, "Exiting while idle");
+    loop_.quit();
+}
+
 DBusHandlerResult UpdateService::messageHandler(DBusConnection* connection,
                                                DBusMessage* message,
                                                void* user_data) {
     UpdateService* service = static_cast<UpdateService*>(user_data);
-    service->logInfo("=== MESSAGE HANDLER CALLED ===");
     return service->handleMethodCall(message);
 }
 
+// Dispatch tables, constant-initialized: nothing is built at start-up
+const UpdateService::Handler UpdateService::METHOD_HANDLERS[] = {
+    { "Install", &UpdateService::handleInstall },
+    { "InstallBundle", &UpdateService::handleInstallBundle },
+    { "Info", &UpdateService::handleInfo },
+    { "InspectBundle", &UpdateService::handleInspectBundle },
+    { "Mark", &UpdateService::handleMark },
+    { "GetSlotStatus", &UpdateService::handleGetSlotStatus },
+    { "GetArtifactStatus", &UpdateService::handleGetArtifactStatus },
+    { "GetPrimary", &UpdateService::handleGetPrimary },
+    { "Subscribe", &UpdateService::handleSubscribe },
+    { "Unsubscribe", &UpdateService::handleUnsubscribe },
+    { "QueueInstall", &UpdateService::handleQueueInstall },
+    { "CancelJob", &UpdateService::handleCancelJob },
+    { "GetQueue", &UpdateService::handleGetQueue },
+    { nullptr, nullptr },
+};
+
+const UpdateService::Handler UpdateService::PROPERTY_HANDLERS[] = {
+    { "Operation", &UpdateService::handleGetOperation },
+    { "LastError", &UpdateService::handleGetLastError },
+    { "Progress", &UpdateService::handleGetProgress },
+    { "Compatible", &UpdateService::handleGetCompatible },
+    { "Variant", &UpdateService::handleGetVariant },
+    { "BootSlot", &UpdateService::handleGetBootSlot },
+    { "CallLatency", &UpdateService::handleGetCallLatency },
+    { "LatencyBuckets", &UpdateService::handleGetLatencyBuckets },
+    { "PendingCalls", &UpdateService::handleGetPendingCalls },
+    { "SignalCounters", &UpdateService::handleGetSignalCounters },
+    { nullptr, nullptr },
+};
+
+const UpdateService::Handler* UpdateService::findHandler(const Handler* table, const char* name) {
+    if (!name) {
+        return nullptr;
+    }
+    for (const Handler* handler = table; handler->name; ++handler) {
+        if (strcmp(handler->name, name) == 0) {
+            return handler;
+        }
+    }
+    return nullptr;
+}
+
 DBusHandlerResult UpdateService::handleMethodCall(DBusMessage* message) {
     const char* interface = dbus_message_get_interface(message);
     const char* member = dbus_message_get_member(message);
-    const char* path = dbus_message_get_path(message);
     const char* sender = dbus_message_get_sender(message);
 
-    logInfo("=== HANDLE METHOD CALL ENTERED ===");
-    logInfo("Interface: " + std::string(interface ? interface : "null"));
-    logInfo("Member: " + std::string(member ? member : "null"));
-    logInfo("Path: " + std::string(path ? path : "null"));
-    logInfo("Sender: " + std::string(sender ? sender : "null"));
+    usvc_debug_sampled(calls, "Method call: ", DLT_STRING(interface ? interface : "null"),
+                       DLT_STRING(member ? member : "null"), DLT_CSTRING("from"), DLT_STRING(sender ? sender : "null"));
+
+    // After the name is released only in-flight work is finished; the caller retries and
+    // reaches the next instance
+    if (name_released_ && interface &&
+        (strcmp(interface, INTERFACE_NAME) == 0 || strcmp(interface, "org.freedesktop.DBus.Properties") == 0)) {
+        sendReply(createErrorReply(message, "org.freedesktop.UpdateService.Error.Exiting",
+                                   "Service is exiting, retry the call"));
+        return DBUS_HANDLER_RESULT_HANDLED;
+    }
+
+    // Any client call restarts the idle interval
+    if (idle_exit_ms_ > 0) {
+        loop_.setTimerEnabled(idle_timer_, true);
+    }
 
     // Handle our interface methods
     if (interface && strcmp(interface, INTERFACE_NAME) == 0) {
-        DBusMessage* reply = nullptr;
-
-        if (strcmp(member, "Install") == 0) {
-            reply = handleInstall(message);
-        } else if (strcmp(member, "InstallBundle") == 0) {
-            reply = handleInstallBundle(message);
-        } else if (strcmp(member, "Info") == 0) {
-            reply = handleInfo(message);
-        } else if (strcmp(member, "InspectBundle") == 0) {
-            reply = handleInspectBundle(message);
-        } else if (strcmp(member, "Mark") == 0) {
-            reply = handleMark(message);
-        } else if (strcmp(member, "GetSlotStatus") == 0) {
-            reply = handleGetSlotStatus(message);
-        } else if (strcmp(member, "GetArtifactStatus") == 0) {
-            reply = handleGetArtifactStatus(message);
-        } else if (strcmp(member, "GetPrimary") == 0) {
-            reply = handleGetPrimary(message);
+        const Handler* handler = findHandler(METHOD_HANDLERS, member);
+        if (!handler) {
+            usvc_error(calls, "Unknown method: ", DLT_STRING(member ? member : "unknown"));
+            return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
         }
+        DBusMessage* reply = (this->*handler->handle)(message);
 
+        // Forwarded calls return nullptr here: their reply is sent when RAUC answers
         if (reply) {
-            dbus_connection_send(service_connection_, reply, nullptr);
-            dbus_message_unref(reply);
-            logDebug("Reply sent for method: " + std::string(member ? member : "unknown"));
-            return DBUS_HANDLER_RESULT_HANDLED;
-        } else {
-            logError("Failed to create reply for method: " + std::string(member ? member : "unknown"));
+            sendReply(reply);
         }
+        return DBUS_HANDLER_RESULT_HANDLED;
     }
 
     // Handle properties interface
     if (interface && strcmp(interface, "org.freedesktop.DBus.Properties") == 0) {
-        logInfo("=== PROCESSING PROPERTIES INTERFACE ===");
         DBusMessage* reply = handlePropertyCall(message);
         if (reply) {
-            dbus_connection_send(service_connection_, reply, nullptr);
-            dbus_message_unref(reply);
-            logInfo("=== PROPERTIES REPLY SENT ===");
-            return DBUS_HANDLER_RESULT_HANDLED;
-        } else {
-            logError("=== PROPERTIES CALL RETURNED NULL ===");
+            sendReply(reply);
         }
+        return DBUS_HANDLER_RESULT_HANDLED;
     }
 
     return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
@@ -336,21 +532,14 @@ DBusMessage* UpdateService::handlePropertyCall(DBusMessage* message) {
         dbus_message_iter_get_basic(&iter, &property_name);
 
         // Handle our properties
-        if (strcmp(interface_name, INTERFACE_NAME) == 0) {
-            if (strcmp(property_name, "Operation") == 0) {
-                return handleGetOperation(message);
-            } else if (strcmp(property_name, "LastError") == 0) {
-                return handleGetLastError(message);
-            } else if (strcmp(property_name, "Progress") == 0) {
-                return handleGetProgress(message);
-            } else if (strcmp(property_name, "Compatible") == 0) {
-                return handleGetCompatible(message);
-            } else if (strcmp(property_name, "Variant") == 0) {
-                return handleGetVariant(message);
-            } else if (strcmp(property_name, "BootSlot") == 0) {
-                return handleGetBootSlot(message);
-            }
+        const Handler* handler = strcmp(interface_name, INTERFACE_NAME) == 0
+            ? findHandler(PROPERTY_HANDLERS, property_name)
+            : nullptr;
+        if (handler) {
+            return (this->*handler->handle)(message);
         }
+    } else if (strcmp(member, "GetAll") == 0) {
+        return handleGetAll(message);
     }
 
     return createErrorReply(message, "org.freedesktop.DBus.Error.UnknownProperty", "Unknown property");
@@ -361,16 +550,41 @@ DBusHandlerResult UpdateService::raucSignalHandler(DBusConnection* connection,
                                                   void* user_data) {
     UpdateService* service = static_cast<UpdateService*>(user_data);
 
-    if (dbus_message_get_type(message) == DBUS_MESSAGE_TYPE_SIGNAL) {
-        const char* interface = dbus_message_get_interface(message);
-        const char* member = dbus_message_get_member(message);
-        const char* sender = dbus_message_get_sender(message);
+    if (dbus_message_get_type(message) != DBUS_MESSAGE_TYPE_SIGNAL) {
+        return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    }
+
+    const char* member = dbus_message_get_member(message);
+    usvc_debug_sampled(signals, "RAUC signal received: ", DLT_STRING(member ? member : "null"));
 
-        service->logInfo("=== RAUC SIGNAL RECEIVED ===");
-        service->logInfo("Interface: " + std::string(interface ? interface : "null"));
-        service->logInfo("Member: " + std::string(member ? member : "null"));
-        service->logInfo("Sender: " + std::string(sender ? sender : "null"));
+    if (dbus_message_is_signal(message, RAUC_PROPERTIES_INTERFACE, "PropertiesChanged")) {
+        service->signal_counters_.received++;
+        service->forwardRaucPropertiesChanged(message);
+        return DBUS_HANDLER_RESULT_HANDLED;
+    }
+
+    if (dbus_message_is_signal(message, DBUS_INTERFACE_DBUS, "NameOwnerChanged")) {
+        const char* name = nullptr;
+        if (dbus_message_get_args(message, nullptr, DBUS_TYPE_STRING, &name, DBUS_TYPE_INVALID) &&
+            strcmp(name, RAUC_SERVICE_NAME) == 0) {
+            usvc_info(signals, "RAUC owner changed - dropping cached Operation/LastError/Progress");
+            service->property_cache_.invalidateMutable();
+            // The installation RAUC was running is gone with it, queued or started by a direct Install
+            if (service->installation_active_ && !service->job_call_) {
+                service->setInstallationActive(false);
+                if (service->install_queue_.running()) {
+                    service->finishRunningJob(false, "RAUC restarted during the installation");
+                } else {
+                    service->startNextJob();
+                }
+            }
+        }
+        // Client name changes are handled by clientSignalHandler()
+        return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+    }
 
+    if (dbus_message_has_interface(message, RAUC_INTERFACE_NAME)) {
+        service->signal_counters_.received++;
         service->forwardRaucSignal(message);
         return DBUS_HANDLER_RESULT_HANDLED;
     }
@@ -378,37 +592,52 @@ DBusHandlerResult UpdateService::raucSignalHandler(DBusConnection* connection,
     return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
 }
 
+DBusHandlerResult UpdateService::clientSignalHandler(DBusConnection* connection,
+                                                    DBusMessage* message,
+                                                    void* user_data) {
+    UpdateService* service = static_cast<UpdateService*>(user_data);
+
+    // A subscribed client left the bus: NameOwnerChanged(name, old_owner, "")
+    const char* name = nullptr;
+    const char* old_owner = nullptr;
+    const char* new_owner = nullptr;
+    if (dbus_message_is_signal(message, DBUS_INTERFACE_DBUS, "NameOwnerChanged") &&
+        dbus_message_get_args(message, nullptr, DBUS_TYPE_STRING, &name, DBUS_TYPE_STRING, &old_owner,
+                              DBUS_TYPE_STRING, &new_owner, DBUS_TYPE_INVALID) &&
+        new_owner[0] == '\0' && service->clients_.unsubscribe(name)) {
+        usvc_info(signals, "Subscribed client left the bus: ", DLT_STRING(name));
+        dbus_bus_remove_match(service->service_connection_, clientMatchRule(name).c_str(), nullptr);
+    }
+    return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+}
+
 void UpdateService::forwardRaucSignal(DBusMessage* message) {
     const char* interface = dbus_message_get_interface(message);
     const char* member = dbus_message_get_member(message);
 
-    logInfo("=== FORWARDING RAUC SIGNAL ===");
-    logInfo("Original interface: " + std::string(interface ? interface : "null"));
-    logInfo("Original member: " + std::string(member ? member : "null"));
-
     // Check if this is a RAUC signal
     if (!interface || strcmp(interface, "de.pengutronix.rauc.Installer") != 0) {
-        logInfo("Not a RAUC Installer signal, ignoring: " + std::string(interface ? interface : "unknown"));
+        usvc_debug(signals, "Not a RAUC Installer signal, ignoring: ", DLT_STRING(interface ? interface : "unknown"));
         return;
     }
 
-    logInfo("Processing RAUC signal: " + std::string(member));
-
     // Create new signal with our interface name and updated member name
     DBusMessage* signal = nullptr;
 
     if (strcmp(member, "Completed") == 0) {
         signal = dbus_message_new_signal(OBJECT_PATH, INTERFACE_NAME, "Completed");
-        logInfo("Creating Completed signal for UPDATE-AGENT");
     } else if (strcmp(member, "Progress") == 0) {
         signal = dbus_message_new_signal(OBJECT_PATH, INTERFACE_NAME, "Progress");
-        logInfo("Creating Progress signal for UPDATE-AGENT");
     } else {
-        logInfo("Unknown RAUC signal member, not forwarding: " + std::string(member));
+        usvc_debug(signals, "Unknown RAUC signal member, not forwarding: ", DLT_STRING(member));
         return;
     }
 
     if (signal) {
+        int forwarded_percentage = -1;
+        bool completed_success = false;
+        const char* completed_message = nullptr;
+
         // Copy and convert arguments from original message - EXACTLY like the working version
         DBusMessageIter src_iter, dst_iter;
         if (dbus_message_iter_init(message, &src_iter)) {
@@ -417,13 +646,9 @@ void UpdateService::forwardRaucSignal(DBusMessage* message) {
             if (strcmp(member, "Completed") == 0) {
                 // RAUC Completed: (bs) -> Our Completed: (bs) - EXACTLY like working version
                 bool success = false;
-                std::string message_text;
+                const char* message_text = nullptr;
 
-                // Debug: Log the actual argument type we received
                 int arg_type = dbus_message_iter_get_arg_type(&src_iter);
-                logInfo("Completed signal - Received argument type: " + std::to_string(arg_type));
-                logInfo("Completed signal - DBUS_TYPE_BOOLEAN is: " + std::to_string(DBUS_TYPE_BOOLEAN));
-                logInfo("Completed signal - DBUS_TYPE_INT32 is: " + std::to_string(DBUS_TYPE_INT32));
 
                 // Parse success argument - handle both boolean and int32 types
                 if (arg_type == DBUS_TYPE_BOOLEAN) {
@@ -431,7 +656,6 @@ void UpdateService::forwardRaucSignal(DBusMessage* message) {
                     dbus_message_iter_get_basic(&src_iter, &result);
                     success = result;
                     dbus_message_iter_append_basic(&dst_iter, DBUS_TYPE_BOOLEAN, &result);
-                    logInfo("Completed signal - success (boolean): " + std::string(success ? "true" : "false"));
                 } else if (arg_type == DBUS_TYPE_INT32) {
                     // RAUC sometimes sends int32 where 0 = success, non-zero = failure
                     dbus_int32_t result;
@@ -439,9 +663,9 @@ void UpdateService::forwardRaucSignal(DBusMessage* message) {
                     success = (result == 0);  // 0 means success in RAUC
                     dbus_bool_t bool_result = success;
                     dbus_message_iter_append_basic(&dst_iter, DBUS_TYPE_BOOLEAN, &bool_result);
-                    logInfo("Completed signal - success (int32->boolean): " + std::string(success ? "true" : "false") + " (code: " + std::to_string(result) + ")");
+                    usvc_debug(signals, "Completed signal - int32 result code: ", DLT_INT32(result));
                 } else {
-                    logError("Completed signal: Expected boolean or int32 argument, got type: " + std::to_string(arg_type));
+                    usvc_error(signals, "Completed signal: Expected boolean or int32 argument, got type: ", DLT_INT(arg_type));
                     dbus_message_unref(signal);
                     return;
                 }
@@ -449,182 +673,386 @@ void UpdateService::forwardRaucSignal(DBusMessage* message) {
                 // Parse message string - handle optional message
                 if (dbus_message_iter_next(&src_iter)) {
                     if (dbus_message_iter_get_arg_type(&src_iter) == DBUS_TYPE_STRING) {
-                        const char* msg;
-                        dbus_message_iter_get_basic(&src_iter, &msg);
-                        message_text = msg ? msg : "";
-                        dbus_message_iter_append_basic(&dst_iter, DBUS_TYPE_STRING, &msg);
-                        logInfo("Completed signal - message: " + message_text);
+                        dbus_message_iter_get_basic(&src_iter, &message_text);
+                        dbus_message_iter_append_basic(&dst_iter, DBUS_TYPE_STRING, &message_text);
                     } else {
-                        logError("Completed signal: Expected string argument, got different type");
+                        usvc_error(signals, "Completed signal: Expected string argument, got different type");
                         dbus_message_unref(signal);
                         return;
                     }
                 } else {
                     // No message provided - use default
                     message_text = success ? "Installation completed" : "Installation failed";
-                    const char* default_msg = message_text.c_str();
-                    dbus_message_iter_append_basic(&dst_iter, DBUS_TYPE_STRING, &default_msg);
-                    logInfo("Completed signal - no message provided, using default: " + message_text);
+                    dbus_message_iter_append_basic(&dst_iter, DBUS_TYPE_STRING, &message_text);
                 }
 
-                logInfo("Completed signal parsed successfully: success=" + std::string(success ? "true" : "false") + ", message='" + message_text + "'");
+                usvc_info(signals, "Installation completed: success=", DLT_BOOL(success),
+                          DLT_CSTRING("message:"), DLT_STRING(message_text));
 
-                // Mark installation as completed - stop Progress polling
-                installation_active_ = false;
-                last_progress_percentage_ = -1;
-                logInfo("Installation completed - Progress polling stopped");
+                // Mark installation as completed - disarm the Progress fallback poll
+                setInstallationActive(false);
+                completed_success = success;
+                completed_message = message_text;
 
             } else if (strcmp(member, "Progress") == 0) {
                 // RAUC Progress: (i) -> Our Progress: (i) - EXACTLY like working version
-                int arg_type = dbus_message_iter_get_arg_type(&src_iter);
-                logInfo("Progress signal - Received argument type: " + std::to_string(arg_type));
-                logInfo("Progress signal - DBUS_TYPE_INT32 is: " + std::to_string(DBUS_TYPE_INT32));
-
                 if (dbus_message_iter_get_arg_type(&src_iter) == DBUS_TYPE_INT32) {
                     dbus_int32_t percentage;
                     dbus_message_iter_get_basic(&src_iter, &percentage);
                     dbus_message_iter_append_basic(&dst_iter, DBUS_TYPE_INT32, &percentage);
-
-                    logInfo("Progress signal - percentage: " + std::to_string(percentage));
+                    forwarded_percentage = percentage;
                 } else {
-                    logError("Progress signal: Expected integer argument, got different type");
+                    usvc_error(signals, "Progress signal: Expected integer argument, got different type");
                     dbus_message_unref(signal);
                     return;
                 }
             }
         } else {
-            logError("Failed to get signal arguments");
+            usvc_error(signals, "Failed to get signal arguments");
             dbus_message_unref(signal);
             return;
         }
 
-        // Send the signal
-        dbus_bool_t sent = dbus_connection_send(service_connection_, signal, nullptr);
+        // Unicast to subscribed clients, broadcast only for match-rule listeners (UPDATE_SERVICE_BROADCAST_SIGNALS=1)
+        dbus_bool_t sent = TRUE;
+        if (broadcast_signals_) {
+            sent = dbus_connection_send(service_connection_, signal, nullptr);
+            signal_counters_.broadcast++;
+        }
+        if (strcmp(member, "Completed") == 0) {
+            for (const std::string& client : clients_.completedTargets()) {
+                sendUnicast(signal, client);
+            }
+            loop_.setTimerEnabled(coalesce_timer_, false);
+        } else if (forwarded_percentage >= 0) {
+            sendProgressToClients(forwarded_percentage);
+        }
         dbus_message_unref(signal);
 
         if (sent) {
-            logInfo("Signal successfully forwarded to update-agent: " + std::string(member));
+            usvc_debug_sampled(signals, "Signal forwarded: ", DLT_STRING(member), DLT_INT(forwarded_percentage));
         } else {
-            logError("Failed to send signal to update-agent: " + std::string(member));
+            usvc_error(signals, "Failed to send signal to update-agent: ", DLT_STRING(member));
+        }
+
+        // A queued job RAUC accepted has finished; completion of a direct Install only frees the queue
+        if (completed_message) {
+            if (install_queue_.running() && !job_call_) {
+                finishRunningJob(completed_success, completed_message);
+            } else {
+                startNextJob();
+            }
         }
     } else {
-        logError("Failed to create signal for forwarding: " + std::string(member ? member : "unknown"));
+        usvc_error(signals, "Failed to create signal for forwarding: ", DLT_STRING(member));
     }
 }
 
 // Method implementations - forward to RAUC with original method names
 DBusMessage* UpdateService::handleInstall(DBusMessage* message) {
-    logInfo("Install called - forwarding to RAUC Install");
+    usvc_info(calls, "Install called - forwarding to RAUC Install");
 
-    // Mark installation as active for Progress polling
-    installation_active_ = true;
-    last_progress_percentage_ = -1;
-    logInfo("Installation started - Progress polling activated");
-
-    return forwardToRauc("Install", message);
+    // Marks the installation active; Progress is polled only if RAUC stops reporting changes
+    return forwardToRauc("Install", message, true);
 }
 
 DBusMessage* UpdateService::handleInstallBundle(DBusMessage* message) {
-    logInfo("InstallBundle called - forwarding to RAUC InstallBundle");
-    return forwardToRauc("InstallBundle", message);
+    usvc_info(calls, "InstallBundle called - forwarding to RAUC InstallBundle");
+    return forwardToRauc("InstallBundle", message, true);
 }
 
 DBusMessage* UpdateService::handleInfo(DBusMessage* message) {
-    logInfo("Info called - forwarding to RAUC Info");
+    usvc_info(calls, "Info called - forwarding to RAUC Info");
     return forwardToRauc("Info", message);
 }
 
 DBusMessage* UpdateService::handleInspectBundle(DBusMessage* message) {
-    logInfo("InspectBundle called - forwarding to RAUC InspectBundle");
+    usvc_info(calls, "InspectBundle called - forwarding to RAUC InspectBundle");
     return forwardToRauc("InspectBundle", message);
 }
 
 DBusMessage* UpdateService::handleMark(DBusMessage* message) {
-    logInfo("Mark called - forwarding to RAUC Mark");
+    usvc_info(calls, "Mark called - forwarding to RAUC Mark");
     return forwardToRauc("Mark", message);
 }
 
 DBusMessage* UpdateService::handleGetSlotStatus(DBusMessage* message) {
-    logInfo("GetSlotStatus called - forwarding to RAUC GetSlotStatus");
+    usvc_info(calls, "GetSlotStatus called - forwarding to RAUC GetSlotStatus");
     return forwardToRauc("GetSlotStatus", message);
 }
 
 DBusMessage* UpdateService::handleGetArtifactStatus(DBusMessage* message) {
-    logInfo("GetArtifactStatus called - forwarding to RAUC GetArtifactStatus");
+    usvc_info(calls, "GetArtifactStatus called - forwarding to RAUC GetArtifactStatus");
     return forwardToRauc("GetArtifactStatus", message);
 }
 
 DBusMessage* UpdateService::handleGetPrimary(DBusMessage* message) {
-    logInfo("GetPrimary called - forwarding to RAUC GetPrimary");
+    usvc_info(calls, "GetPrimary called - forwarding to RAUC GetPrimary");
     return forwardToRauc("GetPrimary", message);
 }
 
 // Property implementations - forward to RAUC properties
 DBusMessage* UpdateService::handleGetOperation(DBusMessage* message) {
-    logDebug("Getting Operation property");
-    DBusMessage* reply = getRaucProperty("Operation", message);
-    if (!reply) {
-        logError("Failed to get Operation property from RAUC");
-        return createErrorReply(message, "org.freedesktop.UpdateService.Error", "Failed to get Operation property");
-    }
-    return reply;
+    usvc_debug_sampled(calls, "Getting Operation property");
+    return getRaucProperty("Operation", message);
 }
 
 DBusMessage* UpdateService::handleGetLastError(DBusMessage* message) {
-    logDebug("Getting LastError property");
-    DBusMessage* reply = getRaucProperty("LastError", message);
+    usvc_debug_sampled(calls, "Getting LastError property");
+    return getRaucProperty("LastError", message);
+}
+
+DBusMessage* UpdateService::handleGetProgress(DBusMessage* message) {
+    usvc_debug_sampled(calls, "Getting Progress property");
+    return getRaucProperty("Progress", message);
+}
+
+DBusMessage* UpdateService::handleGetCompatible(DBusMessage* message) {
+    usvc_debug_sampled(calls, "Getting Compatible property");
+    return getRaucProperty("Compatible", message);
+}
+
+DBusMessage* UpdateService::handleGetVariant(DBusMessage* message) {
+    usvc_debug_sampled(calls, "Getting Variant property");
+    return getRaucProperty("Variant", message);
+}
+
+DBusMessage* UpdateService::handleGetBootSlot(DBusMessage* message) {
+    usvc_debug_sampled(calls, "Getting BootSlot property");
+    return getRaucProperty("BootSlot", message);
+}
+
+DBusMessage* UpdateService::handleGetCallLatency(DBusMessage* message) {
+    usvc_debug_sampled(calls, "Getting CallLatency property");
+
+    DBusMessage* reply = dbus_message_new_method_return(message);
     if (!reply) {
-        logError("Failed to get LastError property from RAUC");
-        return createErrorReply(message, "org.freedesktop.UpdateService.Error", "Failed to get LastError property");
+        return nullptr;
     }
+
+    DBusMessageIter iter, variant_iter;
+    dbus_message_iter_init_append(reply, &iter);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_VARIANT, "a{s(ttttat)}", &variant_iter);
+    appendCallLatency(&variant_iter);
+    dbus_message_iter_close_container(&iter, &variant_iter);
     return reply;
 }
 
-DBusMessage* UpdateService::handleGetProgress(DBusMessage* message) {
-    logDebug("Getting Progress property");
-    DBusMessage* reply = getRaucProperty("Progress", message);
+DBusMessage* UpdateService::handleGetLatencyBuckets(DBusMessage* message) {
+    usvc_debug_sampled(calls, "Getting LatencyBuckets property");
+
+    DBusMessage* reply = dbus_message_new_method_return(message);
     if (!reply) {
-        logError("Failed to get Progress property from RAUC");
-        return createErrorReply(message, "org.freedesktop.UpdateService.Error", "Failed to get Progress property");
+        return nullptr;
     }
+
+    DBusMessageIter iter, variant_iter;
+    dbus_message_iter_init_append(reply, &iter);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_VARIANT, "at", &variant_iter);
+    appendLatencyBuckets(&variant_iter);
+    dbus_message_iter_close_container(&iter, &variant_iter);
     return reply;
 }
 
-DBusMessage* UpdateService::handleGetCompatible(DBusMessage* message) {
-    logDebug("Getting Compatible property");
-    DBusMessage* reply = getRaucProperty("Compatible", message);
+DBusMessage* UpdateService::handleGetPendingCalls(DBusMessage* message) {
+    usvc_debug_sampled(calls, "Getting PendingCalls property");
+
+    DBusMessage* reply = dbus_message_new_method_return(message);
     if (!reply) {
-        logError("Failed to get Compatible property from RAUC");
-        return createErrorReply(message, "org.freedesktop.UpdateService.Error", "Failed to get Compatible property");
+        return nullptr;
     }
+
+    DBusMessageIter iter, variant_iter;
+    dbus_message_iter_init_append(reply, &iter);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_VARIANT, "u", &variant_iter);
+    appendPendingCalls(&variant_iter);
+    dbus_message_iter_close_container(&iter, &variant_iter);
     return reply;
 }
 
-DBusMessage* UpdateService::handleGetVariant(DBusMessage* message) {
-    logDebug("Getting Variant property");
-    DBusMessage* reply = getRaucProperty("Variant", message);
+DBusMessage* UpdateService::handleGetSignalCounters(DBusMessage* message) {
+    usvc_debug_sampled(calls, "Getting SignalCounters property");
+
+    DBusMessage* reply = dbus_message_new_method_return(message);
     if (!reply) {
-        logError("Failed to get Variant property from RAUC");
-        return createErrorReply(message, "org.freedesktop.UpdateService.Error", "Failed to get Variant property");
+        return nullptr;
     }
+
+    DBusMessageIter iter, variant_iter;
+    dbus_message_iter_init_append(reply, &iter);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_VARIANT, "a{st}", &variant_iter);
+    appendSignalCounters(&variant_iter);
+    dbus_message_iter_close_container(&iter, &variant_iter);
     return reply;
 }
 
-DBusMessage* UpdateService::handleGetBootSlot(DBusMessage* message) {
-    logDebug("Getting BootSlot property");
-    DBusMessage* reply = getRaucProperty("BootSlot", message);
+void UpdateService::appendCallLatency(DBusMessageIter* iter) {
+    // a{s(ttttat)}: method -> (calls, failures, total us, max us, bucket counts)
+    DBusMessageIter dict_iter;
+    dbus_message_iter_open_container(iter, DBUS_TYPE_ARRAY, "{s(ttttat)}", &dict_iter);
+
+    for (const auto& entry : call_latency_) {
+        const LatencyHistogram& histogram = entry.second;
+        DBusMessageIter entry_iter, struct_iter, buckets_iter;
+        const char* method = entry.first.c_str();
+        dbus_uint64_t count = histogram.count();
+        dbus_uint64_t failures = histogram.failures();
+        dbus_uint64_t total_us = histogram.totalMicros();
+        dbus_uint64_t max_us = histogram.maxMicros();
+        std::vector<dbus_uint64_t> buckets(histogram.buckets().begin(), histogram.buckets().end());
+        const dbus_uint64_t* bucket_data = buckets.data();
+
+        dbus_message_iter_open_container(&dict_iter, DBUS_TYPE_DICT_ENTRY, nullptr, &entry_iter);
+        dbus_message_iter_append_basic(&entry_iter, DBUS_TYPE_STRING, &method);
+        dbus_message_iter_open_container(&entry_iter, DBUS_TYPE_STRUCT, nullptr, &struct_iter);
+        dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT64, &count);
+        dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT64, &failures);
+        dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT64, &total_us);
+        dbus_message_iter_append_basic(&struct_iter, DBUS_TYPE_UINT64, &max_us);
+        dbus_message_iter_open_container(&struct_iter, DBUS_TYPE_ARRAY, "t", &buckets_iter);
+        dbus_message_iter_append_fixed_array(&buckets_iter, DBUS_TYPE_UINT64, &bucket_data,
+                                             static_cast<int>(buckets.size()));
+        dbus_message_iter_close_container(&struct_iter, &buckets_iter);
+        dbus_message_iter_close_container(&entry_iter, &struct_iter);
+        dbus_message_iter_close_container(&dict_iter, &entry_iter);
+    }
+
+    dbus_message_iter_close_container(iter, &dict_iter);
+}
+
+void UpdateService::appendLatencyBuckets(DBusMessageIter* iter) {
+    std::vector<dbus_uint64_t> bounds(LatencyHistogram::bucketBounds(),
+                                      LatencyHistogram::bucketBounds() + LatencyHistogram::BUCKETS - 1);
+    const dbus_uint64_t* bound_data = bounds.data();
+
+    DBusMessageIter array_iter;
+    dbus_message_iter_open_container(iter, DBUS_TYPE_ARRAY, "t", &array_iter);
+    dbus_message_iter_append_fixed_array(&array_iter, DBUS_TYPE_UINT64, &bound_data, static_cast<int>(bounds.size()));
+    dbus_message_iter_close_container(iter, &array_iter);
+}
+
+void UpdateService::appendSignalCounters(DBusMessageIter* iter) {
+    const std::pair<const char*, dbus_uint64_t> counters[] = {
+        { "received", signal_counters_.received },
+        { "broadcast", signal_counters_.broadcast },
+        { "unicast", signal_counters_.unicast },
+        { "duplicate", signal_counters_.duplicate },
+        { "coalesced", clients_.coalesced() },
+        { "clients", clients_.size() },
+    };
+
+    DBusMessageIter dict_iter, entry_iter;
+    dbus_message_iter_open_container(iter, DBUS_TYPE_ARRAY, "{st}", &dict_iter);
+    for (const auto& counter : counters) {
+        dbus_message_iter_open_container(&dict_iter, DBUS_TYPE_DICT_ENTRY, nullptr, &entry_iter);
+        dbus_message_iter_append_basic(&entry_iter, DBUS_TYPE_STRING, &counter.first);
+        dbus_message_iter_append_basic(&entry_iter, DBUS_TYPE_UINT64, &counter.second);
+        dbus_message_iter_close_container(&dict_iter, &entry_iter);
+    }
+    dbus_message_iter_close_container(iter, &dict_iter);
+}
+
+void UpdateService::appendPendingCalls(DBusMessageIter* iter) {
+    dbus_uint32_t pending = static_cast<dbus_uint32_t>(in_flight_.size());
+    dbus_message_iter_append_basic(iter, DBUS_TYPE_UINT32, &pending);
+}
+
+DBusMessage* UpdateService::handleGetAll(DBusMessage* message) {
+    const char* interface_name = nullptr;
+    if (!dbus_message_get_args(message, nullptr, DBUS_TYPE_STRING, &interface_name, DBUS_TYPE_INVALID)) {
+        return createErrorReply(message, "org.freedesktop.DBus.Error.InvalidArgs", "Invalid arguments");
+    }
+    if (strcmp(interface_name, INTERFACE_NAME) != 0) {
+        return createErrorReply(message, "org.freedesktop.DBus.Error.UnknownInterface", "Unknown interface");
+    }
+
+    // Fill the cache with one RAUC GetAll instead of a Get per property
+    if (!property_cache_.complete() && requireRauc()) {
+        DBusMessage* rauc_call = dbus_message_new_method_call(
+            RAUC_SERVICE_NAME, RAUC_OBJECT_PATH, RAUC_PROPERTIES_INTERFACE, "GetAll");
+        const char* rauc_interface = RAUC_INTERFACE_NAME;
+        if (rauc_call &&
+            dbus_message_append_args(rauc_call, DBUS_TYPE_STRING, &rauc_interface, DBUS_TYPE_INVALID) &&
+            sendToRauc(rauc_call, message, "GetAll", std::string(), true)) {
+            dbus_message_unref(rauc_call);
+            return nullptr;
+        }
+        if (rauc_call) {
+            dbus_message_unref(rauc_call);
+        }
+        usvc_error(calls, "RAUC GetAll failed - answering from cache");
+    }
+    return buildAllPropertiesReply(message);
+}
+
+DBusMessage* UpdateService::buildAllPropertiesReply(DBusMessage* request) {
+    DBusMessage* reply = dbus_message_new_method_return(request);
     if (!reply) {
-        logError("Failed to get BootSlot property from RAUC");
-        return createErrorReply(message, "org.freedesktop.UpdateService.Error", "Failed to get BootSlot property");
+        return nullptr;
+    }
+
+    DBusMessageIter iter, dict_iter, entry_iter, variant_iter;
+    dbus_message_iter_init_append(reply, &iter);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "{sv}", &dict_iter);
+
+    // RAUC properties we have a value for
+    for (const char* const* name = PropertyCache::names(); *name; ++name) {
+        DBusMessage* cached = property_cache_.lookup(*name);
+        DBusMessageIter cached_iter;
+        if (!cached || !dbus_message_iter_init(cached, &cached_iter)) {
+            continue;
+        }
+        dbus_message_iter_open_container(&dict_iter, DBUS_TYPE_DICT_ENTRY, nullptr, &entry_iter);
+        dbus_message_iter_append_basic(&entry_iter, DBUS_TYPE_STRING, name);
+        dbus_copy::copyValue(&cached_iter, &entry_iter, DBUS_TYPE_VARIANT_AS_STRING);
+        dbus_message_iter_close_container(&dict_iter, &entry_iter);
+    }
+
+    // Broker statistics
+    struct StatsProperty {
+        const char* name;
+        const char* signature;
+        void (UpdateService::*append)(DBusMessageIter*);
+    };
+    static const StatsProperty stats_properties[] = {
+        { "CallLatency", "a{s(ttttat)}", &UpdateService::appendCallLatency },
+        { "LatencyBuckets", "at", &UpdateService::appendLatencyBuckets },
+        { "PendingCalls", "u", &UpdateService::appendPendingCalls },
+        { "SignalCounters", "a{st}", &UpdateService::appendSignalCounters },
+    };
+    for (const StatsProperty& property : stats_properties) {
+        dbus_message_iter_open_container(&dict_iter, DBUS_TYPE_DICT_ENTRY, nullptr, &entry_iter);
+        dbus_message_iter_append_basic(&entry_iter, DBUS_TYPE_STRING, &property.name);
+        dbus_message_iter_open_container(&entry_iter, DBUS_TYPE_VARIANT, property.signature, &variant_iter);
+        (this->*property.append)(&variant_iter);
+        dbus_message_iter_close_container(&entry_iter, &variant_iter);
+        dbus_message_iter_close_container(&dict_iter, &entry_iter);
     }
+
+    dbus_message_iter_close_container(&iter, &dict_iter);
     return reply;
 }
 
-DBusMessage* UpdateService::forwardToRauc(const std::string& rauc_method_name, DBusMessage* message) {
-    logDebug("Forwarding to RAUC: " + rauc_method_name);
+void UpdateService::cacheAllProperties(DBusMessage* rauc_reply) {
+    DBusMessageIter iter, dict_iter;
+    if (!dbus_message_has_signature(rauc_reply, "a{sv}") || !dbus_message_iter_init(rauc_reply, &iter)) {
+        return;
+    }
+    dbus_message_iter_recurse(&iter, &dict_iter);
+    for (; dbus_message_iter_get_arg_type(&dict_iter) == DBUS_TYPE_DICT_ENTRY; dbus_message_iter_next(&dict_iter)) {
+        DBusMessageIter entry_iter;
+        const char* name = nullptr;
+        dbus_message_iter_recurse(&dict_iter, &entry_iter);
+        dbus_message_iter_get_basic(&entry_iter, &name);
+        dbus_message_iter_next(&entry_iter);
+        property_cache_.storeVariant(name, &entry_iter);
+    }
+}
 
-    if (!connected_to_rauc_) {
-        logError("Not connected to RAUC service");
+DBusMessage* UpdateService::forwardToRauc(const std::string& rauc_method_name, DBusMessage* message,
+                                          bool install_call) {
+    if (!requireRauc()) {
+        usvc_error(calls, "Not connected to RAUC service for: ", DLT_STRING(rauc_method_name.c_str()));
         return createErrorReply(message, "de.makepluscode.updateservice.Error", "Not connected to RAUC");
     }
 
@@ -637,81 +1065,52 @@ DBusMessage* UpdateService::forwardToRauc(const std::string& rauc_method_name, D
     );
 
     if (!rauc_call) {
-        logError("Failed to create D-Bus method call for RAUC");
+        usvc_error(calls, "Failed to create D-Bus method call for RAUC: ", DLT_STRING(rauc_method_name.c_str()));
         return createErrorReply(message, "de.makepluscode.updateservice.Error", "Failed to create RAUC call");
     }
 
-    logDebug("Created RAUC method call: " + std::string(RAUC_SERVICE_NAME) + "." + rauc_method_name);
-
-    // Copy arguments from original message
-    DBusMessageIter src_iter, dst_iter;
-    if (dbus_message_iter_init(message, &src_iter)) {
-        dbus_message_iter_init_append(rauc_call, &dst_iter);
-
-        // Copy all arguments
-        do {
-            int arg_type = dbus_message_iter_get_arg_type(&src_iter);
-            if (arg_type == DBUS_TYPE_INVALID) break;
-
-            // Copy basic types and variants
-            if (arg_type == DBUS_TYPE_STRING) {
-                const char* value;
-                dbus_message_iter_get_basic(&src_iter, &value);
-                dbus_message_iter_append_basic(&dst_iter, DBUS_TYPE_STRING, &value);
-            }
-            // Add more argument copying as needed for complex types
-
-        } while (dbus_message_iter_next(&src_iter));
+    // Copy all arguments from original message (any signature, e.g. InstallBundle's a{sv} options)
+    if (!dbus_copy::copyArguments(message, rauc_call)) {
+        usvc_error(calls, "Failed to copy arguments for RAUC call: ", DLT_STRING(rauc_method_name.c_str()));
+        dbus_message_unref(rauc_call);
+        return createErrorReply(message, "de.makepluscode.updateservice.Error", "Failed to create RAUC call");
     }
 
-    // Send call to RAUC and wait for reply
-
-    DBusMessage* rauc_reply = dbus_connection_send_with_reply_and_block(
-        rauc_connection_, rauc_call, 30000, nullptr);
-
+    // Send without blocking; onRaucReply() sends the client reply
+    PendingForward* forward = sendToRauc(rauc_call, message, rauc_method_name, std::string());
     dbus_message_unref(rauc_call);
 
-    if (!rauc_reply) {
-        logError("RAUC method call failed: " + rauc_method_name);
+    if (!forward) {
+        usvc_error(calls, "RAUC method call failed: ", DLT_STRING(rauc_method_name.c_str()));
         return createErrorReply(message, "de.makepluscode.updateservice.Error", "RAUC call failed");
     }
-
-    logDebug("RAUC method completed: " + rauc_method_name);
-
-    // Create reply with same content as RAUC reply
-    DBusMessage* reply = dbus_message_new_method_return(message);
-    if (reply) {
-        // Copy reply arguments
-        DBusMessageIter reply_src_iter, reply_dst_iter;
-        if (dbus_message_iter_init(rauc_reply, &reply_src_iter)) {
-            dbus_message_iter_init_append(reply, &reply_dst_iter);
-
-            // Copy all reply arguments
-            do {
-                int arg_type = dbus_message_iter_get_arg_type(&reply_src_iter);
-                if (arg_type == DBUS_TYPE_INVALID) break;
-
-                if (arg_type == DBUS_TYPE_STRING) {
-                    const char* value;
-                    dbus_message_iter_get_basic(&reply_src_iter, &value);
-                    dbus_message_iter_append_basic(&reply_dst_iter, DBUS_TYPE_STRING, &value);
-                }
-                // Add more types as needed
-
-            } while (dbus_message_iter_next(&reply_src_iter));
+    if (install_call) {
+        // Only the call that started the installation ends it when RAUC refuses it; a second
+        // Install that RAUC rejects as already in progress leaves the running one alone
+        forward->install_call = true;
+        forward->owns_installation = !installation_active_;
+        install_calls_++;
+        if (forward->owns_installation) {
+            setInstallationActive(true);
         }
     }
-
-    dbus_message_unref(rauc_reply);
-    return reply;
+    return nullptr;
 }
 
 DBusMessage* UpdateService::getRaucProperty(const std::string& property_name, DBusMessage* original_message) {
-    logDebug("Getting RAUC property: " + property_name);
+    // Answered locally when cached: immutable values, or mutable ones kept current by PropertiesChanged
+    DBusMessage* cached = property_cache_.lookup(property_name);
+    if (cached) {
+        DBusMessage* reply = wrapRaucProperty(original_message, cached, property_name);
+        if (reply) {
+            return reply;
+        }
+    }
 
-    if (!connected_to_rauc_) {
-        logError("Not connected to RAUC service for property: " + property_name);
-        return nullptr;
+    if (!requireRauc()) {
+        usvc_error(calls, "Not connected to RAUC service for property: ", DLT_STRING(property_name.c_str()));
+        return createErrorReply(original_message, "org.freedesktop.UpdateService.Error",
+                                "Failed to get " + property_name + " property");
     }
 
     // Create property get call to RAUC
@@ -723,8 +1122,9 @@ DBusMessage* UpdateService::getRaucProperty(const std::string& property_name, DB
     );
 
     if (!prop_call) {
-        logError("Failed to create property call message for: " + property_name);
-        return nullptr;
+        usvc_error(calls, "Failed to create property call message for: ", DLT_STRING(property_name.c_str()));
+        return createErrorReply(original_message, "org.freedesktop.UpdateService.Error",
+                                "Failed to get " + property_name + " property");
     }
 
     // Add arguments (interface name and property name)
@@ -737,111 +1137,214 @@ DBusMessage* UpdateService::getRaucProperty(const std::string& property_name, DB
     dbus_message_iter_append_basic(&iter, DBUS_TYPE_STRING, &interface_name);
     dbus_message_iter_append_basic(&iter, DBUS_TYPE_STRING, &prop_name);
 
-    // Send call and get reply
-    DBusMessage* rauc_reply = dbus_connection_send_with_reply_and_block(
-        rauc_connection_, prop_call, 30000, nullptr);
-
+    bool queued = sendToRauc(prop_call, original_message, "Get(" + property_name + ")", property_name) != nullptr;
     dbus_message_unref(prop_call);
 
-    if (!rauc_reply) {
-        logError("RAUC property call failed: " + property_name);
+    if (!queued) {
+        usvc_error(calls, "RAUC property call failed: ", DLT_STRING(property_name.c_str()));
+        return createErrorReply(original_message, "org.freedesktop.UpdateService.Error",
+                                "Failed to get " + property_name + " property");
+    }
+    return nullptr;
+}
+
+UpdateService::PendingForward* UpdateService::sendToRauc(DBusMessage* rauc_call, DBusMessage* request,
+                                                         const std::string& stats_key,
+                                                         const std::string& property_name, bool all_properties) {
+    DBusPendingCall* pending = nullptr;
+    if (!dbus_connection_send_with_reply(rauc_connection_, rauc_call, &pending, RAUC_CALL_TIMEOUT_MS)) {
+        return nullptr;
+    }
+    // NULL without an error means the connection is already disconnected
+    if (!pending) {
+        return nullptr;
+    }
+
+    PendingForward* forward = new PendingForward();
+    forward->service = this;
+    forward->request = dbus_message_ref(request);
+    forward->pending = pending;
+    forward->stats_key = stats_key;
+    forward->property_name = property_name;
+    forward->all_properties = all_properties;
+    forward->install_call = false;
+    forward->owns_installation = false;
+    forward->started = std::chrono::steady_clock::now();
+
+    if (!dbus_pending_call_set_notify(pending, onRaucReply, forward, freePendingForward)) {
+        dbus_pending_call_cancel(pending);
+        dbus_pending_call_unref(pending);
+        dbus_message_unref(forward->request);
+        delete forward;
         return nullptr;
     }
 
+    in_flight_.insert(forward);
+    usvc_debug_sampled(calls, "RAUC call in flight: ", DLT_STRING(stats_key.c_str()),
+                       DLT_CSTRING("pending:"), DLT_UINT64(in_flight_.size()));
+    return forward;
+}
+
+void UpdateService::onRaucReply(DBusPendingCall* pending, void* user_data) {
+    PendingForward* forward = static_cast<PendingForward*>(user_data);
+    UpdateService* service = forward->service;
+
+    DBusMessage* rauc_reply = dbus_pending_call_steal_reply(pending);
+    auto elapsed = std::chrono::steady_clock::now() - forward->started;
+    bool failed = !rauc_reply || dbus_message_get_type(rauc_reply) == DBUS_MESSAGE_TYPE_ERROR;
+    service->call_latency_[forward->stats_key].record(
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()), failed);
+
+    DBusMessage* reply = nullptr;
+    if (forward->all_properties) {
+        if (failed) {
+            reply = service->buildMethodReply(forward->request, rauc_reply, forward->stats_key);
+        } else {
+            service->cacheAllProperties(rauc_reply);
+            reply = service->buildAllPropertiesReply(forward->request);
+        }
+    } else if (forward->property_name.empty()) {
+        reply = service->buildMethodReply(forward->request, rauc_reply, forward->stats_key);
+        if (forward->install_call) {
+            service->install_calls_--;
+            if (!failed && !service->installation_active_) {
+                // Accepted after the call that armed the poll was refused: runs until Completed
+                service->setInstallationActive(true);
+            } else if (failed && forward->owns_installation && service->installation_active_) {
+                // A refused Install never sends Completed; do not keep queued jobs waiting for it
+                service->setInstallationActive(false);
+            }
+            service->startNextJob();
+        }
+    } else {
+        if (!failed) {
+            service->property_cache_.store(forward->property_name, rauc_reply);
+        }
+        reply = service->buildPropertyReply(forward->request, rauc_reply, forward->property_name);
+    }
+    if (rauc_reply) {
+        dbus_message_unref(rauc_reply);
+    }
+    if (reply) {
+        service->sendReply(reply);
+    }
+
+    // Dropping the last reference frees the PendingForward through freePendingForward()
+    service->in_flight_.erase(forward);
+    dbus_pending_call_unref(pending);
+}
+
+void UpdateService::freePendingForward(void* data) {
+    PendingForward* forward = static_cast<PendingForward*>(data);
+    dbus_message_unref(forward->request);
+    delete forward;
+}
+
+void UpdateService::cancelPendingForwards() {
+    std::set<PendingForward*> forwards;
+    forwards.swap(in_flight_);
+    install_calls_ = 0;
+    for (PendingForward* forward : forwards) {
+        DBusPendingCall* pending = forward->pending;
+        dbus_pending_call_cancel(pending);
+        dbus_pending_call_unref(pending);
+    }
+    if (!forwards.empty()) {
+        usvc_info(calls, "Cancelled RAUC calls still in flight: ", DLT_UINT64(forwards.size()));
+    }
+}
+
+void UpdateService::sendReply(DBusMessage* reply) {
+    if (service_connection_) {
+        dbus_connection_send(service_connection_, reply, nullptr);
+    }
+    dbus_message_unref(reply);
+}
+
+DBusMessage* UpdateService::buildMethodReply(DBusMessage* request, DBusMessage* rauc_reply,
+                                             const std::string& rauc_method_name) {
+    if (!rauc_reply) {
+        usvc_error(calls, "RAUC method call failed: ", DLT_STRING(rauc_method_name.c_str()));
+        return createErrorReply(request, "de.makepluscode.updateservice.Error", "RAUC call failed");
+    }
+
+    // Pass RAUC errors (including NoReply on timeout) through unchanged
+    if (dbus_message_get_type(rauc_reply) == DBUS_MESSAGE_TYPE_ERROR) {
+        const char* error_name = dbus_message_get_error_name(rauc_reply);
+        const char* error_message = nullptr;
+        dbus_message_get_args(rauc_reply, nullptr, DBUS_TYPE_STRING, &error_message, DBUS_TYPE_INVALID);
+        usvc_error(calls, "RAUC method call failed: ", DLT_STRING(rauc_method_name.c_str()),
+                   DLT_STRING(error_name ? error_name : "unknown"));
+        return createErrorReply(request, error_name ? error_name : "de.makepluscode.updateservice.Error",
+                                error_message ? error_message : "RAUC call failed");
+    }
+
+    // Create reply with same content as RAUC reply (GetSlotStatus a(sa{sv}), GetArtifactStatus aa{sv}, ...)
+    DBusMessage* reply = dbus_message_new_method_return(request);
+    if (reply && !dbus_copy::copyArguments(rauc_reply, reply)) {
+        usvc_error(calls, "Failed to copy RAUC reply for: ", DLT_STRING(rauc_method_name.c_str()));
+        dbus_message_unref(reply);
+        return createErrorReply(request, "de.makepluscode.updateservice.Error", "Failed to copy RAUC reply");
+    }
+    return reply;
+}
+
+DBusMessage* UpdateService::buildPropertyReply(DBusMessage* original_message, DBusMessage* rauc_reply,
+                                               const std::string& property_name) {
+    DBusMessage* reply = rauc_reply ? wrapRaucProperty(original_message, rauc_reply, property_name) : nullptr;
+    if (!reply) {
+        usvc_error(calls, "Failed to get property from RAUC: ", DLT_STRING(property_name.c_str()));
+        return createErrorReply(original_message, "org.freedesktop.UpdateService.Error",
+                                "Failed to get " + property_name + " property");
+    }
+    return reply;
+}
+
+DBusMessage* UpdateService::wrapRaucProperty(DBusMessage* original_message, DBusMessage* rauc_reply,
+                                             const std::string& property_name) {
     // Check if reply is an error
     if (dbus_message_get_type(rauc_reply) == DBUS_MESSAGE_TYPE_ERROR) {
-        logError("RAUC returned error for property: " + property_name);
         const char* error_name = dbus_message_get_error_name(rauc_reply);
-        logError("Error name: " + std::string(error_name ? error_name : "unknown"));
-        dbus_message_unref(rauc_reply);
+        usvc_error(calls, "RAUC returned error for property: ", DLT_STRING(property_name.c_str()),
+                   DLT_STRING(error_name ? error_name : "unknown"));
         return nullptr;
     }
 
     // Create a proper Properties.Get reply that wraps the RAUC property value in a variant
     DBusMessage* reply = dbus_message_new_method_return(original_message);
     if (!reply) {
-        logError("Failed to create Properties.Get reply for: " + property_name);
-        dbus_message_unref(rauc_reply);
+        usvc_error(calls, "Failed to create Properties.Get reply for: ", DLT_STRING(property_name.c_str()));
         return nullptr;
     }
 
-    // Parse the RAUC reply and wrap it in a variant
+    // Wrap the RAUC value in our variant: RAUC already returns one, a bare single value gets wrapped
     DBusMessageIter rauc_iter, reply_iter, variant_iter;
-    if (dbus_message_iter_init(rauc_reply, &rauc_iter)) {
+    bool copied = dbus_message_iter_init(rauc_reply, &rauc_iter);
+    if (copied) {
         dbus_message_iter_init_append(reply, &reply_iter);
-
-        // Start a variant
-        const char* variant_signature = nullptr;
-        int arg_type = dbus_message_iter_get_arg_type(&rauc_iter);
-
-        if (arg_type == DBUS_TYPE_VARIANT) {
-            // RAUC already returns a variant, so we can copy it directly
-            DBusMessageIter rauc_variant_iter;
-            dbus_message_iter_recurse(&rauc_iter, &rauc_variant_iter);
-            variant_signature = dbus_message_iter_get_signature(&rauc_variant_iter);
-        } else {
-            // RAUC returns a direct value, we need to wrap it in a variant
-            variant_signature = dbus_message_iter_get_signature(&rauc_iter);
-        }
-
-        if (variant_signature) {
-            dbus_message_iter_open_container(&reply_iter, DBUS_TYPE_VARIANT, variant_signature, &variant_iter);
-
-            if (arg_type == DBUS_TYPE_VARIANT) {
-                // Copy the variant content directly by iterating through it
-                DBusMessageIter rauc_variant_iter;
-                dbus_message_iter_recurse(&rauc_iter, &rauc_variant_iter);
-
-                // Copy the variant content manually
-                int variant_arg_type = dbus_message_iter_get_arg_type(&rauc_variant_iter);
-                if (variant_arg_type == DBUS_TYPE_STRING) {
-                    const char* value;
-                    dbus_message_iter_get_basic(&rauc_variant_iter, &value);
-                    dbus_message_iter_append_basic(&variant_iter, DBUS_TYPE_STRING, &value);
-                } else if (variant_arg_type == DBUS_TYPE_INT32) {
-                    dbus_int32_t value;
-                    dbus_message_iter_get_basic(&rauc_variant_iter, &value);
-                    dbus_message_iter_append_basic(&variant_iter, DBUS_TYPE_INT32, &value);
-                } else if (variant_arg_type == DBUS_TYPE_BOOLEAN) {
-                    dbus_bool_t value;
-                    dbus_message_iter_get_basic(&rauc_variant_iter, &value);
-                    dbus_message_iter_append_basic(&variant_iter, DBUS_TYPE_BOOLEAN, &value);
-                }
-                // Add more types as needed
+        const char* value_signature = dbus_message_get_signature(rauc_reply);
+
+        if (dbus_message_iter_get_arg_type(&rauc_iter) == DBUS_TYPE_VARIANT) {
+            copied = dbus_copy::copyValue(&rauc_iter, &reply_iter, value_signature);
+        } else if (dbus_copy::completeTypeLength(value_signature) == static_cast<int>(strlen(value_signature)) &&
+                   dbus_message_iter_open_container(&reply_iter, DBUS_TYPE_VARIANT, value_signature, &variant_iter)) {
+            copied = dbus_copy::copyValue(&rauc_iter, &variant_iter, value_signature);
+            if (copied) {
+                copied = dbus_message_iter_close_container(&reply_iter, &variant_iter);
             } else {
-                // Copy the direct value into our variant manually
-                if (arg_type == DBUS_TYPE_STRING) {
-                    const char* value;
-                    dbus_message_iter_get_basic(&rauc_iter, &value);
-                    dbus_message_iter_append_basic(&variant_iter, DBUS_TYPE_STRING, &value);
-                } else if (arg_type == DBUS_TYPE_INT32) {
-                    dbus_int32_t value;
-                    dbus_message_iter_get_basic(&rauc_iter, &value);
-                    dbus_message_iter_append_basic(&variant_iter, DBUS_TYPE_INT32, &value);
-                } else if (arg_type == DBUS_TYPE_BOOLEAN) {
-                    dbus_bool_t value;
-                    dbus_message_iter_get_basic(&rauc_iter, &value);
-                    dbus_message_iter_append_basic(&variant_iter, DBUS_TYPE_BOOLEAN, &value);
-                }
-                // Add more types as needed
+                dbus_message_iter_abandon_container(&reply_iter, &variant_iter);
             }
-
-            dbus_message_iter_close_container(&reply_iter, &variant_iter);
         } else {
-            logError("Failed to get variant signature for property: " + property_name);
-            dbus_message_unref(reply);
-            dbus_message_unref(rauc_reply);
-            return nullptr;
+            copied = false;
         }
-    } else {
-        logError("Failed to parse RAUC reply for property: " + property_name);
+    }
+
+    if (!copied) {
+        usvc_error(calls, "Failed to parse RAUC reply for property: ", DLT_STRING(property_name.c_str()));
         dbus_message_unref(reply);
-        dbus_message_unref(rauc_reply);
         return nullptr;
     }
 
-    dbus_message_unref(rauc_reply);
-    logDebug("Successfully created Properties.Get reply for: " + property_name);
     return reply;
 }
 
@@ -849,24 +1352,19 @@ DBusMessage* UpdateService::createErrorReply(DBusMessage* message,
                                            const std::string& error_name,
                                            const std::string& error_message) {
     DBusMessage* reply = dbus_message_new_error(message, error_name.c_str(), error_message.c_str());
-    logError("Returning error: " + error_name + " - " + error_message);
+    usvc_error(calls, "Returning error: ", DLT_STRING(error_name.c_str()), DLT_STRING(error_message.c_str()));
     return reply;
 }
 
-void UpdateService::logInfo(const std::string& message) {
-    DLT_LOG(dlt_context_service, DLT_LOG_INFO, DLT_STRING(message.c_str()));
-}
-
-void UpdateService::logError(const std::string& message) {
-    DLT_LOG(dlt_context_service, DLT_LOG_ERROR, DLT_STRING(message.c_str()));
-}
-
-void UpdateService::logDebug(const std::string& message) {
-    DLT_LOG(dlt_context_service, DLT_LOG_DEBUG, DLT_STRING(message.c_str()));
+void UpdateService::setInstallationActive(bool active) {
+    installation_active_ = active;
+    last_progress_percentage_ = -1;
+    loop_.setTimerEnabled(progress_timer_, active && connected_to_rauc_);
+    usvc_debug(signals, "Progress fallback poll ", DLT_STRING(active ? "armed" : "disarmed"));
 }
 
 void UpdateService::pollAndForwardProgress() {
-    if (!connected_to_rauc_) {
+    if (!connected_to_rauc_ || progress_poll_) {
         return;
     }
 
@@ -879,61 +1377,70 @@ void UpdateService::pollAndForwardProgress() {
     );
 
     if (!prop_call) {
-        logError("Failed to create Progress property call");
+        usvc_error(signals, "Failed to create Progress property call");
         return;
     }
 
-    // Add arguments (interface name and property name)
-    DBusMessageIter iter;
-    dbus_message_iter_init_append(prop_call, &iter);
-
     const char* interface_name = RAUC_INTERFACE_NAME;
     const char* prop_name = "Progress";
-
-    dbus_message_iter_append_basic(&iter, DBUS_TYPE_STRING, &interface_name);
-    dbus_message_iter_append_basic(&iter, DBUS_TYPE_STRING, &prop_name);
-
-    // Send call and get reply (with short timeout to avoid blocking)
-    DBusMessage* rauc_reply = dbus_connection_send_with_reply_and_block(
-        rauc_connection_, prop_call, 1000, nullptr);
-
+    dbus_message_append_args(prop_call,
+        DBUS_TYPE_STRING, &interface_name,
+        DBUS_TYPE_STRING, &prop_name,
+        DBUS_TYPE_INVALID);
+
+    // The reply arrives through onProgressPollReply(); the loop keeps serving clients meanwhile
+    DBusPendingCall* pending = nullptr;
+    if (dbus_connection_send_with_reply(rauc_connection_, prop_call, &pending, PROGRESS_POLL_TIMEOUT_MS) && pending) {
+        if (dbus_pending_call_set_notify(pending, onProgressPollReply, this, nullptr)) {
+            progress_poll_ = pending;
+        } else {
+            dbus_pending_call_cancel(pending);
+            dbus_pending_call_unref(pending);
+        }
+    }
     dbus_message_unref(prop_call);
+}
 
-    if (!rauc_reply) {
-        // Don't spam logs - Progress polling failing is expected when idle
-        return;
-    }
+void UpdateService::onProgressPollReply(DBusPendingCall* pending, void* user_data) {
+    UpdateService* service = static_cast<UpdateService*>(user_data);
+    DBusMessage* rauc_reply = dbus_pending_call_steal_reply(pending);
+    dbus_pending_call_unref(pending);
+    service->progress_poll_ = nullptr;
 
-    // Check if reply is an error
-    if (dbus_message_get_type(rauc_reply) == DBUS_MESSAGE_TYPE_ERROR) {
-        dbus_message_unref(rauc_reply);
+    if (!rauc_reply) {
         return;
     }
 
-    // Parse Progress property: variant containing (isi) struct
-    DBusMessageIter reply_iter, variant_iter, struct_iter;
-    if (!dbus_message_iter_init(rauc_reply, &reply_iter)) {
-        dbus_message_unref(rauc_reply);
-        return;
+    // Progress property: variant containing (isi); errors are expected when idle
+    DBusMessageIter reply_iter, variant_iter;
+    if (dbus_message_get_type(rauc_reply) == DBUS_MESSAGE_TYPE_METHOD_RETURN &&
+        dbus_message_iter_init(rauc_reply, &reply_iter) &&
+        dbus_message_iter_get_arg_type(&reply_iter) == DBUS_TYPE_VARIANT) {
+        service->property_cache_.store("Progress", rauc_reply);
+        dbus_message_iter_recurse(&reply_iter, &variant_iter);
+        service->updateProgress(&variant_iter);
     }
+    dbus_message_unref(rauc_reply);
+}
 
-    if (dbus_message_iter_get_arg_type(&reply_iter) != DBUS_TYPE_VARIANT) {
-        dbus_message_unref(rauc_reply);
-        return;
+void UpdateService::cancelProgressPoll() {
+    if (progress_poll_) {
+        dbus_pending_call_cancel(progress_poll_);
+        dbus_pending_call_unref(progress_poll_);
+        progress_poll_ = nullptr;
     }
+}
 
-    dbus_message_iter_recurse(&reply_iter, &variant_iter);
-
-    if (dbus_message_iter_get_arg_type(&variant_iter) != DBUS_TYPE_STRUCT) {
-        dbus_message_unref(rauc_reply);
+void UpdateService::updateProgress(DBusMessageIter* progress) {
+    if (dbus_message_iter_get_arg_type(progress) != DBUS_TYPE_STRUCT) {
         return;
     }
 
-    dbus_message_iter_recurse(&variant_iter, &struct_iter);
+    DBusMessageIter struct_iter;
+    dbus_message_iter_recurse(progress, &struct_iter);
 
     // Extract first int32 (percentage)
     if (dbus_message_iter_get_arg_type(&struct_iter) != DBUS_TYPE_INT32) {
-        dbus_message_unref(rauc_reply);
         return;
     }
 
@@ -941,30 +1448,125 @@ void UpdateService::pollAndForwardProgress() {
     dbus_message_iter_get_basic(&struct_iter, &percentage);
 
     // Extract string (message)
-    std::string progress_message = "";
-    if (dbus_message_iter_next(&struct_iter)) {
-        if (dbus_message_iter_get_arg_type(&struct_iter) == DBUS_TYPE_STRING) {
-            const char* msg;
-            dbus_message_iter_get_basic(&struct_iter, &msg);
-            progress_message = msg ? msg : "";
-        }
+    const char* progress_message = "";
+    if (dbus_message_iter_next(&struct_iter) &&
+        dbus_message_iter_get_arg_type(&struct_iter) == DBUS_TYPE_STRING) {
+        dbus_message_iter_get_basic(&struct_iter, &progress_message);
     }
 
-    dbus_message_unref(rauc_reply);
-
     // Only forward if percentage changed
     if (percentage != last_progress_percentage_) {
         last_progress_percentage_ = percentage;
-        sendProgressSignal(percentage, progress_message);
-        logInfo("Progress updated: " + std::to_string(percentage) + "% - " + progress_message);
+        sendProgressSignal(percentage);
+        usvc_info_sampled(signals, "Progress updated: ", DLT_INT32(percentage), DLT_STRING(progress_message));
+    }
+}
+
+void UpdateService::forwardRaucPropertiesChanged(DBusMessage* message) {
+    // PropertiesChanged(s interface, a{sv} changed, as invalidated) from RAUC's object
+    DBusMessageIter args, changed;
+    const char* interface_name = nullptr;
+    if (!dbus_message_has_path(message, RAUC_OBJECT_PATH) ||
+        !dbus_message_has_signature(message, "sa{sv}as") ||
+        !dbus_message_iter_init(message, &args)) {
+        return;
+    }
+    dbus_message_iter_get_basic(&args, &interface_name);
+    if (strcmp(interface_name, RAUC_INTERFACE_NAME) != 0) {
+        return;
+    }
+    dbus_message_iter_next(&args);
+
+    // Re-emit the forwarded subset as our own PropertiesChanged for match-rule listeners. Progress
+    // goes out as our Progress signal only, not a second time in PropertiesChanged.
+    DBusMessage* signal = nullptr;
+    DBusMessageIter out_args, out_changed, out_invalidated;
+    if (broadcast_signals_) {
+        signal = dbus_message_new_signal(OBJECT_PATH, RAUC_PROPERTIES_INTERFACE, "PropertiesChanged");
+        if (!signal) {
+            usvc_error(signals, "Failed to create PropertiesChanged signal");
+        } else {
+            const char* our_interface = INTERFACE_NAME;
+            dbus_message_iter_init_append(signal, &out_args);
+            dbus_message_iter_append_basic(&out_args, DBUS_TYPE_STRING, &our_interface);
+            dbus_message_iter_open_container(&out_args, DBUS_TYPE_ARRAY, "{sv}", &out_changed);
+        }
+    }
+
+    int changes = 0;
+    int forwarded = 0;
+    dbus_message_iter_recurse(&args, &changed);
+    for (; dbus_message_iter_get_arg_type(&changed) == DBUS_TYPE_DICT_ENTRY; dbus_message_iter_next(&changed)) {
+        DBusMessageIter key_iter, value_iter;
+        const char* key = nullptr;
+        dbus_message_iter_recurse(&changed, &key_iter);
+        dbus_message_iter_get_basic(&key_iter, &key);
+
+        // Keep the cache current for every RAUC property, forward only the subset clients follow
+        dbus_message_iter_next(&key_iter);
+        property_cache_.storeVariant(key, &key_iter);
+
+        if (!isForwardedProperty(key)) {
+            continue;
+        }
+        changes++;
+
+        dbus_message_iter_recurse(&key_iter, &value_iter);
+        if (strcmp(key, "Progress") == 0) {
+            updateProgress(&value_iter);
+            continue;
+        }
+        if (dbus_message_iter_get_arg_type(&value_iter) == DBUS_TYPE_STRING) {
+            const char* value = nullptr;
+            dbus_message_iter_get_basic(&value_iter, &value);
+            usvc_info(signals, "RAUC property changed: ", DLT_STRING(key), DLT_STRING(value));
+        }
+
+        if (signal && dbus_copy::copyValue(&changed, &out_changed, "{sv}")) {
+            forwarded++;
+        }
+    }
+
+    // Invalidated properties are read from RAUC again on the next Get
+    DBusMessageIter invalidated;
+    dbus_message_iter_next(&args);
+    dbus_message_iter_recurse(&args, &invalidated);
+    if (signal) {
+        dbus_message_iter_close_container(&out_args, &out_changed);
+        dbus_message_iter_open_container(&out_args, DBUS_TYPE_ARRAY, "s", &out_invalidated);
+    }
+    for (; dbus_message_iter_get_arg_type(&invalidated) == DBUS_TYPE_STRING; dbus_message_iter_next(&invalidated)) {
+        const char* name = nullptr;
+        dbus_message_iter_get_basic(&invalidated, &name);
+        property_cache_.invalidate(name);
+        if (!isForwardedProperty(name)) {
+            continue;
+        }
+        changes++;
+        if (signal && dbus_message_iter_append_basic(&out_invalidated, DBUS_TYPE_STRING, &name)) {
+            forwarded++;
+        }
+    }
+
+    if (signal) {
+        dbus_message_iter_close_container(&out_args, &out_invalidated);
+        if (forwarded > 0 && dbus_connection_send(service_connection_, signal, nullptr)) {
+            signal_counters_.broadcast++;
+        }
+        dbus_message_unref(signal);
+    }
+
+    // RAUC reports changes itself; restart the fallback poll interval
+    if (changes > 0 && installation_active_) {
+        loop_.setTimerEnabled(progress_timer_, connected_to_rauc_);
     }
 }
 
-void UpdateService::sendProgressSignal(int percentage, const std::string& message) {
+void UpdateService::sendProgressSignal(int percentage) {
     // Create Progress signal for UPDATE-AGENT
     DBusMessage* signal = dbus_message_new_signal(OBJECT_PATH, INTERFACE_NAME, "Progress");
     if (!signal) {
-        logError("Failed to create Progress signal");
+        usvc_error(signals, "Failed to create Progress signal");
         return;
     }
 
@@ -975,13 +1577,326 @@ void UpdateService::sendProgressSignal(int percentage, const std::string& messag
     dbus_int32_t progress = percentage;
     dbus_message_iter_append_basic(&iter, DBUS_TYPE_INT32, &progress);
 
-    // Send the signal
-    dbus_bool_t sent = dbus_connection_send(service_connection_, signal, nullptr);
+    // Unicast to subscribed clients, broadcast only for match-rule listeners (UPDATE_SERVICE_BROADCAST_SIGNALS=1)
+    dbus_bool_t sent = TRUE;
+    if (broadcast_signals_) {
+        sent = dbus_connection_send(service_connection_, signal, nullptr);
+        signal_counters_.broadcast++;
+    }
     dbus_message_unref(signal);
+    sendProgressToClients(percentage);
+
+    if (!sent) {
+        usvc_error(signals, "Failed to send Progress signal to update-agent");
+    }
+}
+
+DBusMessage* UpdateService::handleSubscribe(DBusMessage* message) {
+    const char* sender = dbus_message_get_sender(message);
+    DBusMessageIter iter, dict_iter;
+    if (!sender || !dbus_message_has_signature(message, "a{sv}") || !dbus_message_iter_init(message, &iter)) {
+        return createErrorReply(message, "org.freedesktop.DBus.Error.InvalidArgs", "Expected a{sv} options");
+    }
+
+    // progress (b), progress-step (u, percent), progress-interval-ms (u), completed (b)
+    ClientRegistry::Options options;
+    dbus_message_iter_recurse(&iter, &dict_iter);
+    for (; dbus_message_iter_get_arg_type(&dict_iter) == DBUS_TYPE_DICT_ENTRY; dbus_message_iter_next(&dict_iter)) {
+        DBusMessageIter entry_iter, value_iter;
+        const char* key = nullptr;
+        dbus_message_iter_recurse(&dict_iter, &entry_iter);
+        dbus_message_iter_get_basic(&entry_iter, &key);
+        dbus_message_iter_next(&entry_iter);
+        dbus_message_iter_recurse(&entry_iter, &value_iter);
+        int type = dbus_message_iter_get_arg_type(&value_iter);
+
+        DBusBasicValue value;
+        value.u64 = 0;
+        if (type == DBUS_TYPE_BOOLEAN || type == DBUS_TYPE_UINT32) {
+            dbus_message_iter_get_basic(&value_iter, &value);
+        }
+        if (strcmp(key, "progress") == 0 && type == DBUS_TYPE_BOOLEAN) {
+            options.progress = value.bool_val;
+        } else if (strcmp(key, "progress-step") == 0 && type == DBUS_TYPE_UINT32) {
+            options.progress_step = value.u32;
+        } else if (strcmp(key, "progress-interval-ms") == 0 && type == DBUS_TYPE_UINT32) {
+            options.progress_interval_ms = value.u32;
+        } else if (strcmp(key, "completed") == 0 && type == DBUS_TYPE_BOOLEAN) {
+            options.completed = value.bool_val;
+        } else {
+            return createErrorReply(message, "org.freedesktop.DBus.Error.InvalidArgs",
+                                    "Unknown or mistyped option: " + std::string(key));
+        }
+    }
+
+    // Subscribers wait for RAUC signals, so connect now if that was deferred
+    requireRauc();
+    if (clients_.subscribe(sender, options)) {
+        // Without an error argument libdbus does not wait for the bus to confirm
+        dbus_bus_add_match(service_connection_, clientMatchRule(sender).c_str(), nullptr);
+    }
+    usvc_info(signals, "Client subscribed: ", DLT_STRING(sender), DLT_CSTRING("progress:"), DLT_BOOL(options.progress),
+              DLT_CSTRING("step %:"), DLT_UINT32(options.progress_step),
+              DLT_CSTRING("interval ms:"), DLT_UINT32(options.progress_interval_ms),
+              DLT_CSTRING("completed:"), DLT_BOOL(options.completed));
+    return dbus_message_new_method_return(message);
+}
+
+DBusMessage* UpdateService::handleUnsubscribe(DBusMessage* message) {
+    const char* sender = dbus_message_get_sender(message);
+    if (sender && clients_.unsubscribe(sender)) {
+        dbus_bus_remove_match(service_connection_, clientMatchRule(sender).c_str(), nullptr);
+        usvc_info(signals, "Client unsubscribed: ", DLT_STRING(sender));
+    }
+    return dbus_message_new_method_return(message);
+}
+
+DBusMessage* UpdateService::handleQueueInstall(DBusMessage* message) {
+    const char* bundle = nullptr;
+    DBusMessageIter iter, dict_iter;
+    if (!dbus_message_has_signature(message, "sa{sv}") || !dbus_message_iter_init(message, &iter)) {
+        return createErrorReply(message, "org.freedesktop.DBus.Error.InvalidArgs", "Expected bundle and a{sv} options");
+    }
+    dbus_message_iter_get_basic(&iter, &bundle);
+    dbus_message_iter_next(&iter);
+
+    // priority (i, higher starts first), hash (s, deduplication key, defaults to the bundle)
+    dbus_int32_t priority = 0;
+    const char* hash = "";
+    dbus_message_iter_recurse(&iter, &dict_iter);
+    for (; dbus_message_iter_get_arg_type(&dict_iter) == DBUS_TYPE_DICT_ENTRY; dbus_message_iter_next(&dict_iter)) {
+        DBusMessageIter entry_iter, value_iter;
+        const char* key = nullptr;
+        dbus_message_iter_recurse(&dict_iter, &entry_iter);
+        dbus_message_iter_get_basic(&entry_iter, &key);
+        dbus_message_iter_next(&entry_iter);
+        dbus_message_iter_recurse(&entry_iter, &value_iter);
+        int type = dbus_message_iter_get_arg_type(&value_iter);
+
+        if (strcmp(key, "priority") == 0 && type == DBUS_TYPE_INT32) {
+            dbus_message_iter_get_basic(&value_iter, &priority);
+        } else if (strcmp(key, "hash") == 0 && type == DBUS_TYPE_STRING) {
+            dbus_message_iter_get_basic(&value_iter, &hash);
+        } else {
+            return createErrorReply(message, "org.freedesktop.DBus.Error.InvalidArgs",
+                                    "Unknown or mistyped option: " + std::string(key));
+        }
+    }
+    if (bundle[0] == '\0' || !isQueueField(bundle) || !isQueueField(hash)) {
+        return createErrorReply(message, "org.freedesktop.DBus.Error.InvalidArgs", "Invalid bundle or hash");
+    }
+
+    InstallQueue::Added added = install_queue_.add(bundle, hash, priority);
+    usvc_info(calls, "Install job queued: ", DLT_UINT32(added.id), DLT_STRING(bundle), DLT_CSTRING("priority:"),
+              DLT_INT32(priority), DLT_CSTRING("deduplicated:"), DLT_BOOL(added.deduplicated));
+
+    DBusMessage* reply = dbus_message_new_method_return(message);
+    dbus_uint32_t job_id = added.id;
+    dbus_bool_t deduplicated = added.deduplicated;
+    if (reply) {
+        dbus_message_append_args(reply, DBUS_TYPE_UINT32, &job_id, DBUS_TYPE_BOOLEAN, &deduplicated, DBUS_TYPE_INVALID);
+    }
+    startNextJob();
+    return reply;
+}
+
+DBusMessage* UpdateService::handleCancelJob(DBusMessage* message) {
+    dbus_uint32_t job_id = 0;
+    if (!dbus_message_get_args(message, nullptr, DBUS_TYPE_UINT32, &job_id, DBUS_TYPE_INVALID)) {
+        return createErrorReply(message, "org.freedesktop.DBus.Error.InvalidArgs", "Expected job id");
+    }
+    const InstallQueue::Job* job = install_queue_.find(job_id);
+    if (!job) {
+        return createErrorReply(message, "org.freedesktop.UpdateService.Error.UnknownJob",
+                                "No queued job " + std::to_string(job_id));
+    }
+    if (job->state == InstallQueue::State::Running) {
+        return createErrorReply(message, "org.freedesktop.UpdateService.Error.JobRunning",
+                                "Job " + std::to_string(job_id) + " is already installing");
+    }
+    install_queue_.cancel(job_id);
+    usvc_info(calls, "Install job cancelled: ", DLT_UINT32(job_id));
+    return dbus_message_new_method_return(message);
+}
+
+DBusMessage* UpdateService::handleGetQueue(DBusMessage* message) {
+    DBusMessage* reply = dbus_message_new_method_return(message);
+    if (!reply) {
+        return nullptr;
+    }
+
+    // a(usiss): id, state, priority, bundle, hash in start order
+    DBusMessageIter iter, array_iter, job_iter;
+    dbus_message_iter_init_append(reply, &iter);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "(usiss)", &array_iter);
+    for (const InstallQueue::Job& job : install_queue_.jobs()) {
+        dbus_uint32_t id = job.id;
+        const char* state = InstallQueue::stateName(job.state);
+        dbus_int32_t priority = job.priority;
+        const char* bundle = job.bundle.c_str();
+        const char* hash = job.hash.c_str();
+        dbus_message_iter_open_container(&array_iter, DBUS_TYPE_STRUCT, nullptr, &job_iter);
+        dbus_message_iter_append_basic(&job_iter, DBUS_TYPE_UINT32, &id);
+        dbus_message_iter_append_basic(&job_iter, DBUS_TYPE_STRING, &state);
+        dbus_message_iter_append_basic(&job_iter, DBUS_TYPE_INT32, &priority);
+        dbus_message_iter_append_basic(&job_iter, DBUS_TYPE_STRING, &bundle);
+        dbus_message_iter_append_basic(&job_iter, DBUS_TYPE_STRING, &hash);
+        dbus_message_iter_close_container(&array_iter, &job_iter);
+    }
+    dbus_message_iter_close_container(&iter, &array_iter);
+    return reply;
+}
 
-    if (sent) {
-        logInfo("Progress signal sent to update-agent: " + std::to_string(percentage) + "%");
+void UpdateService::startNextJob() {
+    // RAUC runs one installation at a time: wait for Completed and for direct Install calls it has not answered
+    if (installation_active_ || install_calls_ > 0 || job_call_ || install_queue_.size() == 0 || !requireRauc()) {
+        return;
+    }
+    const InstallQueue::Job* job = install_queue_.startNext();
+    if (!job) {
+        return;
+    }
+    dbus_uint32_t job_id = job->id;
+    const char* bundle = job->bundle.c_str();
+
+    // InstallBundle(source, args): RAUC answers once it has accepted the bundle, Completed follows
+    DBusMessage* call = dbus_message_new_method_call(RAUC_SERVICE_NAME, RAUC_OBJECT_PATH, RAUC_INTERFACE_NAME,
+                                                     "InstallBundle");
+    DBusMessageIter iter, args_iter;
+    bool built = call != nullptr;
+    if (built) {
+        dbus_message_iter_init_append(call, &iter);
+        built = dbus_message_iter_append_basic(&iter, DBUS_TYPE_STRING, &bundle) &&
+                dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "{sv}", &args_iter) &&
+                dbus_message_iter_close_container(&iter, &args_iter);
+    }
+
+    DBusPendingCall* pending = nullptr;
+    if (built && dbus_connection_send_with_reply(rauc_connection_, call, &pending, RAUC_CALL_TIMEOUT_MS) && pending &&
+        dbus_pending_call_set_notify(pending, onJobInstallReply, this, nullptr)) {
+        job_call_ = pending;
+        setInstallationActive(true);
+        usvc_info(calls, "Install job started: ", DLT_UINT32(job_id), DLT_STRING(bundle));
+
+        DBusMessage* signal = dbus_message_new_signal(OBJECT_PATH, INTERFACE_NAME, "JobStarted");
+        if (signal && dbus_message_append_args(signal, DBUS_TYPE_UINT32, &job_id, DBUS_TYPE_STRING, &bundle,
+                                               DBUS_TYPE_INVALID) &&
+            dbus_connection_send(service_connection_, signal, nullptr)) {
+            signal_counters_.broadcast++;
+        }
+        if (signal) {
+            dbus_message_unref(signal);
+        }
     } else {
-        logError("Failed to send Progress signal to update-agent");
+        if (pending) {
+            dbus_pending_call_cancel(pending);
+            dbus_pending_call_unref(pending);
+        }
+        finishRunningJob(false, "Failed to send InstallBundle to RAUC");
+    }
+    if (call) {
+        dbus_message_unref(call);
+    }
+}
+
+void UpdateService::onJobInstallReply(DBusPendingCall* pending, void* user_data) {
+    UpdateService* service = static_cast<UpdateService*>(user_data);
+    DBusMessage* rauc_reply = dbus_pending_call_steal_reply(pending);
+    dbus_pending_call_unref(pending);
+    service->job_call_ = nullptr;
+
+    // Accepted: the job runs until RAUC's Completed signal
+    if (rauc_reply && dbus_message_get_type(rauc_reply) == DBUS_MESSAGE_TYPE_METHOD_RETURN) {
+        dbus_message_unref(rauc_reply);
+        return;
+    }
+
+    const char* error_message = nullptr;
+    if (rauc_reply) {
+        dbus_message_get_args(rauc_reply, nullptr, DBUS_TYPE_STRING, &error_message, DBUS_TYPE_INVALID);
+    }
+    service->setInstallationActive(false);
+    service->finishRunningJob(false, error_message ? error_message : "RAUC did not accept the installation");
+    if (rauc_reply) {
+        dbus_message_unref(rauc_reply);
+    }
+}
+
+void UpdateService::finishRunningJob(bool success, const char* message) {
+    dbus_uint32_t job_id = install_queue_.finishRunning();
+    if (job_id == 0) {
+        return;
+    }
+    usvc_info(calls, "Install job finished: ", DLT_UINT32(job_id), DLT_BOOL(success), DLT_STRING(message));
+
+    DBusMessage* signal = dbus_message_new_signal(OBJECT_PATH, INTERFACE_NAME, "JobCompleted");
+    dbus_bool_t result = success;
+    if (signal && dbus_message_append_args(signal, DBUS_TYPE_UINT32, &job_id, DBUS_TYPE_BOOLEAN, &result,
+                                           DBUS_TYPE_STRING, &message, DBUS_TYPE_INVALID) &&
+        dbus_connection_send(service_connection_, signal, nullptr)) {
+        signal_counters_.broadcast++;
+    }
+    if (signal) {
+        dbus_message_unref(signal);
+    }
+    startNextJob();
+}
+
+void UpdateService::cancelJobCall() {
+    if (job_call_) {
+        dbus_pending_call_cancel(job_call_);
+        dbus_pending_call_unref(job_call_);
+        job_call_ = nullptr;
+    }
+}
+
+void UpdateService::sendUnicast(DBusMessage* signal, const std::string& destination) {
+    DBusMessage* copy = dbus_message_copy(signal);
+    if (!copy) {
+        return;
+    }
+    if (dbus_message_set_destination(copy, destination.c_str()) &&
+        dbus_connection_send(service_connection_, copy, nullptr)) {
+        signal_counters_.unicast++;
+        // The same signal was broadcast: a subscriber that also has a match rule for it gets it twice
+        if (broadcast_signals_) {
+            signal_counters_.duplicate++;
+        }
+    }
+    dbus_message_unref(copy);
+}
+
+void UpdateService::sendProgressToClients(int percentage) {
+    if (clients_.size() == 0) {
+        return;
+    }
+
+    std::vector<std::string> targets = clients_.progressTargets(percentage, ClientRegistry::Clock::now());
+    if (!targets.empty()) {
+        DBusMessage* signal = dbus_message_new_signal(OBJECT_PATH, INTERFACE_NAME, "Progress");
+        dbus_int32_t progress = percentage;
+        if (signal && dbus_message_append_args(signal, DBUS_TYPE_INT32, &progress, DBUS_TYPE_INVALID)) {
+            for (const std::string& client : targets) {
+                sendUnicast(signal, client);
+            }
+        }
+        if (signal) {
+            dbus_message_unref(signal);
+        }
+    }
+    loop_.setTimerEnabled(coalesce_timer_, clients_.hasPendingProgress());
+}
+
+void UpdateService::flushCoalescedProgress() {
+    for (const auto& due : clients_.takeDueProgress(ClientRegistry::Clock::now())) {
+        DBusMessage* signal = dbus_message_new_signal(OBJECT_PATH, INTERFACE_NAME, "Progress");
+        dbus_int32_t progress = due.second;
+        if (signal && dbus_message_append_args(signal, DBUS_TYPE_INT32, &progress, DBUS_TYPE_INVALID)) {
+            sendUnicast(signal, due.first);
+        }
+        if (signal) {
+            dbus_message_unref(signal);
+        }
     }
+    loop_.setTimerEnabled(coalesce_timer_, clients_.hasPendingProgress());
 }
@@ -1,6 +1,14 @@
 #pragma once
 
+#include "event_loop.h"
+#include "client_registry.h"
+#include "install_queue.h"
+#include "latency_histogram.h"
+#include "property_cache.h"
 #include <dbus/dbus.h>
+#include <chrono>
+#include <map>
+#include <set>
 #include <string>
 #include <functional>
 #include <memory>
@@ -24,28 +32,81 @@ public:
     bool initialize();
 
     /**
-     * @brief Start the service main loop
+     * @brief Run the event loop until stop() is called, then tear down
      */
     void run();
 
     /**
-     * @brief Stop the service
+     * @brief Stop the service; safe to call from signal handlers and other threads
      */
     void stop();
 
 private:
+    friend struct IdleExitProbe;  // tests/test_idle_exit.cpp
+
+
     // D-Bus connection for serving our interface
     DBusConnection* service_connection_;
 
     // D-Bus connection for communicating with RAUC
     DBusConnection* rauc_connection_;
 
+    // fd-driven main loop and its timers
+    EventLoop loop_;
+    int reconnect_timer_;
+    int progress_timer_;
+    int coalesce_timer_;
+    int idle_timer_;
+
+    // Idle exit interval (UPDATE_SERVICE_IDLE_EXIT_SEC), 0 when the broker runs permanently
+    int idle_exit_ms_;
+
+    // Also broadcast Progress/Completed/PropertiesChanged for match-rule listeners (UPDATE_SERVICE_BROADCAST_SIGNALS)
+    bool broadcast_signals_;
+
+    // A forwarded call waiting for RAUC; correlates the RAUC reply with the client request
+    struct PendingForward {
+        UpdateService* service;
+        DBusMessage* request;          // client call to answer (reference held)
+        DBusPendingCall* pending;
+        std::string stats_key;         // RAUC method, or "Get(<property>)"
+        std::string property_name;     // set for Properties.Get forwards
+        bool all_properties;           // Properties.GetAll forward
+        bool install_call;             // direct Install/InstallBundle
+        bool owns_installation;        // install call that marked the installation active
+        std::chrono::steady_clock::time_point started;
+    };
+
+    std::set<PendingForward*> in_flight_;
+    std::map<std::string, LatencyHistogram> call_latency_;
+
+    // RAUC property values answered locally (see PropertyCache)
+    PropertyCache property_cache_;
+
+    // Clients receiving unicast Progress/Completed, and signal traffic counters
+    ClientRegistry clients_;
+    struct SignalCounters {
+        uint64_t received = 0;   // RAUC signals handled
+        uint64_t broadcast = 0;  // signals broadcast on our interface
+        uint64_t unicast = 0;    // signals sent to subscribed clients
+        uint64_t duplicate = 0;  // unicasts of a signal that was also broadcast
+    } signal_counters_;
+
+    // Queued installations; the running job's InstallBundle call while RAUC has not accepted it
+    InstallQueue install_queue_;
+    DBusPendingCall* job_call_;
+
     // Service state
-    bool running_;
     bool connected_to_rauc_;
-    bool installation_active_;
+    bool rauc_wanted_;      // connect (and reconnect) to RAUC; deferred to first use with idle exit
+    bool name_released_;    // idle exit in progress
+    bool installation_active_;  // RAUC runs (or is about to run) an installation until Completed
+    int install_calls_;         // direct Install/InstallBundle calls RAUC has not answered yet
     int last_progress_percentage_;
 
+    // Outstanding fallback Progress poll (at most one)
+    DBusPendingCall* progress_poll_;
+
     /**
      * @brief Connect to RAUC D-Bus service
      * @return true if successful, false otherwise
@@ -57,6 +118,34 @@ private:
      */
     void disconnectFromRauc();
 
+    /**
+     * @brief Retry the RAUC connection (reconnect timer)
+     */
+    void reconnectToRauc();
+
+    /**
+     * @brief Connect to RAUC on first use if that was deferred
+     * @return true if connected
+     */
+    bool requireRauc();
+
+    /**
+     * @brief No subscribed clients, forwarded calls, queued jobs or running installation
+     */
+    bool isIdle() const;
+
+    /**
+     * @brief Idle timer: release the service name and stop the loop if still idle
+     *
+     * Calls that reach the broker after the release get Error.Exiting.
+     */
+    void exitIfIdle();
+
+    /**
+     * @brief Release connections and the service name once the loop has stopped
+     */
+    void shutdown();
+
     /**
      * @brief Register our D-Bus service
      * @return true if successful, false otherwise
@@ -80,6 +169,15 @@ private:
      */
     DBusHandlerResult handleMethodCall(DBusMessage* message);
 
+    // Method and property dispatch tables, terminated by a nullptr name
+    struct Handler {
+        const char* name;
+        DBusMessage* (UpdateService::*handle)(DBusMessage* message);
+    };
+    static const Handler METHOD_HANDLERS[];
+    static const Handler PROPERTY_HANDLERS[];
+    static const Handler* findHandler(const Handler* table, const char* name);
+
     /**
      * @brief Handle property get/set requests
      */
@@ -92,11 +190,23 @@ private:
                                              DBusMessage* message,
                                              void* user_data);
 
+    /**
+     * @brief Service connection filter dropping subscriptions of clients that left the bus
+     */
+    static DBusHandlerResult clientSignalHandler(DBusConnection* connection,
+                                                DBusMessage* message,
+                                                void* user_data);
+
     /**
      * @brief Forward RAUC signals to our clients
      */
     void forwardRaucSignal(DBusMessage* message);
 
+    /**
+     * @brief Forward RAUC Progress/Operation/LastError changes to our clients
+     */
+    void forwardRaucPropertiesChanged(DBusMessage* message);
+
     // Method implementations that forward to RAUC
     DBusMessage* handleInstall(DBusMessage* message);
     DBusMessage* handleInstallBundle(DBusMessage* message);
@@ -115,41 +225,163 @@ private:
     DBusMessage* handleGetVariant(DBusMessage* message);
     DBusMessage* handleGetBootSlot(DBusMessage* message);
 
+    // Client subscriptions for unicast signals
+    DBusMessage* handleSubscribe(DBusMessage* message);
+    DBusMessage* handleUnsubscribe(DBusMessage* message);
+
+    // Install job queue
+    DBusMessage* handleQueueInstall(DBusMessage* message);
+    DBusMessage* handleCancelJob(DBusMessage* message);
+    DBusMessage* handleGetQueue(DBusMessage* message);
+
+    /**
+     * @brief Start the next queued job when RAUC is connected and no installation is running
+     */
+    void startNextJob();
+
+    /**
+     * @brief Pending call notification for a job's InstallBundle: a RAUC error fails the job
+     */
+    static void onJobInstallReply(DBusPendingCall* pending, void* user_data);
+
+    /**
+     * @brief Report the running job's result (JobCompleted) and start the next one
+     */
+    void finishRunningJob(bool success, const char* message);
+
+    /**
+     * @brief Drop an outstanding job InstallBundle call (shutdown)
+     */
+    void cancelJobCall();
+
     /**
-     * @brief Forward method call to RAUC
+     * @brief Send a copy of a signal to one client
+     */
+    void sendUnicast(DBusMessage* signal, const std::string& destination);
+
+    /**
+     * @brief Deliver a percentage to subscribed clients, coalescing per their options
+     */
+    void sendProgressToClients(int percentage);
+
+    /**
+     * @brief Send coalesced percentages whose client interval has passed (coalesce timer)
+     */
+    void flushCoalescedProgress();
+
+    // Broker statistics properties
+    DBusMessage* handleGetCallLatency(DBusMessage* message);
+    DBusMessage* handleGetLatencyBuckets(DBusMessage* message);
+    DBusMessage* handleGetPendingCalls(DBusMessage* message);
+    void appendCallLatency(DBusMessageIter* iter);
+    void appendLatencyBuckets(DBusMessageIter* iter);
+    void appendPendingCalls(DBusMessageIter* iter);
+    DBusMessage* handleGetSignalCounters(DBusMessage* message);
+    void appendSignalCounters(DBusMessageIter* iter);
+
+    /**
+     * @brief Properties.GetAll: answered from the cache, filled from RAUC's GetAll when incomplete
+     */
+    DBusMessage* handleGetAll(DBusMessage* message);
+
+    /**
+     * @brief Build the GetAll reply from the cache and the broker statistics
+     */
+    DBusMessage* buildAllPropertiesReply(DBusMessage* request);
+
+    /**
+     * @brief Store the cacheable values of a RAUC GetAll reply
+     */
+    void cacheAllProperties(DBusMessage* rauc_reply);
+
+    /**
+     * @brief Forward method call to RAUC without blocking
      * @param rauc_method_name The original RAUC method name
      * @param message The incoming D-Bus message
-     * @return D-Bus reply message
+     * @param install_call Install/InstallBundle: marks the installation active unless one is already running
+     * @return Error reply if the call could not be sent, nullptr if the reply follows from onRaucReply()
      */
-    DBusMessage* forwardToRauc(const std::string& rauc_method_name, DBusMessage* message);
+    DBusMessage* forwardToRauc(const std::string& rauc_method_name, DBusMessage* message, bool install_call = false);
 
     /**
-     * @brief Get property from RAUC
+     * @brief Get property from RAUC without blocking
      * @param property_name The RAUC property name
      * @param original_message The original D-Bus message to create reply for
-     * @return D-Bus reply message
+     * @return Error reply if the call could not be sent, nullptr if the reply follows from onRaucReply()
      */
     DBusMessage* getRaucProperty(const std::string& property_name, DBusMessage* original_message);
 
+    /**
+     * @brief Send a call to RAUC and track it until the reply arrives
+     * @return The tracked call, nullptr if it could not be queued
+     */
+    PendingForward* sendToRauc(DBusMessage* rauc_call, DBusMessage* request,
+                    const std::string& stats_key, const std::string& property_name,
+                    bool all_properties = false);
+
+    /**
+     * @brief Pending call notification: record latency and answer the client
+     */
+    static void onRaucReply(DBusPendingCall* pending, void* user_data);
+    static void freePendingForward(void* data);
+
+    /**
+     * @brief Cancel calls still waiting for RAUC (shutdown)
+     */
+    void cancelPendingForwards();
+
+    /**
+     * @brief Build the client reply for a forwarded method or property call
+     * @param rauc_reply RAUC's reply, nullptr if none was received
+     */
+    DBusMessage* buildMethodReply(DBusMessage* request, DBusMessage* rauc_reply, const std::string& rauc_method_name);
+    DBusMessage* buildPropertyReply(DBusMessage* original_message, DBusMessage* rauc_reply,
+                                    const std::string& property_name);
+
+    /**
+     * @brief Wrap a RAUC Properties.Get reply value into our Properties.Get reply
+     * @return nullptr if RAUC returned an error or an unparsable reply
+     */
+    DBusMessage* wrapRaucProperty(DBusMessage* original_message, DBusMessage* rauc_reply,
+                                  const std::string& property_name);
+
+    /**
+     * @brief Send a reply on the service connection and release it
+     */
+    void sendReply(DBusMessage* reply);
+
     /**
      * @brief Create error reply
      */
     DBusMessage* createErrorReply(DBusMessage* message, const std::string& error_name, const std::string& error_message);
 
     /**
-     * @brief Poll RAUC Progress property and forward if changed
+     * @brief Arm or disarm the Progress fallback poll for a running installation
+     */
+    void setInstallationActive(bool active);
+
+    /**
+     * @brief Fallback when RAUC sent no PropertiesChanged for a while: query Progress without blocking
      */
     void pollAndForwardProgress();
 
     /**
-     * @brief Send Progress signal to update-agent
+     * @brief Pending call notification for the fallback Progress poll
      */
-    void sendProgressSignal(int percentage, const std::string& message);
+    static void onProgressPollReply(DBusPendingCall* pending, void* user_data);
 
     /**
-     * @brief Log messages with DLT
+     * @brief Drop an outstanding fallback Progress poll
+     */
+    void cancelProgressPoll();
+
+    /**
+     * @brief Forward a RAUC Progress value, positioned at its (isi) struct, if the percentage changed
+     */
+    void updateProgress(DBusMessageIter* progress);
+
+    /**
+     * @brief Send Progress signal to update-agent
      */
-    void logInfo(const std::string& message);
-    void logError(const std::string& message);
-    void logDebug(const std::string& message);
+    void sendProgressSignal(int percentage);
 };
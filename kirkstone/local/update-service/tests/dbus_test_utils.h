@@ -0,0 +1,139 @@
+#ifndef DBUS_TEST_UTILS_H
+#define DBUS_TEST_UTILS_H
+
+#include <dbus/dbus.h>
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+
+// Helpers shared by the copier and broker round-trip tests. dump*() renders
+// values independently of dbus_copy, so comparing two dumps checks a copy.
+namespace dbus_test {
+
+inline void dumpValue(DBusMessageIter* iter, std::string& out);
+
+inline void dumpContainer(DBusMessageIter* iter, std::string& out, char open, char close) {
+    DBusMessageIter sub;
+    dbus_message_iter_recurse(iter, &sub);
+    out += open;
+    bool first = true;
+    while (dbus_message_iter_get_arg_type(&sub) != DBUS_TYPE_INVALID) {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+        dumpValue(&sub, out);
+        dbus_message_iter_next(&sub);
+    }
+    out += close;
+}
+
+inline void dumpValue(DBusMessageIter* iter, std::string& out) {
+    int type = dbus_message_iter_get_arg_type(iter);
+    char buffer[64];
+
+    switch (type) {
+    case DBUS_TYPE_ARRAY: {
+        char* signature = dbus_message_iter_get_signature(iter);
+        out += signature;
+        dbus_free(signature);
+        dumpContainer(iter, out, '[', ']');
+        return;
+    }
+    case DBUS_TYPE_STRUCT:
+        dumpContainer(iter, out, '(', ')');
+        return;
+    case DBUS_TYPE_DICT_ENTRY:
+        dumpContainer(iter, out, '{', '}');
+        return;
+    case DBUS_TYPE_VARIANT: {
+        DBusMessageIter sub;
+        dbus_message_iter_recurse(iter, &sub);
+        char* signature = dbus_message_iter_get_signature(&sub);
+        out += "v<";
+        out += signature;
+        out += ">:";
+        dbus_free(signature);
+        dumpValue(&sub, out);
+        return;
+    }
+    case DBUS_TYPE_STRING:
+    case DBUS_TYPE_OBJECT_PATH:
+    case DBUS_TYPE_SIGNATURE: {
+        const char* value = nullptr;
+        dbus_message_iter_get_basic(iter, &value);
+        out += static_cast<char>(type);
+        out += '"';
+        out += value;
+        out += '"';
+        return;
+    }
+    case DBUS_TYPE_DOUBLE: {
+        double value = 0;
+        dbus_message_iter_get_basic(iter, &value);
+        snprintf(buffer, sizeof(buffer), "d%.17g", value);
+        out += buffer;
+        return;
+    }
+    case DBUS_TYPE_UNIX_FD: {
+        int fd = -1;
+        dbus_message_iter_get_basic(iter, &fd);
+        out += fd >= 0 ? "h<fd>" : "h<invalid>";
+        return;
+    }
+    default: {
+        DBusBasicValue value;
+        value.u64 = 0;
+        dbus_message_iter_get_basic(iter, &value);
+        uint64_t number = type == DBUS_TYPE_BYTE ? value.byt
+                        : type == DBUS_TYPE_BOOLEAN ? value.bool_val
+                        : type == DBUS_TYPE_INT16 ? static_cast<uint64_t>(value.i16)
+                        : type == DBUS_TYPE_UINT16 ? value.u16
+                        : type == DBUS_TYPE_INT32 ? static_cast<uint64_t>(value.i32)
+                        : type == DBUS_TYPE_UINT32 ? value.u32
+                        : value.u64;
+        snprintf(buffer, sizeof(buffer), "%c%" PRIu64, static_cast<char>(type), number);
+        out += buffer;
+        return;
+    }
+    }
+}
+
+// "<signature>|<arg>;<arg>;..." for the whole message body
+inline std::string dumpArguments(DBusMessage* message) {
+    std::string out = dbus_message_get_signature(message);
+    out += '|';
+    DBusMessageIter iter;
+    if (dbus_message_iter_init(message, &iter)) {
+        do {
+            dumpValue(&iter, out);
+            out += ';';
+        } while (dbus_message_iter_next(&iter));
+    }
+    return out;
+}
+
+// Builders for the a{sv} dictionaries RAUC uses everywhere
+inline void appendVariant(DBusMessageIter* iter, int type, const void* value) {
+    char signature[2] = { static_cast<char>(type), '\0' };
+    DBusMessageIter variant;
+    dbus_message_iter_open_container(iter, DBUS_TYPE_VARIANT, signature, &variant);
+    dbus_message_iter_append_basic(&variant, type, value);
+    dbus_message_iter_close_container(iter, &variant);
+}
+
+inline void appendEntry(DBusMessageIter* dict, const char* key, int type, const void* value) {
+    DBusMessageIter entry;
+    dbus_message_iter_open_container(dict, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    appendVariant(&entry, type, value);
+    dbus_message_iter_close_container(dict, &entry);
+}
+
+inline void appendStringEntry(DBusMessageIter* dict, const char* key, const char* value) {
+    appendEntry(dict, key, DBUS_TYPE_STRING, &value);
+}
+
+} // namespace dbus_test
+
+#endif // DBUS_TEST_UTILS_H
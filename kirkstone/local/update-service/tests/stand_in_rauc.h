@@ -0,0 +1,186 @@
+#ifndef STAND_IN_RAUC_H
+#define STAND_IN_RAUC_H
+
+#include <dbus/dbus.h>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Private dbus-daemon for the broker tests. DBUS_SYSTEM_BUS_ADDRESS points
+ * at it, so UpdateService's dbus_bus_get(DBUS_BUS_SYSTEM) connects here.
+ */
+class PrivateBus {
+public:
+    bool start() {
+        FILE* daemon = popen("dbus-daemon --session --fork --print-address=1 --print-pid=1", "r");
+        if (!daemon) {
+            return false;
+        }
+        char address[512] = {};
+        char pid[32] = {};
+        bool ok = fgets(address, sizeof(address), daemon) && fgets(pid, sizeof(pid), daemon);
+        pclose(daemon);
+        if (!ok) {
+            return false;
+        }
+        address[strcspn(address, "\n")] = '\0';
+        address_ = address;
+        pid_ = atoi(pid);
+        setenv("DBUS_SYSTEM_BUS_ADDRESS", address_.c_str(), 1);
+        return pid_ > 0;
+    }
+
+    void stop() {
+        if (pid_ > 0) {
+            kill(pid_, SIGTERM);
+            pid_ = 0;
+        }
+    }
+
+    const std::string& address() const { return address_; }
+
+private:
+    std::string address_;
+    pid_t pid_ = 0;
+};
+
+/**
+ * Minimal stand-in for RAUC on the private bus: owns de.pengutronix.rauc,
+ * records every call it receives and answers with canned replies keyed by
+ * member ("Get:<property>" for Properties.Get).
+ */
+class StandInRauc {
+public:
+    using ReplyBuilder = std::function<DBusMessage*(DBusMessage* call)>;
+
+    ~StandInRauc() { stop(); }
+
+    bool start() {
+        connection_ = dbus_bus_get_private(DBUS_BUS_SYSTEM, nullptr);
+        if (!connection_) {
+            return false;
+        }
+        dbus_connection_set_exit_on_disconnect(connection_, FALSE);
+        if (dbus_bus_request_name(connection_, "de.pengutronix.rauc", DBUS_NAME_FLAG_DO_NOT_QUEUE, nullptr) !=
+            DBUS_REQUEST_NAME_REPLY_PRIMARY_OWNER) {
+            return false;
+        }
+
+        static const DBusObjectPathVTable vtable = { nullptr, handleMessage, nullptr, nullptr, nullptr, nullptr };
+        dbus_connection_register_object_path(connection_, "/", &vtable, this);
+
+        running_ = true;
+        thread_ = std::thread([this]() {
+            while (running_ && dbus_connection_read_write_dispatch(connection_, 20)) {
+            }
+        });
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        if (connection_) {
+            dbus_connection_close(connection_);
+            dbus_connection_unref(connection_);
+            connection_ = nullptr;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (DBusMessage* call : calls_) {
+            dbus_message_unref(call);
+        }
+        calls_.clear();
+    }
+
+    void setReply(const std::string& key, ReplyBuilder builder) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        replies_[key] = std::move(builder);
+    }
+
+    // Number of calls received for key
+    int callCount(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        int count = 0;
+        for (DBusMessage* call : calls_) {
+            count += keyFor(call) == key ? 1 : 0;
+        }
+        return count;
+    }
+
+    // Send a signal (PropertiesChanged, Completed, ...) as RAUC
+    bool emit(DBusMessage* signal) {
+        bool sent = dbus_connection_send(connection_, signal, nullptr);
+        dbus_connection_flush(connection_);
+        return sent;
+    }
+
+    // Most recent call received for key, with a reference for the caller (or nullptr)
+    DBusMessage* lastCall(const std::string& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = calls_.rbegin(); it != calls_.rend(); ++it) {
+            if (keyFor(*it) == key) {
+                return dbus_message_ref(*it);
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    DBusConnection* connection_ = nullptr;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::mutex mutex_;
+    std::vector<DBusMessage*> calls_;
+    std::map<std::string, ReplyBuilder> replies_;
+
+    static std::string keyFor(DBusMessage* call) {
+        std::string key = dbus_message_get_member(call);
+        if (key == "Get" && dbus_message_has_interface(call, "org.freedesktop.DBus.Properties")) {
+            const char* interface_name = nullptr;
+            const char* property_name = nullptr;
+            if (dbus_message_get_args(call, nullptr, DBUS_TYPE_STRING, &interface_name, DBUS_TYPE_STRING,
+                                      &property_name, DBUS_TYPE_INVALID)) {
+                key += ":";
+                key += property_name;
+            }
+        }
+        return key;
+    }
+
+    static DBusHandlerResult handleMessage(DBusConnection* connection, DBusMessage* message, void* user_data) {
+        StandInRauc* rauc = static_cast<StandInRauc*>(user_data);
+        if (dbus_message_get_type(message) != DBUS_MESSAGE_TYPE_METHOD_CALL) {
+            return DBUS_HANDLER_RESULT_NOT_YET_HANDLED;
+        }
+
+        std::string key = keyFor(message);
+        ReplyBuilder builder;
+        {
+            std::lock_guard<std::mutex> lock(rauc->mutex_);
+            rauc->calls_.push_back(dbus_message_ref(message));
+            auto it = rauc->replies_.find(key);
+            if (it != rauc->replies_.end()) {
+                builder = it->second;
+            }
+        }
+
+        DBusMessage* reply = builder
+            ? builder(message)
+            : dbus_message_new_error(message, "org.freedesktop.DBus.Error.UnknownMethod", key.c_str());
+        dbus_connection_send(connection, reply, nullptr);
+        dbus_message_unref(reply);
+        return DBUS_HANDLER_RESULT_HANDLED;
+    }
+};
+
+#endif // STAND_IN_RAUC_H
@@ -0,0 +1,932 @@
+#include <gtest/gtest.h>
+#include "update_service.h"
+#include "dbus_test_utils.h"
+#include "stand_in_rauc.h"
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <set>
+#include <thread>
+
+using dbus_test::appendEntry;
+using dbus_test::appendStringEntry;
+using dbus_test::dumpArguments;
+
+namespace {
+
+const char* const BROKER_NAME = "org.freedesktop.UpdateService";
+const char* const BROKER_PATH = "/org/freedesktop/UpdateService";
+const char* const BROKER_INTERFACE = "org.freedesktop.UpdateService";
+
+using Filler = std::function<void(DBusMessageIter*)>;
+
+// Reply builder appending the given arguments
+StandInRauc::ReplyBuilder replyWith(Filler fill) {
+    return [fill](DBusMessage* call) {
+        DBusMessage* reply = dbus_message_new_method_return(call);
+        DBusMessageIter iter;
+        dbus_message_iter_init_append(reply, &iter);
+        fill(&iter);
+        return reply;
+    };
+}
+
+void appendStrings(DBusMessageIter* iter, std::initializer_list<const char*> values) {
+    for (const char* value : values) {
+        dbus_message_iter_append_basic(iter, DBUS_TYPE_STRING, &value);
+    }
+}
+
+void appendInstallArgs(DBusMessageIter* iter) {
+    // InstallBundle/InspectBundle options: a{sv} with basic and container values
+    appendStrings(iter, { "https://updates.example.com/nuc-image-1.4.2.raucb" });
+    DBusMessageIter dict, entry, variant, headers;
+    dbus_message_iter_open_container(iter, DBUS_TYPE_ARRAY, "{sv}", &dict);
+    dbus_bool_t ignore = TRUE;
+    appendEntry(&dict, "ignore-compatible", DBUS_TYPE_BOOLEAN, &ignore);
+    appendStringEntry(&dict, "tls-key", "/etc/rauc/client.key");
+    const char* key = "http-headers";
+    dbus_message_iter_open_container(&dict, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "as", &variant);
+    dbus_message_iter_open_container(&variant, DBUS_TYPE_ARRAY, "s", &headers);
+    appendStrings(&headers, { "Authorization: TargetToken abc", "X-Device: nuc-device-001" });
+    dbus_message_iter_close_container(&variant, &headers);
+    dbus_message_iter_close_container(&entry, &variant);
+    dbus_message_iter_close_container(&dict, &entry);
+    dbus_message_iter_close_container(iter, &dict);
+}
+
+void appendSlotStatus(DBusMessageIter* iter) {
+    DBusMessageIter slots, slot, dict;
+    dbus_message_iter_open_container(iter, DBUS_TYPE_ARRAY, "(sa{sv})", &slots);
+    for (const char* name : { "rootfs.0", "rootfs.1", "efi.0" }) {
+        dbus_uint64_t size = 8589934592ULL;
+        dbus_uint32_t installed = 12;
+        dbus_message_iter_open_container(&slots, DBUS_TYPE_STRUCT, nullptr, &slot);
+        dbus_message_iter_append_basic(&slot, DBUS_TYPE_STRING, &name);
+        dbus_message_iter_open_container(&slot, DBUS_TYPE_ARRAY, "{sv}", &dict);
+        appendStringEntry(&dict, "class", "rootfs");
+        appendStringEntry(&dict, "state", name[7] == '0' ? "booted" : "inactive");
+        appendStringEntry(&dict, "boot-status", "good");
+        appendEntry(&dict, "size", DBUS_TYPE_UINT64, &size);
+        appendEntry(&dict, "installed.count", DBUS_TYPE_UINT32, &installed);
+        dbus_message_iter_close_container(&slot, &dict);
+        dbus_message_iter_close_container(&slots, &slot);
+    }
+    dbus_message_iter_close_container(iter, &slots);
+}
+
+void appendArtifactStatus(DBusMessageIter* iter) {
+    // aa{sv}: one dict per repository, artifacts nested as a variant holding aa{sv}
+    DBusMessageIter repos, repo, entry, variant, artifacts, artifact;
+    dbus_message_iter_open_container(iter, DBUS_TYPE_ARRAY, "a{sv}", &repos);
+    dbus_message_iter_open_container(&repos, DBUS_TYPE_ARRAY, "{sv}", &repo);
+    appendStringEntry(&repo, "name", "apps");
+    appendStringEntry(&repo, "type", "composefs");
+    const char* key = "artifacts";
+    dbus_message_iter_open_container(&repo, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "aa{sv}", &variant);
+    dbus_message_iter_open_container(&variant, DBUS_TYPE_ARRAY, "a{sv}", &artifacts);
+    dbus_message_iter_open_container(&artifacts, DBUS_TYPE_ARRAY, "{sv}", &artifact);
+    appendStringEntry(&artifact, "name", "dashboard");
+    appendStringEntry(&artifact, "checksum", "sha256:a03b221c6c6eae71");
+    dbus_message_iter_close_container(&artifacts, &artifact);
+    dbus_message_iter_close_container(&variant, &artifacts);
+    dbus_message_iter_close_container(&entry, &variant);
+    dbus_message_iter_close_container(&repo, &entry);
+    dbus_message_iter_close_container(&repos, &repo);
+    dbus_message_iter_close_container(iter, &repos);
+}
+
+void appendBundleInfo(DBusMessageIter* iter) {
+    DBusMessageIter dict, entry, variant, update;
+    dbus_message_iter_open_container(iter, DBUS_TYPE_ARRAY, "{sv}", &dict);
+    appendStringEntry(&dict, "manifest-hash", "9f86d081884c7d659a2feaa0c55ad015");
+    const char* key = "update";
+    dbus_message_iter_open_container(&dict, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "a{sv}", &variant);
+    dbus_message_iter_open_container(&variant, DBUS_TYPE_ARRAY, "{sv}", &update);
+    appendStringEntry(&update, "compatible", "intel-corei7-64");
+    appendStringEntry(&update, "version", "1.4.2");
+    dbus_message_iter_close_container(&variant, &update);
+    dbus_message_iter_close_container(&entry, &variant);
+    dbus_message_iter_close_container(&dict, &entry);
+    dbus_message_iter_close_container(iter, &dict);
+}
+
+// Value of one SignalCounters entry in a dumpArguments() string
+uint64_t counterValue(const std::string& counters, const char* name) {
+    std::string key = std::string("{s\"") + name + "\",t";
+    size_t pos = counters.find(key);
+    return pos == std::string::npos ? UINT64_MAX : std::stoull(counters.substr(pos + key.size()));
+}
+
+} // namespace
+
+class BrokerRoundTripTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        dbus_threads_init_default();
+        bus_ = new PrivateBus();
+        ASSERT_TRUE(bus_->start()) << "dbus-daemon is required for the broker tests";
+
+        // RAUC must own its name before the broker connects to it
+        rauc_ = new StandInRauc();
+        ASSERT_TRUE(rauc_->start());
+
+        // Keep the install queue in memory; the suite follows signals with match rules
+        setenv("UPDATE_SERVICE_QUEUE_FILE", "", 1);
+        setenv("UPDATE_SERVICE_BROADCAST_SIGNALS", "1", 1);
+        service_ = new UpdateService();
+        ASSERT_TRUE(service_->initialize());
+        loop_ = new std::thread([]() { service_->run(); });
+
+        client_ = dbus_bus_get_private(DBUS_BUS_SYSTEM, nullptr);
+        ASSERT_NE(client_, nullptr);
+        dbus_connection_set_exit_on_disconnect(client_, FALSE);
+    }
+
+    static void TearDownTestSuite() {
+        if (client_) {
+            dbus_connection_close(client_);
+            dbus_connection_unref(client_);
+            client_ = nullptr;
+        }
+        if (service_) {
+            service_->stop();
+        }
+        if (loop_) {
+            loop_->join();
+            delete loop_;
+            loop_ = nullptr;
+        }
+        delete service_;
+        service_ = nullptr;
+        delete rauc_;
+        rauc_ = nullptr;
+        if (bus_) {
+            bus_->stop();
+            delete bus_;
+            bus_ = nullptr;
+        }
+    }
+
+    // Calls the broker and returns its reply (error replies included)
+    static DBusMessage* callBroker(DBusMessage* call) {
+        DBusPendingCall* pending = nullptr;
+        if (!dbus_connection_send_with_reply(client_, call, &pending, 5000) || !pending) {
+            return nullptr;
+        }
+        dbus_pending_call_block(pending);
+        DBusMessage* reply = dbus_pending_call_steal_reply(pending);
+        dbus_pending_call_unref(pending);
+        return reply;
+    }
+
+    // Round-trips one method: arguments must reach RAUC unchanged and RAUC's
+    // reply must reach the client unchanged
+    void expectMethodRoundTrip(const char* method, Filler call_args, Filler reply_args) {
+        rauc_->setReply(method, replyWith(reply_args));
+
+        DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, method);
+        DBusMessageIter iter;
+        dbus_message_iter_init_append(call, &iter);
+        call_args(&iter);
+
+        DBusMessage* reply = callBroker(call);
+        ASSERT_NE(reply, nullptr) << method;
+        ASSERT_EQ(dbus_message_get_type(reply), DBUS_MESSAGE_TYPE_METHOD_RETURN)
+            << method << ": " << (dbus_message_get_error_name(reply) ? dbus_message_get_error_name(reply) : "");
+
+        DBusMessage* forwarded = rauc_->lastCall(method);
+        ASSERT_NE(forwarded, nullptr) << method;
+        EXPECT_EQ(dumpArguments(forwarded), dumpArguments(call)) << method;
+        EXPECT_STREQ(dbus_message_get_interface(forwarded), "de.pengutronix.rauc.Installer");
+
+        DBusMessage* expected = dbus_message_new_method_return(call);
+        dbus_message_iter_init_append(expected, &iter);
+        reply_args(&iter);
+        EXPECT_EQ(dumpArguments(reply), dumpArguments(expected)) << method;
+
+        dbus_message_unref(expected);
+        dbus_message_unref(forwarded);
+        dbus_message_unref(reply);
+        dbus_message_unref(call);
+    }
+
+    void expectPropertyRoundTrip(const char* property, const char* signature, Filler value) {
+        dropCachedProperty(property);
+        rauc_->setReply(std::string("Get:") + property, replyWith([&](DBusMessageIter* iter) {
+            DBusMessageIter variant;
+            dbus_message_iter_open_container(iter, DBUS_TYPE_VARIANT, signature, &variant);
+            value(&variant);
+            dbus_message_iter_close_container(iter, &variant);
+        }));
+
+        DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, "org.freedesktop.DBus.Properties", "Get");
+        appendStrings((dbus_message_iter_init_append(call, &iter_), &iter_), { BROKER_INTERFACE, property });
+
+        DBusMessage* reply = callBroker(call);
+        ASSERT_NE(reply, nullptr) << property;
+        ASSERT_EQ(dbus_message_get_type(reply), DBUS_MESSAGE_TYPE_METHOD_RETURN) << property;
+
+        DBusMessage* expected = dbus_message_new_method_return(call);
+        DBusMessageIter iter, variant;
+        dbus_message_iter_init_append(expected, &iter);
+        dbus_message_iter_open_container(&iter, DBUS_TYPE_VARIANT, signature, &variant);
+        value(&variant);
+        dbus_message_iter_close_container(&iter, &variant);
+        EXPECT_EQ(dumpArguments(reply), dumpArguments(expected)) << property;
+
+        dbus_message_unref(expected);
+        dbus_message_unref(reply);
+        dbus_message_unref(call);
+    }
+
+    // Broker Properties.Get; returns the reply (error replies included)
+    DBusMessage* getProperty(const char* property) {
+        DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, "org.freedesktop.DBus.Properties", "Get");
+        appendStrings((dbus_message_iter_init_append(call, &iter_), &iter_), { BROKER_INTERFACE, property });
+        DBusMessage* reply = callBroker(call);
+        dbus_message_unref(call);
+        return reply;
+    }
+
+    // RAUC PropertiesChanged(de.pengutronix.rauc.Installer, changed, invalidated)
+    static void emitPropertiesChanged(Filler changed, std::initializer_list<const char*> invalidated) {
+        DBusMessage* signal = dbus_message_new_signal("/", "org.freedesktop.DBus.Properties", "PropertiesChanged");
+        DBusMessageIter iter, dict, names;
+        dbus_message_iter_init_append(signal, &iter);
+        appendStrings(&iter, { "de.pengutronix.rauc.Installer" });
+        dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "{sv}", &dict);
+        changed(&dict);
+        dbus_message_iter_close_container(&iter, &dict);
+        dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "s", &names);
+        appendStrings(&names, invalidated);
+        dbus_message_iter_close_container(&iter, &names);
+        rauc_->emit(signal);
+        dbus_message_unref(signal);
+    }
+
+    // RAUC Completed with its int32 result code (0 is success)
+    static void emitCompleted(dbus_int32_t result) {
+        DBusMessage* completed = dbus_message_new_signal("/", "de.pengutronix.rauc.Installer", "Completed");
+        dbus_message_append_args(completed, DBUS_TYPE_INT32, &result, DBUS_TYPE_INVALID);
+        rauc_->emit(completed);
+        dbus_message_unref(completed);
+    }
+
+    // QueueInstall(source, {priority, hash}); returns the reply arguments
+    static std::string queueInstall(const char* source, dbus_int32_t priority, const char* hash) {
+        DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "QueueInstall");
+        DBusMessageIter iter, dict;
+        dbus_message_iter_init_append(call, &iter);
+        appendStrings(&iter, { source });
+        dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "{sv}", &dict);
+        appendEntry(&dict, "priority", DBUS_TYPE_INT32, &priority);
+        if (hash) {
+            appendStringEntry(&dict, "hash", hash);
+        }
+        dbus_message_iter_close_container(&iter, &dict);
+        DBusMessage* reply = callBroker(call);
+        std::string arguments = reply ? dumpArguments(reply) : std::string("no reply");
+        if (reply) {
+            dbus_message_unref(reply);
+        }
+        dbus_message_unref(call);
+        return arguments;
+    }
+
+    // Wait until RAUC has received `count` calls for key (forwarding is asynchronous)
+    static bool waitForCalls(const std::string& key, int count) {
+        for (int i = 0; i < 100 && rauc_->callCount(key) < count; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        return rauc_->callCount(key) >= count;
+    }
+
+    // Next broker signal with this interface and member; others are dropped
+    static DBusMessage* waitForSignal(const char* interface, const char* member) {
+        for (int i = 0; i < 100; i++) {
+            while (DBusMessage* received = dbus_connection_pop_message(client_)) {
+                if (dbus_message_is_signal(received, interface, member)) {
+                    return received;
+                }
+                dbus_message_unref(received);
+            }
+            dbus_connection_read_write(client_, 20);
+        }
+        return nullptr;
+    }
+
+    // Make the broker forget a cached value (invalidating LastError too yields a signal to wait for)
+    static void dropCachedProperty(const char* property) {
+        dbus_bus_add_match(client_, "type='signal',path='/org/freedesktop/UpdateService'", nullptr);
+        emitPropertiesChanged([](DBusMessageIter*) {}, { property, "LastError" });
+        DBusMessage* changed = waitForSignal("org.freedesktop.DBus.Properties", "PropertiesChanged");
+        if (changed) {
+            dbus_message_unref(changed);
+        }
+        dbus_bus_remove_match(client_, "type='signal',path='/org/freedesktop/UpdateService'", nullptr);
+    }
+
+    static PrivateBus* bus_;
+    static StandInRauc* rauc_;
+    static UpdateService* service_;
+    static std::thread* loop_;
+    static DBusConnection* client_;
+    DBusMessageIter iter_;
+};
+
+PrivateBus* BrokerRoundTripTest::bus_ = nullptr;
+StandInRauc* BrokerRoundTripTest::rauc_ = nullptr;
+UpdateService* BrokerRoundTripTest::service_ = nullptr;
+std::thread* BrokerRoundTripTest::loop_ = nullptr;
+DBusConnection* BrokerRoundTripTest::client_ = nullptr;
+
+TEST_F(BrokerRoundTripTest, Install) {
+    expectMethodRoundTrip("Install",
+        [](DBusMessageIter* iter) { appendStrings(iter, { "/data/nuc-image-1.4.2.raucb" }); },
+        [](DBusMessageIter*) {});
+}
+
+TEST_F(BrokerRoundTripTest, InstallBundle) {
+    expectMethodRoundTrip("InstallBundle", appendInstallArgs, [](DBusMessageIter*) {});
+}
+
+TEST_F(BrokerRoundTripTest, Info) {
+    expectMethodRoundTrip("Info",
+        [](DBusMessageIter* iter) { appendStrings(iter, { "/data/nuc-image-1.4.2.raucb" }); },
+        [](DBusMessageIter* iter) { appendStrings(iter, { "intel-corei7-64", "1.4.2" }); });
+}
+
+TEST_F(BrokerRoundTripTest, InspectBundle) {
+    expectMethodRoundTrip("InspectBundle", appendInstallArgs, appendBundleInfo);
+}
+
+TEST_F(BrokerRoundTripTest, Mark) {
+    expectMethodRoundTrip("Mark",
+        [](DBusMessageIter* iter) { appendStrings(iter, { "good", "booted" }); },
+        [](DBusMessageIter* iter) { appendStrings(iter, { "rootfs.0", "marked slot rootfs.0 as good" }); });
+}
+
+TEST_F(BrokerRoundTripTest, GetSlotStatus) {
+    expectMethodRoundTrip("GetSlotStatus", [](DBusMessageIter*) {}, appendSlotStatus);
+}
+
+TEST_F(BrokerRoundTripTest, GetSlotStatusEmpty) {
+    expectMethodRoundTrip("GetSlotStatus", [](DBusMessageIter*) {}, [](DBusMessageIter* iter) {
+        DBusMessageIter slots;
+        dbus_message_iter_open_container(iter, DBUS_TYPE_ARRAY, "(sa{sv})", &slots);
+        dbus_message_iter_close_container(iter, &slots);
+    });
+}
+
+TEST_F(BrokerRoundTripTest, GetArtifactStatus) {
+    expectMethodRoundTrip("GetArtifactStatus", [](DBusMessageIter*) {}, appendArtifactStatus);
+}
+
+TEST_F(BrokerRoundTripTest, GetPrimary) {
+    expectMethodRoundTrip("GetPrimary", [](DBusMessageIter*) {},
+        [](DBusMessageIter* iter) { appendStrings(iter, { "rootfs.0" }); });
+}
+
+TEST_F(BrokerRoundTripTest, StringProperties) {
+    for (const char* property : { "Operation", "LastError", "Compatible", "Variant", "BootSlot" }) {
+        expectPropertyRoundTrip(property, "s", [property](DBusMessageIter* iter) {
+            appendStrings(iter, { property });
+        });
+    }
+}
+
+TEST_F(BrokerRoundTripTest, ProgressProperty) {
+    expectPropertyRoundTrip("Progress", "(isi)", [](DBusMessageIter* iter) {
+        DBusMessageIter progress;
+        dbus_int32_t percentage = 60;
+        const char* message = "Copying image to rootfs.1";
+        dbus_int32_t depth = 2;
+        dbus_message_iter_open_container(iter, DBUS_TYPE_STRUCT, nullptr, &progress);
+        dbus_message_iter_append_basic(&progress, DBUS_TYPE_INT32, &percentage);
+        dbus_message_iter_append_basic(&progress, DBUS_TYPE_STRING, &message);
+        dbus_message_iter_append_basic(&progress, DBUS_TYPE_INT32, &depth);
+        dbus_message_iter_close_container(iter, &progress);
+    });
+}
+
+TEST_F(BrokerRoundTripTest, RaucErrorsArePassedThrough) {
+    rauc_->setReply("Mark", [](DBusMessage* call) {
+        return dbus_message_new_error(call, "org.gtk.GDBus.UnmappedGError.Quark._g_2dio_2derror_2dquark.Code1",
+                                      "No slot with name 'rootfs.9'");
+    });
+
+    DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "Mark");
+    appendStrings((dbus_message_iter_init_append(call, &iter_), &iter_), { "good", "rootfs.9" });
+    DBusMessage* reply = callBroker(call);
+    ASSERT_NE(reply, nullptr);
+    EXPECT_EQ(dbus_message_get_type(reply), DBUS_MESSAGE_TYPE_ERROR);
+    EXPECT_STREQ(dbus_message_get_error_name(reply),
+                 "org.gtk.GDBus.UnmappedGError.Quark._g_2dio_2derror_2dquark.Code1");
+
+    const char* message = nullptr;
+    ASSERT_TRUE(dbus_message_get_args(reply, nullptr, DBUS_TYPE_STRING, &message, DBUS_TYPE_INVALID));
+    EXPECT_STREQ(message, "No slot with name 'rootfs.9'");
+
+    dbus_message_unref(reply);
+    dbus_message_unref(call);
+}
+
+namespace {
+
+void appendProgressEntry(DBusMessageIter* dict, dbus_int32_t percentage, const char* message, dbus_int32_t depth) {
+    const char* key = "Progress";
+    DBusMessageIter entry, variant, progress;
+    dbus_message_iter_open_container(dict, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "(isi)", &variant);
+    dbus_message_iter_open_container(&variant, DBUS_TYPE_STRUCT, nullptr, &progress);
+    dbus_message_iter_append_basic(&progress, DBUS_TYPE_INT32, &percentage);
+    dbus_message_iter_append_basic(&progress, DBUS_TYPE_STRING, &message);
+    dbus_message_iter_append_basic(&progress, DBUS_TYPE_INT32, &depth);
+    dbus_message_iter_close_container(&variant, &progress);
+    dbus_message_iter_close_container(&entry, &variant);
+    dbus_message_iter_close_container(dict, &entry);
+}
+
+const char* const BROKER_SIGNALS = "type='signal',path='/org/freedesktop/UpdateService'";
+
+} // namespace
+
+TEST_F(BrokerRoundTripTest, PropertyChangesAreForwarded) {
+    dbus_bus_add_match(client_, BROKER_SIGNALS, nullptr);
+
+    // Operation and Progress change; Compatible is not forwarded, Progress only as our Progress signal
+    emitPropertiesChanged([](DBusMessageIter* dict) {
+        appendStringEntry(dict, "Operation", "installing");
+        appendStringEntry(dict, "Compatible", "intel-corei7-64");
+        appendProgressEntry(dict, 40, "Checking bundle", 1);
+    }, {});
+
+    DBusMessage* progress_signal = waitForSignal(BROKER_INTERFACE, "Progress");
+    DBusMessage* properties_signal = waitForSignal("org.freedesktop.DBus.Properties", "PropertiesChanged");
+    dbus_bus_remove_match(client_, BROKER_SIGNALS, nullptr);
+
+    ASSERT_NE(progress_signal, nullptr);
+    EXPECT_EQ(dumpArguments(progress_signal), "i|i40;");
+    ASSERT_NE(properties_signal, nullptr);
+    EXPECT_EQ(dumpArguments(properties_signal),
+              "sa{sv}as|s\"org.freedesktop.UpdateService\";"
+              "a{sv}[{s\"Operation\",v<s>:s\"installing\"}];as[];");
+
+    dbus_message_unref(progress_signal);
+    dbus_message_unref(properties_signal);
+}
+
+TEST_F(BrokerRoundTripTest, ImmutablePropertiesAreCached) {
+    rauc_->setReply("Get:BootSlot", replyWith([](DBusMessageIter* iter) {
+        const char* slot = "A";
+        dbus_test::appendVariant(iter, DBUS_TYPE_STRING, &slot);
+    }));
+    DBusMessage* first = getProperty("BootSlot");
+    ASSERT_NE(first, nullptr);
+    int calls = rauc_->callCount("Get:BootSlot");
+
+    DBusMessage* second = getProperty("BootSlot");
+    ASSERT_NE(second, nullptr);
+    EXPECT_EQ(rauc_->callCount("Get:BootSlot"), calls);
+    EXPECT_EQ(dumpArguments(second), dumpArguments(first));
+
+    dbus_message_unref(first);
+    dbus_message_unref(second);
+}
+
+TEST_F(BrokerRoundTripTest, PropertiesChangedUpdatesCache) {
+    dbus_bus_add_match(client_, BROKER_SIGNALS, nullptr);
+    rauc_->setReply("Get:Operation", replyWith([](DBusMessageIter* iter) {
+        const char* operation = "idle";
+        dbus_test::appendVariant(iter, DBUS_TYPE_STRING, &operation);
+    }));
+
+    // A changed value is served without asking RAUC
+    emitPropertiesChanged([](DBusMessageIter* dict) { appendStringEntry(dict, "Operation", "installing"); }, {});
+    DBusMessage* changed = waitForSignal("org.freedesktop.DBus.Properties", "PropertiesChanged");
+    ASSERT_NE(changed, nullptr);
+    dbus_message_unref(changed);
+
+    int calls = rauc_->callCount("Get:Operation");
+    DBusMessage* reply = getProperty("Operation");
+    ASSERT_NE(reply, nullptr);
+    EXPECT_EQ(dumpArguments(reply), "v|v<s>:s\"installing\";");
+    EXPECT_EQ(rauc_->callCount("Get:Operation"), calls);
+    dbus_message_unref(reply);
+
+    // An invalidated value is read from RAUC again
+    emitPropertiesChanged([](DBusMessageIter*) {}, { "Operation" });
+    changed = waitForSignal("org.freedesktop.DBus.Properties", "PropertiesChanged");
+    ASSERT_NE(changed, nullptr);
+    EXPECT_EQ(dumpArguments(changed), "sa{sv}as|s\"org.freedesktop.UpdateService\";a{sv}[];as[s\"Operation\"];");
+    dbus_message_unref(changed);
+    dbus_bus_remove_match(client_, BROKER_SIGNALS, nullptr);
+
+    reply = getProperty("Operation");
+    ASSERT_NE(reply, nullptr);
+    EXPECT_EQ(dumpArguments(reply), "v|v<s>:s\"idle\";");
+    EXPECT_EQ(rauc_->callCount("Get:Operation"), calls + 1);
+    dbus_message_unref(reply);
+}
+
+TEST_F(BrokerRoundTripTest, GetAll) {
+    rauc_->setReply("GetAll", replyWith([](DBusMessageIter* iter) {
+        DBusMessageIter dict;
+        dbus_message_iter_open_container(iter, DBUS_TYPE_ARRAY, "{sv}", &dict);
+        for (const char* name : { "Operation", "LastError", "Compatible", "Variant", "BootSlot" }) {
+            appendStringEntry(&dict, name, "from-getall");
+        }
+        appendProgressEntry(&dict, 0, "", 0);
+        dbus_message_iter_close_container(iter, &dict);
+    }));
+
+    DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, "org.freedesktop.DBus.Properties", "GetAll");
+    appendStrings((dbus_message_iter_init_append(call, &iter_), &iter_), { BROKER_INTERFACE });
+    DBusMessage* reply = callBroker(call);
+    ASSERT_NE(reply, nullptr);
+    ASSERT_TRUE(dbus_message_has_signature(reply, "a{sv}"));
+
+    std::set<std::string> names;
+    DBusMessageIter dict, entry;
+    dbus_message_iter_init(reply, &iter_);
+    dbus_message_iter_recurse(&iter_, &dict);
+    for (; dbus_message_iter_get_arg_type(&dict) == DBUS_TYPE_DICT_ENTRY; dbus_message_iter_next(&dict)) {
+        const char* name = nullptr;
+        dbus_message_iter_recurse(&dict, &entry);
+        dbus_message_iter_get_basic(&entry, &name);
+        names.insert(name);
+    }
+    EXPECT_EQ(names, (std::set<std::string>{ "Operation", "LastError", "Progress", "Compatible", "Variant",
+                                             "BootSlot", "CallLatency", "LatencyBuckets", "PendingCalls",
+                                             "SignalCounters" }));
+
+    // Everything is cached now: a second GetAll does not reach RAUC
+    int calls = rauc_->callCount("GetAll");
+    DBusMessage* again = callBroker(call);
+    ASSERT_NE(again, nullptr);
+    EXPECT_EQ(rauc_->callCount("GetAll"), calls);
+
+    dbus_message_unref(again);
+    dbus_message_unref(reply);
+    dbus_message_unref(call);
+}
+
+TEST_F(BrokerRoundTripTest, SubscribedClientsReceiveUnicastSignals) {
+    // No match rule: only signals addressed to this client arrive
+    DBusMessage* subscribe = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "Subscribe");
+    DBusMessageIter dict;
+    dbus_message_iter_init_append(subscribe, &iter_);
+    dbus_message_iter_open_container(&iter_, DBUS_TYPE_ARRAY, "{sv}", &dict);
+    dbus_uint32_t step = 50;
+    appendEntry(&dict, "progress-step", DBUS_TYPE_UINT32, &step);
+    dbus_message_iter_close_container(&iter_, &dict);
+    DBusMessage* reply = callBroker(subscribe);
+    ASSERT_NE(reply, nullptr);
+    ASSERT_EQ(dbus_message_get_type(reply), DBUS_MESSAGE_TYPE_METHOD_RETURN);
+    dbus_message_unref(reply);
+    dbus_message_unref(subscribe);
+
+    // 20 % is within the 50 % step of 10 % and is not delivered
+    for (int percentage : { 10, 20, 70 }) {
+        emitPropertiesChanged([percentage](DBusMessageIter* dict) {
+            appendProgressEntry(dict, percentage, "Copying", 1);
+        }, {});
+    }
+    DBusMessage* completed = dbus_message_new_signal("/", "de.pengutronix.rauc.Installer", "Completed");
+    dbus_int32_t result = 0;
+    dbus_message_append_args(completed, DBUS_TYPE_INT32, &result, DBUS_TYPE_INVALID);
+    rauc_->emit(completed);
+    dbus_message_unref(completed);
+
+    const char* unique_name = dbus_bus_get_unique_name(client_);
+    std::vector<std::string> received;
+    for (int i = 0; i < 3; i++) {
+        DBusMessage* signal = waitForSignal(BROKER_INTERFACE, i < 2 ? "Progress" : "Completed");
+        ASSERT_NE(signal, nullptr) << i;
+        EXPECT_STREQ(dbus_message_get_destination(signal), unique_name);
+        received.push_back(dumpArguments(signal));
+        dbus_message_unref(signal);
+    }
+    EXPECT_EQ(received, (std::vector<std::string>{ "i|i10;", "i|i70;", "bs|b1;s\"Installation completed\";" }));
+
+    DBusMessage* unsubscribe = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "Unsubscribe");
+    reply = callBroker(unsubscribe);
+    ASSERT_NE(reply, nullptr);
+    dbus_message_unref(reply);
+    dbus_message_unref(unsubscribe);
+
+    reply = getProperty("SignalCounters");
+    ASSERT_NE(reply, nullptr);
+    std::string counters = dumpArguments(reply);
+    EXPECT_NE(counters.find("{s\"coalesced\",t1}"), std::string::npos) << counters;
+    EXPECT_NE(counters.find("{s\"clients\",t0}"), std::string::npos) << counters;
+    // Broadcast is on in this suite, so each unicast is a possible duplicate for a client with a match rule
+    EXPECT_GT(counterValue(counters, "unicast"), 0u) << counters;
+    EXPECT_EQ(counterValue(counters, "duplicate"), counterValue(counters, "unicast")) << counters;
+    dbus_message_unref(reply);
+}
+
+TEST_F(BrokerRoundTripTest, InstallQueue) {
+    dbus_bus_add_match(client_, BROKER_SIGNALS, nullptr);
+    rauc_->setReply("InstallBundle", replyWith([](DBusMessageIter*) {}));
+
+    // An installation left running by another test holds the queue back until it completes
+    emitCompleted(0);
+    DBusMessage* signal = waitForSignal(BROKER_INTERFACE, "Completed");
+    ASSERT_NE(signal, nullptr);
+    dbus_message_unref(signal);
+
+    // The first job starts right away, the others wait by priority
+    std::string first = queueInstall("/data/a.raucb", 0, nullptr);
+    ASSERT_EQ(first.compare(0, 4, "ub|u"), 0) << first;
+    std::string a = first.substr(4, first.find(';') - 4);
+    EXPECT_EQ(first, "ub|u" + a + ";b0;");
+    signal = waitForSignal(BROKER_INTERFACE, "JobStarted");
+    ASSERT_NE(signal, nullptr);
+    EXPECT_EQ(dumpArguments(signal), "us|u" + a + ";s\"/data/a.raucb\";");
+    dbus_message_unref(signal);
+
+    std::string b = std::to_string(std::stoul(a) + 1);
+    std::string c = std::to_string(std::stoul(a) + 2);
+    EXPECT_EQ(queueInstall("/data/b.raucb", 0, nullptr), "ub|u" + b + ";b0;");
+    EXPECT_EQ(queueInstall("/data/c.raucb", 10, "sha256:cc"), "ub|u" + c + ";b0;");
+    EXPECT_EQ(queueInstall("/mnt/usb/c.raucb", 0, "sha256:cc"), "ub|u" + c + ";b1;");
+
+    DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "GetQueue");
+    DBusMessage* reply = callBroker(call);
+    ASSERT_NE(reply, nullptr);
+    EXPECT_EQ(dumpArguments(reply),
+              "a(usiss)|a(usiss)[(u" + a + ",s\"running\",i0,s\"/data/a.raucb\",s\"/data/a.raucb\"),"
+              "(u" + c + ",s\"queued\",i10,s\"/data/c.raucb\",s\"sha256:cc\"),"
+              "(u" + b + ",s\"queued\",i0,s\"/data/b.raucb\",s\"/data/b.raucb\")];");
+    dbus_message_unref(reply);
+    dbus_message_unref(call);
+
+    // Queued jobs can be cancelled, the running one cannot
+    for (const std::string& job : { b, a }) {
+        call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "CancelJob");
+        dbus_uint32_t job_id = std::stoul(job);
+        dbus_message_append_args(call, DBUS_TYPE_UINT32, &job_id, DBUS_TYPE_INVALID);
+        reply = callBroker(call);
+        ASSERT_NE(reply, nullptr);
+        if (job == b) {
+            EXPECT_EQ(dbus_message_get_type(reply), DBUS_MESSAGE_TYPE_METHOD_RETURN);
+        } else {
+            EXPECT_STREQ(dbus_message_get_error_name(reply), "org.freedesktop.UpdateService.Error.JobRunning");
+        }
+        dbus_message_unref(reply);
+        dbus_message_unref(call);
+    }
+
+    // RAUC finishes the first job, the broker hands it the next one
+    int install_calls = rauc_->callCount("InstallBundle");
+    emitCompleted(0);
+    signal = waitForSignal(BROKER_INTERFACE, "JobCompleted");
+    ASSERT_NE(signal, nullptr);
+    EXPECT_EQ(dumpArguments(signal), "ubs|u" + a + ";b1;s\"Installation completed\";");
+    dbus_message_unref(signal);
+    signal = waitForSignal(BROKER_INTERFACE, "JobStarted");
+    ASSERT_NE(signal, nullptr);
+    EXPECT_EQ(dumpArguments(signal), "us|u" + c + ";s\"/data/c.raucb\";");
+    dbus_message_unref(signal);
+    ASSERT_TRUE(waitForCalls("InstallBundle", install_calls + 1));
+    DBusMessage* forwarded = rauc_->lastCall("InstallBundle");
+    ASSERT_NE(forwarded, nullptr);
+    EXPECT_EQ(dumpArguments(forwarded), "sa{sv}|s\"/data/c.raucb\";a{sv}[];");
+    dbus_message_unref(forwarded);
+
+    // A bundle RAUC refuses fails its job without a Completed
+    rauc_->setReply("InstallBundle", [](DBusMessage* call) {
+        return dbus_message_new_error(call, "org.gtk.GDBus.UnmappedGError.Quark._g_2dio_2derror_2dquark.Code1",
+                                      "Bundle signature verification failed");
+    });
+    std::string d = std::to_string(std::stoul(a) + 3);
+    EXPECT_EQ(queueInstall("/data/d.raucb", 0, nullptr), "ub|u" + d + ";b0;");
+    emitCompleted(1);
+    signal = waitForSignal(BROKER_INTERFACE, "JobCompleted");
+    ASSERT_NE(signal, nullptr);
+    EXPECT_EQ(dumpArguments(signal), "ubs|u" + c + ";b0;s\"Installation failed\";");
+    dbus_message_unref(signal);
+    signal = waitForSignal(BROKER_INTERFACE, "JobCompleted");
+    ASSERT_NE(signal, nullptr);
+    EXPECT_EQ(dumpArguments(signal), "ubs|u" + d + ";b0;s\"Bundle signature verification failed\";");
+    dbus_message_unref(signal);
+    dbus_bus_remove_match(client_, BROKER_SIGNALS, nullptr);
+
+    call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "GetQueue");
+    reply = callBroker(call);
+    ASSERT_NE(reply, nullptr);
+    EXPECT_EQ(dumpArguments(reply), "a(usiss)|a(usiss)[];");
+    dbus_message_unref(reply);
+    dbus_message_unref(call);
+}
+
+TEST_F(BrokerRoundTripTest, RefusedInstallKeepsRunningInstallation) {
+    dbus_bus_add_match(client_, BROKER_SIGNALS, nullptr);
+
+    for (const char* method : { "Install", "InstallBundle" }) {
+        // RAUC accepts the first call and refuses the second one while it is installing
+        rauc_->setReply(method, replyWith([](DBusMessageIter*) {}));
+        DBusMessage* first = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, method);
+        dbus_message_iter_init_append(first, &iter_);
+        if (strcmp(method, "Install") == 0) {
+            appendStrings(&iter_, { "/data/nuc-image-1.4.2.raucb" });
+        } else {
+            appendInstallArgs(&iter_);
+        }
+        DBusMessage* reply = callBroker(first);
+        ASSERT_NE(reply, nullptr) << method;
+        ASSERT_EQ(dbus_message_get_type(reply), DBUS_MESSAGE_TYPE_METHOD_RETURN) << method;
+        dbus_message_unref(reply);
+
+        rauc_->setReply(method, [](DBusMessage* call) {
+            return dbus_message_new_error(call, "org.gtk.GDBus.UnmappedGError.Quark._g_2dio_2derror_2dquark.Code0",
+                                          "Already processing a different method");
+        });
+        reply = callBroker(first);
+        ASSERT_NE(reply, nullptr) << method;
+        EXPECT_EQ(dbus_message_get_type(reply), DBUS_MESSAGE_TYPE_ERROR) << method;
+        dbus_message_unref(reply);
+        dbus_message_unref(first);
+        rauc_->setReply("InstallBundle", replyWith([](DBusMessageIter*) {}));
+
+        // The queued job waits for the first installation instead of being refused by RAUC
+        int install_calls = rauc_->callCount("InstallBundle");
+        std::string queued = queueInstall("/data/e.raucb", 0, nullptr);
+        ASSERT_EQ(queued.compare(0, 4, "ub|u"), 0) << queued;
+        std::string e = queued.substr(4, queued.find(';') - 4);
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        EXPECT_EQ(rauc_->callCount("InstallBundle"), install_calls) << method;
+
+        DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "GetQueue");
+        reply = callBroker(call);
+        ASSERT_NE(reply, nullptr);
+        EXPECT_EQ(dumpArguments(reply),
+                  "a(usiss)|a(usiss)[(u" + e + ",s\"queued\",i0,s\"/data/e.raucb\",s\"/data/e.raucb\")];")
+            << method;
+        dbus_message_unref(reply);
+        dbus_message_unref(call);
+
+        // Completed of the first installation starts the job, its own Completed finishes it
+        emitCompleted(0);
+        DBusMessage* signal = waitForSignal(BROKER_INTERFACE, "JobStarted");
+        ASSERT_NE(signal, nullptr) << method;
+        EXPECT_EQ(dumpArguments(signal), "us|u" + e + ";s\"/data/e.raucb\";");
+        dbus_message_unref(signal);
+        emitCompleted(0);
+        signal = waitForSignal(BROKER_INTERFACE, "JobCompleted");
+        ASSERT_NE(signal, nullptr) << method;
+        EXPECT_EQ(dumpArguments(signal), "ubs|u" + e + ";b1;s\"Installation completed\";");
+        dbus_message_unref(signal);
+    }
+    dbus_bus_remove_match(client_, BROKER_SIGNALS, nullptr);
+}
+
+namespace {
+
+// Next signal with this member on connection, or nullptr after timeout_ms
+DBusMessage* nextSignal(DBusConnection* connection, const char* member, int timeout_ms) {
+    for (int waited = 0; waited <= timeout_ms; waited += 20) {
+        while (DBusMessage* received = dbus_connection_pop_message(connection)) {
+            if (dbus_message_is_signal(received, BROKER_INTERFACE, member)) {
+                return received;
+            }
+            dbus_message_unref(received);
+        }
+        dbus_connection_read_write(connection, 20);
+    }
+    return nullptr;
+}
+
+// Runs in a fresh process: UPDATE_SERVICE_BROADCAST_SIGNALS (unset here) is read when the broker is created
+void runSubscribersOnlyBroker() {
+    dbus_threads_init_default();
+    PrivateBus bus;
+    if (!bus.start()) {
+        fprintf(stderr, "dbus-daemon is required for the broadcast test\n");
+        exit(2);
+    }
+    StandInRauc rauc;
+    if (!rauc.start()) {
+        bus.stop();
+        exit(2);
+    }
+
+    setenv("UPDATE_SERVICE_QUEUE_FILE", "", 1);
+    unsetenv("UPDATE_SERVICE_BROADCAST_SIGNALS");
+    UpdateService* service = new UpdateService();
+    if (!service->initialize()) {
+        rauc.stop();
+        bus.stop();
+        exit(3);
+    }
+    std::thread loop([service]() { service->run(); });
+
+    // One subscribed client without match rules, one legacy listener with a match rule only
+    DBusConnection* subscriber = dbus_bus_get_private(DBUS_BUS_SYSTEM, nullptr);
+    DBusConnection* listener = dbus_bus_get_private(DBUS_BUS_SYSTEM, nullptr);
+    dbus_connection_set_exit_on_disconnect(subscriber, FALSE);
+    dbus_connection_set_exit_on_disconnect(listener, FALSE);
+    dbus_bus_add_match(listener, "type='signal',path='/org/freedesktop/UpdateService'", nullptr);
+
+    int result = 0;
+    DBusMessage* subscribe = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "Subscribe");
+    DBusMessageIter iter, dict;
+    dbus_message_iter_init_append(subscribe, &iter);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "{sv}", &dict);
+    dbus_message_iter_close_container(&iter, &dict);
+    DBusMessage* reply = dbus_connection_send_with_reply_and_block(subscriber, subscribe, 5000, nullptr);
+    dbus_message_unref(subscribe);
+    if (!reply || dbus_message_get_type(reply) != DBUS_MESSAGE_TYPE_METHOD_RETURN) {
+        fprintf(stderr, "Subscribe failed\n");
+        result = 4;
+    }
+    if (reply) {
+        dbus_message_unref(reply);
+    }
+
+    DBusMessage* operation = dbus_message_new_signal("/", "org.freedesktop.DBus.Properties", "PropertiesChanged");
+    DBusMessageIter dict_iter, names;
+    const char* rauc_interface = "de.pengutronix.rauc.Installer";
+    dbus_message_iter_init_append(operation, &iter);
+    dbus_message_iter_append_basic(&iter, DBUS_TYPE_STRING, &rauc_interface);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "{sv}", &dict_iter);
+    appendStringEntry(&dict_iter, "Operation", "installing");
+    dbus_message_iter_close_container(&iter, &dict_iter);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "s", &names);
+    dbus_message_iter_close_container(&iter, &names);
+    rauc.emit(operation);
+    dbus_message_unref(operation);
+
+    DBusMessage* completed = dbus_message_new_signal("/", "de.pengutronix.rauc.Installer", "Completed");
+    dbus_int32_t code = 0;
+    dbus_message_append_args(completed, DBUS_TYPE_INT32, &code, DBUS_TYPE_INVALID);
+    rauc.emit(completed);
+    dbus_message_unref(completed);
+
+    DBusMessage* unicast = result ? nullptr : nextSignal(subscriber, "Completed", 2000);
+    if (!result && !unicast) {
+        fprintf(stderr, "subscriber did not receive Completed\n");
+        result = 5;
+    }
+    if (unicast) {
+        dbus_message_unref(unicast);
+        // The broker handled the signals already; a broadcast would be queued for the listener by now
+        for (int waited = 0; waited <= 300 && !result; waited += 20) {
+            while (DBusMessage* received = dbus_connection_pop_message(listener)) {
+                if (dbus_message_get_type(received) == DBUS_MESSAGE_TYPE_SIGNAL &&
+                    dbus_message_has_path(received, BROKER_PATH)) {
+                    fprintf(stderr, "%s was broadcast by default\n", dbus_message_get_member(received));
+                    result = 6;
+                }
+                dbus_message_unref(received);
+            }
+            dbus_connection_read_write(listener, 20);
+        }
+    }
+
+    if (!result) {
+        DBusMessage* get = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, "org.freedesktop.DBus.Properties", "Get");
+        const char* interface = BROKER_INTERFACE;
+        const char* property = "SignalCounters";
+        dbus_message_append_args(get, DBUS_TYPE_STRING, &interface, DBUS_TYPE_STRING, &property, DBUS_TYPE_INVALID);
+        reply = dbus_connection_send_with_reply_and_block(subscriber, get, 5000, nullptr);
+        dbus_message_unref(get);
+        std::string counters = reply ? dumpArguments(reply) : std::string();
+        if (reply) {
+            dbus_message_unref(reply);
+        }
+        if (counterValue(counters, "unicast") != 1 || counterValue(counters, "duplicate") != 0 ||
+            counterValue(counters, "broadcast") != 0) {
+            fprintf(stderr, "unexpected counters: %s\n", counters.c_str());
+            result = 7;
+        }
+    }
+
+    service->stop();
+    loop.join();
+    delete service;
+    dbus_connection_close(subscriber);
+    dbus_connection_unref(subscriber);
+    dbus_connection_close(listener);
+    dbus_connection_unref(listener);
+    rauc.stop();
+    bus.stop();
+    exit(result);
+}
+
+} // namespace
+
+TEST(BroadcastSignalsTest, DefaultSendsOnlyToSubscribers) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(runSubscribersOnlyBroker(), ::testing::ExitedWithCode(0), "");
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "client_registry.h"
+
+using Clock = ClientRegistry::Clock;
+using Names = std::vector<std::string>;
+
+class ClientRegistryTest : public ::testing::Test {
+protected:
+    static ClientRegistry::Options progressEvery(uint32_t step, uint32_t interval_ms) {
+        ClientRegistry::Options options;
+        options.progress_step = step;
+        options.progress_interval_ms = interval_ms;
+        return options;
+    }
+
+    ClientRegistry registry;
+    Clock::time_point start = Clock::now();
+
+    Clock::time_point at(int ms) { return start + std::chrono::milliseconds(ms); }
+};
+
+TEST_F(ClientRegistryTest, SubscribeAndUnsubscribe) {
+    EXPECT_TRUE(registry.subscribe(":1.10", ClientRegistry::Options()));
+    EXPECT_FALSE(registry.subscribe(":1.10", progressEvery(10, 0)));
+    EXPECT_EQ(registry.size(), 1u);
+    EXPECT_TRUE(registry.unsubscribe(":1.10"));
+    EXPECT_FALSE(registry.unsubscribe(":1.10"));
+    EXPECT_EQ(registry.size(), 0u);
+}
+
+TEST_F(ClientRegistryTest, DefaultOptionsReceiveEveryChange) {
+    registry.subscribe(":1.10", ClientRegistry::Options());
+    for (int percentage = 0; percentage <= 100; percentage += 5) {
+        EXPECT_EQ(registry.progressTargets(percentage, at(percentage)), Names{ ":1.10" });
+    }
+    EXPECT_EQ(registry.coalesced(), 0u);
+}
+
+TEST_F(ClientRegistryTest, ProgressStepFiltersSmallChanges) {
+    registry.subscribe(":1.10", progressEvery(10, 0));
+    EXPECT_EQ(registry.progressTargets(0, at(0)), Names{ ":1.10" });
+    EXPECT_TRUE(registry.progressTargets(5, at(1)).empty());
+    EXPECT_TRUE(registry.progressTargets(9, at(2)).empty());
+    EXPECT_EQ(registry.progressTargets(10, at(3)), Names{ ":1.10" });
+    EXPECT_TRUE(registry.progressTargets(15, at(4)).empty());
+    // 100 % is always delivered
+    EXPECT_EQ(registry.progressTargets(100, at(5)), Names{ ":1.10" });
+    EXPECT_EQ(registry.coalesced(), 3u);
+}
+
+TEST_F(ClientRegistryTest, IntervalCoalescesToLatestValue) {
+    registry.subscribe(":1.10", progressEvery(1, 500));
+    EXPECT_EQ(registry.progressTargets(10, at(0)), Names{ ":1.10" });
+    EXPECT_TRUE(registry.progressTargets(20, at(100)).empty());
+    EXPECT_TRUE(registry.progressTargets(30, at(200)).empty());
+    EXPECT_TRUE(registry.hasPendingProgress());
+
+    EXPECT_TRUE(registry.takeDueProgress(at(400)).empty());
+    auto due = registry.takeDueProgress(at(500));
+    ASSERT_EQ(due.size(), 1u);
+    EXPECT_EQ(due[0].first, ":1.10");
+    EXPECT_EQ(due[0].second, 30);
+    EXPECT_FALSE(registry.hasPendingProgress());
+    EXPECT_EQ(registry.coalesced(), 1u);  // 20 was replaced by 30
+}
+
+TEST_F(ClientRegistryTest, ClientsAreFilteredIndependently) {
+    ClientRegistry::Options completion_only;
+    completion_only.progress = false;
+    registry.subscribe(":1.10", ClientRegistry::Options());
+    registry.subscribe(":1.11", progressEvery(25, 0));
+    registry.subscribe(":1.12", completion_only);
+
+    EXPECT_EQ(registry.progressTargets(0, at(0)), (Names{ ":1.10", ":1.11" }));
+    EXPECT_EQ(registry.progressTargets(10, at(1)), Names{ ":1.10" });
+    EXPECT_EQ(registry.progressTargets(30, at(2)), (Names{ ":1.10", ":1.11" }));
+    EXPECT_EQ(registry.completedTargets(), (Names{ ":1.10", ":1.11", ":1.12" }));
+}
+
+TEST_F(ClientRegistryTest, CompletedResetsProgressState) {
+    ClientRegistry::Options no_completed = progressEvery(10, 1000);
+    no_completed.completed = false;
+    registry.subscribe(":1.10", no_completed);
+
+    EXPECT_EQ(registry.progressTargets(50, at(0)), Names{ ":1.10" });
+    EXPECT_TRUE(registry.progressTargets(90, at(10)).empty());
+    EXPECT_TRUE(registry.completedTargets().empty());
+    EXPECT_FALSE(registry.hasPendingProgress());
+
+    // The next installation starts fresh: no interval or step carried over
+    EXPECT_EQ(registry.progressTargets(55, at(20)), Names{ ":1.10" });
+}
@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+#include "dbus_copy.h"
+#include "dbus_test_utils.h"
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using dbus_test::appendEntry;
+using dbus_test::appendStringEntry;
+using dbus_test::dumpArguments;
+
+class DBusCopyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        source = dbus_message_new_method_call("de.pengutronix.rauc", "/", "de.pengutronix.rauc.Installer", "Test");
+        target = dbus_message_new_method_call("de.pengutronix.rauc", "/", "de.pengutronix.rauc.Installer", "Test");
+        dbus_message_iter_init_append(source, &args);
+    }
+
+    void TearDown() override {
+        dbus_message_unref(source);
+        dbus_message_unref(target);
+    }
+
+    void expectIdenticalCopy() {
+        ASSERT_TRUE(dbus_copy::copyArguments(source, target));
+        EXPECT_STREQ(dbus_message_get_signature(target), dbus_message_get_signature(source));
+        EXPECT_EQ(dumpArguments(target), dumpArguments(source));
+    }
+
+    DBusMessage* source = nullptr;
+    DBusMessage* target = nullptr;
+    DBusMessageIter args;
+};
+
+TEST_F(DBusCopyTest, CopiesAllBasicTypes) {
+    unsigned char byte_value = 0xA5;
+    dbus_bool_t bool_value = TRUE;
+    dbus_int16_t int16_value = -1234;
+    dbus_uint16_t uint16_value = 65000;
+    dbus_int32_t int32_value = -42;
+    dbus_uint32_t uint32_value = 4000000000u;
+    dbus_int64_t int64_value = -9000000000000000000LL;
+    dbus_uint64_t uint64_value = 18000000000000000000ULL;
+    double double_value = 3.141592653589793;
+    const char* string_value = "caf\xc3\xa9";
+    const char* path_value = "/org/freedesktop/UpdateService";
+    const char* signature_value = "a(sa{sv})";
+
+    ASSERT_TRUE(dbus_message_append_args(source,
+        DBUS_TYPE_BYTE, &byte_value,
+        DBUS_TYPE_BOOLEAN, &bool_value,
+        DBUS_TYPE_INT16, &int16_value,
+        DBUS_TYPE_UINT16, &uint16_value,
+        DBUS_TYPE_INT32, &int32_value,
+        DBUS_TYPE_UINT32, &uint32_value,
+        DBUS_TYPE_INT64, &int64_value,
+        DBUS_TYPE_UINT64, &uint64_value,
+        DBUS_TYPE_DOUBLE, &double_value,
+        DBUS_TYPE_STRING, &string_value,
+        DBUS_TYPE_OBJECT_PATH, &path_value,
+        DBUS_TYPE_SIGNATURE, &signature_value,
+        DBUS_TYPE_INVALID));
+
+    expectIdenticalCopy();
+    EXPECT_STREQ(dbus_message_get_signature(target), "ybnqiuxtdsog");
+}
+
+TEST_F(DBusCopyTest, CopiesFixedArraysAsBlocks) {
+    const unsigned char bytes[] = { 0x00, 0xFF, 0x00, 0x7F };
+    const unsigned char* byte_data = bytes;
+    const dbus_int32_t ints[] = { -1, 0, 1, 2147483647 };
+    const dbus_int32_t* int_data = ints;
+    const double doubles[] = { 0.5, -2.25 };
+    const double* double_data = doubles;
+    const unsigned char* empty_data = bytes;
+
+    ASSERT_TRUE(dbus_message_append_args(source,
+        DBUS_TYPE_ARRAY, DBUS_TYPE_BYTE, &byte_data, 4,
+        DBUS_TYPE_ARRAY, DBUS_TYPE_INT32, &int_data, 4,
+        DBUS_TYPE_ARRAY, DBUS_TYPE_DOUBLE, &double_data, 2,
+        DBUS_TYPE_ARRAY, DBUS_TYPE_BYTE, &empty_data, 0,
+        DBUS_TYPE_INVALID));
+
+    expectIdenticalCopy();
+
+    // Embedded NULs survive the block copy
+    DBusMessageIter iter, array;
+    ASSERT_TRUE(dbus_message_iter_init(target, &iter));
+    dbus_message_iter_recurse(&iter, &array);
+    const unsigned char* copied = nullptr;
+    int count = 0;
+    dbus_message_iter_get_fixed_array(&array, &copied, &count);
+    ASSERT_EQ(count, 4);
+    EXPECT_EQ(memcmp(copied, bytes, sizeof(bytes)), 0);
+}
+
+TEST_F(DBusCopyTest, CopiesSlotStatusArray) {
+    // GetSlotStatus: a(sa{sv})
+    DBusMessageIter slots, slot, dict;
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "(sa{sv})", &slots);
+    for (const char* name : { "rootfs.0", "rootfs.1" }) {
+        dbus_uint64_t size = 4294967296ULL;
+        dbus_uint32_t count = 3;
+        dbus_message_iter_open_container(&slots, DBUS_TYPE_STRUCT, nullptr, &slot);
+        dbus_message_iter_append_basic(&slot, DBUS_TYPE_STRING, &name);
+        dbus_message_iter_open_container(&slot, DBUS_TYPE_ARRAY, "{sv}", &dict);
+        appendStringEntry(&dict, "bootname", name[7] == '0' ? "A" : "B");
+        appendStringEntry(&dict, "state", "booted");
+        appendEntry(&dict, "size", DBUS_TYPE_UINT64, &size);
+        appendEntry(&dict, "installed.count", DBUS_TYPE_UINT32, &count);
+        dbus_message_iter_close_container(&slot, &dict);
+        dbus_message_iter_close_container(&slots, &slot);
+    }
+    dbus_message_iter_close_container(&args, &slots);
+
+    expectIdenticalCopy();
+    EXPECT_STREQ(dbus_message_get_signature(target), "a(sa{sv})");
+}
+
+TEST_F(DBusCopyTest, CopiesEmptyContainerArrays) {
+    // No element to look at: the element signature must come from the enclosing signature
+    DBusMessageIter empty;
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "(sa{sv})", &empty);
+    dbus_message_iter_close_container(&args, &empty);
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "aa{sv}", &empty);
+    dbus_message_iter_close_container(&args, &empty);
+
+    expectIdenticalCopy();
+    EXPECT_STREQ(dbus_message_get_signature(target), "a(sa{sv})aaa{sv}");
+}
+
+TEST_F(DBusCopyTest, CopiesVariantsHoldingContainers) {
+    // InspectBundle style a{sv} whose values are dicts, arrays, structs and nested variants
+    DBusMessageIter dict, entry, variant, inner, item;
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "{sv}", &dict);
+
+    appendStringEntry(&dict, "manifest-hash", "9f86d081884c7d659a2feaa0c55ad015");
+
+    const char* key = "update";
+    dbus_message_iter_open_container(&dict, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "a{sv}", &variant);
+    dbus_message_iter_open_container(&variant, DBUS_TYPE_ARRAY, "{sv}", &inner);
+    appendStringEntry(&inner, "compatible", "nuc");
+    appendStringEntry(&inner, "version", "1.4.2");
+    dbus_message_iter_close_container(&variant, &inner);
+    dbus_message_iter_close_container(&entry, &variant);
+    dbus_message_iter_close_container(&dict, &entry);
+
+    key = "hooks";
+    dbus_message_iter_open_container(&dict, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "as", &variant);
+    dbus_message_iter_open_container(&variant, DBUS_TYPE_ARRAY, "s", &inner);
+    for (const char* hook : { "install-check", "post-install" }) {
+        dbus_message_iter_append_basic(&inner, DBUS_TYPE_STRING, &hook);
+    }
+    dbus_message_iter_close_container(&variant, &inner);
+    dbus_message_iter_close_container(&entry, &variant);
+    dbus_message_iter_close_container(&dict, &entry);
+
+    key = "progress";
+    dbus_message_iter_open_container(&dict, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "(isi)", &variant);
+    dbus_message_iter_open_container(&variant, DBUS_TYPE_STRUCT, nullptr, &item);
+    dbus_int32_t percentage = 42;
+    const char* message = "Copying image";
+    dbus_int32_t depth = 2;
+    dbus_message_iter_append_basic(&item, DBUS_TYPE_INT32, &percentage);
+    dbus_message_iter_append_basic(&item, DBUS_TYPE_STRING, &message);
+    dbus_message_iter_append_basic(&item, DBUS_TYPE_INT32, &depth);
+    dbus_message_iter_close_container(&variant, &item);
+    dbus_message_iter_close_container(&entry, &variant);
+    dbus_message_iter_close_container(&dict, &entry);
+
+    key = "nested";
+    dbus_message_iter_open_container(&dict, DBUS_TYPE_DICT_ENTRY, nullptr, &entry);
+    dbus_message_iter_append_basic(&entry, DBUS_TYPE_STRING, &key);
+    dbus_message_iter_open_container(&entry, DBUS_TYPE_VARIANT, "v", &variant);
+    dbus_uint64_t value = 7;
+    dbus_test::appendVariant(&variant, DBUS_TYPE_UINT64, &value);
+    dbus_message_iter_close_container(&entry, &variant);
+    dbus_message_iter_close_container(&dict, &entry);
+
+    dbus_message_iter_close_container(&args, &dict);
+
+    expectIdenticalCopy();
+}
+
+TEST_F(DBusCopyTest, CopiesDeepNesting) {
+    DBusMessageIter levels[6];
+    dbus_message_iter_open_container(&args, DBUS_TYPE_ARRAY, "aaa(iai)", &levels[0]);
+    dbus_message_iter_open_container(&levels[0], DBUS_TYPE_ARRAY, "aa(iai)", &levels[1]);
+    dbus_message_iter_open_container(&levels[1], DBUS_TYPE_ARRAY, "a(iai)", &levels[2]);
+    dbus_message_iter_open_container(&levels[2], DBUS_TYPE_ARRAY, "(iai)", &levels[3]);
+    dbus_message_iter_open_container(&levels[3], DBUS_TYPE_STRUCT, nullptr, &levels[4]);
+    dbus_int32_t number = 5;
+    dbus_message_iter_append_basic(&levels[4], DBUS_TYPE_INT32, &number);
+    dbus_message_iter_open_container(&levels[4], DBUS_TYPE_ARRAY, "i", &levels[5]);
+    dbus_message_iter_append_basic(&levels[5], DBUS_TYPE_INT32, &number);
+    for (int level = 5; level > 0; --level) {
+        dbus_message_iter_close_container(&levels[level - 1], &levels[level]);
+    }
+    dbus_message_iter_close_container(&args, &levels[0]);
+
+    expectIdenticalCopy();
+}
+
+TEST_F(DBusCopyTest, DuplicatesUnixFds) {
+    int fds[2];
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_TRUE(dbus_message_append_args(source, DBUS_TYPE_UNIX_FD, &fds[0], DBUS_TYPE_INVALID));
+
+    ASSERT_TRUE(dbus_copy::copyArguments(source, target));
+    int copied = -1;
+    ASSERT_TRUE(dbus_message_get_args(target, nullptr, DBUS_TYPE_UNIX_FD, &copied, DBUS_TYPE_INVALID));
+
+    struct stat original_stat, copied_stat;
+    ASSERT_EQ(fstat(fds[0], &original_stat), 0);
+    ASSERT_EQ(fstat(copied, &copied_stat), 0);
+    EXPECT_EQ(original_stat.st_ino, copied_stat.st_ino);
+    EXPECT_NE(copied, fds[0]);
+
+    close(copied);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_F(DBusCopyTest, EmptyMessageCopiesNothing) {
+    EXPECT_TRUE(dbus_copy::copyArguments(source, target));
+    EXPECT_STREQ(dbus_message_get_signature(target), "");
+}
+
+TEST_F(DBusCopyTest, RejectsSignatureMismatch) {
+    const char* value = "x";
+    ASSERT_TRUE(dbus_message_append_args(source, DBUS_TYPE_STRING, &value, DBUS_TYPE_INVALID));
+
+    DBusMessageIter source_iter, target_iter;
+    ASSERT_TRUE(dbus_message_iter_init(source, &source_iter));
+    dbus_message_iter_init_append(target, &target_iter);
+    EXPECT_FALSE(dbus_copy::copyValue(&source_iter, &target_iter, "i"));
+    EXPECT_FALSE(dbus_copy::copyValue(&source_iter, &target_iter, ""));
+}
+
+TEST_F(DBusCopyTest, CompleteTypeLength) {
+    EXPECT_EQ(dbus_copy::completeTypeLength("s"), 1);
+    EXPECT_EQ(dbus_copy::completeTypeLength("si"), 1);
+    EXPECT_EQ(dbus_copy::completeTypeLength("a{sv}i"), 5);
+    EXPECT_EQ(dbus_copy::completeTypeLength("a(sa{sv})"), 9);
+    EXPECT_EQ(dbus_copy::completeTypeLength("aaa(iai)s"), 8);
+    EXPECT_EQ(dbus_copy::completeTypeLength("(i(ss)a{s(ii)})x"), 15);
+    EXPECT_EQ(dbus_copy::completeTypeLength(""), 0);
+}
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include "update_service.h"
+#include "stand_in_rauc.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+// Drives the release step directly, so calls can be queued on the broker's
+// connection before it runs instead of racing the idle timer
+struct IdleExitProbe {
+    static DBusConnection* connection(UpdateService& service) { return service.service_connection_; }
+    static void exitIfIdle(UpdateService& service) { service.exitIfIdle(); }
+    static bool isIdle(const UpdateService& service) { return service.isIdle(); }
+    static size_t queuedJobs(const UpdateService& service) { return service.install_queue_.size(); }
+};
+
+namespace {
+
+const char* BROKER_NAME = "org.freedesktop.UpdateService";
+const char* BROKER_PATH = "/org/freedesktop/UpdateService";
+const char* BROKER_INTERFACE = "org.freedesktop.UpdateService";
+
+void fail(int code, const char* reason) {
+    fprintf(stderr, "%s\n", reason);
+    exit(code);
+}
+
+bool callBroker(DBusConnection* client, const char* method, bool with_options) {
+    DBusMessage* call = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, method);
+    if (with_options) {
+        DBusMessageIter iter, dict;
+        dbus_message_iter_init_append(call, &iter);
+        dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "{sv}", &dict);
+        dbus_message_iter_close_container(&iter, &dict);
+    }
+    DBusMessage* reply = dbus_connection_send_with_reply_and_block(client, call, 5000, nullptr);
+    dbus_message_unref(call);
+    if (reply) {
+        dbus_message_unref(reply);
+    }
+    return reply != nullptr;
+}
+
+bool waitFor(const std::atomic<bool>& flag, int timeout_ms) {
+    for (int waited = 0; !flag && waited < timeout_ms; waited += 20) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    return flag;
+}
+
+// Runs in a fresh process (threadsafe death test style): the broker's shared
+// system bus connection must not be the one the round-trip tests use
+void runIdleBroker() {
+    dbus_threads_init_default();
+    PrivateBus bus;
+    if (!bus.start()) {
+        fail(2, "dbus-daemon is required for the idle exit test");
+    }
+    StandInRauc rauc;
+    if (!rauc.start()) {
+        fail(2, "stand-in RAUC did not start");
+    }
+    rauc.setReply("GetSlotStatus", [](DBusMessage* call) { return dbus_message_new_method_return(call); });
+
+    setenv("UPDATE_SERVICE_QUEUE_FILE", "", 1);
+    setenv("UPDATE_SERVICE_IDLE_EXIT_SEC", "1", 1);
+    UpdateService* service = new UpdateService();
+    if (!service->initialize()) {
+        fail(3, "broker did not initialize");
+    }
+    std::atomic<bool> stopped(false);
+    std::thread loop([&]() {
+        service->run();
+        stopped = true;
+    });
+
+    DBusConnection* client = dbus_bus_get_private(DBUS_BUS_SYSTEM, nullptr);
+    if (!client) {
+        fail(2, "client connection failed");
+    }
+    dbus_connection_set_exit_on_disconnect(client, FALSE);
+
+    // RAUC is connected on the first call that needs it
+    if (!callBroker(client, "GetSlotStatus", false) || rauc.callCount("GetSlotStatus") != 1) {
+        fail(4, "GetSlotStatus was not forwarded to RAUC");
+    }
+
+    // A subscribed client keeps the broker running
+    if (!callBroker(client, "Subscribe", true)) {
+        fail(5, "Subscribe failed");
+    }
+    if (waitFor(stopped, 2500)) {
+        fail(6, "broker exited with a subscribed client");
+    }
+
+    // Idle again: the name is released and the loop returns
+    if (!callBroker(client, "Unsubscribe", false)) {
+        fail(5, "Unsubscribe failed");
+    }
+    if (!waitFor(stopped, 3000)) {
+        fail(7, "broker did not exit while idle");
+    }
+    if (dbus_bus_name_has_owner(client, BROKER_NAME, nullptr)) {
+        fail(8, "service name still owned after idle exit");
+    }
+
+    loop.join();
+    delete service;
+    dbus_connection_close(client);
+    dbus_connection_unref(client);
+    rauc.stop();
+    bus.stop();
+    exit(0);
+}
+
+DBusPendingCall* sendToBroker(DBusConnection* client, DBusMessage* call) {
+    DBusPendingCall* pending = nullptr;
+    dbus_connection_send_with_reply(client, call, &pending, 5000);
+    dbus_message_unref(call);
+    return pending;
+}
+
+bool answeredWithExiting(DBusPendingCall* pending) {
+    dbus_pending_call_block(pending);
+    DBusMessage* reply = dbus_pending_call_steal_reply(pending);
+    dbus_pending_call_unref(pending);
+    bool exiting = reply && dbus_message_is_error(reply, "org.freedesktop.UpdateService.Error.Exiting");
+    if (reply) {
+        dbus_message_unref(reply);
+    }
+    return exiting;
+}
+
+// Calls routed to the broker just before it released its name must not start work
+void runReleaseWithQueuedCalls() {
+    dbus_threads_init_default();
+    PrivateBus bus;
+    if (!bus.start()) {
+        fail(2, "dbus-daemon is required for the idle exit test");
+    }
+    StandInRauc rauc;
+    if (!rauc.start()) {
+        fail(2, "stand-in RAUC did not start");
+    }
+
+    setenv("UPDATE_SERVICE_QUEUE_FILE", "", 1);
+    setenv("UPDATE_SERVICE_IDLE_EXIT_SEC", "1", 1);
+    UpdateService* service = new UpdateService();
+    if (!service->initialize()) {
+        fail(3, "broker did not initialize");
+    }
+
+    DBusConnection* client = dbus_bus_get_private(DBUS_BUS_SYSTEM, nullptr);
+    if (!client) {
+        fail(2, "client connection failed");
+    }
+    dbus_connection_set_exit_on_disconnect(client, FALSE);
+
+    DBusMessage* subscribe = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "Subscribe");
+    DBusMessageIter iter, dict;
+    dbus_message_iter_init_append(subscribe, &iter);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "{sv}", &dict);
+    dbus_message_iter_close_container(&iter, &dict);
+
+    DBusMessage* queue = dbus_message_new_method_call(BROKER_NAME, BROKER_PATH, BROKER_INTERFACE, "QueueInstall");
+    const char* bundle = "/data/update.raucb";
+    dbus_message_iter_init_append(queue, &iter);
+    dbus_message_iter_append_basic(&iter, DBUS_TYPE_STRING, &bundle);
+    dbus_message_iter_open_container(&iter, DBUS_TYPE_ARRAY, "{sv}", &dict);
+    dbus_message_iter_close_container(&iter, &dict);
+
+    DBusPendingCall* subscribe_call = sendToBroker(client, subscribe);
+    DBusPendingCall* queue_call = sendToBroker(client, queue);
+    dbus_connection_flush(client);
+
+    // Read both calls into the broker's queue without dispatching them
+    DBusConnection* broker = IdleExitProbe::connection(*service);
+    for (int waited = 0; waited < 500; waited += 50) {
+        dbus_connection_read_write(broker, 50);
+    }
+
+    IdleExitProbe::exitIfIdle(*service);
+
+    // The bus is stopped before exiting either way: a left-over dbus-daemon keeps the
+    // death test's pipe open
+    int result = 0;
+    if (!answeredWithExiting(subscribe_call) || !answeredWithExiting(queue_call)) {
+        fprintf(stderr, "calls queued during the release were not answered with Error.Exiting\n");
+        result = 9;
+    } else if (!IdleExitProbe::isIdle(*service) || IdleExitProbe::queuedJobs(*service) != 0) {
+        fprintf(stderr, "exiting broker accepted new work\n");
+        result = 10;
+    } else if (dbus_bus_name_has_owner(client, BROKER_NAME, nullptr)) {
+        fprintf(stderr, "service name still owned after idle exit\n");
+        result = 8;
+    }
+
+    delete service;
+    dbus_connection_close(client);
+    dbus_connection_unref(client);
+    rauc.stop();
+    bus.stop();
+    exit(result);
+}
+
+} // namespace
+
+TEST(IdleExitTest, RejectsCallsQueuedDuringRelease) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(runReleaseWithQueuedCalls(), ::testing::ExitedWithCode(0), "");
+}
+
+TEST(IdleExitTest, ExitsOnlyWhenIdle) {
+    GTEST_FLAG_SET(death_test_style, "threadsafe");
+    EXPECT_EXIT(runIdleBroker(), ::testing::ExitedWithCode(0), "");
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "install_queue.h"
+#include <cstdio>
+
+using State = InstallQueue::State;
+
+namespace {
+
+std::vector<uint32_t> ids(const InstallQueue& queue) {
+    std::vector<uint32_t> result;
+    for (const InstallQueue::Job& job : queue.jobs()) {
+        result.push_back(job.id);
+    }
+    return result;
+}
+
+} // namespace
+
+class InstallQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override { std::remove(state_file.c_str()); }
+    void TearDown() override {
+        std::remove(state_file.c_str());
+        std::remove((state_file + ".tmp").c_str());
+    }
+
+    std::string state_file = ::testing::TempDir() + "update-service-install-queue";
+};
+
+TEST_F(InstallQueueTest, StartsByPriorityThenSubmissionOrder) {
+    InstallQueue queue;
+    uint32_t low = queue.add("/data/low.raucb", "", 0).id;
+    uint32_t high = queue.add("/data/high.raucb", "", 10).id;
+    uint32_t low_later = queue.add("/data/low-later.raucb", "", 0).id;
+    EXPECT_EQ(ids(queue), (std::vector<uint32_t>{ high, low, low_later }));
+
+    const InstallQueue::Job* job = queue.startNext();
+    ASSERT_NE(job, nullptr);
+    EXPECT_EQ(job->id, high);
+    EXPECT_EQ(queue.startNext(), nullptr);  // one installation at a time
+
+    // A later high-priority job still waits for the running one
+    uint32_t urgent = queue.add("/data/urgent.raucb", "", 100).id;
+    EXPECT_EQ(ids(queue), (std::vector<uint32_t>{ high, urgent, low, low_later }));
+
+    EXPECT_EQ(queue.finishRunning(), high);
+    EXPECT_EQ(queue.startNext()->id, urgent);
+    EXPECT_EQ(queue.finishRunning(), urgent);
+    EXPECT_EQ(queue.startNext()->id, low);
+}
+
+TEST_F(InstallQueueTest, IdenticalBundlesAreDeduplicated) {
+    InstallQueue queue;
+    InstallQueue::Added first = queue.add("/data/a.raucb", "sha256:aa", 0);
+    EXPECT_FALSE(first.deduplicated);
+
+    // Same hash under another path, with a higher priority
+    InstallQueue::Added again = queue.add("/mnt/usb/a.raucb", "sha256:aa", 5);
+    EXPECT_TRUE(again.deduplicated);
+    EXPECT_EQ(again.id, first.id);
+    EXPECT_EQ(queue.find(first.id)->priority, 5);
+    EXPECT_EQ(queue.find(first.id)->bundle, "/data/a.raucb");
+
+    // Without a hash the source is the key
+    uint32_t by_path = queue.add("/data/b.raucb", "", 0).id;
+    EXPECT_TRUE(queue.add("/data/b.raucb", "", 0).deduplicated);
+
+    // The running job deduplicates too
+    EXPECT_EQ(queue.startNext()->id, first.id);
+    EXPECT_EQ(queue.add("/data/a.raucb", "sha256:aa", 0).id, first.id);
+    EXPECT_EQ(queue.size(), 2u);
+
+    // Once finished, the same bundle can be queued again
+    EXPECT_EQ(queue.finishRunning(), first.id);
+    InstallQueue::Added requeued = queue.add("/data/a.raucb", "sha256:aa", 0);
+    EXPECT_FALSE(requeued.deduplicated);
+    EXPECT_GT(requeued.id, by_path);
+}
+
+TEST_F(InstallQueueTest, CancelOnlyQueuedJobs) {
+    InstallQueue queue;
+    uint32_t first = queue.add("/data/a.raucb", "", 0).id;
+    uint32_t second = queue.add("/data/b.raucb", "", 0).id;
+    queue.startNext();
+
+    EXPECT_FALSE(queue.cancel(first));  // running
+    EXPECT_TRUE(queue.cancel(second));
+    EXPECT_FALSE(queue.cancel(second));
+    EXPECT_FALSE(queue.cancel(12345));
+    EXPECT_EQ(ids(queue), std::vector<uint32_t>{ first });
+}
+
+TEST_F(InstallQueueTest, QueuedJobsSurviveRestart) {
+    uint32_t running, queued_low, queued_high;
+    {
+        InstallQueue queue(state_file);
+        EXPECT_EQ(queue.load(), 0u);
+        running = queue.add("/data/running.raucb", "", 50).id;
+        queue.startNext();
+        queued_low = queue.add("https://updates.example.com/low.raucb", "sha256:11", 1).id;
+        queued_high = queue.add("/data/high.raucb", "", 7).id;
+        EXPECT_FALSE(queue.saveFailed());
+    }
+
+    InstallQueue restored(state_file);
+    EXPECT_EQ(restored.load(), 2u);
+    EXPECT_EQ(restored.find(running), nullptr);  // its result was never seen
+    EXPECT_EQ(ids(restored), (std::vector<uint32_t>{ queued_high, queued_low }));
+
+    const InstallQueue::Job* low = restored.find(queued_low);
+    ASSERT_NE(low, nullptr);
+    EXPECT_EQ(low->bundle, "https://updates.example.com/low.raucb");
+    EXPECT_EQ(low->hash, "sha256:11");
+    EXPECT_EQ(low->priority, 1);
+    EXPECT_EQ(low->state, State::Queued);
+
+    // Ids are not reused
+    EXPECT_GT(restored.add("/data/new.raucb", "", 0).id, queued_high);
+}
+
+TEST_F(InstallQueueTest, UnwritableStateFileIsReported) {
+    InstallQueue queue("/nonexistent-directory/install-queue");
+    EXPECT_EQ(queue.load(), 0u);
+    EXPECT_TRUE(queue.saveFailed());
+    EXPECT_FALSE(queue.add("/data/a.raucb", "", 0).deduplicated);
+    EXPECT_EQ(queue.size(), 1u);
+}
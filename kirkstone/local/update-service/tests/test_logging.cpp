@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "logging.h"
+
+using usvc_log::Subsystem;
+
+class LogSamplingTest : public ::testing::Test {
+protected:
+    // Sampling is process wide; leave every subsystem logging every line
+    void TearDown() override {
+        usvc_log::setSampling(Subsystem::service, 1);
+        usvc_log::setSampling(Subsystem::calls, 1);
+        usvc_log::setSampling(Subsystem::signals, 1);
+    }
+
+    static int selected(Subsystem subsystem, int calls) {
+        int count = 0;
+        for (int i = 0; i < calls; ++i) {
+            count += usvc_log::sample(subsystem) ? 1 : 0;
+        }
+        return count;
+    }
+};
+
+TEST_F(LogSamplingTest, DefaultLogsEveryLine) {
+    EXPECT_EQ(usvc_log::sampling(Subsystem::signals), 1u);
+    EXPECT_EQ(selected(Subsystem::signals, 50), 50);
+}
+
+TEST_F(LogSamplingTest, FirstAndEveryNthLineIsSelected) {
+    usvc_log::setSampling(Subsystem::calls, 10);
+    EXPECT_TRUE(usvc_log::sample(Subsystem::calls));
+    EXPECT_EQ(selected(Subsystem::calls, 9), 0);
+    EXPECT_TRUE(usvc_log::sample(Subsystem::calls));
+    EXPECT_EQ(selected(Subsystem::calls, 100), 10);
+    // Other subsystems keep their own rate and counter
+    EXPECT_EQ(selected(Subsystem::signals, 5), 5);
+}
+
+TEST_F(LogSamplingTest, ConfigureFromSpec) {
+    usvc_log::configureSampling("signals=100,calls=10");
+    EXPECT_EQ(usvc_log::sampling(Subsystem::signals), 100u);
+    EXPECT_EQ(usvc_log::sampling(Subsystem::calls), 10u);
+    EXPECT_EQ(usvc_log::sampling(Subsystem::service), 1u);
+}
+
+TEST_F(LogSamplingTest, ConfigureIgnoresBadEntries) {
+    usvc_log::configureSampling("signals=0,calls=abc,bogus=5,service=7x,,calls");
+    EXPECT_EQ(usvc_log::sampling(Subsystem::signals), 1u);
+    EXPECT_EQ(usvc_log::sampling(Subsystem::calls), 1u);
+    EXPECT_EQ(usvc_log::sampling(Subsystem::service), 1u);
+
+    usvc_log::configureSampling(nullptr);
+    usvc_log::configureSampling("service=3");
+    EXPECT_EQ(usvc_log::sampling(Subsystem::service), 3u);
+}